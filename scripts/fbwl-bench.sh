@@ -0,0 +1,320 @@
+#!/usr/bin/env bash
+set -euo pipefail
+
+# Headless latency benchmark (`make bench`). Drives one compositor through a
+# fixed set of scenarios and compares the compositor-side p50/p99 handler
+# timings (`fbwl-remote perf-stats`) against scripts/fbwl-bench-baseline.txt.
+# With FBWL_BENCH_RECORD=1 (`make bench-record`) it rewrites the baseline from this run instead:
+# each ceiling is the measured p50/p99 plus FBWL_BENCH_MARGIN percent.
+#
+# Knobs:
+#   FBWL_BENCH_WINDOWS=N        toplevels to spawn (default 50)
+#   FBWL_BENCH_SWITCHES=N       workspace switches (default 200)
+#   FBWL_BENCH_MOTIONS=N        pointer motions over decorations (default 10000)
+#   FBWL_BENCH_MENU_ITEMS=N     custom menu size (default 5000)
+#   FBWL_BENCH_MENU_OPENS=N     menu open/scroll rounds (default 20)
+#   FBWL_BENCH_MENU_KEYS=N      Down presses through the open menu (default 200)
+#   FBWL_BENCH_TITLES=N         title changes in the storm (default 5000)
+#   FBWL_BENCH_IPC=N            IPC commands (default 500)
+#   FBWL_BENCH_SLACK=PCT        loosen every baseline ceiling by PCT percent
+#   FBWL_BENCH_BASELINE=FILE    baseline to compare against (or record into)
+#   FBWL_BENCH_RECORD=1         record a new baseline instead of checking
+#   FBWL_BENCH_MARGIN=PCT       headroom added to recorded values (default 50)
+
+need_cmd() {
+  command -v "$1" >/dev/null 2>&1 || { echo "missing required command: $1" >&2; exit 1; }
+}
+
+need_exe() {
+  [[ -x "$1" ]] || { echo "missing required executable: $1 (build first)" >&2; exit 1; }
+}
+
+need_cmd awk
+need_cmd mktemp
+need_cmd rg
+need_cmd timeout
+need_cmd wc
+
+need_exe ./fluxbox-wayland
+need_exe ./fbwl-input-injector
+need_exe ./fbwl-remote
+need_exe ./fbwl-smoke-client
+
+SCRIPT_DIR="$(cd "$(dirname "${BASH_SOURCE[0]}")" && pwd)"
+BASELINE="${FBWL_BENCH_BASELINE:-$SCRIPT_DIR/fbwl-bench-baseline.txt}"
+RECORD="${FBWL_BENCH_RECORD:-0}"
+MARGIN="${FBWL_BENCH_MARGIN:-50}"
+if [[ "$RECORD" != 1 ]]; then
+  [[ -f "$BASELINE" ]] || { echo "missing baseline: $BASELINE" >&2; exit 1; }
+fi
+
+WINDOWS="${FBWL_BENCH_WINDOWS:-50}"
+SWITCHES="${FBWL_BENCH_SWITCHES:-200}"
+MOTIONS="${FBWL_BENCH_MOTIONS:-10000}"
+MENU_ITEMS="${FBWL_BENCH_MENU_ITEMS:-5000}"
+MENU_OPENS="${FBWL_BENCH_MENU_OPENS:-20}"
+MENU_KEYS="${FBWL_BENCH_MENU_KEYS:-200}"
+TITLES="${FBWL_BENCH_TITLES:-5000}"
+IPC_CMDS="${FBWL_BENCH_IPC:-500}"
+SLACK="${FBWL_BENCH_SLACK:-0}"
+
+export XDG_RUNTIME_DIR="${XDG_RUNTIME_DIR:-/tmp/xdg-runtime-$UID}"
+mkdir -p "$XDG_RUNTIME_DIR"
+chmod 0700 "$XDG_RUNTIME_DIR"
+
+SOCKET="wayland-fbwl-bench-$UID-$$"
+LOG="/tmp/fluxbox-wayland-bench-$UID-$$.log"
+CFGDIR="$(mktemp -d "/tmp/fbwl-bench-$UID-XXXXXX")"
+CLIENT_PIDS=()
+
+cleanup() {
+  for pid in "${CLIENT_PIDS[@]}"; do
+    kill "$pid" 2>/dev/null || true
+  done
+  if [[ -n "${FBW_PID:-}" ]]; then kill "$FBW_PID" 2>/dev/null || true; fi
+  wait 2>/dev/null || true
+  rm -rf "$CFGDIR" 2>/dev/null || true
+}
+trap cleanup EXIT
+
+: >"$LOG"
+
+cat >"$CFGDIR/init" <<EOF
+session.screen0.allowRemoteActions: true
+session.screen0.workspaces: 2
+EOF
+
+cat >"$CFGDIR/keys" <<'EOF'
+Mod1 F1 :CustomMenu bench.menu
+EOF
+
+{
+  echo "[begin] (Bench)"
+  for ((i = 1; i <= MENU_ITEMS; i++)); do
+    echo "[exec] (Item $i) {true}"
+  done
+  echo "[end]"
+} >"$CFGDIR/bench.menu"
+
+WLR_BACKENDS=headless WLR_RENDERER=pixman ./fluxbox-wayland \
+  --no-xwayland \
+  --socket "$SOCKET" \
+  --workspaces 2 \
+  --config-dir "$CFGDIR" \
+  --keys "$CFGDIR/keys" \
+  >"$LOG" 2>&1 &
+FBW_PID=$!
+
+timeout 10 bash -c "until rg -q 'Running fluxbox-wayland' '$LOG'; do sleep 0.05; done"
+timeout 10 bash -c "until rg -q 'IPC: listening' '$LOG'; do sleep 0.05; done"
+
+remote() {
+  ./fbwl-remote --socket "$SOCKET" "$@"
+}
+
+perf_line() {
+  remote perf-stats | rg -m1 "^probe=$1 " || true
+}
+
+perf_count() {
+  local line
+  line="$(perf_line "$1")"
+  if [[ "$line" =~ count=([0-9]+) ]]; then
+    echo "${BASH_REMATCH[1]}"
+  else
+    echo 0
+  fi
+}
+
+wait_count() {
+  local probe="$1" want="$2" secs="$3"
+  local deadline=$((SECONDS + secs))
+  while (( $(perf_count "$probe") < want )); do
+    if ((SECONDS >= deadline)); then
+      echo "timed out waiting for $want $probe samples (log=$LOG)" >&2
+      exit 1
+    fi
+    sleep 0.05
+  done
+}
+
+FAILED=0
+RECORDED=()
+
+record() {
+  local scenario="$1" probe="$2" line="$3"
+  local row
+  row="$(echo "$line" | awk -v s="$scenario" -v p="$probe" -v margin="$MARGIN" '{
+    for (i = 1; i <= NF; i++) {
+      if ($i ~ /^p50_us=/) { p50 = substr($i, 8) + 0 }
+      if ($i ~ /^p99_us=/) { p99 = substr($i, 8) + 0 }
+    }
+    c50 = p50 * (100 + margin) / 100
+    c99 = p99 * (100 + margin) / 100
+    printf "%-10s %-12s %7d %8d", s, p, (c50 == int(c50)) ? c50 : int(c50) + 1, (c99 == int(c99)) ? c99 : int(c99) + 1
+  }')"
+  RECORDED+=("$row")
+  echo "bench: scenario=$scenario $line recorded"
+}
+
+check() {
+  local scenario="$1" probe="$2"
+  local line limit
+  line="$(perf_line "$probe")"
+  if [[ "$RECORD" == 1 && -n "$line" ]]; then
+    record "$scenario" "$probe" "$line"
+    return
+  fi
+  limit="$(awk -v s="$scenario" -v p="$probe" '$1 == s && $2 == p { print $3, $4; exit }' "$BASELINE")"
+  if [[ -z "$line" ]]; then
+    echo "bench: scenario=$scenario probe=$probe no samples FAIL"
+    FAILED=1
+    return
+  fi
+  if [[ -z "$limit" ]]; then
+    echo "bench: scenario=$scenario $line (no baseline)"
+    return
+  fi
+  local verdict
+  verdict="$(echo "$line $limit" | awk -v slack="$SLACK" '{
+    for (i = 1; i <= NF; i++) {
+      if ($i ~ /^p50_us=/) { p50 = substr($i, 8) + 0 }
+      if ($i ~ /^p99_us=/) { p99 = substr($i, 8) + 0 }
+    }
+    max50 = $(NF - 1) * (100 + slack) / 100
+    max99 = $NF * (100 + slack) / 100
+    printf "limit_p50_us=%.1f limit_p99_us=%.1f %s", max50, max99, (p50 > max50 || p99 > max99) ? "REGRESSION" : "ok"
+  }')"
+  echo "bench: scenario=$scenario $line $verdict"
+  if [[ "$verdict" == *REGRESSION ]]; then
+    FAILED=1
+  fi
+}
+
+# spawn: N decorated toplevels mapping at once. They stay up for the
+# workspace and motion scenarios.
+remote perf-reset >/dev/null
+for ((i = 1; i <= WINDOWS; i++)); do
+  ./fbwl-smoke-client --socket "$SOCKET" --title "bench-$i" --xdg-decoration \
+    --width 200 --height 120 --timeout-ms 10000 --stay-ms 600000 >/dev/null 2>&1 &
+  CLIENT_PIDS+=("$!")
+done
+wait_count map "$WINDOWS" 30
+check spawn map
+
+# workspace: bounce between two workspaces while ws1 holds every window.
+remote perf-reset >/dev/null
+for ((i = 0; i < SWITCHES; i++)); do
+  remote workspace $((i % 2 == 0 ? 2 : 1)) >/dev/null
+done
+remote workspace 1 >/dev/null
+wait_count workspace "$SWITCHES" 10
+check workspace workspace
+
+# motion: sweep rows across the stacked titlebars and borders.
+remote perf-reset >/dev/null
+CHUNK=500
+for ((start = 0; start < MOTIONS; start += CHUNK)); do
+  mapfile -t coords < <(awk -v s="$start" -v n="$CHUNK" -v total="$MOTIONS" 'BEGIN {
+    for (i = s; i < s + n && i < total; i++) {
+      print 10 + (i % 120) * 10
+      print 10 + int(i / 120) % 35 * 20
+    }
+  }')
+  ./fbwl-input-injector --socket "$SOCKET" motion "${coords[@]}" >/dev/null 2>&1
+done
+wait_count motion "$MOTIONS" 30
+check motion motion
+
+# menu: open the large custom menu and walk the pointer down its items.
+remote perf-reset >/dev/null
+for ((round = 1; round <= MENU_OPENS; round++)); do
+  ./fbwl-input-injector --socket "$SOCKET" motion 100 100 >/dev/null 2>&1
+  OFFSET=$(wc -c <"$LOG" | tr -d ' ')
+  ./fbwl-input-injector --socket "$SOCKET" key alt-f1 >/dev/null 2>&1
+  START=$((OFFSET + 1))
+  timeout 10 bash -c "until tail -c +$START '$LOG' | rg -q 'Menu: open at '; do sleep 0.05; done"
+  open_line="$(tail -c +$START "$LOG" | rg -m1 'Menu: open at ')"
+  if [[ ! "$open_line" =~ x=([-0-9]+)\ y=([-0-9]+)\ items=([0-9]+) ]]; then
+    echo "failed to parse menu open line: $open_line" >&2
+    exit 1
+  fi
+  MENU_X="${BASH_REMATCH[1]}"
+  MENU_Y="${BASH_REMATCH[2]}"
+  mapfile -t coords < <(awk -v x="$((MENU_X + 20))" -v y="$((MENU_Y + 30))" 'BEGIN {
+    for (i = 0; y + i * 6 < 700; i++) {
+      print x
+      print y + i * 6
+    }
+  }')
+  ./fbwl-input-injector --socket "$SOCKET" motion "${coords[@]}" >/dev/null 2>&1
+  ./fbwl-input-injector --socket "$SOCKET" key escape >/dev/null 2>&1
+done
+wait_count menu-open "$MENU_OPENS" 10
+check menu menu-open
+check menu menu-select
+
+# menu-nav: walk the same menu by keyboard, well past the items that fit on
+# the first screen, so selection cost is measured deep into the list too.
+remote perf-reset >/dev/null
+./fbwl-input-injector --socket "$SOCKET" motion 100 100 >/dev/null 2>&1
+OFFSET=$(wc -c <"$LOG" | tr -d ' ')
+./fbwl-input-injector --socket "$SOCKET" key alt-f1 >/dev/null 2>&1
+START=$((OFFSET + 1))
+timeout 10 bash -c "until tail -c +$START '$LOG' | rg -q 'Menu: open at '; do sleep 0.05; done"
+for ((i = 0; i < MENU_KEYS; i++)); do
+  ./fbwl-input-injector --socket "$SOCKET" key down >/dev/null 2>&1
+done
+wait_count menu-nav "$MENU_KEYS" 30
+./fbwl-input-injector --socket "$SOCKET" key escape >/dev/null 2>&1
+check menu menu-nav
+
+# title: one client retitling as fast as it can.
+remote perf-reset >/dev/null
+./fbwl-smoke-client --socket "$SOCKET" --title bench-storm --title-storm "$TITLES" \
+  --timeout-ms 10000 --stay-ms 600000 >/dev/null 2>&1 &
+CLIENT_PIDS+=("$!")
+wait_count title "$TITLES" 60
+check title title
+
+# ipc: a mix of trivial and state-reading commands.
+remote perf-reset >/dev/null
+for ((i = 0; i < IPC_CMDS; i++)); do
+  if ((i % 2 == 0)); then
+    remote ping >/dev/null
+  else
+    remote get-config >/dev/null
+  fi
+done
+check ipc ipc
+
+if [[ "$RECORD" == 1 ]]; then
+  if ((FAILED != 0)); then
+    echo "bench: not recording, some probes had no samples (log=$LOG)" >&2
+    exit 1
+  fi
+  {
+    echo "# Latency ceilings for scripts/fbwl-bench.sh (\`make bench\`)."
+    echo "#"
+    echo "# Values are compositor-side handler durations in microseconds, as reported"
+    echo "# by \`fbwl-remote perf-stats\`. A scenario fails when its measured p50 or p99"
+    echo "# exceeds the ceiling here. FBWL_BENCH_SLACK=<percent> loosens every ceiling"
+    echo "# for slower hosts."
+    echo "#"
+    echo "# Generated by \`make bench-record\`: measured p50/p99 plus a"
+    echo "# ${MARGIN}% margin. Recorded $(date -u +%Y-%m-%d) on $(uname -srm)."
+    echo "# Re-record after a change makes a path faster so the gain is protected."
+    echo "#"
+    echo "# scenario   probe        p50_us   p99_us"
+    printf '%s\n' "${RECORDED[@]}"
+  } >"$BASELINE"
+  echo "ok: bench baseline recorded to $BASELINE (margin=${MARGIN}% log=$LOG)"
+  exit 0
+fi
+
+if ((FAILED != 0)); then
+  echo "bench: regression against $BASELINE (log=$LOG)" >&2
+  exit 1
+fi
+
+echo "ok: bench passed (socket=$SOCKET log=$LOG)"
@@ -94,6 +94,8 @@ scripts=(
   scripts/fbwl-smoke-xwayland-xprop-clientpattern.sh
   scripts/fbwl-smoke-xwayland-max-ignore-increment.sh
   scripts/fbwl-smoke-ipc.sh
+  scripts/fbwl-smoke-trace.sh
+  scripts/fbwl-smoke-spawn.sh
   scripts/fbwl-smoke-restart.sh
   scripts/fbwl-smoke-startfluxbox-wayland.sh
   scripts/fbwl-smoke-fluxbox-remote.sh
@@ -179,6 +181,8 @@ scripts=(
   scripts/fbwl-smoke-keybinding-head-mark.sh
   scripts/fbwl-smoke-resource-style-cmds.sh
   scripts/fbwl-smoke-cache-resources.sh
+  scripts/fbwl-smoke-init-wildcards.sh
+  scripts/fbwl-smoke-config-watch.sh
   scripts/fbwl-smoke-keys-file.sh
   scripts/fbwl-smoke-bindkey.sh
   scripts/fbwl-smoke-keys-chaining.sh
@@ -0,0 +1,87 @@
+#!/usr/bin/env bash
+set -euo pipefail
+
+need_cmd() {
+  command -v "$1" >/dev/null 2>&1 || { echo "missing required command: $1" >&2; exit 1; }
+}
+
+need_cmd mktemp
+need_cmd rg
+need_cmd timeout
+need_cmd wc
+
+export XDG_RUNTIME_DIR="${XDG_RUNTIME_DIR:-/tmp/xdg-runtime-$UID}"
+mkdir -p "$XDG_RUNTIME_DIR"
+chmod 0700 "$XDG_RUNTIME_DIR"
+
+SOCKET="${SOCKET:-wayland-fbwl-config-watch-$UID-$$}"
+LOG="${LOG:-/tmp/fluxbox-wayland-config-watch-$UID-$$.log}"
+CFGDIR="$(mktemp -d "/tmp/fbwl-config-watch-$UID-XXXXXX")"
+
+cleanup() {
+  rm -rf "$CFGDIR" 2>/dev/null || true
+  if [[ -n "${FBW_PID:-}" ]]; then kill "$FBW_PID" 2>/dev/null || true; fi
+  wait 2>/dev/null || true
+}
+trap cleanup EXIT
+
+: >"$LOG"
+
+cat >"$CFGDIR/init" <<EOF
+session.screen0.toolbar.visible: false
+session.cacheLife: 7
+session.styleFile: $CFGDIR/style
+EOF
+cat >"$CFGDIR/style" <<'EOF'
+window.title.focus: Flat Pixmap
+window.title.focus.pixmap: title.xpm
+EOF
+printf '/* XPM */\n' >"$CFGDIR/title.xpm"
+cat >"$CFGDIR/keys" <<'EOF'
+Mod4 Return :ExecCommand true
+EOF
+
+WLR_BACKENDS="${WLR_BACKENDS:-headless}" WLR_RENDERER="${WLR_RENDERER:-pixman}" ./fluxbox-wayland \
+  --no-xwayland \
+  --socket "$SOCKET" \
+  --config-dir "$CFGDIR" \
+  >"$LOG" 2>&1 &
+FBW_PID=$!
+
+timeout 5 bash -c "until rg -q 'Running fluxbox-wayland' '$LOG'; do sleep 0.05; done"
+
+# Editors commonly save through a temp file and rename(2); only keys reload.
+OFFSET=$(wc -c <"$LOG" | tr -d ' ')
+START=$((OFFSET + 1))
+printf 'Mod4 Return :ExecCommand false\n' >"$CFGDIR/keys.tmp"
+mv -f "$CFGDIR/keys.tmp" "$CFGDIR/keys"
+timeout 5 bash -c "until tail -c +$START '$LOG' | rg -q 'Reconfigure: reloaded keys from '; do sleep 0.05; done"
+tail -c +$START "$LOG" | rg -q 'ConfigWatch: reloading keys$'
+if tail -c +$START "$LOG" | rg -q 'Reconfigure: (reloaded init|reloaded style|reloaded menu)'; then
+  echo "keys edit reloaded unrelated config" >&2
+  exit 1
+fi
+
+OFFSET=$(wc -c <"$LOG" | tr -d ' ')
+START=$((OFFSET + 1))
+cat >"$CFGDIR/init" <<EOF
+session.screen0.toolbar.visible: false
+session.cacheLife: 9
+session.styleFile: $CFGDIR/style
+EOF
+timeout 5 bash -c "until tail -c +$START '$LOG' | rg -q 'Reconfigure: init globals .* cacheLife=9 '; do sleep 0.05; done"
+tail -c +$START "$LOG" | rg -q 'ConfigWatch: reloading init$'
+
+# A pixmap the style references is watched too; rewriting it reloads the
+# style even though the parsed values are unchanged.
+OFFSET=$(wc -c <"$LOG" | tr -d ' ')
+START=$((OFFSET + 1))
+printf '/* XPM */\n/* edited */\n' >"$CFGDIR/title.xpm"
+timeout 5 bash -c "until tail -c +$START '$LOG' | rg -q 'Reconfigure: reloaded style from '; do sleep 0.05; done"
+tail -c +$START "$LOG" | rg -q 'ConfigWatch: reloading style$'
+if tail -c +$START "$LOG" | rg -q 'Reconfigure: style unchanged'; then
+  echo "pixmap edit did not rebuild the style" >&2
+  exit 1
+fi
+
+echo "ok: config watch smoke passed (socket=$SOCKET log=$LOG)"
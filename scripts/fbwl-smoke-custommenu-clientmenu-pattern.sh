@@ -83,7 +83,7 @@ OFFSET=$(wc -c <"$LOG" | tr -d ' ')
 ./fbwl-input-injector --socket "$SOCKET" key alt-f1 >/dev/null 2>&1
 START=$((OFFSET + 1))
 
-timeout 5 bash -c "until tail -c +$START '$LOG' | rg -q 'CustomMenu: loaded '; do sleep 0.05; done"
+timeout 5 bash -c "until tail -c +$START '$LOG' | rg -q 'CustomMenu: loaded .*custom\\.menu title=Custom$'; do sleep 0.05; done"
 timeout 5 bash -c "until tail -c +$START '$LOG' | rg -q 'Menu: open at '; do sleep 0.05; done"
 
 open_line="$(tail -c +$START "$LOG" | rg -m1 'Menu: open at ' || true)"
@@ -118,6 +118,32 @@ if ! rg -q '^ok$' "$MARKER"; then
   exit 1
 fi
 
+# Reopening an unchanged custom menu reuses the parsed tree.
+OFFSET=$(wc -c <"$LOG" | tr -d ' ')
+./fbwl-input-injector --socket "$SOCKET" key alt-f1 >/dev/null 2>&1
+START=$((OFFSET + 1))
+timeout 5 bash -c "until tail -c +$START '$LOG' | rg -q 'Menu: cache hit path=.*custom\\.menu'; do sleep 0.05; done"
+timeout 5 bash -c "until tail -c +$START '$LOG' | rg -q 'CustomMenu: loaded 1 items from .*custom\\.menu title=Custom$'; do sleep 0.05; done"
+timeout 5 bash -c "until tail -c +$START '$LOG' | rg -q 'Menu: open at '; do sleep 0.05; done"
+./fbwl-input-injector --socket "$SOCKET" key escape >/dev/null 2>&1
+
+# Editing it invalidates the cached entry.
+cat >"$CUSTOM_MENU" <<EOF
+[begin] (Custom)
+[exec] (TouchMarker) {sh -c 'echo ok >"$MARKER"'}
+[nop] (Edited)
+[end]
+EOF
+OFFSET=$(wc -c <"$LOG" | tr -d ' ')
+./fbwl-input-injector --socket "$SOCKET" key alt-f1 >/dev/null 2>&1
+START=$((OFFSET + 1))
+timeout 5 bash -c "until tail -c +$START '$LOG' | rg -q 'Menu: open at .* items=2'; do sleep 0.05; done"
+if tail -c +$START "$LOG" | rg -q 'Menu: cache hit '; then
+  echo "expected edited custom menu to be reparsed (log=$LOG)" >&2
+  exit 1
+fi
+./fbwl-input-injector --socket "$SOCKET" key escape >/dev/null 2>&1
+
 # ClientMenu: filter by pattern.
 ./fbwl-smoke-client --socket "$SOCKET" --title cm-a --stay-ms 10000 >/dev/null 2>&1 &
 A_PID=$!
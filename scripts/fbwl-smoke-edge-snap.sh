@@ -24,6 +24,7 @@ TITLE_H=21
 cleanup() {
   rm -rf "$CFGDIR" 2>/dev/null || true
   if [[ -n "${CLIENT_PID:-}" ]]; then kill "$CLIENT_PID" 2>/dev/null || true; fi
+  if [[ -n "${CLIENT2_PID:-}" ]]; then kill "$CLIENT2_PID" 2>/dev/null || true; fi
   if [[ -n "${FBW_PID:-}" ]]; then kill "$FBW_PID" 2>/dev/null || true; fi
   wait 2>/dev/null || true
 }
@@ -101,6 +102,46 @@ X1=$((OUT_X + EXT_LEFT))
 Y1=$((OUT_Y + EXT_TOP))
 tail -c +$((OFFSET + 1)) "$LOG" | rg -q "Move: client-snap x=$X1 y=$Y1"
 
+# Move next to a second window: a 4px gap to its right frame edge snaps shut.
+./fbwl-smoke-client --socket "$SOCKET" --title client-snap2 --xdg-decoration --stay-ms 10000 >/dev/null 2>&1 &
+CLIENT2_PID=$!
+
+timeout 5 bash -c "until rg -q 'Surface size: client-snap2 [0-9]+x[0-9]+' '$LOG'; do sleep 0.05; done"
+timeout 5 bash -c "until rg -q 'Place: client-snap2 ' '$LOG'; do sleep 0.05; done"
+
+place2_line="$(rg -m1 'Place: client-snap2 ' "$LOG")"
+if [[ "$place2_line" =~ x=([-0-9]+)\ y=([-0-9]+) ]]; then
+  XB="${BASH_REMATCH[1]}"
+  YB="${BASH_REMATCH[2]}"
+else
+  echo "failed to parse Place line: $place2_line" >&2
+  exit 1
+fi
+size2_line="$(rg -m1 'Surface size: client-snap2 ' "$LOG")"
+if [[ "$size2_line" =~ ([0-9]+)x([0-9]+) ]]; then
+  WB="${BASH_REMATCH[1]}"
+else
+  echo "failed to parse Surface size line: $size2_line" >&2
+  exit 1
+fi
+
+OFFSET=$(wc -c <"$LOG" | tr -d ' ')
+B_FRAME_RIGHT=$((XB + WB + EXT_RIGHT))
+SNAP_START_X=$((X1 + 10))
+SNAP_START_Y=$((Y1 + 10))
+SNAP_END_X=$((SNAP_START_X + (B_FRAME_RIGHT + 4 + EXT_LEFT - X1)))
+SNAP_END_Y=$((SNAP_START_Y + (YB + 20 - Y1)))
+./fbwl-input-injector --socket "$SOCKET" drag-alt-left "$SNAP_START_X" "$SNAP_START_Y" "$SNAP_END_X" "$SNAP_END_Y"
+
+X2=$((B_FRAME_RIGHT + EXT_LEFT))
+Y2=$((YB + 20))
+tail -c +$((OFFSET + 1)) "$LOG" | rg -q "Move: client-snap x=$X2 y=$Y2"
+
+# Back to the output corner for the resize check.
+OFFSET=$(wc -c <"$LOG" | tr -d ' ')
+./fbwl-input-injector --socket "$SOCKET" drag-alt-left "$((X2 + 10))" "$((Y2 + 10))" "$MOVE_END_X" "$MOVE_END_Y"
+tail -c +$((OFFSET + 1)) "$LOG" | rg -q "Move: client-snap x=$X1 y=$Y1"
+
 # Resize: drag to within 5px of output bottom-right so it snaps.
 OFFSET=$(wc -c <"$LOG" | tr -d ' ')
 RESIZE_START_X=$((X1 + 10))
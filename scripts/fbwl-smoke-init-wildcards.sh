@@ -0,0 +1,54 @@
+#!/usr/bin/env bash
+set -euo pipefail
+
+need_cmd() {
+  command -v "$1" >/dev/null 2>&1 || { echo "missing required command: $1" >&2; exit 1; }
+}
+
+need_cmd mktemp
+need_cmd rg
+need_cmd timeout
+
+export XDG_RUNTIME_DIR="${XDG_RUNTIME_DIR:-/tmp/xdg-runtime-$UID}"
+mkdir -p "$XDG_RUNTIME_DIR"
+chmod 0700 "$XDG_RUNTIME_DIR"
+
+SOCKET="${SOCKET:-wayland-fbwl-init-wildcards-$UID-$$}"
+LOG="${LOG:-/tmp/fluxbox-wayland-init-wildcards-$UID-$$.log}"
+CFGDIR="$(mktemp -d "/tmp/fbwl-init-wildcards-$UID-XXXXXX")"
+
+cleanup() {
+  rm -rf "$CFGDIR" 2>/dev/null || true
+  if [[ -n "${FBW_PID:-}" ]]; then kill "$FBW_PID" 2>/dev/null || true; fi
+  wait 2>/dev/null || true
+}
+trap cleanup EXIT
+
+: >"$LOG"
+
+# Exact keys win over wildcards, keys are case-insensitive, and the more
+# specific wildcard wins over a bare loose binding.
+cat >"$CFGDIR/init" <<'EOF'
+session.?.toolbar.visible: false
+*allowRemoteActions: true
+*cacheLife: 7
+*cacheMax: 1
+Session.CacheMax: 321
+*colorsPerChannel: 2
+session*colorsPerChannel: 8
+session.configVersion: 99
+EOF
+
+WLR_BACKENDS="${WLR_BACKENDS:-headless}" WLR_RENDERER="${WLR_RENDERER:-pixman}" ./fluxbox-wayland \
+  --no-xwayland \
+  --socket "$SOCKET" \
+  --config-dir "$CFGDIR" \
+  >"$LOG" 2>&1 &
+FBW_PID=$!
+
+timeout 5 bash -c "until rg -q 'Running fluxbox-wayland' '$LOG'; do sleep 0.05; done"
+rg -q 'Init: loaded .* \(8 resources, 6 wildcard\)' "$LOG"
+timeout 5 bash -c "until rg -q 'Init: globals .* configVersion=99 cacheLife=7 cacheMax=321 colorsPerChannel=8 .*' '$LOG'; do sleep 0.05; done"
+./fbwl-remote --socket "$SOCKET" reconfigure | rg -q '^ok reconfigure$'
+
+echo "ok: init wildcards smoke passed (socket=$SOCKET log=$LOG)"
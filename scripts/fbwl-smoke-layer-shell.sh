@@ -103,4 +103,12 @@ OFFSET=$(wc -c <"$LOG" | tr -d ' ')
 ./fbwl-input-injector --socket "$SOCKET" key alt-m >/dev/null 2>&1
 tail -c +$((OFFSET + 1)) "$LOG" | rg -q "Maximize: placed on w=${MAX_USABLE_W} h=${MAX_USABLE_H}"
 
+OFFSET=$(wc -c <"$LOG" | tr -d ' ')
+kill "$LS_PID" 2>/dev/null || true
+wait "$LS_PID" 2>/dev/null || true
+unset LS_PID
+timeout 5 bash -c "until tail -c +$((OFFSET + 1)) '$LOG' | rg -q 'LayerShell: output=[^ ]+ usable=0,0 ${OUT_W}x${OUT_H}'; do sleep 0.05; done"
+timeout 5 bash -c "until tail -c +$((OFFSET + 1)) '$LOG' | rg -q 'Usable: output=[^ ]+ box='; do sleep 0.05; done"
+timeout 5 bash -c "until tail -c +$((OFFSET + 1)) '$LOG' | rg -q 'Maximize: refit placed '; do sleep 0.05; done"
+
 echo "ok: layer-shell smoke passed (socket=$SOCKET log=$LOG output=${OUT_W}x${OUT_H} panel_h=$PANEL_H)"
@@ -7,6 +7,7 @@ need_cmd() {
 
 need_cmd rg
 need_cmd timeout
+need_cmd wc
 
 export XDG_RUNTIME_DIR="${XDG_RUNTIME_DIR:-/tmp/xdg-runtime-$UID}"
 mkdir -p "$XDG_RUNTIME_DIR"
@@ -49,4 +50,22 @@ timeout 5 bash -c "until [[ \$(rg -c 'OutputLayout:' '$LOG') -ge 2 ]]; do sleep
 ./fbwl-output-management-client --socket "$SOCKET" --timeout-ms 6000 --expect-heads 2 --target-index 1 --delta-y 120 >"$OM_LOG" 2>&1
 rg -q '^ok output-management moved ' "$OM_LOG"
 
+# The whole configuration lands as one batch and one layout pass.
+timeout 5 bash -c "until rg -q 'OutputMgmt: applied ' '$LOG'; do sleep 0.05; done"
+APPLIED=$(rg -c 'OutputMgmt: applied ' "$LOG")
+if [[ "$APPLIED" -ne 1 ]]; then
+  echo "expected one batched apply, got $APPLIED (log=$LOG)" >&2
+  exit 1
+fi
+# Both heads start auto-placed, so the first apply pins both of them.
+rg -q 'OutputMgmt: applied heads=2 enabled=2 relayout=2$' "$LOG"
+
+# A second apply that only moves head 1 leaves head 0 in the layout as is.
+OFFSET=$(wc -c <"$LOG" | tr -d ' ')
+START=$((OFFSET + 1))
+./fbwl-output-management-client --socket "$SOCKET" --timeout-ms 6000 --expect-heads 2 --target-index 1 --delta-y 60 >"$OM_LOG" 2>&1
+rg -q '^ok output-management moved ' "$OM_LOG"
+timeout 5 bash -c "until tail -c +$START '$LOG' | rg -q 'OutputMgmt: applied '; do sleep 0.05; done"
+tail -c +$START "$LOG" | rg -q 'OutputMgmt: applied heads=2 enabled=2 relayout=1$'
+
 echo "ok: output-management smoke passed (socket=$SOCKET log=$LOG)"
@@ -21,7 +21,11 @@ chmod 0700 "$XDG_RUNTIME_DIR"
 SOCKET="${SOCKET:-wayland-fbwl-restart-$UID-$$}"
 LOG="${LOG:-/tmp/fluxbox-wayland-restart-$UID-$$.log}"
 
+SOCKET_KEEP="${SOCKET_KEEP:-wayland-fbwl-restart-keep-$UID-$$}"
+LOG_KEEP="${LOG_KEEP:-/tmp/fluxbox-wayland-restart-keep-$UID-$$.log}"
+
 cleanup() {
+  if [[ -n "${CLIENT_PID:-}" ]]; then kill "$CLIENT_PID" 2>/dev/null || true; fi
   if [[ -n "${FBW_PID:-}" ]]; then kill "$FBW_PID" 2>/dev/null || true; fi
   wait 2>/dev/null || true
 }
@@ -37,11 +41,67 @@ FBW_PID=$!
 timeout 5 bash -c "until rg -q 'Running fluxbox-wayland' '$LOG'; do sleep 0.05; done"
 timeout 5 bash -c "until ./fbwl-remote --socket \"$SOCKET\" ping | rg -q '^ok pong$'; do sleep 0.05; done"
 
+./fbwl-smoke-client --socket "$SOCKET" --title restart-a --stay-ms 20000 >/dev/null 2>&1 &
+CLIENT_PID=$!
+timeout 5 bash -c "until rg -q 'Place: restart-a ' '$LOG'; do sleep 0.05; done"
+
 OFFSET="$(wc -c <"$LOG" | tr -d ' ')"
 ./fbwl-remote --socket "$SOCKET" restart | rg -q '^ok restarting$'
 
+timeout 10 bash -c "until tail -c +$((OFFSET + 1)) '$LOG' | rg -q 'Session: saved 1 windows to .* reason=restart'; do sleep 0.05; done"
 timeout 10 bash -c "until tail -c +$((OFFSET + 1)) '$LOG' | rg -q 'Running fluxbox-wayland'; do sleep 0.05; done"
 timeout 10 bash -c "until ./fbwl-remote --socket \"$SOCKET\" ping | rg -q '^ok pong$'; do sleep 0.05; done"
+tail -c +$((OFFSET + 1)) "$LOG" | rg -q 'Session: loaded 1 windows from '
+wait "$CLIENT_PID" 2>/dev/null || true
+
+# The old connection died with the old process; a reconnecting client gets its
+# snapshot entry back instead of being placed again.
+OFFSET="$(wc -c <"$LOG" | tr -d ' ')"
+./fbwl-smoke-client --socket "$SOCKET" --title restart-a --stay-ms 20000 >/dev/null 2>&1 &
+CLIENT_PID=$!
+timeout 5 bash -c "until tail -c +$((OFFSET + 1)) '$LOG' | rg -q 'Session: restored title=restart-a '; do sleep 0.05; done"
+if tail -c +$((OFFSET + 1)) "$LOG" | rg -q 'Place: restart-a '; then
+  echo "restored view was placed again" >&2
+  exit 1
+fi
+
+kill "$CLIENT_PID" 2>/dev/null || true
+./fbwl-remote --socket "$SOCKET" quit | rg -q '^ok quitting$'
+timeout 5 bash -c "while kill -0 '$FBW_PID' 2>/dev/null; do sleep 0.05; done"
+wait 2>/dev/null || true
+unset CLIENT_PID FBW_PID
+
+# --restart-keep-socket: the listening socket survives the re-exec. The old
+# process stops dispatching once it has answered the restart, so a client
+# that connects right after that sits in the backlog and is served by the
+# new process on the same socket.
+: >"$LOG_KEEP"
+WLR_BACKENDS=headless WLR_RENDERER=pixman ./fluxbox-wayland \
+  --no-xwayland \
+  --socket "$SOCKET_KEEP" \
+  --restart-keep-socket \
+  >"$LOG_KEEP" 2>&1 &
+FBW_PID=$!
+
+timeout 5 bash -c "until rg -q 'Running fluxbox-wayland' '$LOG_KEEP'; do sleep 0.05; done"
+timeout 5 bash -c "until ./fbwl-remote --socket \"$SOCKET_KEEP\" ping | rg -q '^ok pong$'; do sleep 0.05; done"
+
+OFFSET="$(wc -c <"$LOG_KEEP" | tr -d ' ')"
+./fbwl-remote --socket "$SOCKET_KEEP" restart | rg -q '^ok restarting$'
+./fbwl-smoke-client --socket "$SOCKET_KEEP" --title restart-keep --timeout-ms 10000 --stay-ms 20000 >/dev/null 2>&1 &
+CLIENT_PID=$!
+
+timeout 10 bash -c "until tail -c +$((OFFSET + 1)) '$LOG_KEEP' | rg -q 'Place: restart-keep '; do sleep 0.05; done"
+AFTER="$(tail -c +$((OFFSET + 1)) "$LOG_KEEP")"
+echo "$AFTER" | rg -q "Restart: inherited socket $SOCKET_KEEP fd=[0-9]+"
+if ! echo "$AFTER" | rg -U -q '(?s)Running fluxbox-wayland.*Place: restart-keep '; then
+  echo "client connected during the restart was not served by the new process" >&2
+  exit 1
+fi
+if ! kill -0 "$CLIENT_PID" 2>/dev/null; then
+  echo "client connected during the restart lost its connection" >&2
+  exit 1
+fi
 
-echo "ok: restart smoke passed (socket=$SOCKET log=$LOG)"
+echo "ok: restart smoke passed (socket=$SOCKET log=$LOG keep_socket=$SOCKET_KEEP log_keep=$LOG_KEEP)"
 
@@ -48,6 +48,7 @@ dbus-run-session -- bash -c '
   FBW_PID=$!
 
   cleanup() {
+    if [[ -n "${ITEM_PID:-}" ]]; then kill "$ITEM_PID" 2>/dev/null || true; fi
     if [[ -n "${FBW_PID:-}" ]]; then
       kill "$FBW_PID" 2>/dev/null || true
       wait "$FBW_PID" 2>/dev/null || true
@@ -69,6 +70,42 @@ dbus-run-session -- bash -c '
   timeout 5 bash -c "until rg -q \"SNI: item registered id=$ID\" \"$LOG\"; do sleep 0.05; done"
   timeout 5 bash -c "until rg -q \"SNI: item unregistered id=$ID\" \"$LOG\"; do sleep 0.05; done"
 
+  # A burst of property signals (PropertiesChanged with values plus NewStatus)
+  # is applied without Get round trips and lands as in-place tray updates
+  # (coalesced per event-loop pass), never as a full toolbar rebuild.
+  timeout 5 bash -c "until rg -q \"Toolbar: position \" \"$LOG\"; do sleep 0.05; done"
+  BURST_OUT="$(mktemp)"
+  ./fbwl-sni-item-client --item-path /fbwl/BurstItem --icon-rgba "#00ff00" --update-icon-rgba "#ff0000" \
+    --burst-on-usr1 8 --stay-ms 8000 >"$BURST_OUT" 2>&1 &
+  ITEM_PID=$!
+  timeout 5 bash -c "until rg -q \"^ok sni registered id=\" \"$BURST_OUT\"; do sleep 0.05; done"
+  BURST_ID="$(sed -n "s/^ok sni registered id=//p" "$BURST_OUT")"
+  timeout 5 bash -c "until rg -q \"SNI: icon updated id=$BURST_ID status=Active\" \"$LOG\"; do sleep 0.05; done"
+  timeout 5 bash -c "until rg -q \"Toolbar: tray item idx=0 .*id=$BURST_ID\" \"$LOG\"; do sleep 0.05; done"
+  sleep 0.2
+
+  OFFSET=$(wc -c <"$LOG" | tr -d " ")
+  START=$((OFFSET + 1))
+  kill -USR1 "$ITEM_PID"
+  timeout 5 bash -c "until rg -q \"^ok sni burst signals=16$\" \"$BURST_OUT\"; do sleep 0.05; done"
+  timeout 5 bash -c "until tail -c +$START \"$LOG\" | rg -q \"Toolbar: tray icons updated\"; do sleep 0.05; done"
+  sleep 0.2
+
+  LAST_STATUS="$(tail -c +$START "$LOG" | rg "SNI: status updated id=$BURST_ID " | tail -n 1)"
+  if [[ "$LAST_STATUS" != *"status=NeedsAttention" ]]; then
+    echo "expected final status NeedsAttention after burst, got: $LAST_STATUS" >&2
+    exit 1
+  fi
+  if tail -c +$START "$LOG" | rg -q "Toolbar: built "; then
+    echo "signal burst rebuilt the whole toolbar (log=$LOG)" >&2
+    exit 1
+  fi
+
+  kill "$ITEM_PID" 2>/dev/null || true
+  wait "$ITEM_PID" 2>/dev/null || true
+  unset ITEM_PID
+  rm -f "$BURST_OUT"
+
   ./fbwl-remote --socket "$SOCKET" quit | rg -q "^ok quitting$"
   timeout 5 bash -c "while kill -0 \"$FBW_PID\" 2>/dev/null; do sleep 0.05; done"
   wait "$FBW_PID"
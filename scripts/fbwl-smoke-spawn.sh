@@ -0,0 +1,60 @@
+#!/usr/bin/env bash
+set -euo pipefail
+
+need_cmd() {
+  command -v "$1" >/dev/null 2>&1 || { echo "missing required command: $1" >&2; exit 1; }
+}
+
+need_cmd rg
+need_cmd timeout
+
+export XDG_RUNTIME_DIR="${XDG_RUNTIME_DIR:-/tmp/xdg-runtime-$UID}"
+mkdir -p "$XDG_RUNTIME_DIR"
+chmod 0700 "$XDG_RUNTIME_DIR"
+
+SOCKET="${SOCKET:-wayland-fbwl-spawn-$UID-$$}"
+LOG="${LOG:-/tmp/fluxbox-wayland-spawn-$UID-$$.log}"
+
+cleanup() {
+  if [[ -n "${FBW_PID:-}" ]]; then
+    kill "$FBW_PID" 2>/dev/null || true
+    wait "$FBW_PID" 2>/dev/null || true
+  fi
+}
+trap cleanup EXIT
+
+: >"$LOG"
+WLR_BACKENDS=headless WLR_RENDERER=pixman ./fluxbox-wayland \
+  --no-xwayland \
+  --socket "$SOCKET" \
+  >"$LOG" 2>&1 &
+FBW_PID=$!
+
+timeout 5 bash -c "until rg -q 'Running fluxbox-wayland' '$LOG'; do sleep 0.05; done"
+timeout 5 bash -c "until ./fbwl-remote --socket '$SOCKET' ping | rg -q '^ok pong$'; do sleep 0.05; done"
+
+# Plain commands skip /bin/sh; builtins and anything with shell syntax still
+# go through it, and so does a program that is not on PATH.
+./fbwl-remote --socket "$SOCKET" exec true | rg -q '^ok$'
+./fbwl-remote --socket "$SOCKET" exec 'exit 3' | rg -q '^ok$'
+./fbwl-remote --socket "$SOCKET" exec "fbwl-no-such-command-$$" | rg -q '^ok$'
+
+# All three children must be reaped by the compositor, not left as zombies.
+timeout 5 bash -c "until ./fbwl-remote --socket '$SOCKET' launches | rg -q '^ok launched=3 direct=1 failed=0 running=0$'; do sleep 0.05; done"
+LAUNCHES="$(./fbwl-remote --socket "$SOCKET" launches)"
+echo "$LAUNCHES" | rg -q '^pid=[0-9]+ direct=1 spawn_us=[0-9]+ life_ms=[0-9]+ state=exited=0 cmd=true$'
+echo "$LAUNCHES" | rg -q '^pid=[0-9]+ direct=0 spawn_us=[0-9]+ life_ms=[0-9]+ state=exited=3 cmd=exit 3$'
+echo "$LAUNCHES" | rg -q "^pid=[0-9]+ direct=0 spawn_us=[0-9]+ life_ms=[0-9]+ state=exited=127 cmd=fbwl-no-such-command-$$\$"
+
+ZOMBIES="$(ps -o stat= --ppid "$FBW_PID" | rg -c '^Z' || true)"
+if [[ "${ZOMBIES:-0}" != "0" ]]; then
+  echo "compositor left $ZOMBIES zombie children" >&2
+  exit 1
+fi
+
+./fbwl-remote --socket "$SOCKET" quit | rg -q '^ok quitting$'
+timeout 5 bash -c "while kill -0 '$FBW_PID' 2>/dev/null; do sleep 0.05; done"
+wait "$FBW_PID"
+unset FBW_PID
+
+echo "ok: spawn smoke passed (socket=$SOCKET log=$LOG)"
@@ -0,0 +1,77 @@
+#!/usr/bin/env bash
+set -euo pipefail
+
+need_cmd() {
+  command -v "$1" >/dev/null 2>&1 || { echo "missing required command: $1" >&2; exit 1; }
+}
+
+need_cmd rg
+need_cmd timeout
+
+export XDG_RUNTIME_DIR="${XDG_RUNTIME_DIR:-/tmp/xdg-runtime-$UID}"
+mkdir -p "$XDG_RUNTIME_DIR"
+chmod 0700 "$XDG_RUNTIME_DIR"
+
+SOCKET="${SOCKET:-wayland-fbwl-trace-$UID-$$}"
+LOG="${LOG:-/tmp/fluxbox-wayland-trace-$UID-$$.log}"
+DUMP="${DUMP:-/tmp/fbwl-trace-dump-$UID-$$.txt}"
+
+cleanup() {
+  if [[ -n "${FBW_PID:-}" ]]; then
+    kill "$FBW_PID" 2>/dev/null || true
+    wait "$FBW_PID" 2>/dev/null || true
+  fi
+  rm -f "$DUMP" 2>/dev/null || true
+}
+trap cleanup EXIT
+
+: >"$LOG"
+
+if WLR_BACKENDS=headless WLR_RENDERER=pixman ./fluxbox-wayland --trace bogus >/dev/null 2>&1; then
+  echo "expected --trace bogus to fail" >&2
+  exit 1
+fi
+
+WLR_BACKENDS=headless WLR_RENDERER=pixman ./fluxbox-wayland \
+  --no-xwayland \
+  --socket "$SOCKET" \
+  --workspaces 3 \
+  --trace all \
+  --trace-text focus,stack \
+  >"$LOG" 2>&1 &
+FBW_PID=$!
+
+timeout 5 bash -c "until rg -q 'Running fluxbox-wayland' '$LOG'; do sleep 0.05; done"
+timeout 5 bash -c "until rg -q 'IPC: listening' '$LOG'; do sleep 0.05; done"
+
+# Workspace events are recorded in the ring but kept out of the text log.
+./fbwl-remote --socket "$SOCKET" workspace 2 | rg -q '^ok workspace=2$'
+if rg -q 'Workspace: apply current=2' "$LOG"; then
+  echo "workspace trace leaked into the text log with --trace-text focus,stack" >&2
+  exit 1
+fi
+
+./fbwl-remote --socket "$SOCKET" trace-dump "$DUMP" | rg -q "^ok events=[1-9][0-9]* path=$DUMP\$"
+rg -q '^[0-9]+\.[0-9]{6} workspace Workspace: apply current=2 reason=ipc head=[0-9]+ heads=[0-9]+$' "$DUMP"
+rg -q "Trace: dumped [0-9]+ events to $DUMP" "$LOG"
+
+# The text sink can be switched back at runtime for log-scraping tests.
+./fbwl-remote --socket "$SOCKET" trace-text workspace | rg -q '^ok$'
+./fbwl-remote --socket "$SOCKET" workspace 3 | rg -q '^ok workspace=3$'
+timeout 5 bash -c "until rg -q 'Workspace: apply current=3 reason=ipc' '$LOG'; do sleep 0.05; done"
+
+set +e
+OUT="$(./fbwl-remote --socket "$SOCKET" trace-text nope 2>&1)"
+RC=$?
+set -e
+if ((RC == 0)) || ! echo "$OUT" | rg -q '^err invalid_trace_categories$'; then
+  echo "expected err invalid_trace_categories, got: $OUT" >&2
+  exit 1
+fi
+
+./fbwl-remote --socket "$SOCKET" quit | rg -q '^ok quitting$'
+timeout 5 bash -c "while kill -0 '$FBW_PID' 2>/dev/null; do sleep 0.05; done"
+wait "$FBW_PID"
+unset FBW_PID
+
+echo "ok: trace smoke passed (socket=$SOCKET log=$LOG)"
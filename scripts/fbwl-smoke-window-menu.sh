@@ -244,7 +244,9 @@ tail -c +$((OFFSET + 1)) "$LOG" | rg -q 'Menu: enter-submenu reason=activate'
 
 OFFSET=$(wc -c <"$LOG" | tr -d ' ')
 click_menu_item 0
-tail -c +$((OFFSET + 1)) "$LOG" | rg -q 'Remember: wrote '
+tail -c +$((OFFSET + 1)) "$LOG" | rg -q 'Remember: updated rule='
+# The write is deferred until the Remember edits go quiet.
+timeout 5 bash -c "until tail -c +$((OFFSET + 1)) '$LOG' | rg -q 'Remember: wrote '; do sleep 0.05; done"
 timeout 5 bash -c "until [[ -f '$APPS_PATH' ]]; do sleep 0.05; done"
 rg -q '\[Workspace\] \{1\}' "$APPS_PATH"
 
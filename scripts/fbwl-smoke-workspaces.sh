@@ -68,6 +68,15 @@ tail -c +$((OFFSET + 1)) "$LOG" | rg -q "Workspace: view=$OTHER_VIEW ws=1 visibl
 tail -c +$((OFFSET + 1)) "$LOG" | rg -q "Workspace: view=$FOCUSED_VIEW ws=2 visible=1"
 tail -c +$((OFFSET + 1)) "$LOG" | rg -q "Focus: $FOCUSED_VIEW"
 
+# A plain switch patches the toolbar in place: the workspace name, plus one
+# iconbar entry dropped and one added.
+tail -c +$((OFFSET + 1)) "$LOG" | rg -q 'Toolbar: workspacename label=.*2$'
+tail -c +$((OFFSET + 1)) "$LOG" | rg -q 'Toolbar: iconbar updated count=1 kept=0 added=1 removed=1$'
+if tail -c +$((OFFSET + 1)) "$LOG" | rg -q 'Toolbar: built '; then
+  echo "expected no full toolbar rebuild on a workspace switch" >&2
+  exit 1
+fi
+
 OFFSET=$(wc -c <"$LOG" | tr -d ' ')
 ./fbwl-input-injector --socket "$SOCKET" key alt-1
 tail -c +$((OFFSET + 1)) "$LOG" | rg -q 'Policy: workspace switch( head=[0-9]+)? to 1'
@@ -75,5 +84,11 @@ tail -c +$((OFFSET + 1)) "$LOG" | rg -q 'Workspace: apply current=1 reason=switc
 tail -c +$((OFFSET + 1)) "$LOG" | rg -q "Workspace: view=$OTHER_VIEW ws=1 visible=1"
 tail -c +$((OFFSET + 1)) "$LOG" | rg -q "Workspace: view=$FOCUSED_VIEW ws=2 visible=0"
 tail -c +$((OFFSET + 1)) "$LOG" | rg -q "Focus: $OTHER_VIEW"
+tail -c +$((OFFSET + 1)) "$LOG" | rg -q 'Toolbar: workspacename label=.*1$'
+tail -c +$((OFFSET + 1)) "$LOG" | rg -q 'Toolbar: iconbar updated count=1 kept=0 added=1 removed=1$'
+if tail -c +$((OFFSET + 1)) "$LOG" | rg -q 'Toolbar: built '; then
+  echo "expected no full toolbar rebuild on a workspace switch" >&2
+  exit 1
+fi
 
 echo "ok: workspaces smoke passed (socket=$SOCKET log=$LOG)"
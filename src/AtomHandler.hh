@@ -53,6 +53,7 @@ public:
     virtual void updateHints(FluxboxWindow &win) = 0;
     virtual void updateLayer(FluxboxWindow &win) = 0;
     virtual void updateFrameExtents(FluxboxWindow &win) { }
+    virtual void updateStacking(BScreen &screen) { }
     virtual bool checkClientMessage(const XClientMessageEvent &ce,
                                     BScreen * screen, WinClient * const winclient) = 0;
 
@@ -60,6 +61,9 @@ public:
 
     virtual void reconfigure() {}
 
+    /// called once the event queue is drained, to publish deferred updates
+    virtual void flush() {}
+
     /// should this object be updated or not?
     bool update() const { return m_update; }
 
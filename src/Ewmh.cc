@@ -36,6 +36,7 @@
 #include "FbTk/I18n.hh"
 #include "FbTk/LayerItem.hh"
 #include "FbTk/Layer.hh"
+#include "FbTk/MultLayers.hh"
 #include "FbTk/FbPixmap.hh"
 
 #include <X11/Xproto.h>
@@ -43,7 +44,6 @@
 
 #include <iostream>
 #include <algorithm>
-#include <new>
 #include <cstring>
 #include <cstdlib>
 
@@ -51,15 +51,6 @@
 using std::cerr;
 using std::endl;
 using std::vector;
-using std::list;
-
-// mipspro has no new(nothrow)
-#if defined sgi && ! defined GCC
-#define FB_new_nothrow new
-#else
-#define FB_new_nothrow new(std::nothrow)
-#endif
-
 
 namespace {
 
@@ -606,19 +597,34 @@ void Ewmh::initForScreen(BScreen &screen) {
                                        (unsigned char *) &atomsupported,
                                        (sizeof atomsupported)/sizeof atomsupported[0]);
 
-    // update atoms
+    // windows managed by initWindows() were set up before we got here,
+    // so seed the cached client list from the authoritative one
+    ScreenState &state = m_screens[&screen];
+    const FocusableList::Focusables &creation_order =
+            screen.focusControl().creationOrderList().clientList();
+    state.client_list.clear();
+    state.client_list.reserve(creation_order.size());
+    FocusableList::Focusables::const_iterator client_it = creation_order.begin();
+    FocusableList::Focusables::const_iterator client_it_end = creation_order.end();
+    for (; client_it != client_it_end; ++client_it) {
+        WinClient *client = dynamic_cast<WinClient *>(*client_it);
+        if (client)
+            state.client_list.push_back(client->window());
+    }
 
-    updateWorkspaceCount(screen);
-    updateCurrentWorkspace(screen);
-    updateWorkspaceNames(screen);
-    updateClientList(screen);
-    updateViewPort(screen);
-    updateGeometry(screen);
-    updateWorkarea(screen);
+    // update atoms
+    markScreen(screen, DIRTY_WORKSPACE_COUNT | DIRTY_CURRENT_WORKSPACE |
+               DIRTY_WORKSPACE_NAMES | DIRTY_CLIENT_LIST | DIRTY_STACKING |
+               DIRTY_VIEWPORT | DIRTY_GEOMETRY | DIRTY_WORKAREA);
 
 }
 
 void Ewmh::setupClient(WinClient &winclient) {
+    ScreenState &state = m_screens[&winclient.screen()];
+    if (std::find(state.client_list.begin(), state.client_list.end(),
+                  winclient.window()) == state.client_list.end())
+        state.client_list.push_back(winclient.window());
+
     updateStrut(winclient);
 
     FbTk::FbString newtitle = winclient.textProperty(m_net->wm_name);
@@ -714,6 +720,11 @@ void Ewmh::updateFrameClose(FluxboxWindow &win) {
 }
 
 void Ewmh::updateFocusedWindow(BScreen &screen, Window win) {
+    m_screens[&screen].active_window = win;
+    markScreen(screen, DIRTY_ACTIVE_WINDOW);
+}
+
+void Ewmh::publishActiveWindow(BScreen &screen, Window win) {
     /* From Extended Window Manager Hints, draft 1.3:
      *
      * _NET_ACTIVE_WINDOW, WINDOW/32
@@ -733,6 +744,16 @@ void Ewmh::updateFocusedWindow(BScreen &screen, Window win) {
 // The Window Manager should remove the property whenever a window is withdrawn
 // but it should leave the property in place when it is shutting down
 void Ewmh::updateClientClose(WinClient &winclient){
+    // whatever was pending for this client is moot now
+    m_dirty_clients.erase(winclient.window());
+
+    ScreenState &state = m_screens[&winclient.screen()];
+    std::vector<Window>::iterator it = std::find(state.client_list.begin(),
+                                                 state.client_list.end(),
+                                                 winclient.window());
+    if (it != state.client_list.end())
+        state.client_list.erase(it);
+
     if (!winclient.screen().isShuttingdown()) {
         XDeleteProperty(FbTk::App::instance()->display(), winclient.window(),
                         m_net->wm_state);
@@ -746,26 +767,18 @@ void Ewmh::updateClientList(BScreen &screen) {
     if (screen.isShuttingdown())
         return;
 
-    list<Focusable *> creation_order_list =
-            screen.focusControl().creationOrderList().clientList();
+    markScreen(screen, DIRTY_CLIENT_LIST | DIRTY_STACKING);
+}
+
+void Ewmh::updateStacking(BScreen &screen) {
 
-    size_t num = creation_order_list.size();
-    Window *wl = FB_new_nothrow Window[num];
-    if (wl == 0) {
-        _FB_USES_NLS;
-        cerr<<_FB_CONSOLETEXT(Ewmh, OutOfMemoryClientList,
-                      "Fatal: Out of memory, can't allocate for EWMH client list", "")<<endl;
+    if (screen.isShuttingdown())
         return;
-    }
 
-    int win=0;
-    list<Focusable *>::iterator client_it = creation_order_list.begin();
-    list<Focusable *>::iterator client_it_end = creation_order_list.end();
-    for (; client_it != client_it_end; ++client_it) {
-        WinClient *client = dynamic_cast<WinClient *>(*client_it);
-        if (client)
-            wl[win++] = client->window();
-    }
+    markScreen(screen, DIRTY_STACKING);
+}
+
+void Ewmh::publishClientList(BScreen &screen, ScreenState &state) {
 
     /*  From Extended Window Manager Hints, draft 1.3:
      *
@@ -780,17 +793,79 @@ void Ewmh::updateClientList(BScreen &screen) {
      * SHOULD be set and updated by the Window
      * Manager.
      */
+    const std::vector<Window> &wl = state.client_list;
     screen.rootWindow().changeProperty(m_net->client_list,
                                        XA_WINDOW, 32,
-                                       PropModeReplace, (unsigned char *)wl, num);
+                                       PropModeReplace,
+                                       (unsigned char *)(wl.empty() ? 0 : &wl[0]),
+                                       wl.size());
+}
+
+void Ewmh::publishStacking(BScreen &screen, ScreenState &state) {
+
+    std::vector<Window> &stacking = state.stacking;
+    stacking.clear();
+    stacking.reserve(state.client_list.size());
+
+    Fluxbox *fluxbox = Fluxbox::instance();
+    FbTk::MultLayers &layers = screen.layerManager();
+
+    // the layer manager keeps layer 0 and the front of each item list on
+    // top, so walk both backwards to get bottom-to-top order
+    for (int l = layers.size() - 1; l >= 0; --l) {
+        const FbTk::Layer::ItemList &items = layers.getLayer(l)->itemList();
+        FbTk::Layer::ItemList::const_reverse_iterator item_it = items.rbegin();
+        FbTk::Layer::ItemList::const_reverse_iterator item_it_end = items.rend();
+        for (; item_it != item_it_end; ++item_it) {
+            FbTk::LayerItem::Windows &frames = (*item_it)->getWindows();
+            if (frames.empty())
+                continue;
+
+            // the group search gives us the active client of a frame
+            WinClient *active = fluxbox->searchWindow(frames.front()->window());
+            if (active == 0 || active->fbwindow() == 0 ||
+                &active->screen() != &screen)
+                continue;
+
+            // inactive tabs sit below the active one
+            FluxboxWindow::ClientList &clients = active->fbwindow()->clientList();
+            FluxboxWindow::ClientList::iterator it = clients.begin();
+            FluxboxWindow::ClientList::iterator it_end = clients.end();
+            for (; it != it_end; ++it) {
+                if (*it != active)
+                    stacking.push_back((*it)->window());
+            }
+            stacking.push_back(active->window());
+        }
+    }
+
+    // anything not on a layer (should not happen) goes to the bottom,
+    // _NET_CLIENT_LIST_STACKING must list the same windows as _NET_CLIENT_LIST
+    if (stacking.size() != state.client_list.size()) {
+        std::vector<Window> sorted(stacking);
+        std::sort(sorted.begin(), sorted.end());
+        std::vector<Window> missing;
+        std::vector<Window>::const_iterator it = state.client_list.begin();
+        std::vector<Window>::const_iterator it_end = state.client_list.end();
+        for (; it != it_end; ++it) {
+            if (!std::binary_search(sorted.begin(), sorted.end(), *it))
+                missing.push_back(*it);
+        }
+        stacking.insert(stacking.begin(), missing.begin(), missing.end());
+    }
+
     screen.rootWindow().changeProperty(m_net->client_list_stacking,
                                        XA_WINDOW, 32,
-                                       PropModeReplace, (unsigned char *)wl, num);
-
-    delete [] wl;
+                                       PropModeReplace,
+                                       (unsigned char *)(stacking.empty() ? 0 : &stacking[0]),
+                                       stacking.size());
 }
 
 void Ewmh::updateWorkspaceNames(BScreen &screen) {
+    markScreen(screen, DIRTY_WORKSPACE_NAMES);
+}
+
+void Ewmh::publishWorkspaceNames(BScreen &screen) {
     /* From Extended Window Manager Hints, draft 1.3:
      *
      * _NET_DESKTOP_NAMES, UTF8_STRING[]
@@ -856,6 +931,10 @@ void Ewmh::updateWorkspaceNames(BScreen &screen) {
 }
 
 void Ewmh::updateCurrentWorkspace(BScreen &screen) {
+    markScreen(screen, DIRTY_CURRENT_WORKSPACE);
+}
+
+void Ewmh::publishCurrentWorkspace(BScreen &screen) {
     /* From Extended Window Manager Hints, draft 1.3:
      *
      * _NET_CURRENT_DESKTOP desktop, CARDINAL/32
@@ -874,6 +953,10 @@ void Ewmh::updateCurrentWorkspace(BScreen &screen) {
 }
 
 void Ewmh::updateWorkspaceCount(BScreen &screen) {
+    markScreen(screen, DIRTY_WORKSPACE_COUNT);
+}
+
+void Ewmh::publishWorkspaceCount(BScreen &screen) {
     /* From Extended Window Manager Hints, draft 1.3:
      *
      * _NET_NUMBER_OF_DESKTOPS, CARDINAL/32
@@ -890,6 +973,10 @@ void Ewmh::updateWorkspaceCount(BScreen &screen) {
 }
 
 void Ewmh::updateViewPort(BScreen &screen) {
+    markScreen(screen, DIRTY_VIEWPORT);
+}
+
+void Ewmh::publishViewPort(BScreen &screen) {
     /* From Extended Window Manager Hints, draft 1.3:
      *
      * _NET_DESKTOP_VIEWPORT x, y, CARDINAL[][2]/32
@@ -908,6 +995,10 @@ void Ewmh::updateViewPort(BScreen &screen) {
 }
 
 void Ewmh::updateGeometry(BScreen &screen) {
+    markScreen(screen, DIRTY_GEOMETRY);
+}
+
+void Ewmh::publishGeometry(BScreen &screen) {
     /* From Extended Window Manager Hints, draft 1.3:
      *
      * _NET_DESKTOP_GEOMETRY width, height, CARDINAL[2]/32
@@ -929,6 +1020,10 @@ void Ewmh::updateGeometry(BScreen &screen) {
 }
 
 void Ewmh::updateWorkarea(BScreen &screen) {
+    markScreen(screen, DIRTY_WORKAREA);
+}
+
+void Ewmh::publishWorkarea(BScreen &screen) {
     /* From Extended Window Manager Hints, draft 1.3:
      *
      * _NET_WORKAREA, x, y, width, height CARDINAL[][4]/32
@@ -967,7 +1062,10 @@ void Ewmh::updateWorkarea(BScreen &screen) {
 }
 
 void Ewmh::updateState(FluxboxWindow &win) {
+    markWindow(win, DIRTY_STATE);
+}
 
+void Ewmh::publishState(FluxboxWindow &win) {
 
     updateActions(win);
 
@@ -1036,12 +1134,17 @@ void Ewmh::updateState(FluxboxWindow &win) {
 
 void Ewmh::updateLayer(FluxboxWindow &win) {
     updateState(win);
+    updateStacking(win.screen());
 }
 
 void Ewmh::updateHints(FluxboxWindow &win) {
 }
 
 void Ewmh::updateWorkspace(FluxboxWindow &win) {
+    markWindow(win, DIRTY_DESKTOP);
+}
+
+void Ewmh::publishWorkspace(FluxboxWindow &win) {
     long workspace = win.workspaceNumber();
 
     if (win.isStuck())
@@ -1516,6 +1619,10 @@ void Ewmh::setupState(FluxboxWindow &win) {
 }
 
 void Ewmh::updateFrameExtents(FluxboxWindow &win) {
+    markWindow(win, DIRTY_FRAME_EXTENTS);
+}
+
+void Ewmh::publishFrameExtents(FluxboxWindow &win) {
     /* Frame extents are basically the amount the window manager frame
        protrudes from the client window, on left, right, top, bottom
        (it is independent of window position).
@@ -1538,3 +1645,80 @@ void Ewmh::updateFrameExtents(FluxboxWindow &win) {
     }
 }
 
+void Ewmh::markScreen(BScreen &screen, unsigned int what) {
+    m_screens[&screen].dirty |= what;
+}
+
+void Ewmh::markWindow(FluxboxWindow &win, unsigned int what) {
+    FluxboxWindow::ClientList::iterator it = win.clientList().begin();
+    FluxboxWindow::ClientList::iterator it_end = win.clientList().end();
+    for (; it != it_end; ++it)
+        m_dirty_clients[(*it)->window()] |= what;
+}
+
+void Ewmh::flush() {
+
+    if (!m_dirty_clients.empty()) {
+        // several tabs of one frame share the frame's state, so collapse
+        // the dirty clients into their frames and publish each frame once
+        typedef std::map<FluxboxWindow *, unsigned int> DirtyWindows;
+        DirtyWindows windows;
+
+        Fluxbox *fluxbox = Fluxbox::instance();
+        DirtyClients::iterator it = m_dirty_clients.begin();
+        DirtyClients::iterator it_end = m_dirty_clients.end();
+        for (; it != it_end; ++it) {
+            WinClient *client = fluxbox->searchWindow(it->first);
+            if (client && client->fbwindow())
+                windows[client->fbwindow()] |= it->second;
+        }
+        m_dirty_clients.clear();
+
+        DirtyWindows::iterator win_it = windows.begin();
+        DirtyWindows::iterator win_it_end = windows.end();
+        for (; win_it != win_it_end; ++win_it) {
+            FluxboxWindow &win = *win_it->first;
+            if (win_it->second & DIRTY_STATE)
+                publishState(win);
+            if (win_it->second & DIRTY_DESKTOP)
+                publishWorkspace(win);
+            if (win_it->second & DIRTY_FRAME_EXTENTS)
+                publishFrameExtents(win);
+        }
+    }
+
+    ScreenStates::iterator it = m_screens.begin();
+    ScreenStates::iterator it_end = m_screens.end();
+    for (; it != it_end; ++it) {
+        if (it->second.dirty != 0)
+            publishScreen(*it->first, it->second);
+    }
+}
+
+void Ewmh::publishScreen(BScreen &screen, ScreenState &state) {
+
+    unsigned int dirty = state.dirty;
+    state.dirty = 0;
+
+    if (screen.isShuttingdown())
+        return;
+
+    if (dirty & DIRTY_WORKSPACE_COUNT)
+        publishWorkspaceCount(screen);
+    if (dirty & DIRTY_CURRENT_WORKSPACE)
+        publishCurrentWorkspace(screen);
+    if (dirty & DIRTY_WORKSPACE_NAMES)
+        publishWorkspaceNames(screen);
+    if (dirty & DIRTY_CLIENT_LIST)
+        publishClientList(screen, state);
+    if (dirty & DIRTY_STACKING)
+        publishStacking(screen, state);
+    if (dirty & DIRTY_ACTIVE_WINDOW)
+        publishActiveWindow(screen, state.active_window);
+    if (dirty & DIRTY_VIEWPORT)
+        publishViewPort(screen);
+    if (dirty & DIRTY_GEOMETRY)
+        publishGeometry(screen);
+    if (dirty & DIRTY_WORKAREA)
+        publishWorkarea(screen);
+}
@@ -22,6 +22,9 @@
 #include "AtomHandler.hh"
 #include "FbTk/FbString.hh"
 
+#include <map>
+#include <vector>
+
 /// Implementes Extended Window Manager Hints ( http://www.freedesktop.org/Standards/wm-spec )
 class Ewmh:public AtomHandler {
 public:
@@ -56,8 +59,64 @@ public:
     void updateClientClose(WinClient &winclient);
 
     void updateFrameExtents(FluxboxWindow &win);
+    void updateStacking(BScreen &screen);
+
+    /// publish all property changes collected since the last flush
+    void flush();
 private:
 
+    /// root properties waiting for the next flush
+    enum {
+        DIRTY_CLIENT_LIST       = 1 << 0,
+        DIRTY_STACKING          = 1 << 1,
+        DIRTY_ACTIVE_WINDOW     = 1 << 2,
+        DIRTY_WORKSPACE_NAMES   = 1 << 3,
+        DIRTY_CURRENT_WORKSPACE = 1 << 4,
+        DIRTY_WORKSPACE_COUNT   = 1 << 5,
+        DIRTY_VIEWPORT          = 1 << 6,
+        DIRTY_GEOMETRY          = 1 << 7,
+        DIRTY_WORKAREA          = 1 << 8
+    };
+
+    /// client properties waiting for the next flush
+    enum {
+        DIRTY_STATE         = 1 << 0,
+        DIRTY_DESKTOP       = 1 << 1,
+        DIRTY_FRAME_EXTENTS = 1 << 2
+    };
+
+    struct ScreenState {
+        ScreenState(): dirty(0), active_window(None) { }
+
+        unsigned int dirty;
+        Window active_window;
+        /// _NET_CLIENT_LIST in creation order, maintained incrementally
+        std::vector<Window> client_list;
+        /// scratch buffer reused for _NET_CLIENT_LIST_STACKING
+        std::vector<Window> stacking;
+    };
+
+    typedef std::map<BScreen *, ScreenState> ScreenStates;
+    /// keyed by client window, so a dying frame never leaves a dangling entry
+    typedef std::map<Window, unsigned int> DirtyClients;
+
+    void markScreen(BScreen &screen, unsigned int what);
+    void markWindow(FluxboxWindow &win, unsigned int what);
+
+    void publishScreen(BScreen &screen, ScreenState &state);
+    void publishClientList(BScreen &screen, ScreenState &state);
+    void publishStacking(BScreen &screen, ScreenState &state);
+    void publishActiveWindow(BScreen &screen, Window win);
+    void publishWorkspaceNames(BScreen &screen);
+    void publishCurrentWorkspace(BScreen &screen);
+    void publishWorkspaceCount(BScreen &screen);
+    void publishViewPort(BScreen &screen);
+    void publishGeometry(BScreen &screen);
+    void publishWorkarea(BScreen &screen);
+    void publishState(FluxboxWindow &win);
+    void publishWorkspace(FluxboxWindow &win);
+    void publishFrameExtents(FluxboxWindow &win);
+
     enum { STATE_REMOVE = 0, STATE_ADD = 1, STATE_TOGGLE = 2};
 
     void setState(FluxboxWindow &win, Atom state, bool value);
@@ -74,4 +133,7 @@ private:
 
     class EwmhAtoms;
     EwmhAtoms* m_net;
+
+    ScreenStates m_screens;
+    DirtyClients m_dirty_clients;
 };
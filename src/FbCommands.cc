@@ -31,6 +31,7 @@
 #include "MenuCreator.hh"
 
 #include "FbTk/Theme.hh"
+#include "FbTk/ImageControl.hh"
 #include "FbTk/Menu.hh"
 #include "FbTk/CommandParser.hh"
 #include "FbTk/StringUtil.hh"
@@ -91,6 +92,22 @@ void showMenu(BScreen &screen, FbTk::Menu &menu) {
     screen.placementStrategy().placeAndShowMenu(menu, x, y, mouseInStrut);
 }
 
+// write the outcome of a command to _FLUXBOX_ACTION_RESULT, where
+// 'fluxbox-remote result' picks it up
+void setActionResult(const std::string &result) {
+
+    Display *dpy = Fluxbox::instance()->display();
+    Atom atom_utf8 = XInternAtom(dpy, "UTF8_STRING", False);
+    Atom atom_fbcmd_result = XInternAtom(dpy, "_FLUXBOX_ACTION_RESULT", False);
+
+    const Fluxbox::ScreenList screens(Fluxbox::instance()->screenList());
+    Fluxbox::ScreenList::const_iterator screen = screens.begin();
+    for (; screen != screens.end(); ++screen) {
+        (*screen)->rootWindow().changeProperty(atom_fbcmd_result, atom_utf8, 8,
+            PropModeReplace, (unsigned char*)result.c_str(), result.size());
+    }
+}
+
 }
 
 namespace FbCommands {
@@ -545,16 +562,9 @@ void ClientPatternTestCmd::execute() {
     std::string                         result;
     std::string                         pat;
     int                                 opts;
-    Display*                            dpy;
-    Atom                                atom_utf8;
-    Atom                                atom_fbcmd_result;
     Fluxbox::ScreenList::const_iterator screen;
     const Fluxbox::ScreenList           screens(Fluxbox::instance()->screenList());
 
-    dpy = Fluxbox::instance()->display();
-    atom_utf8 = XInternAtom(dpy, "UTF8_STRING", False);
-    atom_fbcmd_result = XInternAtom(dpy, "_FLUXBOX_ACTION_RESULT", False);
-
     FocusableList::parseArgs(m_args, opts, pat);
     ClientPattern cp(pat.c_str());
 
@@ -597,11 +607,38 @@ void ClientPatternTestCmd::execute() {
     }
 
 
-    // write result to _FLUXBOX_ACTION_RESULT property
-    for (screen = screens.begin(); screen != screens.end(); screen++) {
-        (*screen)->rootWindow().changeProperty(atom_fbcmd_result, atom_utf8, 8,
-            PropModeReplace, (unsigned char*)result.c_str(), result.size());
+    setActionResult(result);
+}
+
+REGISTER_COMMAND(imagecachestats, FbCommands::ImageCacheStatsCmd, void);
+
+void ImageCacheStatsCmd::execute() {
+
+    std::string result;
+    const Fluxbox::ScreenList screens(Fluxbox::instance()->screenList());
+    Fluxbox::ScreenList::const_iterator screen = screens.begin();
+    for (; screen != screens.end(); ++screen) {
+        FbTk::ImageControl::CacheStats stats = (*screen)->imageControl().cacheStats();
+        result += "screen ";
+        result += FbTk::StringUtil::number2String((*screen)->screenNumber());
+        result += ": entries=";
+        result += FbTk::StringUtil::number2String(stats.entries);
+        result += " idle=";
+        result += FbTk::StringUtil::number2String(stats.idle);
+        result += " bytes=";
+        result += FbTk::StringUtil::number2String(stats.bytes);
+        result += " max_bytes=";
+        result += FbTk::StringUtil::number2String(stats.max_bytes);
+        result += " hits=";
+        result += FbTk::StringUtil::number2String(stats.hits);
+        result += " misses=";
+        result += FbTk::StringUtil::number2String(stats.misses);
+        result += " evictions=";
+        result += FbTk::StringUtil::number2String(stats.evictions);
+        result += "\n";
     }
+
+    setActionResult(result);
 }
 
 
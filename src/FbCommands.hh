@@ -228,6 +228,12 @@ private:
     std::string m_args;
 };
 
+/// report pixmap cache counters of all screens
+class ImageCacheStatsCmd: public FbTk::Command<void> {
+public:
+    void execute();
+};
+
 } // end namespace FbCommands
 
 #endif // FBCOMMANDS_HH
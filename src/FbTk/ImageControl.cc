@@ -49,7 +49,6 @@
 
 using std::cerr;
 using std::endl;
-using std::list;
 
 namespace FbTk {
 
@@ -157,17 +156,36 @@ void allocateUnallocatedColors(std::vector<XColor> colors, Display* dpy, Colorma
 } // end anonymous namespace
 
 struct ImageControl::Cache {
+    CacheKey key;
     Pixmap pixmap;
-    Pixmap texture_pixmap;
-    Orientation orient;
-    unsigned int count, width, height;
-    unsigned long pixel1, pixel2, texture;
+    unsigned int count; ///< number of users, idle when 0
+    size_t bytes;
+    Cache *idle_prev, *idle_next;
 };
 
+size_t ImageControl::CacheKeyHash::operator()(const CacheKey &key) const {
+    // FNV-1a over the fields, good enough to spread sizes and colors
+    unsigned long fields[] = {
+        key.texture_pixmap, key.texture, key.pixel1, key.pixel2,
+        key.width, key.height, static_cast<unsigned long>(key.orient)
+    };
+    size_t h = 2166136261u;
+    for (size_t i = 0; i < sizeof(fields)/sizeof(fields[0]); ++i) {
+        h ^= fields[i];
+        h *= 16777619u;
+    }
+    return h;
+}
+
 ImageControl::ImageControl(int screen_num,
                            int cpc, unsigned long cache_timeout, unsigned long cmax):
     m_colors_per_channel(cpc),
-    m_screen_num(screen_num) {
+    m_screen_num(screen_num),
+    m_idle_head(0), m_idle_tail(0),
+    m_idle_count(0),
+    m_cache_bytes(0), m_idle_bytes(0),
+    m_cache_max_bytes(cmax * 1024),
+    m_cache_hits(0), m_cache_misses(0), m_cache_evictions(0) {
 
     Display *disp = FbTk::App::instance()->display();
 
@@ -175,8 +193,6 @@ ImageControl::ImageControl(int screen_num,
     m_visual = DefaultVisual(disp, screen_num);
     m_colormap = DefaultColormap(disp, screen_num);
 
-    cache_max = cmax;
-
     if (cache_timeout && s_timed_cache) {
         m_timer.setTimeout(cache_timeout * FbTk::FbTime::IN_MILLISECONDS);
         RefCount<Command<void> > clean_cache(new SimpleCommand<ImageControl>(*this, &ImageControl::cleanCache));
@@ -201,68 +217,50 @@ ImageControl::~ImageControl() {
         XFreeColors(disp, m_colormap, &pixels[0], pixels.size(), 0);
     }
 
-    if (!cache.empty()) {
-        CacheList::iterator it = cache.begin();
-        CacheList::iterator it_end = cache.end();
-        for (; it != it_end; ++it) {
-            XFreePixmap(disp, (*it)->pixmap);
-            delete (*it);
-        }
+    CacheMap::iterator it = m_cache.begin();
+    CacheMap::iterator it_end = m_cache.end();
+    for (; it != it_end; ++it) {
+        XFreePixmap(disp, it->second->pixmap);
+        delete it->second;
     }
 }
 
 
-Pixmap ImageControl::searchCache(unsigned int width, unsigned int height,
-                                 const Texture &text, FbTk::Orientation orient) const {
-
-    if (text.pixmap().drawable() != None) {
-        // do comparsion with width/height and texture_pixmap
-        CacheList::iterator it = cache.begin();
-        CacheList::iterator it_end = cache.end();
-        for (; it != it_end; ++it) {
-            if ((*it)->texture_pixmap == text.pixmap().drawable() &&
-                (*it)->orient == orient &&
-                (*it)->width == width &&
-                (*it)->height == height &&
-                (*it)->texture == text.type()) {
-                (*it)->count++;
-                return (*it)->pixmap;
-            }
-        }
-        return None;
+ImageControl::CacheKey ImageControl::makeKey(unsigned int width, unsigned int height,
+                                             const Texture &text, Orientation orient) {
+    CacheKey key;
+    key.texture_pixmap = text.pixmap().drawable();
+    key.texture = text.type();
+    key.width = width;
+    key.height = height;
+    key.orient = orient;
+
+    // pixmap textures are identified by their pixmap alone,
+    // and only gradients care about the second color
+    if (key.texture_pixmap != None) {
+        key.pixel1 = key.pixel2 = 0;
+    } else {
+        key.pixel1 = text.color().pixel();
+        key.pixel2 = (text.type() & FbTk::Texture::GRADIENT) ?
+            text.colorTo().pixel() : 0;
     }
+    return key;
+}
 
-    /*    Cache tmp;
-    tmp.texture_pixmap = text.pixmap().drawable();
-    tmp.width = width;
-    tmp.height = height;
-    tmp.texture = text.type();
-    tmp.pixel1 = text.color().pixel();
-    tmp.pixel2 = text.colorTo().pixel();
-    */
-
-    CacheList::iterator it = cache.begin();
-    CacheList::iterator it_end = cache.end();
-    for (; it != it_end; ++it) {
-        if (((*it)->width == width) &&
-            ((*it)->orient == orient) &&
-            ((*it)->height == height) &&
-            ((*it)->texture == text.type()) &&
-            ((*it)->pixel1 == text.color().pixel())) {
-            if (text.type() & FbTk::Texture::GRADIENT) {
-                if ((*it)->pixel2 == text.colorTo().pixel()) {
-                    (*it)->count++;
-                    return (*it)->pixmap;
-                }
-            } else {
-                (*it)->count++;
-                return (*it)->pixmap;
-            }
-        }
+Pixmap ImageControl::searchCache(const CacheKey &key) {
+
+    CacheMap::iterator it = m_cache.find(key);
+    if (it == m_cache.end()) {
+        ++m_cache_misses;
+        return None;
     }
 
-    return None;
+    Cache *entry = it->second;
+    if (entry->count++ == 0)
+        unlinkIdle(entry);
 
+    ++m_cache_hits;
+    return entry->pixmap;
 }
 
 
@@ -281,7 +279,8 @@ Pixmap ImageControl::renderImage(unsigned int width, unsigned int height,
     }
 
     // search cache first
-    Pixmap pixmap = searchCache(width, height, texture, orient);
+    CacheKey key = makeKey(width, height, texture, orient);
+    Pixmap pixmap = searchCache(key);
     if (pixmap) {
         return pixmap; // return cache item
     }
@@ -292,28 +291,19 @@ Pixmap ImageControl::renderImage(unsigned int width, unsigned int height,
     pixmap = image.render(texture);
 
     if (pixmap) {
-        // create new cache item and add it to cache list
+        // create new cache item and add it to cache
 
         Cache *tmp = new Cache;
 
+        tmp->key = key;
         tmp->pixmap = pixmap;
-        tmp->texture_pixmap = texture.pixmap().drawable();
-        tmp->orient = orient;
-        tmp->width = width;
-        tmp->height = height;
         tmp->count = 1;
-        tmp->texture = texture.type();
-        tmp->pixel1 = texture.color().pixel();
-
-        if (texture.type() & FbTk::Texture::GRADIENT)
-            tmp->pixel2 = texture.colorTo().pixel();
-        else
-            tmp->pixel2 = 0l;
+        tmp->bytes = static_cast<size_t>(width) * height * ((bits_per_pixel + 7) / 8);
+        tmp->idle_prev = tmp->idle_next = 0;
 
-        cache.push_back(tmp);
-
-        if (cache.size() > cache_max)
-            cleanCache();
+        m_cache[key] = tmp;
+        m_cache_pixmaps[pixmap] = tmp;
+        m_cache_bytes += tmp->bytes;
 
         return pixmap;
     }
@@ -326,23 +316,82 @@ void ImageControl::removeImage(Pixmap pixmap) {
     if (!pixmap)
         return;
 
-    CacheList::iterator it = cache.begin();
-    CacheList::iterator it_end = cache.end();
-    for (; it != it_end; ++it) {
-        if ((*it)->pixmap == pixmap) {
-            if ((*it)->count) {
-                (*it)->count--;
-                if (s_timed_cache) {
-                    cleanCache();
-                    return;
-                }
-            }
+    PixmapMap::iterator it = m_cache_pixmaps.find(pixmap);
+    if (it == m_cache_pixmaps.end())
+        return;
+
+    Cache *entry = it->second;
+    if (entry->count == 0 || --entry->count > 0)
+        return;
 
-            if ((*it)->count <= 0)
-                cleanCache();
+    // the texture pixmap id may get recycled by the server once the
+    // theme drops it, so never hand out such an entry again
+    if (entry->key.texture_pixmap != None) {
+        freeCache(entry);
+        return;
+    }
 
-            return;
-        }
+    pushIdle(entry);
+    trimCache();
+}
+
+ImageControl::CacheStats ImageControl::cacheStats() const {
+    CacheStats stats;
+    stats.hits = m_cache_hits;
+    stats.misses = m_cache_misses;
+    stats.evictions = m_cache_evictions;
+    stats.entries = m_cache.size();
+    stats.idle = m_idle_count;
+    stats.bytes = m_cache_bytes;
+    stats.max_bytes = m_cache_max_bytes;
+    return stats;
+}
+
+void ImageControl::unlinkIdle(Cache *entry) {
+    if (entry->idle_prev)
+        entry->idle_prev->idle_next = entry->idle_next;
+    else
+        m_idle_head = entry->idle_next;
+
+    if (entry->idle_next)
+        entry->idle_next->idle_prev = entry->idle_prev;
+    else
+        m_idle_tail = entry->idle_prev;
+
+    entry->idle_prev = entry->idle_next = 0;
+    m_idle_bytes -= entry->bytes;
+    --m_idle_count;
+}
+
+void ImageControl::pushIdle(Cache *entry) {
+    entry->idle_prev = 0;
+    entry->idle_next = m_idle_head;
+    if (m_idle_head)
+        m_idle_head->idle_prev = entry;
+    else
+        m_idle_tail = entry;
+    m_idle_head = entry;
+
+    m_idle_bytes += entry->bytes;
+    ++m_idle_count;
+}
+
+void ImageControl::freeCache(Cache *entry) {
+    if (entry->count == 0)
+        unlinkIdle(entry);
+
+    m_cache.erase(entry->key);
+    m_cache_pixmaps.erase(entry->pixmap);
+    m_cache_bytes -= entry->bytes;
+
+    XFreePixmap(FbTk::App::instance()->display(), entry->pixmap);
+    delete entry;
+}
+
+void ImageControl::trimCache() {
+    while (m_idle_tail && m_idle_bytes > m_cache_max_bytes) {
+        freeCache(m_idle_tail);
+        ++m_cache_evictions;
     }
 }
 
@@ -409,26 +458,8 @@ void ImageControl::installRootColormap() {
 
 
 void ImageControl::cleanCache() {
-    Display *disp = FbTk::App::instance()->display();
-    list<CacheList::iterator> deadlist;
-    CacheList::iterator it = cache.begin();
-    CacheList::iterator it_end = cache.end();
-    for (; it != it_end; ++it) {
-        Cache *tmp = (*it);
-        if (tmp->count <= 0) {
-            XFreePixmap(disp, tmp->pixmap);
-            deadlist.push_back(it);
-            delete tmp;
-            tmp=0;
-        }
-    }
-
-    list<CacheList::iterator>::iterator dead_it = deadlist.begin();
-    list<CacheList::iterator>::iterator dead_it_end = deadlist.end();
-    for (; dead_it != dead_it_end; ++dead_it) {
-        cache.erase(*dead_it);
-    }
-
+    while (m_idle_tail)
+        freeCache(m_idle_tail);
 }
 
 void ImageControl::createColorTable() {
@@ -31,8 +31,9 @@
 
 #include <X11/Xlib.h> // for Visual* etc
 
-#include <list>
 #include <vector>
+#include <unordered_map>
+#include <cstddef>
 
 namespace FbTk {
 
@@ -41,6 +42,21 @@ class Texture;
 /// Holds screen info, color tables and caches textures
 class ImageControl: private NotCopyable {
 public:
+    /// counters describing the pixmap cache
+    struct CacheStats {
+        unsigned long hits;
+        unsigned long misses;
+        unsigned long evictions;
+        size_t entries;   ///< cached pixmaps, in use or not
+        size_t idle;      ///< cached pixmaps nobody holds right now
+        size_t bytes;     ///< estimated server memory of all cached pixmaps
+        size_t max_bytes; ///< budget for idle pixmaps
+    };
+
+    /**
+       @param cache_timeout milliseconds between flushes of unused pixmaps
+       @param cache_max size in kilobytes unused pixmaps may occupy
+    */
     ImageControl(int screen_num, int colors_per_channel = 4,
                   unsigned long cache_timeout = 300000l, unsigned long cache_max = 200l);
     virtual ~ImageControl();
@@ -73,13 +89,50 @@ public:
     void getGradientBuffers(unsigned int, unsigned int,
                             unsigned int **, unsigned int **);
 
+    /// free all cached pixmaps that are not in use
     void cleanCache();
+    CacheStats cacheStats() const;
 private:
-    /** 
+    struct Cache;
+
+    /// everything that makes two rendered textures identical
+    struct CacheKey {
+        Pixmap texture_pixmap;
+        unsigned long texture, pixel1, pixel2;
+        unsigned int width, height;
+        Orientation orient;
+
+        bool operator == (const CacheKey &other) const {
+            return texture_pixmap == other.texture_pixmap &&
+                texture == other.texture &&
+                pixel1 == other.pixel1 && pixel2 == other.pixel2 &&
+                width == other.width && height == other.height &&
+                orient == other.orient;
+        }
+    };
+
+    struct CacheKeyHash {
+        size_t operator()(const CacheKey &key) const;
+    };
+
+    typedef std::unordered_map<CacheKey, Cache *, CacheKeyHash> CacheMap;
+    typedef std::unordered_map<Pixmap, Cache *> PixmapMap;
+
+    static CacheKey makeKey(unsigned int width, unsigned int height,
+                            const Texture &text, Orientation orient);
+
+    /**
         Search cache for a specific pixmap
         @return None if no cache was found
     */
-    Pixmap searchCache(unsigned int width, unsigned int height, const Texture &text, Orientation orient) const;
+    Pixmap searchCache(const CacheKey &key);
+
+    /// remove an entry from the cache and free its pixmap
+    void freeCache(Cache *entry);
+    /// evict least recently released pixmaps until we are within budget
+    void trimCache();
+    void unlinkIdle(Cache *entry);
+    void pushIdle(Cache *entry);
 
     void createColorTable();
     Timer m_timer;
@@ -105,11 +158,14 @@ private:
     std::vector<unsigned int> grad_xbuffer;
     std::vector<unsigned int> grad_ybuffer;
 
-    struct Cache;
-    typedef std::list<Cache *> CacheList;
-
-    mutable CacheList cache;
-    unsigned long cache_max;
+    CacheMap m_cache;
+    PixmapMap m_cache_pixmaps; ///< reverse lookup for removeImage
+    /// unused entries, most recently released first
+    Cache *m_idle_head, *m_idle_tail;
+    size_t m_idle_count;
+    size_t m_cache_bytes, m_idle_bytes;
+    size_t m_cache_max_bytes;
+    unsigned long m_cache_hits, m_cache_misses, m_cache_evictions;
 };
 
 } // end namespace FbTk
@@ -689,6 +689,7 @@ void FluxboxWindow::raise() {
             // activate the client so the transient won't get pushed back down
             client->fbwindow()->setCurrentClient(*client, false);
         raiseFluxboxWindow(*client->fbwindow());
+        Fluxbox::instance()->updateStacking(screen());
     }
 
 }
@@ -705,8 +706,10 @@ void FluxboxWindow::lower() {
     // get root window
     WinClient *client = getRootTransientFor(m_client);
 
-    if (client->fbwindow())
+    if (client->fbwindow()) {
         lowerFluxboxWindow(*client->fbwindow());
+        Fluxbox::instance()->updateStacking(screen());
+    }
 }
 
 void FluxboxWindow::tempRaise() {
@@ -719,6 +722,7 @@ void FluxboxWindow::tempRaise() {
     // the root transient will get raised when we stop cycling
     // raising it here causes problems when it isn't the active tab
     tempRaiseFluxboxWindow(*this);
+    Fluxbox::instance()->updateStacking(screen());
 }
 
 
@@ -133,6 +133,12 @@ const char RC_INIT_FILE[] = "init";
 
 Window last_bad_window = None;
 
+// a client flooding the queue must not starve the EWMH properties forever,
+// so the deferred updates are also published after this many events or
+// this much time, whichever comes first
+const unsigned int ATOM_FLUSH_EVENTS = 256;
+const uint64_t ATOM_FLUSH_INTERVAL = 50 * FbTk::FbTime::IN_MILLISECONDS;
+
 // *** NOTE: if you want to debug here the X errors are
 //     coming from, you should turn on the XSynchronise call below
 int handleXErrors(Display *d, XErrorEvent *e) {
@@ -273,6 +279,8 @@ Fluxbox::Fluxbox(int argc, char **argv,
       m_argv(argv), m_argc(argc),
       m_showing_dialog(false),
       m_server_grabs(0),
+      m_events_since_flush(0),
+      m_last_flush(0),
       m_shortcut_manager(new ShortcutManager) {
 
     _FB_USES_NLS;
@@ -281,6 +289,8 @@ Fluxbox::Fluxbox(int argc, char **argv,
     m_state.shutdown = false;
     m_state.starting = true;
 
+    std::fill(m_compressed_events, m_compressed_events + LASTEvent, 0);
+
     if (s_singleton != 0)
         throw _FB_CONSOLETEXT(Fluxbox, FatalSingleton, "Fatal! There can only one instance of fluxbox class.", "Error displayed on weird error where an instance of the Fluxbox class already exists!");
 
@@ -530,6 +540,7 @@ void Fluxbox::eventLoop() {
         if (XPending(disp)) {
             XEvent e;
             XNextEvent(disp, &e);
+            compressEvent(e);
 
             if (last_bad_window != None && e.xany.window == last_bad_window &&
                 e.type != DestroyNotify) { // we must let the actual destroys through
@@ -541,12 +552,97 @@ void Fluxbox::eventLoop() {
                 last_bad_window = None;
                 handleEvent(&e);
             }
+
+            if (++m_events_since_flush >= ATOM_FLUSH_EVENTS ||
+                FbTk::FbTime::mono() - m_last_flush >= ATOM_FLUSH_INTERVAL)
+                flushAtomHandlers();
         } else {
+            // the queue is drained, so this is the last chance to coalesce
+            // property updates before we block waiting for more events
+            flushAtomHandlers();
             FbTk::Timer::updateTimers(ConnectionNumber(disp));
         }
     }
 }
 
+void Fluxbox::flushAtomHandlers() {
+    m_events_since_flush = 0;
+    m_last_flush = FbTk::FbTime::mono();
+    STLUtil::forAllIf(m_atomhandler, mem_fn(&AtomHandler::update),
+            mem_fn(&AtomHandler::flush));
+}
+
+namespace {
+
+bool isCompressible(const XEvent &e) {
+    switch (e.type) {
+    case MotionNotify:
+    case ConfigureNotify:
+    case Expose:
+    case PropertyNotify:
+        return true;
+    default:
+        return false;
+    }
+}
+
+// can 'next' replace 'e' without anyone noticing that 'e' was dropped?
+bool supersedes(const XEvent &e, const XEvent &next) {
+    if (next.type != e.type || next.xany.window != e.xany.window)
+        return false;
+
+    switch (e.type) {
+    case MotionNotify:
+        // a changed button/modifier state may start or end a drag
+        return next.xmotion.state == e.xmotion.state &&
+               next.xmotion.subwindow == e.xmotion.subwindow &&
+               next.xmotion.is_hint == e.xmotion.is_hint;
+    case ConfigureNotify:
+        return next.xconfigure.window == e.xconfigure.window;
+    case Expose:
+        return true;
+    case PropertyNotify:
+        return next.xproperty.atom == e.xproperty.atom &&
+               next.xproperty.state == e.xproperty.state;
+    }
+    return false;
+}
+
+} // end anonymous namespace
+
+void Fluxbox::compressEvent(XEvent &e) {
+
+    if (!isCompressible(e))
+        return;
+
+    Display *disp = display();
+    XEvent next;
+    // only look at the head of the queue, so the relative order of
+    // events for different windows or of different types is kept
+    while (XEventsQueued(disp, QueuedAfterReading) > 0) {
+        XPeekEvent(disp, &next);
+        if (!supersedes(e, next))
+            break;
+
+        XNextEvent(disp, &next);
+        if (e.type == Expose) {
+            // redraw the union of both damaged areas
+            int x1 = std::min(e.xexpose.x, next.xexpose.x);
+            int y1 = std::min(e.xexpose.y, next.xexpose.y);
+            int x2 = std::max(e.xexpose.x + e.xexpose.width,
+                              next.xexpose.x + next.xexpose.width);
+            int y2 = std::max(e.xexpose.y + e.xexpose.height,
+                              next.xexpose.y + next.xexpose.height);
+            next.xexpose.x = x1;
+            next.xexpose.y = y1;
+            next.xexpose.width = x2 - x1;
+            next.xexpose.height = y2 - y1;
+        }
+        ++m_compressed_events[e.type];
+        e = next;
+    }
+}
+
 bool Fluxbox::validateWindow(Window window) const {
     XEvent event;
     if (XCheckTypedWindowEvent(display(), window, DestroyNotify, &event)) {
@@ -1102,7 +1198,16 @@ void Fluxbox::shutdown(int x_wants_down) {
 
     XSetInputFocus(dpy, PointerRoot, None, CurrentTime);
 
+    fbdbg<<"Fluxbox::shutdown(): compressed events: motion="
+         <<m_compressed_events[MotionNotify]
+         <<" configure="<<m_compressed_events[ConfigureNotify]
+         <<" expose="<<m_compressed_events[Expose]
+         <<" property="<<m_compressed_events[PropertyNotify]<<endl;
+
     if (x_wants_down == 0) {
+        // publish whatever the last event pass left pending, so the next
+        // window manager (or ourself after a restart) starts from it
+        flushAtomHandlers();
         STLUtil::forAll(m_screens, mem_fn(&BScreen::shutdown));
         sync(false);
     }
@@ -1372,6 +1477,11 @@ void Fluxbox::updateFrameExtents(FluxboxWindow &win) {
             CallMemFunWithRefArg<AtomHandler, FluxboxWindow&, void>(&AtomHandler::updateFrameExtents, win));
 }
 
+void Fluxbox::updateStacking(BScreen &screen) {
+    STLUtil::forAllIf(m_atomhandler, mem_fn(&AtomHandler::update),
+            CallMemFunWithRefArg<AtomHandler, BScreen&, void>(&AtomHandler::updateStacking, screen));
+}
+
 void Fluxbox::workspaceCountChanged( BScreen& screen ) {
     STLUtil::forAllIf(m_atomhandler, mem_fn(&AtomHandler::update),
             CallMemFunWithRefArg<AtomHandler, BScreen&, void>(&AtomHandler::updateWorkspaceCount, screen));
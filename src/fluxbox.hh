@@ -110,6 +110,10 @@ public:
     //WinClient *searchGroup(Window);
 
     Time getLastTime() const { return m_last_time; }
+    /// @return number of events of this type merged into a later one
+    unsigned long compressedEvents(int type) const {
+        return (type >= 0 && type < LASTEvent) ? m_compressed_events[type] : 0;
+    }
 
     AtomHandler *getAtomHandler(const std::string &name);
     void addAtomHandler(AtomHandler *atomh);
@@ -156,6 +160,8 @@ public:
 
     /// todo, remove this. just temporary
     void updateFrameExtents(FluxboxWindow &win);
+    /// the stacking order of windows on this screen changed
+    void updateStacking(BScreen &screen);
 
     void attachSignals(FluxboxWindow &win);
     void attachSignals(WinClient &winclient);
@@ -193,8 +199,12 @@ private:
     void load_rc();
     void real_reconfigure();
     void handleEvent(XEvent *xe);
+    /// merge queued events that would be superseded by a later one into xe
+    void compressEvent(XEvent &xe);
     void handleUnmapNotify(XUnmapEvent &ue);
     void handleClientMessage(XClientMessageEvent &ce);
+    /// publish updates the atomhandlers deferred while events were pending
+    void flushAtomHandlers();
 
     /// Called when workspace count on a specific screen changed.
     void workspaceCountChanged( BScreen& screen );
@@ -280,6 +290,7 @@ private:
 
     Time    m_last_time;
     XEvent  m_last_event;
+    unsigned long m_compressed_events[LASTEvent];
 
     Window  m_masked;
     FluxboxWindow *m_masked_window;
@@ -308,6 +319,8 @@ private:
     } m_state;
 
     int m_server_grabs;
+    unsigned int m_events_since_flush; ///< events handled since the last atomhandler flush
+    uint64_t m_last_flush;             ///< FbTime::mono() of the last atomhandler flush
     std::unique_ptr<ShortcutManager> m_shortcut_manager;
 };
 
@@ -0,0 +1,243 @@
+#include "wayland/fbwl_config_watch.h"
+
+#include "wayland/fbwl_util.h"
+
+#include <errno.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/inotify.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <wayland-server-core.h>
+
+#include <wlr/util/log.h>
+
+#define CONFIG_WATCH_MASK (IN_CLOSE_WRITE | IN_MOVED_TO | IN_ONLYDIR)
+
+static void config_watch_note(struct fbwl_config_watch *watch, const struct inotify_event *ev) {
+    uint32_t parts = 0;
+    if ((ev->mask & IN_Q_OVERFLOW) != 0) {
+        // Events were dropped; any watched file may have changed.
+        wlr_log(WLR_INFO, "ConfigWatch: event queue overflow");
+        parts = watch->overflow_parts;
+    }
+    for (size_t i = 0; i < watch->entries_len; i++) {
+        const struct fbwl_config_watch_entry *entry = &watch->entries[i];
+        if (entry->wd != ev->wd) {
+            continue;
+        }
+        if (entry->base != NULL && (ev->len == 0 || strcmp(entry->base, ev->name) != 0)) {
+            continue;
+        }
+        parts |= entry->parts;
+    }
+    if (parts == 0) {
+        return;
+    }
+    watch->pending |= parts;
+    if (watch->debounce_timer != NULL) {
+        wl_event_source_timer_update(watch->debounce_timer, watch->debounce_ms);
+    }
+}
+
+static int config_watch_handle_fd(int fd, uint32_t mask, void *data) {
+    struct fbwl_config_watch *watch = data;
+    if (watch == NULL || (mask & WL_EVENT_READABLE) == 0) {
+        return 0;
+    }
+
+    char buf[4096] __attribute__((aligned(__alignof__(struct inotify_event))));
+    for (;;) {
+        ssize_t n = read(fd, buf, sizeof(buf));
+        if (n <= 0) {
+            if (n < 0 && errno == EINTR) {
+                continue;
+            }
+            break;
+        }
+        for (char *p = buf; p < buf + n;) {
+            const struct inotify_event *ev = (const struct inotify_event *)p;
+            config_watch_note(watch, ev);
+            p += sizeof(*ev) + ev->len;
+        }
+    }
+    return 0;
+}
+
+static int config_watch_handle_timer(void *data) {
+    struct fbwl_config_watch *watch = data;
+    if (watch == NULL) {
+        return 0;
+    }
+    const uint32_t parts = watch->pending;
+    watch->pending = 0;
+    if (parts != 0 && watch->apply != NULL) {
+        watch->apply(watch->userdata, parts);
+    }
+    return 0;
+}
+
+bool fbwl_config_watch_init(struct fbwl_config_watch *watch, struct wl_event_loop *loop, int debounce_ms,
+        uint32_t overflow_parts, void (*apply)(void *userdata, uint32_t parts), void *userdata) {
+    if (watch == NULL || loop == NULL) {
+        return false;
+    }
+    *watch = (struct fbwl_config_watch){
+        .fd = -1,
+        .debounce_ms = debounce_ms > 0 ? debounce_ms : 1,
+        .overflow_parts = overflow_parts,
+        .apply = apply,
+        .userdata = userdata,
+    };
+
+    watch->fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (watch->fd < 0) {
+        wlr_log(WLR_ERROR, "ConfigWatch: inotify_init1 failed: %s", strerror(errno));
+        return false;
+    }
+    watch->fd_source = wl_event_loop_add_fd(loop, watch->fd, WL_EVENT_READABLE, config_watch_handle_fd, watch);
+    watch->debounce_timer = wl_event_loop_add_timer(loop, config_watch_handle_timer, watch);
+    if (watch->fd_source == NULL || watch->debounce_timer == NULL) {
+        wlr_log(WLR_ERROR, "ConfigWatch: failed to add event sources");
+        fbwl_config_watch_finish(watch);
+        return false;
+    }
+    return true;
+}
+
+void fbwl_config_watch_clear(struct fbwl_config_watch *watch) {
+    fbwl_config_watch_begin(watch);
+    fbwl_config_watch_end(watch);
+}
+
+void fbwl_config_watch_begin(struct fbwl_config_watch *watch) {
+    if (watch == NULL) {
+        return;
+    }
+    for (size_t i = 0; i < watch->entries_len; i++) {
+        watch->entries[i].seen = false;
+        watch->entries[i].parts = 0;
+    }
+}
+
+void fbwl_config_watch_end(struct fbwl_config_watch *watch) {
+    if (watch == NULL) {
+        return;
+    }
+    for (size_t i = 0; i < watch->entries_len; i++) {
+        struct fbwl_config_watch_entry *entry = &watch->entries[i];
+        if (entry->seen) {
+            continue;
+        }
+        // A directory keeps its watch while any kept path lives in it; for
+        // dropped paths sharing one, the first of them removes it.
+        bool shared = false;
+        for (size_t j = 0; j < watch->entries_len && !shared; j++) {
+            shared = j != i && watch->entries[j].wd == entry->wd && (watch->entries[j].seen || j < i);
+        }
+        if (!shared && watch->fd >= 0 && entry->wd >= 0) {
+            (void)inotify_rm_watch(watch->fd, entry->wd);
+        }
+        free(entry->path);
+        free(entry->base);
+    }
+
+    size_t kept = 0;
+    for (size_t i = 0; i < watch->entries_len; i++) {
+        if (watch->entries[i].seen) {
+            watch->entries[kept++] = watch->entries[i];
+        }
+    }
+    watch->entries_len = kept;
+}
+
+void fbwl_config_watch_finish(struct fbwl_config_watch *watch) {
+    if (watch == NULL) {
+        return;
+    }
+    fbwl_config_watch_clear(watch);
+    free(watch->entries);
+    watch->entries = NULL;
+    watch->entries_cap = 0;
+
+    if (watch->debounce_timer != NULL) {
+        wl_event_source_remove(watch->debounce_timer);
+        watch->debounce_timer = NULL;
+    }
+    if (watch->fd_source != NULL) {
+        wl_event_source_remove(watch->fd_source);
+        watch->fd_source = NULL;
+    }
+    fbwl_cleanup_fd(&watch->fd);
+    watch->pending = 0;
+}
+
+bool fbwl_config_watch_add(struct fbwl_config_watch *watch, const char *path, uint32_t parts) {
+    if (watch == NULL || watch->fd < 0 || path == NULL || *path == '\0' || parts == 0) {
+        return false;
+    }
+    for (size_t i = 0; i < watch->entries_len; i++) {
+        if (strcmp(watch->entries[i].path, path) == 0) {
+            watch->entries[i].parts |= parts;
+            watch->entries[i].seen = true;
+            return true;
+        }
+    }
+
+    struct stat st;
+    const bool is_dir = stat(path, &st) == 0 && S_ISDIR(st.st_mode);
+    char *dir = NULL;
+    char *base = NULL;
+    if (is_dir) {
+        dir = strdup(path);
+    } else {
+        const char *slash = strrchr(path, '/');
+        dir = slash == NULL ? strdup(".") : slash == path ? strdup("/") : strndup(path, (size_t)(slash - path));
+        base = strdup(slash != NULL ? slash + 1 : path);
+        if (base == NULL || *base == '\0') {
+            free(dir);
+            free(base);
+            return false;
+        }
+    }
+    if (dir == NULL) {
+        free(base);
+        return false;
+    }
+
+    const int wd = inotify_add_watch(watch->fd, dir, CONFIG_WATCH_MASK);
+    if (wd < 0) {
+        wlr_log(WLR_DEBUG, "ConfigWatch: cannot watch %s: %s", dir, strerror(errno));
+        free(dir);
+        free(base);
+        return false;
+    }
+    free(dir);
+
+    if (watch->entries_len == watch->entries_cap) {
+        const size_t new_cap = watch->entries_cap > 0 ? watch->entries_cap * 2 : 8;
+        struct fbwl_config_watch_entry *p = realloc(watch->entries, new_cap * sizeof(*p));
+        if (p == NULL) {
+            free(base);
+            return false;
+        }
+        watch->entries = p;
+        watch->entries_cap = new_cap;
+    }
+    char *path_dup = strdup(path);
+    if (path_dup == NULL) {
+        free(base);
+        return false;
+    }
+    watch->entries[watch->entries_len++] = (struct fbwl_config_watch_entry){
+        .path = path_dup,
+        .base = base,
+        .wd = wd,
+        .parts = parts,
+        .seen = true,
+    };
+    return true;
+}
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+struct wl_event_loop;
+struct wl_event_source;
+
+struct fbwl_config_watch_entry {
+    char *path;
+    char *base; // NULL when path itself is a watched directory
+    int wd;
+    uint32_t parts;
+    bool seen;
+};
+
+// Watches config files through their parent directories so editors that save
+// via rename are still noticed. Changes are collected into a part mask and
+// handed to `apply` once the directory has been quiet for `debounce_ms`.
+// When the kernel queue overflows, `overflow_parts` is applied instead.
+struct fbwl_config_watch {
+    int fd;
+    struct wl_event_source *fd_source;
+    struct wl_event_source *debounce_timer;
+    int debounce_ms;
+
+    struct fbwl_config_watch_entry *entries;
+    size_t entries_len;
+    size_t entries_cap;
+
+    uint32_t pending;
+    uint32_t overflow_parts;
+    void (*apply)(void *userdata, uint32_t parts);
+    void *userdata;
+};
+
+bool fbwl_config_watch_init(struct fbwl_config_watch *watch, struct wl_event_loop *loop, int debounce_ms,
+        uint32_t overflow_parts, void (*apply)(void *userdata, uint32_t parts), void *userdata);
+void fbwl_config_watch_finish(struct fbwl_config_watch *watch);
+void fbwl_config_watch_clear(struct fbwl_config_watch *watch);
+bool fbwl_config_watch_add(struct fbwl_config_watch *watch, const char *path, uint32_t parts);
+
+// Re-declaring the watched set: paths added between begin and end keep
+// their inotify watch, new ones get one, and the rest are dropped.
+void fbwl_config_watch_begin(struct fbwl_config_watch *watch);
+void fbwl_config_watch_end(struct fbwl_config_watch *watch);
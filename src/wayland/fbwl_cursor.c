@@ -1,7 +1,9 @@
 #include "wayland/fbwl_cursor.h"
 
 #include <stdint.h>
+#include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 
 #include <pixman.h>
 
@@ -36,6 +38,63 @@ struct fbwl_pointer_constraint {
     struct wl_listener destroy;
 };
 
+// What was last handed to wlr_cursor. Pointer motion over empty space or an
+// open menu asks for "default" on every event; only a change is passed on.
+static struct {
+    struct wlr_cursor *cursor;
+    struct wlr_xcursor_manager *cursor_mgr;
+    char name[32];
+} cursor_image;
+
+static const char *const preload_shapes[] = {
+    "default", "pointer", "text", "move", "grabbing", "not-allowed",
+    "n-resize", "s-resize", "e-resize", "w-resize",
+    "ne-resize", "nw-resize", "se-resize", "sw-resize",
+};
+
+void fbwl_cursor_set_xcursor(struct wlr_cursor *cursor, struct wlr_xcursor_manager *cursor_mgr, const char *name) {
+    if (cursor == NULL || cursor_mgr == NULL || name == NULL) {
+        return;
+    }
+    if (cursor_image.cursor == cursor && cursor_image.cursor_mgr == cursor_mgr &&
+            strcmp(cursor_image.name, name) == 0) {
+        return;
+    }
+    wlr_cursor_set_xcursor(cursor, cursor_mgr, name);
+    cursor_image.cursor = cursor;
+    cursor_image.cursor_mgr = cursor_mgr;
+    snprintf(cursor_image.name, sizeof(cursor_image.name), "%s", name);
+}
+
+void fbwl_cursor_set_surface(struct wlr_cursor *cursor, struct wlr_surface *surface,
+        int32_t hotspot_x, int32_t hotspot_y) {
+    if (cursor == NULL) {
+        return;
+    }
+    // Not deduplicated: clients set their cursor once per enter, and a
+    // surface pointer may be reused after the old one is destroyed.
+    wlr_cursor_set_surface(cursor, surface, hotspot_x, hotspot_y);
+    memset(&cursor_image, 0, sizeof(cursor_image));
+}
+
+void fbwl_cursor_preload(struct wlr_xcursor_manager *cursor_mgr, float scale) {
+    if (cursor_mgr == NULL || scale <= 0.0f) {
+        return;
+    }
+    if (!wlr_xcursor_manager_load(cursor_mgr, scale)) {
+        wlr_log(WLR_ERROR, "Cursor: failed to load theme at scale %.2f", scale);
+        return;
+    }
+    size_t found = 0;
+    for (size_t i = 0; i < sizeof(preload_shapes) / sizeof(preload_shapes[0]); i++) {
+        if (wlr_xcursor_manager_get_xcursor(cursor_mgr, preload_shapes[i], scale) != NULL) {
+            found++;
+        }
+    }
+    wlr_log(WLR_DEBUG, "Cursor: theme loaded scale=%.2f shapes=%zu/%zu", scale, found,
+        sizeof(preload_shapes) / sizeof(preload_shapes[0]));
+}
+
 static bool menu_is_open(const struct fbwl_cursor_menu_hooks *hooks) {
     return hooks != NULL && hooks->is_open != NULL && hooks->is_open(hooks->userdata);
 }
@@ -69,6 +128,16 @@ static void cursor_update_pointer_constraint(struct wlr_pointer_constraints_v1 *
     }
 }
 
+static void cursor_clear_pointer_focus(struct wlr_seat *seat,
+        struct wlr_pointer_constraints_v1 *pointer_constraints,
+        struct wlr_pointer_constraint_v1 **active_pointer_constraint) {
+    if (seat->pointer_state.focused_surface == NULL) {
+        return;
+    }
+    wlr_seat_pointer_clear_focus(seat);
+    cursor_update_pointer_constraint(pointer_constraints, seat, active_pointer_constraint);
+}
+
 static void process_cursor_motion(struct wlr_scene *scene, struct wlr_cursor *cursor,
         struct wlr_xcursor_manager *cursor_mgr, struct wlr_seat *seat,
         struct wlr_pointer_constraints_v1 *pointer_constraints,
@@ -87,12 +156,8 @@ static void process_cursor_motion(struct wlr_scene *scene, struct wlr_cursor *cu
             }
         }
 
-        wlr_cursor_set_xcursor(cursor, cursor_mgr, "default");
-        struct wlr_surface *prev_surface = seat->pointer_state.focused_surface;
-        wlr_seat_pointer_clear_focus(seat);
-        if (prev_surface != seat->pointer_state.focused_surface) {
-            cursor_update_pointer_constraint(pointer_constraints, seat, active_pointer_constraint);
-        }
+        fbwl_cursor_set_xcursor(cursor, cursor_mgr, "default");
+        cursor_clear_pointer_focus(seat, pointer_constraints, active_pointer_constraint);
         return;
     }
 
@@ -110,12 +175,8 @@ static void process_cursor_motion(struct wlr_scene *scene, struct wlr_cursor *cu
         return;
     }
 
-    wlr_cursor_set_xcursor(cursor, cursor_mgr, "default");
-    struct wlr_surface *prev_surface = seat->pointer_state.focused_surface;
-    wlr_seat_pointer_clear_focus(seat);
-    if (prev_surface != seat->pointer_state.focused_surface) {
-        cursor_update_pointer_constraint(pointer_constraints, seat, active_pointer_constraint);
-    }
+    fbwl_cursor_set_xcursor(cursor, cursor_mgr, "default");
+    cursor_clear_pointer_focus(seat, pointer_constraints, active_pointer_constraint);
 }
 
 static void clamp_to_box(double *x, double *y, const struct wlr_box *box) {
@@ -396,7 +457,7 @@ void fbwl_cursor_handle_shape_request(struct wlr_seat *seat, struct wlr_cursor *
     }
 
     wlr_log(WLR_INFO, "CursorShape: name=%s", name);
-    wlr_cursor_set_xcursor(cursor, cursor_mgr, name);
+    fbwl_cursor_set_xcursor(cursor, cursor_mgr, name);
 }
 
 void fbwl_cursor_handle_new_pointer_constraint(struct wlr_cursor *cursor, struct wlr_xcursor_manager *cursor_mgr,
@@ -16,6 +16,7 @@ struct wlr_pointer_motion_event;
 struct wlr_pointer_motion_absolute_event;
 struct wlr_scene;
 struct wlr_seat;
+struct wlr_surface;
 struct wlr_xcursor_manager;
 
 struct fbwl_cursor_menu_hooks {
@@ -25,6 +26,14 @@ struct fbwl_cursor_menu_hooks {
     void (*set_selected)(void *userdata, size_t idx);
 };
 
+// Sets a theme cursor by name unless it is the image already shown.
+void fbwl_cursor_set_xcursor(struct wlr_cursor *cursor, struct wlr_xcursor_manager *cursor_mgr, const char *name);
+// Shows a client cursor surface (NULL hides the cursor).
+void fbwl_cursor_set_surface(struct wlr_cursor *cursor, struct wlr_surface *surface,
+        int32_t hotspot_x, int32_t hotspot_y);
+// Loads the cursor theme at an output scale before the first hover needs it.
+void fbwl_cursor_preload(struct wlr_xcursor_manager *cursor_mgr, float scale);
+
 void fbwl_cursor_handle_motion(struct wlr_cursor *cursor, struct wlr_xcursor_manager *cursor_mgr,
         struct wlr_scene *scene, struct wlr_seat *seat,
         struct wlr_relative_pointer_manager_v1 *relative_pointer_mgr,
@@ -90,6 +90,27 @@ static void grab_outline_update(struct fbwl_grab *grab, struct fbwl_view *view,
     wlr_scene_node_raise_to_top(&grab->outline_tree->node);
 }
 
+enum {
+    GRAB_MOVE_REFRESH_MS = 50,
+};
+
+static void grab_move_refresh_cancel(struct fbwl_grab *grab) {
+    if (grab->move_refresh_timer != NULL) {
+        wl_event_source_remove(grab->move_refresh_timer);
+        grab->move_refresh_timer = NULL;
+    }
+    grab->move_refresh_pending = false;
+}
+
+static bool view_title_parentrel(const struct fbwl_view *view) {
+    if (view->server == NULL || !view->decor_enabled) {
+        return false;
+    }
+    const struct fbwl_decor_theme *theme = &view->server->decor_theme;
+    return fbwl_texture_is_parentrelative(&theme->window_title_focus_tex) ||
+        fbwl_texture_is_parentrelative(&theme->window_title_unfocus_tex);
+}
+
 static void grab_apply_pending(struct fbwl_grab *grab, struct wlr_output_layout *output_layout, const char *reason) {
     if (grab == NULL || !grab->pending_valid) {
         return;
@@ -100,6 +121,8 @@ static void grab_apply_pending(struct fbwl_grab *grab, struct wlr_output_layout
     }
 
     const bool sync_tabs = !grab->tab_attach_enabled;
+    const bool catch_up = grab->move_refresh_pending;
+    grab->move_refresh_pending = false;
 
     view->x = grab->pending_x;
     view->y = grab->pending_y;
@@ -107,6 +130,9 @@ static void grab_apply_pending(struct fbwl_grab *grab, struct wlr_output_layout
         wlr_scene_node_set_position(&view->scene_tree->node, view->x, view->y);
     }
     fbwl_view_pseudo_bg_update(view, reason);
+    if (catch_up && view_title_parentrel(view)) {
+        fbwl_view_decor_update(view, &view->server->decor_theme);
+    }
 
     const bool include_size = grab->mode == FBWL_CURSOR_RESIZE;
     if (include_size) {
@@ -140,6 +166,50 @@ static void grab_apply_pending(struct fbwl_grab *grab, struct wlr_output_layout
     fbwl_view_foreign_update_output_from_position(view, output_layout);
 }
 
+static int grab_move_refresh_timer_cb(void *data) {
+    struct fbwl_grab *grab = data;
+    if (grab == NULL || grab->mode != FBWL_CURSOR_MOVE || grab->view == NULL || grab->view->server == NULL ||
+            !grab->move_refresh_pending) {
+        return 0;
+    }
+    grab_apply_pending(grab, grab->view->server->output_layout, "move-refresh");
+    return 0;
+}
+
+// One opaque-move motion step: a pure node translation. Pseudo-transparency
+// samples and the other side effects are refreshed at most every
+// GRAB_MOVE_REFRESH_MS and once more when the grab commits.
+static void grab_apply_move_live(struct fbwl_grab *grab, struct wlr_output_layout *output_layout) {
+    struct fbwl_view *view = grab->view;
+    if (!grab->pending_valid || view == NULL) {
+        return;
+    }
+    view->x = grab->pending_x;
+    view->y = grab->pending_y;
+    if (view->scene_tree != NULL) {
+        wlr_scene_node_set_position(&view->scene_tree->node, view->x, view->y);
+    }
+    if (view->type == FBWL_VIEW_XWAYLAND && view->xwayland_surface != NULL &&
+            grab->pending_w > 0 && grab->pending_h > 0) {
+        wlr_xwayland_surface_configure(view->xwayland_surface, view->x, view->y,
+            (uint16_t)grab->pending_w, (uint16_t)grab->pending_h);
+    }
+
+    if (grab->move_refresh_pending) {
+        return;
+    }
+    grab->move_refresh_pending = true;
+    if (grab->move_refresh_timer == NULL && view->server != NULL) {
+        struct wl_event_loop *loop = wl_display_get_event_loop(view->server->wl_display);
+        grab->move_refresh_timer = wl_event_loop_add_timer(loop, grab_move_refresh_timer_cb, grab);
+    }
+    if (grab->move_refresh_timer == NULL) {
+        grab_apply_pending(grab, output_layout, "move");
+        return;
+    }
+    wl_event_source_timer_update(grab->move_refresh_timer, GRAB_MOVE_REFRESH_MS);
+}
+
 static int grab_resize_timer_cb(void *data) {
     struct fbwl_grab *grab = data;
     if (grab == NULL || grab->mode != FBWL_CURSOR_RESIZE || grab->view == NULL || grab->view->server == NULL) {
@@ -192,6 +262,77 @@ static void view_frame_extents(const struct fbwl_view *view, int *left, int *top
     fbwl_view_decor_frame_extents(view, &view->server->decor_theme, left, top, right, bottom);
 }
 
+// Indexes the frames of the other visible windows; rebuilt only when the
+// visible set changes (map, unmap, workspace switch), not per motion event.
+static void grab_snap_index_sync(struct fbwl_grab *grab, const struct fbwl_view *view) {
+    struct fbwl_server *server = view->server;
+    if (server == NULL) {
+        return;
+    }
+    const uint64_t serial = fbwm_core_visible_serial(&server->wm);
+    if (grab->snap.built && grab->snap.serial == serial) {
+        return;
+    }
+
+    fbwl_snap_index_clear(&grab->snap);
+    size_t count = 0;
+    struct fbwm_visible_iter iter;
+    fbwm_core_visible_iter_init(&server->wm, &iter, false);
+    for (struct fbwm_view *wm_view; (wm_view = fbwm_core_visible_iter_next(&iter)) != NULL;) {
+        const struct fbwl_view *other = wm_view->userdata;
+        if (other == NULL || other == view) {
+            continue;
+        }
+        if (other->tab_group != NULL &&
+                (other->tab_group == view->tab_group || !fbwl_tabs_view_is_active(other))) {
+            continue;
+        }
+        int ext_left = 0;
+        int ext_top = 0;
+        int ext_right = 0;
+        int ext_bottom = 0;
+        view_frame_extents(other, &ext_left, &ext_top, &ext_right, &ext_bottom);
+        if (fbwl_snap_index_add_box(&grab->snap, other->x - ext_left, other->y - ext_top,
+                fbwl_view_current_width(other) + ext_left + ext_right,
+                fbwl_view_current_height(other) + ext_top + ext_bottom)) {
+            count++;
+        }
+    }
+    grab->snap.built = true;
+    grab->snap.serial = serial;
+    wlr_log(WLR_DEBUG, "Snap: indexed %zu windows for %s", count, fbwl_view_display_title(view));
+}
+
+// Snaps whichever of the frame's two edges along `axis` lies closer to a
+// window edge; returns the offset to apply.
+static bool snap_frame_to_windows(struct fbwl_snap_index *index, enum fbwl_snap_axis axis, int start, int size,
+        int lo, int hi, int threshold, int *delta) {
+    int d_start = 0;
+    int d_end = 0;
+    const bool at_start = fbwl_snap_index_nearest(index, axis, start, lo, hi, threshold, &d_start);
+    const bool at_end = fbwl_snap_index_nearest(index, axis, start + size, lo, hi, threshold, &d_end);
+    if (!at_start && !at_end) {
+        return false;
+    }
+    *delta = at_start && (!at_end || abs(d_start) <= abs(d_end)) ? d_start : d_end;
+    return true;
+}
+
+static int snap_pick(int pos, bool output_snapped, int output_pos, bool window_snapped, int window_delta) {
+    if (window_snapped && (!output_snapped || abs(window_delta) < abs(output_pos - pos))) {
+        return pos + window_delta;
+    }
+    return output_snapped ? output_pos : pos;
+}
+
+static int snap_resize_edge(struct fbwl_snap_index *index, enum fbwl_snap_axis axis, int pos, int lo, int hi,
+        bool have_output, int output_edge, int threshold) {
+    const bool output_snapped = have_output && abs(pos - output_edge) <= threshold;
+    int delta = 0;
+    const bool window_snapped = fbwl_snap_index_nearest(index, axis, pos, lo, hi, threshold, &delta);
+    return snap_pick(pos, output_snapped, output_edge, window_snapped, delta);
+}
+
 void fbwl_grab_begin_move(struct fbwl_grab *grab, struct fbwl_view *view, struct wlr_cursor *cursor,
         uint32_t button) {
     if (grab == NULL || view == NULL || cursor == NULL) {
@@ -236,6 +377,7 @@ void fbwl_grab_begin_move(struct fbwl_grab *grab, struct fbwl_view *view, struct
         wl_event_source_remove(grab->resize_timer);
         grab->resize_timer = NULL;
     }
+    grab_move_refresh_cancel(grab);
     grab->mode = FBWL_CURSOR_MOVE;
 }
 
@@ -294,6 +436,7 @@ void fbwl_grab_begin_resize(struct fbwl_grab *grab, struct fbwl_view *view, stru
         wl_event_source_remove(grab->resize_timer);
         grab->resize_timer = NULL;
     }
+    grab_move_refresh_cancel(grab);
     grab->mode = FBWL_CURSOR_RESIZE;
 
     if (view->type == FBWL_VIEW_XDG && view->xdg_toplevel != NULL) {
@@ -311,6 +454,7 @@ void fbwl_grab_commit(struct fbwl_grab *grab, struct wlr_output_layout *output_l
     }
     grab_outline_destroy(grab);
     grab_apply_pending(grab, output_layout, why);
+    grab_move_refresh_cancel(grab);
 }
 
 void fbwl_grab_end(struct fbwl_grab *grab) {
@@ -328,6 +472,8 @@ void fbwl_grab_end(struct fbwl_grab *grab) {
         wl_event_source_remove(grab->resize_timer);
         grab->resize_timer = NULL;
     }
+    grab_move_refresh_cancel(grab);
+    fbwl_snap_index_finish(&grab->snap);
 
     grab->mode = FBWL_CURSOR_PASSTHROUGH;
     grab->view = NULL;
@@ -357,27 +503,45 @@ void fbwl_grab_update(struct fbwl_grab *grab, struct wlr_cursor *cursor,
     if (grab->mode == FBWL_CURSOR_MOVE) {
         int x = grab->view_x + (int)dx;
         int y = grab->view_y + (int)dy;
-        if (edge_snap_threshold_px > 0 && output_layout != NULL && outputs != NULL) {
+        if (edge_snap_threshold_px > 0) {
             struct wlr_box box = {0};
-            struct wlr_output *output = wlr_output_layout_output_at(output_layout, cursor->x, cursor->y);
-            fbwl_view_get_output_usable_box(view, output_layout, outputs, output, &box);
+            if (output_layout != NULL && outputs != NULL) {
+                struct wlr_output *output = wlr_output_layout_output_at(output_layout, cursor->x, cursor->y);
+                fbwl_view_get_output_usable_box(view, output_layout, outputs, output, &box);
+            }
+            int ext_left = 0;
+            int ext_top = 0;
+            int ext_right = 0;
+            int ext_bottom = 0;
+            const int w = fbwl_view_current_width(view);
+            const int h = fbwl_view_current_height(view);
+            view_frame_extents(view, &ext_left, &ext_top, &ext_right, &ext_bottom);
+            const int frame_w = w + ext_left + ext_right;
+            const int frame_h = h + ext_top + ext_bottom;
+            const int frame_x = x - ext_left;
+            const int frame_y = y - ext_top;
+
+            int output_x = frame_x;
+            int output_y = frame_y;
+            bool output_snapped_x = false;
+            bool output_snapped_y = false;
             if (box.width > 0 && box.height > 0) {
-                int ext_left = 0;
-                int ext_top = 0;
-                int ext_right = 0;
-                int ext_bottom = 0;
-                const int w = fbwl_view_current_width(view);
-                const int h = fbwl_view_current_height(view);
-                view_frame_extents(view, &ext_left, &ext_top, &ext_right, &ext_bottom);
-                const int frame_w = w + ext_left + ext_right;
-                const int frame_h = h + ext_top + ext_bottom;
-                int frame_x = x - ext_left;
-                int frame_y = y - ext_top;
-                (void)snap_move_axis(&frame_x, frame_w, box.x, box.x + box.width, edge_snap_threshold_px);
-                (void)snap_move_axis(&frame_y, frame_h, box.y, box.y + box.height, edge_snap_threshold_px);
-                x = frame_x + ext_left;
-                y = frame_y + ext_top;
+                output_snapped_x =
+                    snap_move_axis(&output_x, frame_w, box.x, box.x + box.width, edge_snap_threshold_px);
+                output_snapped_y =
+                    snap_move_axis(&output_y, frame_h, box.y, box.y + box.height, edge_snap_threshold_px);
             }
+
+            grab_snap_index_sync(grab, view);
+            int window_dx = 0;
+            int window_dy = 0;
+            const bool window_snapped_x = snap_frame_to_windows(&grab->snap, FBWL_SNAP_AXIS_X,
+                frame_x, frame_w, frame_y, frame_y + frame_h, edge_snap_threshold_px, &window_dx);
+            const bool window_snapped_y = snap_frame_to_windows(&grab->snap, FBWL_SNAP_AXIS_Y,
+                frame_y, frame_h, frame_x, frame_x + frame_w, edge_snap_threshold_px, &window_dy);
+
+            x = snap_pick(frame_x, output_snapped_x, output_x, window_snapped_x, window_dx) + ext_left;
+            y = snap_pick(frame_y, output_snapped_y, output_y, window_snapped_y, window_dy) + ext_top;
         }
         grab->pending_valid = true;
         grab->pending_x = x;
@@ -386,7 +550,7 @@ void fbwl_grab_update(struct fbwl_grab *grab, struct wlr_cursor *cursor,
         grab->pending_h = fbwl_view_current_height(view);
 
         if (opaque_move) {
-            grab_apply_pending(grab, output_layout, "move");
+            grab_apply_move_live(grab, output_layout);
         } else {
             int ext_left = 0;
             int ext_top = 0;
@@ -464,49 +628,60 @@ void fbwl_grab_update(struct fbwl_grab *grab, struct wlr_cursor *cursor,
             }
         }
 
-        if (!center_resize && edge_resize_snap_threshold_px > 0 && output_layout != NULL && outputs != NULL) {
+        if (!center_resize && edge_resize_snap_threshold_px > 0) {
             struct wlr_box box = {0};
-            struct wlr_output *output = wlr_output_layout_output_at(output_layout, cursor->x, cursor->y);
-            fbwl_view_get_output_usable_box(view, output_layout, outputs, output, &box);
-            if (box.width > 0 && box.height > 0) {
-                int ext_left = 0;
-                int ext_top = 0;
-                int ext_right = 0;
-                int ext_bottom = 0;
-                view_frame_extents(view, &ext_left, &ext_top, &ext_right, &ext_bottom);
-                int frame_l = x - ext_left;
-                int frame_t = y - ext_top;
-                int frame_r = x + w + ext_right;
-                int frame_b = y + h + ext_bottom;
-                const int box_r = box.x + box.width;
-                const int box_b = box.y + box.height;
-                if ((edges & WLR_EDGE_LEFT) != 0 && abs(frame_l - box.x) <= edge_resize_snap_threshold_px) {
-                    frame_l = box.x;
-                }
-                if ((edges & WLR_EDGE_RIGHT) != 0 && abs(frame_r - box_r) <= edge_resize_snap_threshold_px) {
-                    frame_r = box_r;
-                }
-                if ((edges & WLR_EDGE_TOP) != 0 && abs(frame_t - box.y) <= edge_resize_snap_threshold_px) {
-                    frame_t = box.y;
-                }
-                if ((edges & WLR_EDGE_BOTTOM) != 0 && abs(frame_b - box_b) <= edge_resize_snap_threshold_px) {
-                    frame_b = box_b;
-                }
-                x = frame_l + ext_left;
-                y = frame_t + ext_top;
-                w = (frame_r - frame_l) - ext_left - ext_right;
-                h = (frame_b - frame_t) - ext_top - ext_bottom;
-                if (w < 1) {
-                    w = 1;
-                    if ((edges & WLR_EDGE_LEFT) != 0) {
-                        x = (frame_r - ext_right) - 1;
-                    }
+            if (output_layout != NULL && outputs != NULL) {
+                struct wlr_output *output = wlr_output_layout_output_at(output_layout, cursor->x, cursor->y);
+                fbwl_view_get_output_usable_box(view, output_layout, outputs, output, &box);
+            }
+            const bool have_box = box.width > 0 && box.height > 0;
+            grab_snap_index_sync(grab, view);
+            int ext_left = 0;
+            int ext_top = 0;
+            int ext_right = 0;
+            int ext_bottom = 0;
+            view_frame_extents(view, &ext_left, &ext_top, &ext_right, &ext_bottom);
+            int frame_l = x - ext_left;
+            int frame_t = y - ext_top;
+            int frame_r = x + w + ext_right;
+            int frame_b = y + h + ext_bottom;
+            const int box_r = box.x + box.width;
+            const int box_b = box.y + box.height;
+            const int th = edge_resize_snap_threshold_px;
+            const int span_l = frame_l;
+            const int span_t = frame_t;
+            const int span_r = frame_r;
+            const int span_b = frame_b;
+            if ((edges & WLR_EDGE_LEFT) != 0) {
+                frame_l = snap_resize_edge(&grab->snap, FBWL_SNAP_AXIS_X, frame_l, span_t, span_b,
+                    have_box, box.x, th);
+            }
+            if ((edges & WLR_EDGE_RIGHT) != 0) {
+                frame_r = snap_resize_edge(&grab->snap, FBWL_SNAP_AXIS_X, frame_r, span_t, span_b,
+                    have_box, box_r, th);
+            }
+            if ((edges & WLR_EDGE_TOP) != 0) {
+                frame_t = snap_resize_edge(&grab->snap, FBWL_SNAP_AXIS_Y, frame_t, span_l, span_r,
+                    have_box, box.y, th);
+            }
+            if ((edges & WLR_EDGE_BOTTOM) != 0) {
+                frame_b = snap_resize_edge(&grab->snap, FBWL_SNAP_AXIS_Y, frame_b, span_l, span_r,
+                    have_box, box_b, th);
+            }
+            x = frame_l + ext_left;
+            y = frame_t + ext_top;
+            w = (frame_r - frame_l) - ext_left - ext_right;
+            h = (frame_b - frame_t) - ext_top - ext_bottom;
+            if (w < 1) {
+                w = 1;
+                if ((edges & WLR_EDGE_LEFT) != 0) {
+                    x = (frame_r - ext_right) - 1;
                 }
-                if (h < 1) {
-                    h = 1;
-                    if ((edges & WLR_EDGE_TOP) != 0) {
-                        y = (frame_b - ext_bottom) - 1;
-                    }
+            }
+            if (h < 1) {
+                h = 1;
+                if ((edges & WLR_EDGE_TOP) != 0) {
+                    y = (frame_b - ext_bottom) - 1;
                 }
             }
         }
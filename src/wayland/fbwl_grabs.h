@@ -3,6 +3,8 @@
 #include <stdint.h>
 #include <stdbool.h>
 
+#include "wayland/fbwl_snap_index.h"
+
 struct fbwl_view;
 struct wl_list;
 struct wl_event_source;
@@ -42,6 +44,15 @@ struct fbwl_grab {
     struct wlr_scene_rect *outline_right;
 
     struct wl_event_source *resize_timer;
+
+    // Opaque moves only translate the scene node per motion event; the rest
+    // (pseudo-transparency, ParentRelative titlebar, tabs, foreign output)
+    // is caught up from this timer and when the grab commits.
+    struct wl_event_source *move_refresh_timer;
+    bool move_refresh_pending;
+
+    // Other windows' frame edges, indexed lazily on the first snapping step.
+    struct fbwl_snap_index snap;
 };
 
 void fbwl_grab_begin_move(struct fbwl_grab *grab, struct fbwl_view *view, struct wlr_cursor *cursor,
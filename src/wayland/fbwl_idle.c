@@ -25,6 +25,8 @@ static void fbwl_idle_set_inhibited(struct fbwl_idle_state *state, bool inhibite
         return;
     }
     state->idle_inhibited = inhibited;
+    // Whatever arrives next is the first activity of the new state.
+    state->activity_msec = 0;
     if (state->idle_notifier != NULL) {
         wlr_idle_notifier_v1_set_inhibited(state->idle_notifier, inhibited);
     }
@@ -57,12 +59,32 @@ static void fbwl_new_idle_inhibitor(struct wl_listener *listener, void *data) {
     fbwl_idle_set_inhibited(state, true, "new-inhibitor");
 }
 
+static void idle_activity_send(struct fbwl_idle_state *state, uint64_t now) {
+    state->activity_msec = now;
+    state->activity_pending = false;
+    if (state->idle_notifier == NULL || state->seat == NULL || *state->seat == NULL) {
+        return;
+    }
+    wlr_idle_notifier_v1_notify_activity(state->idle_notifier, *state->seat);
+}
+
+static int idle_activity_timer(void *data) {
+    struct fbwl_idle_state *state = data;
+    if (state->activity_pending) {
+        idle_activity_send(state, fbwl_now_msec());
+    }
+    return 0;
+}
+
 bool fbwl_idle_init(struct fbwl_idle_state *state, struct wl_display *display, struct wlr_seat **seat) {
     if (state == NULL || display == NULL) {
         return false;
     }
 
     state->seat = seat;
+    state->activity_msec = 0;
+    state->activity_pending = false;
+    state->activity_timer = wl_event_loop_add_timer(wl_display_get_event_loop(display), idle_activity_timer, state);
 
     state->idle_notifier = wlr_idle_notifier_v1_create(display);
     if (state->idle_notifier == NULL) {
@@ -88,12 +110,30 @@ void fbwl_idle_finish(struct fbwl_idle_state *state) {
         return;
     }
     fbwl_cleanup_listener(&state->new_idle_inhibitor);
+    if (state->activity_timer != NULL) {
+        wl_event_source_remove(state->activity_timer);
+        state->activity_timer = NULL;
+    }
 }
 
 void fbwl_idle_notify_activity(struct fbwl_idle_state *state) {
     if (state == NULL || state->idle_notifier == NULL || state->seat == NULL || *state->seat == NULL) {
         return;
     }
-    wlr_idle_notifier_v1_notify_activity(state->idle_notifier, *state->seat);
+    // Leading edge goes out at once, so the first event after a quiet
+    // period (any idle timeout expiring included) resumes immediately.
+    // Events inside the window are folded into one trailing notification
+    // at its end, which keeps idle timeouts from firing early.
+    const uint64_t now = fbwl_now_msec();
+    if (state->activity_timer == NULL || state->activity_msec == 0 ||
+            now - state->activity_msec >= FBWL_IDLE_ACTIVITY_MIN_MS) {
+        idle_activity_send(state, now);
+        return;
+    }
+    if (!state->activity_pending) {
+        state->activity_pending = true;
+        wl_event_source_timer_update(state->activity_timer,
+            (int)(FBWL_IDLE_ACTIVITY_MIN_MS - (now - state->activity_msec)));
+    }
 }
 
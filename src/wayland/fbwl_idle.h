@@ -1,6 +1,7 @@
 #pragma once
 
 #include <stdbool.h>
+#include <stdint.h>
 
 #include <wayland-server-core.h>
 
@@ -8,6 +9,11 @@ struct wlr_idle_inhibit_manager_v1;
 struct wlr_idle_notifier_v1;
 struct wlr_seat;
 
+enum {
+    // Input activity reaches idle notifications at most this often.
+    FBWL_IDLE_ACTIVITY_MIN_MS = 50,
+};
+
 struct fbwl_idle_state {
     struct wlr_idle_inhibit_manager_v1 *idle_inhibit_mgr;
     struct wl_listener new_idle_inhibitor;
@@ -17,6 +23,10 @@ struct fbwl_idle_state {
     bool idle_inhibited;
 
     struct wlr_seat **seat;
+
+    struct wl_event_source *activity_timer;
+    uint64_t activity_msec;
+    bool activity_pending;
 };
 
 bool fbwl_idle_init(struct fbwl_idle_state *state, struct wl_display *display, struct wlr_seat **seat);
@@ -142,10 +142,34 @@ struct fbwl_keybinding {
     char *mode;
 };
 
+struct fbwl_keybindings_cycle_entry {
+    struct fbwl_view *view;
+    size_t prev;
+    size_t next;
+};
+
+// Candidates of a NextWindow/PrevWindow run, captured on the first press and
+// reused while the modifiers stay held, so each further press is O(1). The
+// entries form a ring in focus order (or creation order for static cycling).
+struct fbwl_keybindings_cycle_session {
+    bool active;
+    bool groups;
+    bool static_order;
+    char *pattern;
+    uint64_t serial;
+    const struct fbwl_view *last_pick;
+    struct fbwl_keybindings_cycle_entry *entries;
+    size_t len;
+    size_t cap;
+    size_t front;
+    size_t cursor;
+};
+
 struct fbwl_keybindings_hooks {
     void *userdata;
     const void *cmdlang_scope;
     struct fbwm_core *wm;
+    struct fbwl_keybindings_cycle_session *cycle_session;
     const char *key_mode;
     uint32_t placeholder_keycode;
     xkb_keysym_t placeholder_sym;
@@ -216,6 +240,8 @@ bool fbwl_keybindings_handle_change_workspace(const struct fbwl_keybinding *bind
 struct fbwl_view *fbwl_keybindings_pick_cycle_candidate(const struct fbwl_keybindings_hooks *hooks, bool reverse,
         bool groups, bool static_order, char *pattern);
 
+void fbwl_keybindings_cycle_session_end(struct fbwl_keybindings_cycle_session *session);
+
 struct fbwl_view *fbwl_keybindings_pick_goto_candidate(const struct fbwl_keybindings_hooks *hooks, int num, bool groups,
         bool static_order, char *pattern);
 
@@ -2,7 +2,11 @@
 
 #include <stdbool.h>
 #include <stddef.h>
+#include <stdint.h>
 #include <stdlib.h>
+#include <string.h>
+
+#include <wlr/util/log.h>
 
 #include "wayland/fbwl_server_internal.h"
 #include "wayland/fbwl_ui_toolbar_iconbar_pattern.h"
@@ -68,139 +72,215 @@ static bool cycle_pattern_matches(const struct fbwl_iconbar_pattern *pat, const
     return fbwl_client_pattern_matches(pat, &env, view, current_workspace0(hooks));
 }
 
-static int view_create_seq_cmp(const void *a, const void *b) {
-    const struct fbwl_view *av = *(const struct fbwl_view *const *)a;
-    const struct fbwl_view *bv = *(const struct fbwl_view *const *)b;
-    if (av == NULL || bv == NULL) {
-        return 0;
+static bool cycle_candidate_ok(const struct fbwl_keybindings_hooks *hooks, struct fbwm_view *wm_view, bool groups,
+        const struct fbwl_iconbar_pattern *pat) {
+    struct fbwl_view *view = wm_view->userdata;
+    if (view == NULL) {
+        return false;
     }
-    if (av->create_seq < bv->create_seq) {
-        return -1;
+    if (groups && !fbwl_tabs_view_is_active(view)) {
+        return false;
     }
-    if (av->create_seq > bv->create_seq) {
-        return 1;
+    return cycle_pattern_matches(pat, view, hooks);
+}
+
+void fbwl_keybindings_cycle_session_end(struct fbwl_keybindings_cycle_session *session) {
+    if (session == NULL) {
+        return;
     }
-    if (av < bv) {
-        return -1;
+    free(session->entries);
+    free(session->pattern);
+    *session = (struct fbwl_keybindings_cycle_session){0};
+}
+
+static bool cycle_session_push(struct fbwl_keybindings_cycle_session *session, struct fbwl_view *view) {
+    if (session->len >= session->cap) {
+        const size_t new_cap = session->cap > 0 ? session->cap * 2 : 16;
+        struct fbwl_keybindings_cycle_entry *tmp = realloc(session->entries, new_cap * sizeof(*tmp));
+        if (tmp == NULL) {
+            return false;
+        }
+        session->entries = tmp;
+        session->cap = new_cap;
     }
-    if (av > bv) {
-        return 1;
+    const size_t idx = session->len++;
+    session->entries[idx] = (struct fbwl_keybindings_cycle_entry){ .view = view, .prev = idx, .next = idx };
+    if (idx > 0) {
+        // Append at the ring's tail, i.e. just before the front.
+        const size_t tail = session->entries[session->front].prev;
+        session->entries[idx].prev = tail;
+        session->entries[idx].next = session->front;
+        session->entries[tail].next = idx;
+        session->entries[session->front].prev = idx;
     }
-    return 0;
+    return true;
 }
 
-static struct fbwl_view *pick_cycle_candidate(const struct fbwl_keybindings_hooks *hooks, bool reverse, bool groups,
-        bool static_order, const struct fbwl_iconbar_pattern *pat) {
-    if (hooks == NULL || hooks->wm == NULL || pat == NULL) {
-        return NULL;
+static bool cycle_session_build(struct fbwl_keybindings_cycle_session *session,
+        const struct fbwl_keybindings_hooks *hooks, bool groups, bool static_order, const char *pattern,
+        const struct fbwl_iconbar_pattern *pat) {
+    char *pattern_copy = strdup(pattern);
+    if (pattern_copy == NULL) {
+        return false;
     }
+    free(session->pattern);
+    session->pattern = pattern_copy;
+    session->active = true;
+    session->groups = groups;
+    session->static_order = static_order;
+    session->serial = fbwm_core_visible_serial(hooks->wm);
+    session->last_pick = NULL;
+    session->len = 0;
+    session->front = 0;
+    session->cursor = SIZE_MAX;
+
     if (static_order) {
-        struct fbwl_view **candidates = NULL;
-        size_t candidates_len = 0;
-        size_t candidates_cap = 0;
-        for (struct fbwm_view *wm_view = hooks->wm->views.next; wm_view != &hooks->wm->views; wm_view = wm_view->next) {
-            if (!fbwm_core_view_is_visible(hooks->wm, wm_view)) {
-                continue;
-            }
-            struct fbwl_view *view = wm_view->userdata;
-            if (view == NULL) {
+        const struct fbwm_view *created = fbwm_core_creation_list(hooks->wm);
+        for (struct fbwm_view *wm_view = created->create_next; wm_view != created; wm_view = wm_view->create_next) {
+            if (!fbwm_core_view_is_visible(hooks->wm, wm_view) || !cycle_candidate_ok(hooks, wm_view, groups, pat)) {
                 continue;
             }
-            if (groups && !fbwl_tabs_view_is_active(view)) {
-                continue;
+            if (!cycle_session_push(session, wm_view->userdata)) {
+                return false;
             }
-            if (!cycle_pattern_matches(pat, view, hooks)) {
+        }
+    } else {
+        struct fbwm_visible_iter iter;
+        fbwm_core_visible_iter_init(hooks->wm, &iter, false);
+        for (struct fbwm_view *wm_view; (wm_view = fbwm_core_visible_iter_next(&iter)) != NULL;) {
+            if (!cycle_candidate_ok(hooks, wm_view, groups, pat)) {
                 continue;
             }
-            if (candidates_len >= candidates_cap) {
-                const size_t new_cap = candidates_cap > 0 ? candidates_cap * 2 : 16;
-                struct fbwl_view **tmp = realloc(candidates, new_cap * sizeof(*tmp));
-                if (tmp == NULL) {
-                    free(candidates);
-                    return NULL;
-                }
-                candidates = tmp;
-                candidates_cap = new_cap;
-            }
-            candidates[candidates_len++] = view;
-        }
-        if (candidates_len == 0) {
-            free(candidates);
-            return NULL;
-        }
-        qsort(candidates, candidates_len, sizeof(*candidates), view_create_seq_cmp);
-        const struct fbwl_view *focused_view = hooks->wm->focused != NULL ? hooks->wm->focused->userdata : NULL;
-        size_t focus_idx = 0;
-        bool focus_found = false;
-        if (focused_view != NULL) {
-            for (size_t i = 0; i < candidates_len; i++) {
-                if (candidates[i] == focused_view) {
-                    focus_idx = i;
-                    focus_found = true;
-                    break;
-                }
+            if (!cycle_session_push(session, wm_view->userdata)) {
+                return false;
             }
         }
-        size_t pick_idx = 0;
-        if (!focus_found) {
-            pick_idx = reverse ? (candidates_len - 1) : 0;
-        } else if (reverse) {
-            pick_idx = (focus_idx + candidates_len - 1) % candidates_len;
-        } else {
-            pick_idx = (focus_idx + 1) % candidates_len;
-        }
-        struct fbwl_view *pick = candidates[pick_idx];
-        free(candidates);
-        return pick;
     }
-    const struct fbwm_view *focused = hooks->wm->focused;
-    if (reverse) {
-        for (struct fbwm_view *wm_view = hooks->wm->views.next; wm_view != &hooks->wm->views; wm_view = wm_view->next) {
-            if (!fbwm_core_view_is_visible(hooks->wm, wm_view)) {
-                continue;
-            }
-            struct fbwl_view *view = wm_view->userdata;
-            if (view == NULL) {
-                continue;
-            }
-            if (groups && !fbwl_tabs_view_is_active(view)) {
-                continue;
-            }
-            if (focused != NULL && wm_view == focused) {
-                continue;
-            }
-            if (!cycle_pattern_matches(pat, view, hooks)) {
-                continue;
+    wlr_log(WLR_DEBUG, "Cycle: snapshot candidates=%zu static=%d groups=%d", session->len,
+        static_order ? 1 : 0, groups ? 1 : 0);
+    return true;
+}
+
+static bool cycle_session_valid(const struct fbwl_keybindings_cycle_session *session,
+        const struct fbwl_keybindings_hooks *hooks, bool groups, bool static_order, const char *pattern) {
+    if (!session->active || session->groups != groups || session->static_order != static_order ||
+            session->pattern == NULL || strcmp(session->pattern, pattern) != 0) {
+        return false;
+    }
+    if (session->serial != fbwm_core_visible_serial(hooks->wm)) {
+        return false;
+    }
+    // Focus moved by other means since the last step: the ring no longer
+    // mirrors the focus order.
+    const struct fbwl_view *focused_view = hooks->wm->focused != NULL ? hooks->wm->focused->userdata : NULL;
+    return session->last_pick == NULL || session->last_pick == focused_view;
+}
+
+static size_t cycle_session_step_static(struct fbwl_keybindings_cycle_session *session,
+        const struct fbwl_view *focused_view, bool reverse) {
+    const size_t len = session->len;
+    if (session->cursor >= len || session->entries[session->cursor].view != focused_view) {
+        session->cursor = SIZE_MAX;
+        for (size_t i = 0; focused_view != NULL && i < len; i++) {
+            if (session->entries[i].view == focused_view) {
+                session->cursor = i;
+                break;
             }
-            return view;
         }
+    }
+    if (session->cursor == SIZE_MAX) {
+        return reverse ? len - 1 : 0;
+    }
+    return reverse ? (session->cursor + len - 1) % len : (session->cursor + 1) % len;
+}
+
+static size_t cycle_session_step_mru(struct fbwl_keybindings_cycle_session *session,
+        const struct fbwl_view *focused_view, bool reverse) {
+    // NextWindow takes the least recently focused candidate; PrevWindow the
+    // most recent one that is not focused.
+    if (!reverse) {
+        return session->entries[session->front].prev;
+    }
+    size_t idx = session->front;
+    if (session->entries[idx].view == focused_view && session->len > 1) {
+        idx = session->entries[idx].next;
+    }
+    return session->entries[idx].view != focused_view ? idx : SIZE_MAX;
+}
+
+static void cycle_session_move_front(struct fbwl_keybindings_cycle_session *session, size_t idx) {
+    if (idx == session->front) {
+        return;
+    }
+    struct fbwl_keybindings_cycle_entry *entries = session->entries;
+    entries[entries[idx].prev].next = entries[idx].next;
+    entries[entries[idx].next].prev = entries[idx].prev;
+    const size_t tail = entries[session->front].prev;
+    entries[idx].prev = tail;
+    entries[idx].next = session->front;
+    entries[tail].next = idx;
+    entries[session->front].prev = idx;
+    session->front = idx;
+}
+
+static struct fbwl_view *pick_cycle_candidate(const struct fbwl_keybindings_hooks *hooks, bool reverse, bool groups,
+        bool static_order, const char *pattern, const struct fbwl_iconbar_pattern *pat) {
+    if (hooks == NULL || hooks->wm == NULL || pat == NULL) {
         return NULL;
     }
-    for (struct fbwm_view *wm_view = hooks->wm->views.prev; wm_view != &hooks->wm->views; wm_view = wm_view->prev) {
-        if (!fbwm_core_view_is_visible(hooks->wm, wm_view)) {
-            continue;
+    struct fbwl_keybindings_cycle_session scratch = {0};
+    struct fbwl_keybindings_cycle_session *session = hooks->cycle_session != NULL ? hooks->cycle_session : &scratch;
+    const struct fbwl_view *focused_view = hooks->wm->focused != NULL ? hooks->wm->focused->userdata : NULL;
+
+    struct fbwl_view *pick = NULL;
+    for (int attempt = 0; attempt < 2 && pick == NULL; attempt++) {
+        if (attempt > 0 || !cycle_session_valid(session, hooks, groups, static_order, pattern)) {
+            if (!cycle_session_build(session, hooks, groups, static_order, pattern, pat)) {
+                fbwl_keybindings_cycle_session_end(session);
+                return NULL;
+            }
         }
-        struct fbwl_view *view = wm_view->userdata;
-        if (view == NULL) {
-            continue;
+        if (session->len == 0) {
+            break;
         }
-        if (groups && !fbwl_tabs_view_is_active(view)) {
-            continue;
+        const size_t idx = static_order ? cycle_session_step_static(session, focused_view, reverse) :
+            cycle_session_step_mru(session, focused_view, reverse);
+        if (idx == SIZE_MAX) {
+            break;
         }
-        if (!cycle_pattern_matches(pat, view, hooks)) {
+        // Minimizing or moving a window does not touch the wmcore serial;
+        // a stale pick forces a fresh snapshot.
+        struct fbwl_view *view = session->entries[idx].view;
+        if (!fbwm_core_view_is_visible(hooks->wm, &view->wm_view)) {
             continue;
         }
-        return view;
+        pick = view;
+        if (static_order) {
+            session->cursor = idx;
+        } else {
+            cycle_session_move_front(session, idx);
+        }
     }
-    return NULL;
+
+    session->last_pick = pick;
+    if (session == &scratch) {
+        fbwl_keybindings_cycle_session_end(&scratch);
+    }
+    return pick;
 }
 
 struct fbwl_view *fbwl_keybindings_pick_cycle_candidate(const struct fbwl_keybindings_hooks *hooks, bool reverse,
         bool groups, bool static_order, char *pattern) {
+    const char *key = pattern != NULL ? pattern : "";
+    char *key_copy = strdup(key);
+    if (key_copy == NULL) {
+        return NULL;
+    }
     struct fbwl_iconbar_pattern pat = {0};
     fbwl_iconbar_pattern_parse_inplace(&pat, pattern);
-    struct fbwl_view *pick = pick_cycle_candidate(hooks, reverse, groups, static_order, &pat);
+    struct fbwl_view *pick = pick_cycle_candidate(hooks, reverse, groups, static_order, key_copy, &pat);
     fbwl_iconbar_pattern_free(&pat);
+    free(key_copy);
     return pick;
 }
 
@@ -226,101 +306,28 @@ static struct fbwl_view *pick_goto_candidate(const struct fbwl_keybindings_hooks
     int remaining = num;
 
     if (static_order) {
-        struct fbwl_view **candidates = NULL;
-        size_t candidates_len = 0;
-        size_t candidates_cap = 0;
-
-        for (struct fbwm_view *wm_view = hooks->wm->views.next; wm_view != &hooks->wm->views; wm_view = wm_view->next) {
-            if (!fbwm_core_view_is_visible(hooks->wm, wm_view)) {
-                continue;
-            }
-            struct fbwl_view *view = wm_view->userdata;
-            if (view == NULL) {
-                continue;
-            }
-            if (groups && !fbwl_tabs_view_is_active(view)) {
-                continue;
-            }
-            if (!cycle_pattern_matches(pat, view, hooks)) {
-                continue;
-            }
-            if (candidates_len >= candidates_cap) {
-                const size_t new_cap = candidates_cap > 0 ? candidates_cap * 2 : 16;
-                struct fbwl_view **tmp = realloc(candidates, new_cap * sizeof(*tmp));
-                if (tmp == NULL) {
-                    free(candidates);
-                    return NULL;
-                }
-                candidates = tmp;
-                candidates_cap = new_cap;
-            }
-            candidates[candidates_len++] = view;
-        }
-
-        if (candidates_len == 0) {
-            free(candidates);
-            return NULL;
-        }
-
-        qsort(candidates, candidates_len, sizeof(*candidates), view_create_seq_cmp);
-
-        if (reverse) {
-            for (size_t i = candidates_len; i > 0 && remaining > 0; i--) {
-                pick = candidates[i - 1];
-                remaining--;
-            }
-        } else {
-            for (size_t i = 0; i < candidates_len && remaining > 0; i++) {
-                pick = candidates[i];
-                remaining--;
-            }
-        }
-
-        free(candidates);
-        return pick;
-    }
-
-    if (reverse) {
-        for (struct fbwm_view *wm_view = hooks->wm->views.prev; wm_view != &hooks->wm->views && remaining > 0;
-                wm_view = wm_view->prev) {
-            if (!fbwm_core_view_is_visible(hooks->wm, wm_view)) {
+        const struct fbwm_view *created = fbwm_core_creation_list(hooks->wm);
+        for (struct fbwm_view *wm_view = reverse ? created->create_prev : created->create_next;
+                wm_view != created && remaining > 0;
+                wm_view = reverse ? wm_view->create_prev : wm_view->create_next) {
+            if (!fbwm_core_view_is_visible(hooks->wm, wm_view) || !cycle_candidate_ok(hooks, wm_view, groups, pat)) {
                 continue;
             }
-            struct fbwl_view *view = wm_view->userdata;
-            if (view == NULL) {
-                continue;
-            }
-            if (groups && !fbwl_tabs_view_is_active(view)) {
-                continue;
-            }
-            if (!cycle_pattern_matches(pat, view, hooks)) {
-                continue;
-            }
-            pick = view;
+            pick = wm_view->userdata;
             remaining--;
         }
         return pick;
     }
 
-    for (struct fbwm_view *wm_view = hooks->wm->views.next; wm_view != &hooks->wm->views && remaining > 0;
-            wm_view = wm_view->next) {
-        if (!fbwm_core_view_is_visible(hooks->wm, wm_view)) {
-            continue;
-        }
-        struct fbwl_view *view = wm_view->userdata;
-        if (view == NULL) {
-            continue;
-        }
-        if (groups && !fbwl_tabs_view_is_active(view)) {
-            continue;
-        }
-        if (!cycle_pattern_matches(pat, view, hooks)) {
+    struct fbwm_visible_iter iter;
+    fbwm_core_visible_iter_init(hooks->wm, &iter, reverse);
+    for (struct fbwm_view *wm_view; remaining > 0 && (wm_view = fbwm_core_visible_iter_next(&iter)) != NULL;) {
+        if (!cycle_candidate_ok(hooks, wm_view, groups, pat)) {
             continue;
         }
-        pick = view;
+        pick = wm_view->userdata;
         remaining--;
     }
-
     return pick;
 }
 
@@ -365,10 +372,9 @@ struct fbwl_view *fbwl_keybindings_pick_dir_focus_candidate(const struct fbwl_ke
     int exposure = 0;
     uint64_t found_seq = 0;
 
-    for (struct fbwm_view *wm_view = hooks->wm->views.next; wm_view != &hooks->wm->views; wm_view = wm_view->next) {
-        if (!fbwm_core_view_is_visible(hooks->wm, wm_view)) {
-            continue;
-        }
+    struct fbwm_visible_iter iter;
+    fbwm_core_visible_iter_init(hooks->wm, &iter, false);
+    for (struct fbwm_view *wm_view; (wm_view = fbwm_core_visible_iter_next(&iter)) != NULL;) {
         struct fbwl_view *view = wm_view->userdata;
         if (view == NULL || view == reference) {
             continue;
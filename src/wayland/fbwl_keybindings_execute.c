@@ -817,7 +817,7 @@ static bool execute_action_depth(enum fbwl_keybinding_action action, int arg, co
         return true;
     case FBWL_KEYBIND_TOGGLE_STICK:
         if (view != NULL) {
-            view->wm_view.sticky = !view->wm_view.sticky;
+            fbwm_core_view_set_sticky(hooks->wm, &view->wm_view, !view->wm_view.sticky);
             wlr_log(WLR_INFO, "Stick: %s %s", fbwl_view_display_title(view), view->wm_view.sticky ? "on" : "off");
             if (hooks->apply_workspace_visibility != NULL) {
                 hooks->apply_workspace_visibility(hooks->userdata, view->wm_view.sticky ? "stick-on" : "stick-off");
@@ -826,7 +826,7 @@ static bool execute_action_depth(enum fbwl_keybinding_action action, int arg, co
         return true;
     case FBWL_KEYBIND_STICK_ON:
         if (view != NULL && !view->wm_view.sticky) {
-            view->wm_view.sticky = true;
+            fbwm_core_view_set_sticky(hooks->wm, &view->wm_view, true);
             wlr_log(WLR_INFO, "Stick: %s on", fbwl_view_display_title(view));
             if (hooks->apply_workspace_visibility != NULL) {
                 hooks->apply_workspace_visibility(hooks->userdata, "stick-on");
@@ -835,7 +835,7 @@ static bool execute_action_depth(enum fbwl_keybinding_action action, int arg, co
         return true;
     case FBWL_KEYBIND_STICK_OFF:
         if (view != NULL && view->wm_view.sticky) {
-            view->wm_view.sticky = false;
+            fbwm_core_view_set_sticky(hooks->wm, &view->wm_view, false);
             wlr_log(WLR_INFO, "Stick: %s off", fbwl_view_display_title(view));
             if (hooks->apply_workspace_visibility != NULL) {
                 hooks->apply_workspace_visibility(hooks->userdata, "stick-off");
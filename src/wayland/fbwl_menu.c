@@ -72,6 +72,49 @@ struct fbwl_menu *fbwl_menu_create(const char *label) {
     return menu;
 }
 
+bool fbwl_menu_append_copy(struct fbwl_menu *dst, const struct fbwl_menu *src) {
+    if (dst == NULL || src == NULL) {
+        return false;
+    }
+    if (!fbwl_menu_reserve_items(dst, src->item_count)) {
+        return false;
+    }
+    for (size_t i = 0; i < src->item_count; i++) {
+        const struct fbwl_menu_item *from = &src->items[i];
+        struct fbwl_menu_item *it = &dst->items[dst->item_count];
+        *it = *from;
+        it->label = from->label != NULL ? strdup(from->label) : NULL;
+        it->cmd = from->cmd != NULL ? strdup(from->cmd) : NULL;
+        it->icon = from->icon != NULL ? strdup(from->icon) : NULL;
+        it->submenu = from->submenu != NULL ? fbwl_menu_clone(from->submenu) : NULL;
+        if ((from->label != NULL && it->label == NULL) || (from->cmd != NULL && it->cmd == NULL) ||
+                (from->icon != NULL && it->icon == NULL) || (from->submenu != NULL && it->submenu == NULL)) {
+            free(it->label);
+            free(it->cmd);
+            free(it->icon);
+            fbwl_menu_free(it->submenu);
+            return false;
+        }
+        dst->item_count++;
+    }
+    return true;
+}
+
+struct fbwl_menu *fbwl_menu_clone(const struct fbwl_menu *menu) {
+    if (menu == NULL) {
+        return NULL;
+    }
+    struct fbwl_menu *copy = fbwl_menu_create(menu->label);
+    if (copy == NULL) {
+        return NULL;
+    }
+    if (!fbwl_menu_append_copy(copy, menu)) {
+        fbwl_menu_free(copy);
+        return NULL;
+    }
+    return copy;
+}
+
 bool fbwl_menu_add_exec(struct fbwl_menu *menu, const char *label, const char *cmd, const char *icon) {
     if (menu == NULL || cmd == NULL || *cmd == '\0') {
         return false;
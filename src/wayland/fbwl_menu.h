@@ -113,6 +113,9 @@ struct fbwl_menu {
 
 struct fbwl_menu *fbwl_menu_create(const char *label);
 void fbwl_menu_free(struct fbwl_menu *menu);
+// Deep copies; on failure dst keeps the items copied so far.
+struct fbwl_menu *fbwl_menu_clone(const struct fbwl_menu *menu);
+bool fbwl_menu_append_copy(struct fbwl_menu *dst, const struct fbwl_menu *src);
 
 bool fbwl_menu_add_exec(struct fbwl_menu *menu, const char *label, const char *cmd, const char *icon);
 bool fbwl_menu_add_exit(struct fbwl_menu *menu, const char *label, const char *icon);
@@ -0,0 +1,263 @@
+#include "wayland/fbwl_menu_cache.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+
+#include <wlr/util/log.h>
+
+#include "wayland/fbwl_menu.h"
+#include "wayland/fbwl_menu_parse.h"
+#include "wmcore/fbwm_core.h"
+
+enum {
+    MENU_CACHE_MAX_ENTRIES = 8,
+};
+
+struct menu_cache_dep {
+    char *path;
+    bool exists;
+    dev_t dev;
+    ino_t ino;
+    off_t size;
+    struct timespec mtime;
+};
+
+struct fbwl_menu_cache_entry {
+    char *path;
+    struct fbwl_menu *menu;
+    struct menu_cache_dep *deps;
+    size_t deps_len;
+    size_t deps_cap;
+    char *workspaces;
+    uint64_t used;
+};
+
+struct menu_cache_record {
+    struct fbwl_menu_cache_entry *entry;
+    bool failed;
+    void (*on_source)(void *userdata, const char *path);
+    void *userdata;
+};
+
+static void dep_stat(struct menu_cache_dep *dep, const char *path) {
+    struct stat st;
+    dep->exists = stat(path, &st) == 0;
+    if (!dep->exists) {
+        return;
+    }
+    dep->dev = st.st_dev;
+    dep->ino = st.st_ino;
+    dep->size = st.st_size;
+    dep->mtime = st.st_mtim;
+}
+
+static bool dep_unchanged(const struct menu_cache_dep *dep) {
+    struct menu_cache_dep now = {0};
+    dep_stat(&now, dep->path);
+    if (now.exists != dep->exists) {
+        return false;
+    }
+    return !now.exists || (now.dev == dep->dev && now.ino == dep->ino && now.size == dep->size &&
+        now.mtime.tv_sec == dep->mtime.tv_sec && now.mtime.tv_nsec == dep->mtime.tv_nsec);
+}
+
+// "count\nname\nname..." for the workspace list [workspaces] expands.
+static char *workspaces_snapshot(struct fbwm_core *wm) {
+    if (wm == NULL) {
+        return NULL;
+    }
+    const int count = fbwm_core_workspace_count(wm);
+    size_t len = 16;
+    for (int i = 0; i < count; i++) {
+        const char *name = fbwm_core_workspace_name(wm, i);
+        len += (name != NULL ? strlen(name) : 0) + 1;
+    }
+    char *out = malloc(len);
+    if (out == NULL) {
+        return NULL;
+    }
+    size_t off = (size_t)snprintf(out, len, "%d", count);
+    for (int i = 0; i < count; i++) {
+        const char *name = fbwm_core_workspace_name(wm, i);
+        off += (size_t)snprintf(out + off, len - off, "\n%s", name != NULL ? name : "");
+    }
+    return out;
+}
+
+static void entry_clear(struct fbwl_menu_cache_entry *entry) {
+    free(entry->path);
+    fbwl_menu_free(entry->menu);
+    for (size_t i = 0; i < entry->deps_len; i++) {
+        free(entry->deps[i].path);
+    }
+    free(entry->deps);
+    free(entry->workspaces);
+    memset(entry, 0, sizeof(*entry));
+}
+
+static bool entry_valid(const struct fbwl_menu_cache_entry *entry, struct fbwm_core *wm) {
+    for (size_t i = 0; i < entry->deps_len; i++) {
+        if (!dep_unchanged(&entry->deps[i])) {
+            return false;
+        }
+    }
+    if (entry->workspaces == NULL) {
+        return true;
+    }
+    char *now = workspaces_snapshot(wm);
+    const bool same = now != NULL && strcmp(now, entry->workspaces) == 0;
+    free(now);
+    return same;
+}
+
+static void record_source(void *userdata, const char *path) {
+    struct menu_cache_record *rec = userdata;
+    if (rec->on_source != NULL) {
+        rec->on_source(rec->userdata, path);
+    }
+    struct fbwl_menu_cache_entry *entry = rec->entry;
+    if (rec->failed || path == NULL || *path == '\0') {
+        return;
+    }
+    if (entry->deps_len == entry->deps_cap) {
+        const size_t cap = entry->deps_cap > 0 ? entry->deps_cap * 2 : 8;
+        struct menu_cache_dep *grown = realloc(entry->deps, cap * sizeof(*grown));
+        if (grown == NULL) {
+            rec->failed = true;
+            return;
+        }
+        entry->deps = grown;
+        entry->deps_cap = cap;
+    }
+    struct menu_cache_dep *dep = &entry->deps[entry->deps_len];
+    memset(dep, 0, sizeof(*dep));
+    dep->path = strdup(path);
+    if (dep->path == NULL) {
+        rec->failed = true;
+        return;
+    }
+    // Stat before the parse reads it: a later edit always changes what we saw.
+    dep_stat(dep, path);
+    entry->deps_len++;
+}
+
+static struct fbwl_menu_cache_entry *cache_find(struct fbwl_menu_cache *cache, const char *path) {
+    for (size_t i = 0; i < cache->entries_len; i++) {
+        struct fbwl_menu_cache_entry *entry = &cache->entries[i];
+        if (entry->path != NULL && strcmp(entry->path, path) == 0) {
+            return entry;
+        }
+    }
+    return NULL;
+}
+
+// Keeps the entries dense so lookups stay a linear scan.
+static void cache_drop(struct fbwl_menu_cache *cache, struct fbwl_menu_cache_entry *entry) {
+    entry_clear(entry);
+    *entry = cache->entries[--cache->entries_len];
+    memset(&cache->entries[cache->entries_len], 0, sizeof(*entry));
+}
+
+static struct fbwl_menu_cache_entry *cache_slot(struct fbwl_menu_cache *cache) {
+    if (cache->entries == NULL) {
+        cache->entries = calloc(MENU_CACHE_MAX_ENTRIES, sizeof(*cache->entries));
+        if (cache->entries == NULL) {
+            return NULL;
+        }
+    }
+    if (cache->entries_len < MENU_CACHE_MAX_ENTRIES) {
+        return &cache->entries[cache->entries_len++];
+    }
+    struct fbwl_menu_cache_entry *oldest = &cache->entries[0];
+    for (size_t i = 1; i < cache->entries_len; i++) {
+        if (cache->entries[i].used < oldest->used) {
+            oldest = &cache->entries[i];
+        }
+    }
+    entry_clear(oldest);
+    return oldest;
+}
+
+static bool cache_fill_from(struct fbwl_menu_cache_entry *entry, struct fbwl_menu *root,
+        void (*on_source)(void *userdata, const char *path), void *userdata) {
+    if (on_source != NULL) {
+        for (size_t i = 0; i < entry->deps_len; i++) {
+            on_source(userdata, entry->deps[i].path);
+        }
+    }
+    if (entry->menu->label != NULL) {
+        char *label = strdup(entry->menu->label);
+        if (label == NULL) {
+            return false;
+        }
+        free(root->label);
+        root->label = label;
+    }
+    return fbwl_menu_append_copy(root, entry->menu);
+}
+
+bool fbwl_menu_cache_parse_file(struct fbwl_menu_cache *cache, struct fbwl_menu *root,
+        struct fbwm_core *wm, const char *path,
+        void (*on_source)(void *userdata, const char *path), void *userdata) {
+    if (root == NULL || path == NULL || *path == '\0') {
+        return false;
+    }
+    if (cache == NULL || root->item_count > 0) {
+        return fbwl_menu_parse_file_sources(root, wm, path, on_source, userdata);
+    }
+
+    struct fbwl_menu_cache_entry *entry = cache_find(cache, path);
+    if (entry != NULL) {
+        if (entry_valid(entry, wm)) {
+            entry->used = ++cache->tick;
+            cache->hits++;
+            wlr_log(WLR_INFO, "Menu: cache hit path=%s deps=%zu", path, entry->deps_len);
+            return cache_fill_from(entry, root, on_source, userdata);
+        }
+        cache_drop(cache, entry);
+    }
+
+    struct fbwl_menu_cache_entry fresh = {0};
+    struct menu_cache_record rec = {
+        .entry = &fresh,
+        .on_source = on_source,
+        .userdata = userdata,
+    };
+    bool used_workspaces = false;
+    cache->misses++;
+    if (!fbwl_menu_parse_file_deps(root, wm, path, record_source, &rec, &used_workspaces)) {
+        entry_clear(&fresh);
+        return false;
+    }
+
+    fresh.path = strdup(path);
+    fresh.menu = fbwl_menu_clone(root);
+    fresh.workspaces = used_workspaces ? workspaces_snapshot(wm) : NULL;
+    if (rec.failed || fresh.path == NULL || fresh.menu == NULL || (used_workspaces && fresh.workspaces == NULL)) {
+        entry_clear(&fresh);
+        return true;
+    }
+    entry = cache_slot(cache);
+    if (entry == NULL) {
+        entry_clear(&fresh);
+        return true;
+    }
+    fresh.used = ++cache->tick;
+    *entry = fresh;
+    wlr_log(WLR_DEBUG, "Menu: cached path=%s deps=%zu workspaces=%d", path, entry->deps_len,
+        used_workspaces ? 1 : 0);
+    return true;
+}
+
+void fbwl_menu_cache_finish(struct fbwl_menu_cache *cache) {
+    if (cache == NULL) {
+        return;
+    }
+    for (size_t i = 0; i < cache->entries_len; i++) {
+        entry_clear(&cache->entries[i]);
+    }
+    free(cache->entries);
+    memset(cache, 0, sizeof(*cache));
+}
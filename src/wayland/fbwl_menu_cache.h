@@ -0,0 +1,28 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+struct fbwm_core;
+struct fbwl_menu;
+struct fbwl_menu_cache_entry;
+
+// Parsed menus keyed by top-level path. An entry is reused while every file
+// and directory its parse read ([include] targets, style and wallpaper dirs)
+// stats the same and, for menus listing [workspaces], the names still match.
+struct fbwl_menu_cache {
+    struct fbwl_menu_cache_entry *entries;
+    size_t entries_len;
+    uint64_t tick;
+    uint64_t hits;
+    uint64_t misses;
+};
+
+// Fills an empty `root` from the cache or by parsing `path`, reporting the
+// same sources as fbwl_menu_parse_file_sources() either way.
+bool fbwl_menu_cache_parse_file(struct fbwl_menu_cache *cache, struct fbwl_menu *root,
+    struct fbwm_core *wm, const char *path,
+    void (*on_source)(void *userdata, const char *path), void *userdata);
+
+void fbwl_menu_cache_finish(struct fbwl_menu_cache *cache);
@@ -18,11 +18,21 @@ enum {
     MENU_MAX_INCLUDE_DEPTH = 8,
 };
 
-static bool menu_add_styles_from_dir(struct fbwl_menu *menu, const char *dir_path, const char *icon) {
+static void menu_note_source(struct fbwl_menu_parse_state *st, const char *path) {
+    if (st != NULL && st->on_source != NULL) {
+        st->on_source(st->on_source_userdata, path);
+    }
+}
+
+static bool menu_add_styles_from_dir(struct fbwl_menu_parse_state *st, struct fbwl_menu *menu,
+        const char *dir_path, const char *icon) {
     if (menu == NULL || dir_path == NULL || *dir_path == '\0') {
         return false;
     }
 
+    // Entries come from the listing, so the directory itself is a source.
+    menu_note_source(st, dir_path);
+
     struct dirent **namelist = NULL;
     int n = scandir(dir_path, &namelist, NULL, alphasort);
     if (n < 0) {
@@ -57,12 +67,14 @@ static bool menu_add_styles_from_dir(struct fbwl_menu *menu, const char *dir_pat
     return true;
 }
 
-static bool menu_add_wallpapers_from_dir(struct fbwl_menu *menu, const char *dir_path, const char *cmd_base,
-        const char *icon) {
+static bool menu_add_wallpapers_from_dir(struct fbwl_menu_parse_state *st, struct fbwl_menu *menu,
+        const char *dir_path, const char *cmd_base, const char *icon) {
     if (menu == NULL || dir_path == NULL || *dir_path == '\0') {
         return false;
     }
 
+    menu_note_source(st, dir_path);
+
     const bool use_server_action = cmd_base == NULL || *cmd_base == '\0';
     const char *prog = cmd_base != NULL && *cmd_base != '\0' ? cmd_base : "fbsetbg";
 
@@ -425,7 +437,7 @@ static bool menu_parse_file_impl(struct fbwl_menu *stack[16], size_t *depth, siz
             if (raw_dir != NULL && *raw_dir != '\0') {
                 char *resolved = fbwl_menu_parse_resolve_path(base_dir, raw_dir);
                 if (resolved != NULL) {
-                    (void)menu_add_styles_from_dir(cur, resolved, icon);
+                    (void)menu_add_styles_from_dir(st, cur, resolved, icon);
                     free(resolved);
                 }
             }
@@ -465,7 +477,7 @@ static bool menu_parse_file_impl(struct fbwl_menu *stack[16], size_t *depth, siz
                     struct fbwl_menu *submenu = fbwl_menu_create(submenu_label);
                     if (submenu != NULL) {
                         if (fbwl_menu_add_submenu(cur, submenu_label, submenu, icon)) {
-                            (void)menu_add_styles_from_dir(submenu, resolved, NULL);
+                            (void)menu_add_styles_from_dir(st, submenu, resolved, NULL);
                         } else {
                             fbwl_menu_free(submenu);
                         }
@@ -475,7 +487,7 @@ static bool menu_parse_file_impl(struct fbwl_menu *stack[16], size_t *depth, siz
             } else if (label != NULL && *label != '\0') {
                 char *resolved = fbwl_menu_parse_resolve_path(base_dir, label);
                 if (resolved != NULL) {
-                    (void)menu_add_styles_from_dir(cur, resolved, icon);
+                    (void)menu_add_styles_from_dir(st, cur, resolved, icon);
                     free(resolved);
                 }
             }
@@ -504,7 +516,7 @@ static bool menu_parse_file_impl(struct fbwl_menu *stack[16], size_t *depth, siz
             if (raw_dir != NULL && *raw_dir != '\0') {
                 char *resolved = fbwl_menu_parse_resolve_path(base_dir, raw_dir);
                 if (resolved != NULL) {
-                    (void)menu_add_wallpapers_from_dir(cur, resolved, cmd, icon);
+                    (void)menu_add_wallpapers_from_dir(st, cur, resolved, cmd, icon);
                     free(resolved);
                 }
             }
@@ -533,6 +545,9 @@ static bool menu_parse_file_impl(struct fbwl_menu *stack[16], size_t *depth, siz
                     if (wm == NULL) {
                         wlr_log(WLR_ERROR, "Menu: ignoring [workspaces] without wm context");
                     } else {
+                        if (st != NULL) {
+                            st->used_workspaces = true;
+                        }
                         const int count = fbwm_core_workspace_count(wm);
                         for (int i = 0; i < count; i++) {
                             const char *name = fbwm_core_workspace_name(wm, i);
@@ -704,6 +719,8 @@ static bool menu_parse_path(struct fbwl_menu *stack[16], size_t *depth, size_t m
         return false;
     }
 
+    menu_note_source(st, path);
+
     if (fbwl_menu_parse_stat_is_dir(path)) {
         return menu_parse_dir(stack, depth, min_depth, st, wm, path, include_depth);
     }
@@ -719,6 +736,16 @@ static bool menu_parse_path(struct fbwl_menu *stack[16], size_t *depth, size_t m
 }
 
 bool fbwl_menu_parse_file(struct fbwl_menu *root, struct fbwm_core *wm, const char *path) {
+    return fbwl_menu_parse_file_sources(root, wm, path, NULL, NULL);
+}
+
+bool fbwl_menu_parse_file_sources(struct fbwl_menu *root, struct fbwm_core *wm, const char *path,
+        void (*on_source)(void *userdata, const char *path), void *userdata) {
+    return fbwl_menu_parse_file_deps(root, wm, path, on_source, userdata, NULL);
+}
+
+bool fbwl_menu_parse_file_deps(struct fbwl_menu *root, struct fbwm_core *wm, const char *path,
+        void (*on_source)(void *userdata, const char *path), void *userdata, bool *used_workspaces) {
     if (root == NULL || path == NULL || *path == '\0') {
         return false;
     }
@@ -726,8 +753,14 @@ bool fbwl_menu_parse_file(struct fbwl_menu *root, struct fbwm_core *wm, const ch
     struct fbwl_menu *stack[16] = {0};
     size_t depth = 0;
     stack[0] = root;
-    struct fbwl_menu_parse_state st = {0};
+    struct fbwl_menu_parse_state st = {
+        .on_source = on_source,
+        .on_source_userdata = userdata,
+    };
     bool ok = menu_parse_path(stack, &depth, 0, &st, wm, path, 0, true);
+    if (used_workspaces != NULL) {
+        *used_workspaces = st.used_workspaces;
+    }
     fbwl_menu_parse_state_clear(&st);
     return ok;
 }
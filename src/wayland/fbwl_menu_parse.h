@@ -6,3 +6,11 @@ struct fbwm_core;
 struct fbwl_menu;
 
 bool fbwl_menu_parse_file(struct fbwl_menu *root, struct fbwm_core *wm, const char *path);
+// Like fbwl_menu_parse_file(), also reporting every file or directory read,
+// including [include] targets, through on_source.
+bool fbwl_menu_parse_file_sources(struct fbwl_menu *root, struct fbwm_core *wm, const char *path,
+    void (*on_source)(void *userdata, const char *path), void *userdata);
+// Like fbwl_menu_parse_file_sources(), also telling whether the result lists
+// the current workspace names ([workspaces]).
+bool fbwl_menu_parse_file_deps(struct fbwl_menu *root, struct fbwm_core *wm, const char *path,
+    void (*on_source)(void *userdata, const char *path), void *userdata, bool *used_workspaces);
@@ -10,6 +10,9 @@ enum {
 struct fbwl_menu_parse_state {
     char *encoding_stack[FBWL_MENU_PARSE_ENCODING_STACK_MAX];
     size_t encoding_depth;
+    void (*on_source)(void *userdata, const char *path);
+    void *on_source_userdata;
+    bool used_workspaces;
 };
 
 const char *fbwl_menu_parse_state_encoding(const struct fbwl_menu_parse_state *st);
@@ -7,6 +7,8 @@
 #include <wayland-server-core.h>
 #include <wlr/util/box.h>
 
+#include "wayland/fbwl_output_usable.h"
+
 struct wlr_allocator;
 struct wlr_buffer;
 struct wlr_renderer;
@@ -23,9 +25,11 @@ struct fbwl_output {
     struct wl_list link;
     struct wlr_output *wlr_output;
     struct wlr_box usable_area;
+    struct fbwl_output_usable_cache usable_cache;
     struct wlr_scene_rect *background_rect;
     struct wlr_scene_buffer *background_image;
     struct wlr_buffer *wallpaper_tile_buf;
+    struct wlr_box background_box; // layout box the background was last built for
     struct wlr_scene *scene;
 
     fbwl_output_on_destroy_fn on_destroy;
@@ -85,6 +85,12 @@ bool fbwl_output_management_apply_config(struct wlr_backend *backend,
         return true;
     }
 
+    // Place every head before arranging any of them, so layer surfaces and
+    // usable areas are computed once against the final layout. Heads that
+    // keep their position are not re-added: each add is a layout change that
+    // wlroots republishes to xdg-output clients and the scene.
+    size_t enabled = 0;
+    size_t moved = 0;
     struct wlr_output_configuration_head_v1 *head;
     wl_list_for_each(head, &config->heads, link) {
         struct wlr_output *wlr_output = head->state.output;
@@ -92,28 +98,45 @@ bool fbwl_output_management_apply_config(struct wlr_backend *backend,
             continue;
         }
 
-        if (head->state.enabled) {
-            wlr_output_layout_add(output_layout, wlr_output, head->state.x, head->state.y);
-
-            struct wlr_box box = {0};
-            wlr_output_layout_get_box(output_layout, wlr_output, &box);
-            struct fbwl_output *out = fbwl_output_find(outputs, wlr_output);
-            if (out != NULL) {
-                out->usable_area = box;
-            }
-            wlr_log(WLR_INFO, "OutputLayout: name=%s x=%d y=%d w=%d h=%d",
-                wlr_output->name != NULL ? wlr_output->name : "(unnamed)",
-                box.x, box.y, box.width, box.height);
-            if (arrange_layers_on_output != NULL) {
-                arrange_layers_on_output(arrange_layers_userdata, wlr_output);
+        struct wlr_output_layout_output *lo = wlr_output_layout_get(output_layout, wlr_output);
+        if (!head->state.enabled) {
+            if (lo != NULL) {
+                wlr_output_layout_remove(output_layout, wlr_output);
+                moved++;
             }
-        } else {
-            wlr_output_layout_remove(output_layout, wlr_output);
             wlr_log(WLR_INFO, "OutputLayout: name=%s removed",
                 wlr_output->name != NULL ? wlr_output->name : "(unnamed)");
+            continue;
+        }
+
+        enabled++;
+        if (lo == NULL || lo->auto_configured || lo->x != head->state.x || lo->y != head->state.y) {
+            wlr_output_layout_add(output_layout, wlr_output, head->state.x, head->state.y);
+            moved++;
+        }
+    }
+
+    wl_list_for_each(head, &config->heads, link) {
+        struct wlr_output *wlr_output = head->state.output;
+        if (wlr_output == NULL || !head->state.enabled) {
+            continue;
+        }
+
+        struct wlr_box box = {0};
+        wlr_output_layout_get_box(output_layout, wlr_output, &box);
+        struct fbwl_output *out = fbwl_output_find(outputs, wlr_output);
+        if (out != NULL) {
+            out->usable_area = box;
+        }
+        wlr_log(WLR_INFO, "OutputLayout: name=%s x=%d y=%d w=%d h=%d",
+            wlr_output->name != NULL ? wlr_output->name : "(unnamed)",
+            box.x, box.y, box.width, box.height);
+        if (arrange_layers_on_output != NULL) {
+            arrange_layers_on_output(arrange_layers_userdata, wlr_output);
         }
     }
 
+    wlr_log(WLR_INFO, "OutputMgmt: applied heads=%zu enabled=%zu relayout=%zu", states_len, enabled, moved);
     return true;
 }
 
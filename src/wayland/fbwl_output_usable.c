@@ -0,0 +1,261 @@
+#include "wayland/fbwl_output_usable.h"
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <wlr/types/wlr_output_layout.h>
+#include <wlr/util/box.h>
+
+#include "wayland/fbwl_output.h"
+#include "wayland/fbwl_screen_map.h"
+#include "wayland/fbwl_server_internal.h"
+
+static void apply_toolbar_strut_box(const struct fbwl_server *server, struct wlr_output_layout *output_layout,
+        struct wl_list *outputs, struct wlr_output *output, struct wlr_box *box) {
+    if (server == NULL || output_layout == NULL || outputs == NULL || output == NULL || box == NULL) {
+        return;
+    }
+    if (box->width < 1 || box->height < 1) {
+        return;
+    }
+    if (!server->toolbar_ui.enabled || server->toolbar_ui.max_over || server->toolbar_ui.auto_hide) { return; }
+    const size_t on_head = server->toolbar_ui.on_head >= 0 ? (size_t)server->toolbar_ui.on_head : 0;
+    struct wlr_output *toolbar_out = fbwl_screen_map_output_for_screen(output_layout, outputs, on_head);
+    if (toolbar_out == NULL || toolbar_out != output) {
+        return;
+    }
+    int thickness = server->toolbar_ui.thickness;
+    if (thickness < 1) {
+        thickness = server->toolbar_ui.height_override;
+        if (thickness <= 0) {
+            thickness = server->decor_theme.toolbar_height > 0 ? server->decor_theme.toolbar_height :
+                (server->decor_theme.title_height > 0 ? server->decor_theme.title_height : 24);
+        }
+    }
+    if (thickness < 1) thickness = 1;
+    int border_w = server->decor_theme.toolbar_border_width;
+    if (border_w < 0) border_w = 0;
+    if (border_w > 20) border_w = 20;
+    int bevel_w = server->decor_theme.toolbar_bevel_width;
+    if (bevel_w < 0) bevel_w = 0;
+    if (bevel_w > 20) bevel_w = 20;
+    int t = thickness + 2 * bevel_w + 2 * border_w;
+    if (t < 1) return;
+    switch (server->toolbar_ui.placement) {
+    case FBWL_TOOLBAR_PLACEMENT_TOP_LEFT:
+    case FBWL_TOOLBAR_PLACEMENT_TOP_CENTER:
+    case FBWL_TOOLBAR_PLACEMENT_TOP_RIGHT:
+        if (box->height <= t) {
+            box->height = 0;
+            return;
+        }
+        box->y += t;
+        box->height -= t;
+        break;
+    case FBWL_TOOLBAR_PLACEMENT_BOTTOM_LEFT:
+    case FBWL_TOOLBAR_PLACEMENT_BOTTOM_CENTER:
+    case FBWL_TOOLBAR_PLACEMENT_BOTTOM_RIGHT:
+        if (box->height <= t) {
+            box->height = 0;
+            return;
+        }
+        box->height -= t;
+        break;
+    case FBWL_TOOLBAR_PLACEMENT_LEFT_BOTTOM:
+    case FBWL_TOOLBAR_PLACEMENT_LEFT_CENTER:
+    case FBWL_TOOLBAR_PLACEMENT_LEFT_TOP:
+        if (box->width <= t) {
+            box->width = 0;
+            return;
+        }
+        box->x += t;
+        box->width -= t;
+        break;
+    case FBWL_TOOLBAR_PLACEMENT_RIGHT_BOTTOM:
+    case FBWL_TOOLBAR_PLACEMENT_RIGHT_CENTER:
+    case FBWL_TOOLBAR_PLACEMENT_RIGHT_TOP:
+        if (box->width <= t) {
+            box->width = 0;
+            return;
+        }
+        box->width -= t;
+        break;
+    }
+}
+
+static void apply_slit_strut_box(const struct fbwl_server *server, struct wlr_output_layout *output_layout,
+        struct wl_list *outputs, struct wlr_output *output, struct wlr_box *box) {
+    if (server == NULL || output_layout == NULL || outputs == NULL || output == NULL || box == NULL) {
+        return;
+    }
+    if (box->width < 1 || box->height < 1) {
+        return;
+    }
+    if (!server->slit_ui.enabled || server->slit_ui.max_over || server->slit_ui.auto_hide) {
+        return;
+    }
+
+    const size_t on_head = server->slit_ui.on_head >= 0 ? (size_t)server->slit_ui.on_head : 0;
+    struct wlr_output *slit_out = fbwl_screen_map_output_for_screen(output_layout, outputs, on_head);
+    if (slit_out == NULL || slit_out != output) {
+        return;
+    }
+
+    const enum fbwl_toolbar_placement placement = server->slit_ui.placement;
+    const int t = placement == FBWL_TOOLBAR_PLACEMENT_LEFT_BOTTOM || placement == FBWL_TOOLBAR_PLACEMENT_LEFT_CENTER ||
+            placement == FBWL_TOOLBAR_PLACEMENT_LEFT_TOP || placement == FBWL_TOOLBAR_PLACEMENT_RIGHT_BOTTOM ||
+            placement == FBWL_TOOLBAR_PLACEMENT_RIGHT_CENTER || placement == FBWL_TOOLBAR_PLACEMENT_RIGHT_TOP ?
+        server->slit_ui.width : server->slit_ui.height;
+    if (t < 1) {
+        return;
+    }
+    switch (server->slit_ui.placement) {
+    case FBWL_TOOLBAR_PLACEMENT_TOP_LEFT:
+    case FBWL_TOOLBAR_PLACEMENT_TOP_CENTER:
+    case FBWL_TOOLBAR_PLACEMENT_TOP_RIGHT:
+        if (box->height <= t) {
+            box->height = 0;
+            return;
+        }
+        box->y += t;
+        box->height -= t;
+        break;
+    case FBWL_TOOLBAR_PLACEMENT_BOTTOM_LEFT:
+    case FBWL_TOOLBAR_PLACEMENT_BOTTOM_CENTER:
+    case FBWL_TOOLBAR_PLACEMENT_BOTTOM_RIGHT:
+        if (box->height <= t) {
+            box->height = 0;
+            return;
+        }
+        box->height -= t;
+        break;
+    case FBWL_TOOLBAR_PLACEMENT_LEFT_BOTTOM:
+    case FBWL_TOOLBAR_PLACEMENT_LEFT_CENTER:
+    case FBWL_TOOLBAR_PLACEMENT_LEFT_TOP:
+        if (box->width <= t) {
+            box->width = 0;
+            return;
+        }
+        box->x += t;
+        box->width -= t;
+        break;
+    case FBWL_TOOLBAR_PLACEMENT_RIGHT_BOTTOM:
+    case FBWL_TOOLBAR_PLACEMENT_RIGHT_CENTER:
+    case FBWL_TOOLBAR_PLACEMENT_RIGHT_TOP:
+        if (box->width <= t) {
+            box->width = 0;
+            return;
+        }
+        box->width -= t;
+        break;
+    }
+}
+
+static void apply_configured_struts_box(const struct fbwl_server *server, struct wlr_output_layout *output_layout,
+        struct wl_list *outputs, struct wlr_output *output, struct wlr_box *box) {
+    if (server == NULL || output_layout == NULL || outputs == NULL || output == NULL || box == NULL) {
+        return;
+    }
+    if (box->width < 1 || box->height < 1) {
+        return;
+    }
+
+    bool found = false;
+    const size_t screen = fbwl_screen_map_screen_for_output(output_layout, outputs, output, &found);
+    const struct fbwl_screen_config *cfg = fbwl_server_screen_config(server, found ? screen : 0);
+    if (cfg == NULL) {
+        return;
+    }
+
+    int l = cfg->struts.left_px;
+    int r = cfg->struts.right_px;
+    int t = cfg->struts.top_px;
+    int b = cfg->struts.bottom_px;
+    if (l < 0) { l = 0; }
+    if (r < 0) { r = 0; }
+    if (t < 0) { t = 0; }
+    if (b < 0) { b = 0; }
+
+    const int64_t w = box->width;
+    const int64_t h = box->height;
+    if ((int64_t)l + (int64_t)r >= w || (int64_t)t + (int64_t)b >= h) {
+        box->width = 0;
+        box->height = 0;
+        return;
+    }
+
+    box->x += l;
+    box->y += t;
+    box->width -= l + r;
+    box->height -= t + b;
+}
+
+static void usable_inputs_snapshot(const struct fbwl_server *server, struct fbwl_output_usable_inputs *in) {
+    memset(in, 0, sizeof(*in));
+    if (server == NULL) {
+        return;
+    }
+    in->toolbar_enabled = server->toolbar_ui.enabled;
+    in->toolbar_max_over = server->toolbar_ui.max_over;
+    in->toolbar_auto_hide = server->toolbar_ui.auto_hide;
+    in->toolbar_on_head = server->toolbar_ui.on_head;
+    in->toolbar_placement = (int)server->toolbar_ui.placement;
+    in->toolbar_thickness = server->toolbar_ui.thickness;
+    in->toolbar_height_override = server->toolbar_ui.height_override;
+    in->theme_toolbar_height = server->decor_theme.toolbar_height;
+    in->theme_title_height = server->decor_theme.title_height;
+    in->theme_toolbar_border_width = server->decor_theme.toolbar_border_width;
+    in->theme_toolbar_bevel_width = server->decor_theme.toolbar_bevel_width;
+    in->slit_enabled = server->slit_ui.enabled;
+    in->slit_max_over = server->slit_ui.max_over;
+    in->slit_auto_hide = server->slit_ui.auto_hide;
+    in->slit_on_head = server->slit_ui.on_head;
+    in->slit_placement = (int)server->slit_ui.placement;
+    in->slit_width = server->slit_ui.width;
+    in->slit_height = server->slit_ui.height;
+}
+
+static void usable_compute(const struct fbwl_server *server, struct wlr_output_layout *output_layout,
+        struct wl_list *outputs, struct wlr_output *output, const struct wlr_box *layer_area, struct wlr_box *box) {
+    if (layer_area != NULL && layer_area->width > 0 && layer_area->height > 0) {
+        *box = *layer_area;
+    } else {
+        wlr_output_layout_get_box(output_layout, output, box);
+    }
+    apply_toolbar_strut_box(server, output_layout, outputs, output, box);
+    apply_slit_strut_box(server, output_layout, outputs, output, box);
+    apply_configured_struts_box(server, output_layout, outputs, output, box);
+}
+
+void fbwl_output_usable_box(struct fbwl_server *server, struct wlr_output_layout *output_layout,
+        struct wl_list *outputs, struct wlr_output *output, struct wlr_box *box) {
+    *box = (struct wlr_box){0};
+    if (server == NULL || output_layout == NULL || outputs == NULL || output == NULL) {
+        return;
+    }
+
+    struct fbwl_output *out = fbwl_output_find(outputs, output);
+    if (out == NULL) {
+        usable_compute(server, output_layout, outputs, output, NULL, box);
+        return;
+    }
+
+    struct fbwl_output_usable_cache *cache = &out->usable_cache;
+    struct fbwl_output_usable_inputs inputs;
+    usable_inputs_snapshot(server, &inputs);
+    if (cache->valid && cache->epoch == server->usable_epoch &&
+            wlr_box_equal(&cache->layer_area, &out->usable_area) &&
+            memcmp(&cache->inputs, &inputs, sizeof(inputs)) == 0) {
+        *box = cache->box;
+        return;
+    }
+
+    usable_compute(server, output_layout, outputs, output, &out->usable_area, box);
+    cache->inputs = inputs;
+    cache->layer_area = out->usable_area;
+    cache->box = *box;
+    cache->epoch = server->usable_epoch;
+    cache->valid = true;
+}
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include <wlr/util/box.h>
+
+struct fbwl_server;
+struct wl_list;
+struct wlr_output;
+struct wlr_output_layout;
+
+// Snapshot of everything the toolbar/slit struts are derived from, so a cached
+// box can be validated with one compare instead of re-walking the screen map.
+struct fbwl_output_usable_inputs {
+    int toolbar_enabled;
+    int toolbar_max_over;
+    int toolbar_auto_hide;
+    int toolbar_on_head;
+    int toolbar_placement;
+    int toolbar_thickness;
+    int toolbar_height_override;
+    int theme_toolbar_height;
+    int theme_title_height;
+    int theme_toolbar_border_width;
+    int theme_toolbar_bevel_width;
+    int slit_enabled;
+    int slit_max_over;
+    int slit_auto_hide;
+    int slit_on_head;
+    int slit_placement;
+    int slit_width;
+    int slit_height;
+};
+
+struct fbwl_output_usable_cache {
+    struct fbwl_output_usable_inputs inputs;
+    struct wlr_box layer_area;
+    struct wlr_box box;
+    uint32_t epoch;
+    bool valid;
+
+    // Box the maximized views on this output were last fitted to.
+    struct wlr_box notified;
+    bool notified_valid;
+    bool refit_pending;
+};
+
+// Layer-shell usable area (or the output box) minus toolbar, slit and
+// configured struts. Cached per output: recomputed when the layer area or the
+// strut inputs change, or after server->usable_epoch is bumped (output layout
+// and struts config changes).
+void fbwl_output_usable_box(struct fbwl_server *server, struct wlr_output_layout *output_layout,
+        struct wl_list *outputs, struct wlr_output *output, struct wlr_box *box);
@@ -0,0 +1,111 @@
+#include "wayland/fbwl_perf.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+enum {
+    PERF_SAMPLES = 16384,
+};
+
+// Durations are kept as uint32 ns (~4.2 s); anything longer saturates.
+struct perf_probe_state {
+    uint64_t count;
+    uint32_t samples[PERF_SAMPLES];
+};
+
+static struct perf_probe_state perf_probes[FBWL_PERF_PROBE_COUNT];
+
+static const char *const perf_probe_names[FBWL_PERF_PROBE_COUNT] = {
+    "map",
+    "workspace",
+    "motion",
+    "menu-open",
+    "menu-select",
+    "menu-nav",
+    "title",
+    "ipc",
+};
+
+uint64_t fbwl_perf_now(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+void fbwl_perf_record(enum fbwl_perf_probe probe, uint64_t start_ns) {
+    if ((unsigned)probe >= FBWL_PERF_PROBE_COUNT) {
+        return;
+    }
+    const uint64_t now = fbwl_perf_now();
+    const uint64_t d = now > start_ns ? now - start_ns : 0;
+    struct perf_probe_state *st = &perf_probes[probe];
+    st->samples[st->count % PERF_SAMPLES] = d > UINT32_MAX ? UINT32_MAX : (uint32_t)d;
+    st->count++;
+}
+
+void fbwl_perf_reset(void) {
+    for (size_t i = 0; i < FBWL_PERF_PROBE_COUNT; i++) {
+        perf_probes[i].count = 0;
+    }
+}
+
+static int perf_cmp_u32(const void *a, const void *b) {
+    const uint32_t x = *(const uint32_t *)a;
+    const uint32_t y = *(const uint32_t *)b;
+    return x < y ? -1 : (x > y ? 1 : 0);
+}
+
+// Nearest-rank percentile over sorted samples.
+static uint32_t perf_rank(const uint32_t *sorted, size_t n, unsigned pct) {
+    size_t rank = ((size_t)pct * n + 99) / 100;
+    if (rank < 1) {
+        rank = 1;
+    }
+    return sorted[rank - 1];
+}
+
+bool fbwl_perf_summarize(enum fbwl_perf_probe probe, struct fbwl_perf_summary *out) {
+    if ((unsigned)probe >= FBWL_PERF_PROBE_COUNT || out == NULL) {
+        return false;
+    }
+    const struct perf_probe_state *st = &perf_probes[probe];
+    *out = (struct fbwl_perf_summary){ .count = st->count };
+    const size_t n = st->count < PERF_SAMPLES ? (size_t)st->count : PERF_SAMPLES;
+    if (n == 0) {
+        return false;
+    }
+    uint32_t *sorted = malloc(n * sizeof(*sorted));
+    if (sorted == NULL) {
+        return false;
+    }
+    memcpy(sorted, st->samples, n * sizeof(*sorted));
+    qsort(sorted, n, sizeof(*sorted), perf_cmp_u32);
+    out->samples = n;
+    out->p50_ns = perf_rank(sorted, n, 50);
+    out->p99_ns = perf_rank(sorted, n, 99);
+    out->max_ns = sorted[n - 1];
+    free(sorted);
+    return true;
+}
+
+size_t fbwl_perf_dump(void (*emit)(void *userdata, const char *line), void *userdata) {
+    if (emit == NULL) {
+        return 0;
+    }
+    size_t emitted = 0;
+    for (size_t i = 0; i < FBWL_PERF_PROBE_COUNT; i++) {
+        struct fbwl_perf_summary sum;
+        if (!fbwl_perf_summarize((enum fbwl_perf_probe)i, &sum)) {
+            continue;
+        }
+        char line[192];
+        snprintf(line, sizeof(line), "probe=%s count=%llu samples=%zu p50_us=%.1f p99_us=%.1f max_us=%.1f",
+            perf_probe_names[i], (unsigned long long)sum.count, sum.samples,
+            (double)sum.p50_ns / 1000.0, (double)sum.p99_ns / 1000.0, (double)sum.max_ns / 1000.0);
+        emit(userdata, line);
+        emitted++;
+    }
+    return emitted;
+}
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Compositor-side latency probes. Each one keeps the most recent handler
+// durations so benchmarks can read percentiles over IPC ("perf-stats")
+// instead of timing from the client side of the socket.
+enum fbwl_perf_probe {
+    FBWL_PERF_MAP = 0,
+    FBWL_PERF_WORKSPACE,
+    FBWL_PERF_MOTION,
+    FBWL_PERF_MENU_OPEN,
+    FBWL_PERF_MENU_SELECT,
+    FBWL_PERF_MENU_NAV,
+    FBWL_PERF_TITLE,
+    FBWL_PERF_IPC,
+    FBWL_PERF_PROBE_COUNT,
+};
+
+struct fbwl_perf_summary {
+    uint64_t count;
+    size_t samples;
+    uint64_t p50_ns;
+    uint64_t p99_ns;
+    uint64_t max_ns;
+};
+
+uint64_t fbwl_perf_now(void);
+void fbwl_perf_record(enum fbwl_perf_probe probe, uint64_t start_ns);
+void fbwl_perf_reset(void);
+
+// Percentiles over the retained samples; false when the probe has none.
+bool fbwl_perf_summarize(enum fbwl_perf_probe probe, struct fbwl_perf_summary *out);
+
+// One "probe=NAME count=... p50_us=... p99_us=... max_us=..." line per probe
+// with samples; returns the number emitted.
+size_t fbwl_perf_dump(void (*emit)(void *userdata, const char *line), void *userdata);
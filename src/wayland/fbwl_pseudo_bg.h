@@ -1,6 +1,7 @@
 #pragma once
 
 #include <stdbool.h>
+#include <stdint.h>
 
 #include "wayland/fbwl_wallpaper.h"
 
@@ -11,11 +12,35 @@ struct wlr_scene_tree;
 struct wlr_scene_buffer;
 struct wlr_scene_rect;
 
+// Inputs of the last update. A call with the same inputs and no wallpaper
+// change since leaves the nodes, and so the damaged region, untouched.
+struct fbwl_pseudo_bg_key {
+    bool valid;
+    uint64_t generation;
+    struct wlr_scene_tree *parent;
+    struct wlr_buffer *wallpaper_buf;
+    enum fbwl_wallpaper_mode wallpaper_mode;
+    int global_x;
+    int global_y;
+    int rel_x;
+    int rel_y;
+    int width;
+    int height;
+    float color[3];
+};
+
 struct fbwl_pseudo_bg {
     struct wlr_scene_buffer *image;
     struct wlr_scene_rect *rect;
+    struct fbwl_pseudo_bg_key key;
 };
 
+// Bumped whenever a wallpaper or an output background is rebuilt; every
+// pseudo background re-samples on its next update.
+uint64_t fbwl_pseudo_bg_generation(void);
+void fbwl_pseudo_bg_invalidate_all(void);
+bool fbwl_pseudo_bg_key_matches(const struct fbwl_pseudo_bg_key *cached, const struct fbwl_pseudo_bg_key *key);
+
 void fbwl_pseudo_bg_destroy(struct fbwl_pseudo_bg *bg);
 
 void fbwl_pseudo_bg_update(struct fbwl_pseudo_bg *bg,
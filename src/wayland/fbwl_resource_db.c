@@ -0,0 +1,509 @@
+#include <ctype.h>
+#include <errno.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <sys/types.h>
+
+#include <wlr/util/log.h>
+
+#include "wayland/fbwl_server_internal.h"
+#include "wayland/fbwl_util.h"
+
+#define RESOURCE_HASH_SEED 2166136261u
+#define RESOURCE_MAX_COMPONENTS 32
+
+// Xrm precedence for one level of the queried key; larger wins. A component
+// matched by name beats '?', which beats a level skipped by a loose binding;
+// within each, tight ('.') beats loose ('*').
+enum resource_rank {
+    RESOURCE_RANK_SKIPPED = 0,
+    RESOURCE_RANK_ANY_LOOSE,
+    RESOURCE_RANK_ANY_TIGHT,
+    RESOURCE_RANK_NAME_LOOSE,
+    RESOURCE_RANK_NAME_TIGHT,
+};
+
+struct resource_component {
+    const char *s;
+    size_t len;
+    bool loose;
+};
+
+struct resource_match {
+    const struct resource_component *pat;
+    size_t pat_len;
+    const struct resource_component *query;
+    size_t query_len;
+    uint8_t cur[RESOURCE_MAX_COMPONENTS];
+    uint8_t best[RESOURCE_MAX_COMPONENTS];
+    bool found;
+};
+
+static bool strip_outer_quotes_inplace(char *s) {
+    if (s == NULL) {
+        return false;
+    }
+    const size_t len = strlen(s);
+    if (len < 2) {
+        return false;
+    }
+    if (!((s[0] == '"' && s[len - 1] == '"') || (s[0] == '\'' && s[len - 1] == '\''))) {
+        return false;
+    }
+    memmove(s, s + 1, len - 1);
+    s[len - 2] = '\0';
+    return true;
+}
+
+static uint32_t resource_hash_update(uint32_t h, const char *s) {
+    for (; *s != '\0'; s++) {
+        h ^= (uint32_t)(unsigned char)tolower((unsigned char)*s);
+        h *= 16777619u;
+    }
+    return h;
+}
+
+static bool resource_folded_equal_parts(const char *folded, const char *const *parts, size_t parts_len) {
+    const char *f = folded;
+    for (size_t i = 0; i < parts_len; i++) {
+        for (const char *p = parts[i]; *p != '\0'; p++, f++) {
+            if (*f != (char)tolower((unsigned char)*p)) {
+                return false;
+            }
+        }
+    }
+    return *f == '\0';
+}
+
+// Looks up the exact key formed by concatenating parts, without building it.
+static const struct fbwl_resource_kv *resource_db_find_parts(const struct fbwl_resource_db *db,
+        const char *const *parts, size_t parts_len) {
+    if (db == NULL || db->index_cap == 0) {
+        return NULL;
+    }
+    uint32_t h = RESOURCE_HASH_SEED;
+    for (size_t i = 0; i < parts_len; i++) {
+        h = resource_hash_update(h, parts[i]);
+    }
+    const size_t mask = db->index_cap - 1;
+    for (size_t i = h & mask;; i = (i + 1) & mask) {
+        const size_t slot = db->index[i];
+        if (slot == 0) {
+            return NULL;
+        }
+        const struct fbwl_resource_kv *kv = &db->items[slot - 1];
+        if (kv->hash == h && resource_folded_equal_parts(kv->folded, parts, parts_len)) {
+            return kv;
+        }
+    }
+}
+
+static void resource_db_index_insert(struct fbwl_resource_db *db, size_t item) {
+    const size_t mask = db->index_cap - 1;
+    size_t i = db->items[item].hash & mask;
+    while (db->index[i] != 0) {
+        i = (i + 1) & mask;
+    }
+    db->index[i] = item + 1;
+}
+
+static bool resource_db_index_reserve(struct fbwl_resource_db *db, size_t exact_len) {
+    if (exact_len * 2 <= db->index_cap) {
+        return true;
+    }
+    size_t new_cap = db->index_cap > 0 ? db->index_cap : 64;
+    while (exact_len * 2 > new_cap) {
+        new_cap *= 2;
+    }
+    size_t *index = calloc(new_cap, sizeof(*index));
+    if (index == NULL) {
+        return false;
+    }
+    free(db->index);
+    db->index = index;
+    db->index_cap = new_cap;
+    for (size_t i = 0; i < db->items_len; i++) {
+        if (!db->items[i].wildcard) {
+            resource_db_index_insert(db, i);
+        }
+    }
+    return true;
+}
+
+static bool resource_db_reserve(struct fbwl_resource_db *db, size_t n) {
+    if (db == NULL) {
+        return false;
+    }
+    if (n <= db->items_cap) {
+        return true;
+    }
+    size_t new_cap = db->items_cap > 0 ? db->items_cap : 16;
+    while (new_cap < n) {
+        new_cap *= 2;
+    }
+
+    void *p = realloc(db->items, new_cap * sizeof(db->items[0]));
+    if (p == NULL) {
+        return false;
+    }
+    db->items = p;
+    db->items_cap = new_cap;
+    return true;
+}
+
+static bool resource_db_wildcards_push(struct fbwl_resource_db *db, size_t item) {
+    if (db->wildcards_len == db->wildcards_cap) {
+        const size_t new_cap = db->wildcards_cap > 0 ? db->wildcards_cap * 2 : 8;
+        size_t *p = realloc(db->wildcards, new_cap * sizeof(*p));
+        if (p == NULL) {
+            return false;
+        }
+        db->wildcards = p;
+        db->wildcards_cap = new_cap;
+    }
+    db->wildcards[db->wildcards_len++] = item;
+    return true;
+}
+
+static void resource_db_note_screen(struct fbwl_resource_db *db, const char *folded) {
+    static const char prefix[] = "session.screen";
+    if (strncmp(folded, prefix, sizeof(prefix) - 1) != 0) {
+        return;
+    }
+    const char *p = folded + sizeof(prefix) - 1;
+    const char *digits = p;
+    unsigned long v = 0;
+    while (isdigit((unsigned char)*p)) {
+        v = v * 10 + (unsigned long)(*p - '0');
+        p++;
+        if (v > 1000000ul) {
+            return;
+        }
+    }
+    if (p == digits || *p != '.') {
+        return;
+    }
+    if (v > db->max_screen) {
+        db->max_screen = (size_t)v;
+    }
+}
+
+static struct fbwl_resource_kv *resource_db_find_wildcard_key(struct fbwl_resource_db *db, const char *folded) {
+    for (size_t i = 0; i < db->wildcards_len; i++) {
+        struct fbwl_resource_kv *kv = &db->items[db->wildcards[i]];
+        if (strcmp(kv->folded, folded) == 0) {
+            return kv;
+        }
+    }
+    return NULL;
+}
+
+static bool resource_db_set_owned(struct fbwl_resource_db *db, char *key, char *value) {
+    if (db == NULL || key == NULL || *key == '\0' || value == NULL) {
+        free(key);
+        free(value);
+        return false;
+    }
+
+    char *folded = strdup(key);
+    if (folded == NULL) {
+        free(key);
+        free(value);
+        return false;
+    }
+    for (char *p = folded; *p != '\0'; p++) {
+        *p = (char)tolower((unsigned char)*p);
+    }
+    const bool wildcard = strpbrk(folded, "*?") != NULL;
+
+    struct fbwl_resource_kv *existing = NULL;
+    if (wildcard) {
+        existing = resource_db_find_wildcard_key(db, folded);
+    } else {
+        const char *parts[] = {folded};
+        existing = (struct fbwl_resource_kv *)resource_db_find_parts(db, parts, 1);
+    }
+    if (existing != NULL) {
+        free(existing->value);
+        existing->value = value;
+        free(folded);
+        free(key);
+        return true;
+    }
+
+    const size_t exact_len = db->items_len - db->wildcards_len + (wildcard ? 0 : 1);
+    if (!resource_db_reserve(db, db->items_len + 1) || (!wildcard && !resource_db_index_reserve(db, exact_len))) {
+        free(folded);
+        free(key);
+        free(value);
+        return false;
+    }
+
+    const size_t item = db->items_len;
+    db->items[item] = (struct fbwl_resource_kv){
+        .key = key,
+        .value = value,
+        .folded = folded,
+        .hash = resource_hash_update(RESOURCE_HASH_SEED, folded),
+        .wildcard = wildcard,
+    };
+    if (wildcard && !resource_db_wildcards_push(db, item)) {
+        free(folded);
+        free(key);
+        free(value);
+        return false;
+    }
+    db->items_len++;
+    if (!wildcard) {
+        resource_db_index_insert(db, item);
+    }
+    resource_db_note_screen(db, folded);
+    return true;
+}
+
+void fbwl_resource_db_free(struct fbwl_resource_db *db) {
+    if (db == NULL) {
+        return;
+    }
+    for (size_t i = 0; i < db->items_len; i++) {
+        free(db->items[i].key);
+        free(db->items[i].value);
+        free(db->items[i].folded);
+    }
+    free(db->items);
+    free(db->index);
+    free(db->wildcards);
+    *db = (struct fbwl_resource_db){0};
+}
+
+static bool fbwl_resource_db_load_file(struct fbwl_resource_db *db, const char *path) {
+    if (db == NULL || path == NULL || *path == '\0') {
+        return false;
+    }
+
+    FILE *f = fopen(path, "r");
+    if (f == NULL) {
+        wlr_log(WLR_ERROR, "Init: failed to open %s: %s", path, strerror(errno));
+        return false;
+    }
+
+    char *line = NULL;
+    size_t cap = 0;
+    ssize_t nread;
+    while ((nread = getline(&line, &cap, f)) != -1) {
+        if (nread > 0 && line[nread - 1] == '\n') {
+            line[nread - 1] = '\0';
+        }
+
+        char *s = fbwl_trim_inplace(line);
+        if (s == NULL || *s == '\0') {
+            continue;
+        }
+        if (*s == '#' || *s == '!') {
+            continue;
+        }
+
+        char *sep = strchr(s, ':');
+        if (sep == NULL) {
+            continue;
+        }
+        *sep = '\0';
+        char *key = fbwl_trim_inplace(s);
+        char *val = fbwl_trim_inplace(sep + 1);
+        if (key == NULL || *key == '\0' || val == NULL || *val == '\0') {
+            continue;
+        }
+
+        char *key_dup = strdup(key);
+        char *val_dup = strdup(val);
+        if (key_dup == NULL || val_dup == NULL) {
+            free(key_dup);
+            free(val_dup);
+            continue;
+        }
+        strip_outer_quotes_inplace(val_dup);
+        (void)resource_db_set_owned(db, key_dup, val_dup);
+    }
+
+    free(line);
+    fclose(f);
+    return true;
+}
+
+bool fbwl_resource_db_load_init(struct fbwl_resource_db *db, const char *config_dir, const char *init_file) {
+    if (db == NULL) {
+        return false;
+    }
+    fbwl_resource_db_free(db);
+
+    char *path = NULL;
+    if (init_file != NULL && *init_file != '\0') {
+        path = fbwl_resolve_config_path(NULL, init_file);
+        if (path == NULL) {
+            path = strdup(init_file);
+        }
+    } else if (config_dir != NULL && *config_dir != '\0') {
+        path = fbwl_path_join(config_dir, "init");
+    } else {
+        return false;
+    }
+    if (path == NULL || !fbwl_file_exists(path)) {
+        free(path);
+        return false;
+    }
+
+    const bool ok = fbwl_resource_db_load_file(db, path);
+    if (ok) {
+        wlr_log(WLR_INFO, "Init: loaded %s (%zu resources, %zu wildcard)", path, db->items_len,
+            db->wildcards_len);
+    }
+    free(path);
+    return ok;
+}
+
+// Splits an Xrm resource specification into components. Runs of bindings
+// collapse, and any '*' in a run makes the following component loose.
+static size_t resource_split(const char *s, struct resource_component out[static RESOURCE_MAX_COMPONENTS]) {
+    size_t n = 0;
+    bool loose = false;
+    while (*s != '\0') {
+        if (*s == '.' || *s == '*') {
+            loose = loose || *s == '*';
+            s++;
+            continue;
+        }
+        if (n == RESOURCE_MAX_COMPONENTS) {
+            return 0;
+        }
+        const char *start = s;
+        while (*s != '\0' && *s != '.' && *s != '*') {
+            s++;
+        }
+        out[n++] = (struct resource_component){.s = start, .len = (size_t)(s - start), .loose = loose};
+        loose = false;
+    }
+    return n;
+}
+
+static void resource_match_at(struct resource_match *m, size_t pi, size_t qi) {
+    if (pi == m->pat_len) {
+        if (qi == m->query_len && (!m->found || memcmp(m->cur, m->best, qi) > 0)) {
+            memcpy(m->best, m->cur, qi);
+            m->found = true;
+        }
+        return;
+    }
+    if (qi == m->query_len) {
+        return;
+    }
+
+    const struct resource_component *p = &m->pat[pi];
+    const struct resource_component *q = &m->query[qi];
+    const bool any = p->len == 1 && p->s[0] == '?';
+    if (any || (p->len == q->len && strncasecmp(p->s, q->s, p->len) == 0)) {
+        if (any) {
+            m->cur[qi] = p->loose ? RESOURCE_RANK_ANY_LOOSE : RESOURCE_RANK_ANY_TIGHT;
+        } else {
+            m->cur[qi] = p->loose ? RESOURCE_RANK_NAME_LOOSE : RESOURCE_RANK_NAME_TIGHT;
+        }
+        resource_match_at(m, pi + 1, qi + 1);
+    }
+    if (p->loose) {
+        m->cur[qi] = RESOURCE_RANK_SKIPPED;
+        resource_match_at(m, pi, qi + 1);
+    }
+}
+
+static const char *resource_db_get_wildcard(const struct fbwl_resource_db *db, const char *key) {
+    struct resource_component query[RESOURCE_MAX_COMPONENTS];
+    const size_t query_len = resource_split(key, query);
+    if (query_len == 0) {
+        return NULL;
+    }
+
+    struct resource_component pat[RESOURCE_MAX_COMPONENTS];
+    uint8_t best[RESOURCE_MAX_COMPONENTS];
+    const char *best_value = NULL;
+    for (size_t i = 0; i < db->wildcards_len; i++) {
+        const struct fbwl_resource_kv *kv = &db->items[db->wildcards[i]];
+        struct resource_match m = {
+            .pat = pat,
+            .pat_len = resource_split(kv->folded, pat),
+            .query = query,
+            .query_len = query_len,
+        };
+        if (m.pat_len == 0 || m.pat_len > query_len) {
+            continue;
+        }
+        resource_match_at(&m, 0, 0);
+        if (!m.found) {
+            continue;
+        }
+        if (best_value == NULL || memcmp(m.best, best, query_len) > 0) {
+            memcpy(best, m.best, query_len);
+            best_value = kv->value;
+        }
+    }
+    return best_value;
+}
+
+const char *fbwl_resource_db_get(const struct fbwl_resource_db *db, const char *key) {
+    if (db == NULL || key == NULL || *key == '\0') {
+        return NULL;
+    }
+    const char *parts[] = {key};
+    const struct fbwl_resource_kv *kv = resource_db_find_parts(db, parts, 1);
+    if (kv != NULL) {
+        return kv->value;
+    }
+    return db->wildcards_len > 0 ? resource_db_get_wildcard(db, key) : NULL;
+}
+
+size_t fbwl_resource_db_max_screen_index(const struct fbwl_resource_db *db) {
+    return db != NULL ? db->max_screen : 0;
+}
+
+static const char *screen_index_str(char buf[static 24], size_t screen) {
+    char *p = buf + 23;
+    *p = '\0';
+    do {
+        *--p = (char)('0' + screen % 10);
+        screen /= 10;
+    } while (screen > 0);
+    return p;
+}
+
+static const char *resource_db_get_screen_one(const struct fbwl_resource_db *db, size_t screen, const char *suffix) {
+    char idx_buf[24];
+    const char *parts[] = {"session.screen", screen_index_str(idx_buf, screen), ".", suffix};
+    const struct fbwl_resource_kv *kv = resource_db_find_parts(db, parts, 4);
+    if (kv != NULL) {
+        return kv->value;
+    }
+    if (db->wildcards_len == 0) {
+        return NULL;
+    }
+
+    char key[256];
+    int n = snprintf(key, sizeof(key), "%s%s%s%s", parts[0], parts[1], parts[2], parts[3]);
+    if (n <= 0 || (size_t)n >= sizeof(key)) {
+        return NULL;
+    }
+    return resource_db_get_wildcard(db, key);
+}
+
+const char *fbwl_resource_db_get_screen(const struct fbwl_resource_db *db, size_t screen, const char *suffix) {
+    if (db == NULL || suffix == NULL || *suffix == '\0') {
+        return NULL;
+    }
+
+    const char *val = resource_db_get_screen_one(db, screen, suffix);
+    if (val != NULL || screen == 0) {
+        return val;
+    }
+    return resource_db_get_screen_one(db, 0, suffix);
+}
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+struct fbwl_resource_kv {
+    char *key;
+    char *value;
+    char *folded; // lowercase copy of key; matching is case-insensitive
+    uint32_t hash;
+    bool wildcard; // key uses Xrm '*' bindings or '?' components
+};
+
+// Items keep insertion order; exact keys are additionally reachable through an
+// open-addressed index (slot holds item index + 1, 0 means empty).
+struct fbwl_resource_db {
+    struct fbwl_resource_kv *items;
+    size_t items_len;
+    size_t items_cap;
+
+    size_t *index;
+    size_t index_cap;
+
+    size_t *wildcards;
+    size_t wildcards_len;
+    size_t wildcards_cap;
+
+    size_t max_screen;
+};
+
+void fbwl_resource_db_free(struct fbwl_resource_db *db);
+bool fbwl_resource_db_load_init(struct fbwl_resource_db *db, const char *config_dir, const char *init_file);
+const char *fbwl_resource_db_get(const struct fbwl_resource_db *db, const char *key);
+size_t fbwl_resource_db_max_screen_index(const struct fbwl_resource_db *db);
+const char *fbwl_resource_db_get_screen(const struct fbwl_resource_db *db, size_t screen, const char *suffix);
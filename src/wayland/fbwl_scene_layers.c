@@ -1,5 +1,6 @@
 #include "wayland/fbwl_scene_layers.h"
 
+#include <stdbool.h>
 #include <stdlib.h>
 
 #include <wlr/types/wlr_layer_shell_v1.h>
@@ -7,8 +8,10 @@
 #include <wlr/types/wlr_output_layout.h>
 #include <wlr/types/wlr_scene.h>
 #include <wlr/util/log.h>
+#include <wlr/version.h>
 
 #include "wayland/fbwl_output.h"
+#include "wayland/fbwl_trace.h"
 #include "wayland/fbwl_util.h"
 
 struct fbwl_layer_surface {
@@ -27,6 +30,12 @@ struct fbwl_layer_surface {
     struct wlr_scene_tree *layer_overlay;
     struct wlr_scene_tree *scene_root;
 
+    fbwl_scene_layers_usable_changed_fn usable_changed;
+    void *usable_changed_userdata;
+
+    // Client state the last arrangement was computed from.
+    struct wlr_layer_surface_v1_state arranged;
+
     struct wl_listener map;
     struct wl_listener unmap;
     struct wl_listener commit;
@@ -52,18 +61,18 @@ static struct wlr_scene_tree *scene_tree_for_layer(struct wlr_scene_tree *layer_
     }
 }
 
-void fbwl_scene_layers_arrange_layer_surfaces_on_output(struct wlr_output_layout *output_layout,
+bool fbwl_scene_layers_arrange_layer_surfaces_on_output(struct wlr_output_layout *output_layout,
         struct wl_list *outputs,
         struct wl_list *layer_surfaces,
         struct wlr_output *wlr_output) {
     if (output_layout == NULL || outputs == NULL || layer_surfaces == NULL || wlr_output == NULL) {
-        return;
+        return false;
     }
 
     struct wlr_box full = {0};
     wlr_output_layout_get_box(output_layout, wlr_output, &full);
     if (full.width < 1 || full.height < 1) {
-        return;
+        return false;
     }
 
     struct wlr_box usable = full;
@@ -91,23 +100,56 @@ void fbwl_scene_layers_arrange_layer_surfaces_on_output(struct wlr_output_layout
                 continue;
             }
             wlr_scene_layer_surface_v1_configure(ls->scene_layer_surface, &full, &usable);
+            if (!fbwl_trace_enabled(FBWL_TRACE_LAYERS)) {
+                continue;
+            }
 
             int lx = 0, ly = 0;
             (void)wlr_scene_node_coords(&ls->scene_layer_surface->tree->node, &lx, &ly);
             const char *ns = ls->layer_surface->namespace != NULL ? ls->layer_surface->namespace : "(no-namespace)";
             const struct wlr_layer_surface_v1_state *st = &ls->layer_surface->current;
-            wlr_log(WLR_INFO, "LayerShell: surface ns=%s layer=%d pos=%d,%d size=%ux%u excl=%d",
+            fbwl_trace(FBWL_TRACE_LAYERS, "LayerShell: surface ns=%s layer=%d pos=%d,%d size=%ux%u excl=%d",
                 ns, (int)ls->layer, lx, ly, st->actual_width, st->actual_height, st->exclusive_zone);
         }
     }
 
     struct fbwl_output *out = fbwl_output_find(outputs, wlr_output);
-    if (out != NULL) {
-        out->usable_area = usable;
+    if (out == NULL || wlr_box_equal(&out->usable_area, &usable)) {
+        return false;
     }
+    out->usable_area = usable;
     wlr_log(WLR_INFO, "LayerShell: output=%s usable=%d,%d %dx%d",
         wlr_output->name != NULL ? wlr_output->name : "(unnamed)",
         usable.x, usable.y, usable.width, usable.height);
+    return true;
+}
+
+static bool layer_surface_state_changed(struct fbwl_layer_surface *ls) {
+    const struct wlr_layer_surface_v1_state *cur = &ls->layer_surface->current;
+    struct wlr_layer_surface_v1_state *old = &ls->arranged;
+    const bool changed = cur->anchor != old->anchor ||
+        cur->exclusive_zone != old->exclusive_zone ||
+        cur->margin.top != old->margin.top ||
+        cur->margin.right != old->margin.right ||
+        cur->margin.bottom != old->margin.bottom ||
+        cur->margin.left != old->margin.left ||
+        cur->desired_width != old->desired_width ||
+        cur->desired_height != old->desired_height ||
+        cur->keyboard_interactive != old->keyboard_interactive ||
+#if WLR_VERSION_NUM >= ((0 << 16) | (19 << 8) | 0)
+        cur->exclusive_edge != old->exclusive_edge ||
+#endif
+        cur->layer != old->layer;
+    *old = *cur;
+    return changed;
+}
+
+static void layer_surface_arrange(struct fbwl_layer_surface *ls) {
+    if (fbwl_scene_layers_arrange_layer_surfaces_on_output(ls->output_layout, ls->outputs, ls->layer_surfaces,
+            ls->layer_surface->output) &&
+            ls->usable_changed != NULL) {
+        ls->usable_changed(ls->usable_changed_userdata, ls->layer_surface->output);
+    }
 }
 
 static void layer_surface_map(struct wl_listener *listener, void *data) {
@@ -115,8 +157,7 @@ static void layer_surface_map(struct wl_listener *listener, void *data) {
     struct fbwl_layer_surface *ls = wl_container_of(listener, ls, map);
     const char *ns = ls->layer_surface->namespace != NULL ? ls->layer_surface->namespace : "(no-namespace)";
     wlr_log(WLR_INFO, "LayerShell: map ns=%s layer=%d", ns, (int)ls->layer);
-    fbwl_scene_layers_arrange_layer_surfaces_on_output(ls->output_layout, ls->outputs, ls->layer_surfaces,
-        ls->layer_surface->output);
+    layer_surface_arrange(ls);
 }
 
 static void layer_surface_unmap(struct wl_listener *listener, void *data) {
@@ -124,8 +165,7 @@ static void layer_surface_unmap(struct wl_listener *listener, void *data) {
     struct fbwl_layer_surface *ls = wl_container_of(listener, ls, unmap);
     const char *ns = ls->layer_surface->namespace != NULL ? ls->layer_surface->namespace : "(no-namespace)";
     wlr_log(WLR_INFO, "LayerShell: unmap ns=%s layer=%d", ns, (int)ls->layer);
-    fbwl_scene_layers_arrange_layer_surfaces_on_output(ls->output_layout, ls->outputs, ls->layer_surfaces,
-        ls->layer_surface->output);
+    layer_surface_arrange(ls);
 }
 
 static void layer_surface_commit(struct wl_listener *listener, void *data) {
@@ -142,8 +182,12 @@ static void layer_surface_commit(struct wl_listener *listener, void *data) {
         }
     }
 
-    fbwl_scene_layers_arrange_layer_surfaces_on_output(ls->output_layout, ls->outputs, ls->layer_surfaces,
-        ls->layer_surface->output);
+    // Buffer-only commits (animated panels, OSDs) leave the arrangement alone;
+    // map/unmap arrange on their own.
+    if (!layer_surface_state_changed(ls) && !ls->layer_surface->initial_commit) {
+        return;
+    }
+    layer_surface_arrange(ls);
 }
 
 static void layer_surface_destroy(struct wl_listener *listener, void *data) {
@@ -153,6 +197,8 @@ static void layer_surface_destroy(struct wl_listener *listener, void *data) {
     struct wl_list *outputs = ls->outputs;
     struct wl_list *layer_surfaces = ls->layer_surfaces;
     struct wlr_output *output = ls->layer_surface->output;
+    fbwl_scene_layers_usable_changed_fn usable_changed = ls->usable_changed;
+    void *usable_changed_userdata = ls->usable_changed_userdata;
     const char *ns = ls->layer_surface->namespace != NULL ? ls->layer_surface->namespace : "(no-namespace)";
     wlr_log(WLR_INFO, "LayerShell: destroy ns=%s layer=%d", ns, (int)ls->layer);
 
@@ -163,7 +209,10 @@ static void layer_surface_destroy(struct wl_listener *listener, void *data) {
     wl_list_remove(&ls->link);
     free(ls);
 
-    fbwl_scene_layers_arrange_layer_surfaces_on_output(output_layout, outputs, layer_surfaces, output);
+    if (fbwl_scene_layers_arrange_layer_surfaces_on_output(output_layout, outputs, layer_surfaces, output) &&
+            usable_changed != NULL) {
+        usable_changed(usable_changed_userdata, output);
+    }
 }
 
 void fbwl_scene_layers_handle_new_layer_surface(struct wlr_layer_surface_v1 *layer_surface,
@@ -174,7 +223,9 @@ void fbwl_scene_layers_handle_new_layer_surface(struct wlr_layer_surface_v1 *lay
         struct wlr_scene_tree *layer_bottom,
         struct wlr_scene_tree *layer_top,
         struct wlr_scene_tree *layer_overlay,
-        struct wlr_scene_tree *scene_root) {
+        struct wlr_scene_tree *scene_root,
+        fbwl_scene_layers_usable_changed_fn usable_changed,
+        void *usable_changed_userdata) {
     if (layer_surface == NULL || output_layout == NULL || outputs == NULL || layer_surfaces == NULL ||
             scene_root == NULL) {
         return;
@@ -204,6 +255,8 @@ void fbwl_scene_layers_handle_new_layer_surface(struct wlr_layer_surface_v1 *lay
     ls->layer_top = layer_top;
     ls->layer_overlay = layer_overlay;
     ls->scene_root = scene_root;
+    ls->usable_changed = usable_changed;
+    ls->usable_changed_userdata = usable_changed_userdata;
 
     struct wlr_scene_tree *parent = scene_tree_for_layer(layer_background, layer_bottom, layer_top, layer_overlay,
         ls->layer);
@@ -231,6 +284,6 @@ void fbwl_scene_layers_handle_new_layer_surface(struct wlr_layer_surface_v1 *lay
         ns, (int)ls->layer,
         layer_surface->output->name != NULL ? layer_surface->output->name : "(unnamed)");
 
-    fbwl_scene_layers_arrange_layer_surfaces_on_output(output_layout, outputs, layer_surfaces, layer_surface->output);
+    layer_surface_arrange(ls);
 }
 
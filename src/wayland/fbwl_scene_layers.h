@@ -1,5 +1,7 @@
 #pragma once
 
+#include <stdbool.h>
+
 #include <wayland-server-core.h>
 
 struct wlr_layer_surface_v1;
@@ -7,7 +9,10 @@ struct wlr_output;
 struct wlr_output_layout;
 struct wlr_scene_tree;
 
-void fbwl_scene_layers_arrange_layer_surfaces_on_output(struct wlr_output_layout *output_layout,
+typedef void (*fbwl_scene_layers_usable_changed_fn)(void *userdata, struct wlr_output *wlr_output);
+
+// Returns true when the output's usable area changed.
+bool fbwl_scene_layers_arrange_layer_surfaces_on_output(struct wlr_output_layout *output_layout,
         struct wl_list *outputs,
         struct wl_list *layer_surfaces,
         struct wlr_output *wlr_output);
@@ -20,5 +25,7 @@ void fbwl_scene_layers_handle_new_layer_surface(struct wlr_layer_surface_v1 *lay
         struct wlr_scene_tree *layer_bottom,
         struct wlr_scene_tree *layer_top,
         struct wlr_scene_tree *layer_overlay,
-        struct wlr_scene_tree *scene_root);
+        struct wlr_scene_tree *scene_root,
+        fbwl_scene_layers_usable_changed_fn usable_changed,
+        void *usable_changed_userdata);
 
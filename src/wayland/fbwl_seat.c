@@ -11,6 +11,7 @@
 #include <wlr/types/wlr_virtual_keyboard_v1.h>
 #include <wlr/util/log.h>
 
+#include "wayland/fbwl_cursor.h"
 #include "wayland/fbwl_util.h"
 
 struct fbwl_keyboard {
@@ -37,6 +38,11 @@ static void keyboard_handle_modifiers(struct wl_listener *listener, void *data)
         return;
     }
 
+    if (keyboard->hooks.notify_modifiers != NULL) {
+        keyboard->hooks.notify_modifiers(keyboard->hooks.userdata,
+            wlr_keyboard_get_modifiers(keyboard->wlr_keyboard));
+    }
+
     wlr_seat_set_keyboard(keyboard->seat, keyboard->wlr_keyboard);
     wlr_seat_keyboard_notify_modifiers(keyboard->seat, &keyboard->wlr_keyboard->modifiers);
 }
@@ -213,7 +219,7 @@ void fbwl_seat_handle_request_cursor(struct wlr_seat *seat, struct wlr_cursor *c
     struct wlr_seat_client *focused_client =
         seat->pointer_state.focused_client;
     if (focused_client == event->seat_client) {
-        wlr_cursor_set_surface(cursor, event->surface,
+        fbwl_cursor_set_surface(cursor, event->surface,
             event->hotspot_x, event->hotspot_y);
     }
 }
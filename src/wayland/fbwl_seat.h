@@ -19,6 +19,7 @@ struct wlr_seat_request_start_drag_event;
 struct fbwl_seat_keyboard_hooks {
     void *userdata;
     void (*notify_activity)(void *userdata);
+    void (*notify_modifiers)(void *userdata, uint32_t modifiers);
 
     bool (*menu_is_open)(void *userdata);
     bool (*menu_handle_key)(void *userdata, xkb_keysym_t sym);
@@ -1,5 +1,6 @@
 #include <ctype.h>
 #include <errno.h>
+#include <fcntl.h>
 #include <signal.h>
 #include <stdbool.h>
 #include <stdio.h>
@@ -37,6 +38,7 @@
 #include "wayland/fbwl_keys_parse.h"
 #include "wayland/fbwl_scene_layers.h"
 #include "wayland/fbwl_server_internal.h"
+#include "wayland/fbwl_spawn.h"
 #include "wayland/fbwl_string_list.h"
 #include "wayland/fbwl_ui_menu_icon.h"
 #include "wayland/fbwl_style_parse.h"
@@ -123,7 +125,7 @@ static void server_new_layer_surface(struct wl_listener *listener, void *data) {
     }
     fbwl_scene_layers_handle_new_layer_surface(data, server->output_layout, &server->outputs, &server->layer_surfaces,
         server->layer_background, server->layer_bottom, server->layer_top, server->layer_overlay,
-        server->scene != NULL ? &server->scene->tree : NULL);
+        server->scene != NULL ? &server->scene->tree : NULL, server_layers_usable_changed, server);
 }
 
 static const char *wl_protocol_logger_type_str(enum wl_protocol_logger_type type) {
@@ -297,6 +299,7 @@ bool fbwl_server_bootstrap(struct fbwl_server *server, const struct fbwl_server_
     struct wl_event_loop *loop = wl_display_get_event_loop(server->wl_display);
     wl_event_loop_add_signal(loop, SIGINT, handle_signal, server);
     wl_event_loop_add_signal(loop, SIGTERM, handle_signal, server);
+    (void)fbwl_spawn_init(loop);
 
     server->auto_raise_timer = wl_event_loop_add_timer(loop, server_auto_raise_timer, server);
 
@@ -309,6 +312,7 @@ bool fbwl_server_bootstrap(struct fbwl_server *server, const struct fbwl_server_
     server->move_osd_ui.visible = false;
     server->move_osd_ui.last_workspace = 0;
     server->move_osd_ui.hide_timer = NULL;
+    server->move_osd_ui.render_timer = wl_event_loop_add_timer(loop, server_move_osd_render_timer, server);
 
     server->backend = wlr_backend_autocreate(loop, NULL);
     if (server->backend == NULL) {
@@ -864,6 +868,7 @@ bool fbwl_server_bootstrap(struct fbwl_server *server, const struct fbwl_server_
     server_toolbar_ui_rebuild(server);
     (void)fbwl_ui_slit_set_order_file(&server->slit_ui, server->slitlist_file);
     server_slit_ui_rebuild(server);
+    server_config_watch_init(server);
 
     server->xdg_shell = wlr_xdg_shell_create(server->wl_display, 3);
     server->new_xdg_toplevel.notify = server_new_xdg_toplevel;
@@ -944,7 +949,20 @@ bool fbwl_server_bootstrap(struct fbwl_server *server, const struct fbwl_server_
         &server->new_virtual_pointer);
 
     const char *socket = NULL;
-    if (opts->socket_name != NULL) {
+    struct fbwl_socket_handover *handover = opts->socket_handover;
+    if (handover != NULL) {
+        if (handover->listen_fd < 0 && !fbwl_socket_handover_listen(handover, opts->socket_name)) {
+            wlr_log(WLR_ERROR, "failed to create Wayland socket");
+            return false;
+        }
+        // libwayland closes the fd it is given; keep the original for the next exec.
+        const int fd = fcntl(handover->listen_fd, F_DUPFD_CLOEXEC, 0);
+        if (fd < 0 || wl_display_add_socket_fd(server->wl_display, fd) != 0) {
+            wlr_log(WLR_ERROR, "failed to add socket fd for '%s'", handover->name);
+            return false;
+        }
+        socket = handover->name;
+    } else if (opts->socket_name != NULL) {
         if (wl_display_add_socket(server->wl_display, opts->socket_name) != 0) {
             wlr_log(WLR_ERROR, "failed to add socket '%s'", opts->socket_name);
             return false;
@@ -977,6 +995,8 @@ bool fbwl_server_bootstrap(struct fbwl_server *server, const struct fbwl_server_
         fbwl_spawn(server->startup_cmd);
     }
 
+    server_session_init(server, socket);
+
     wlr_log(WLR_INFO, "Running fluxbox-wayland on WAYLAND_DISPLAY=%s", socket);
     return true;
 }
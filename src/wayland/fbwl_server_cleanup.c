@@ -12,6 +12,8 @@
 
 #include "wayland/fbwl_output.h"
 #include "wayland/fbwl_server_internal.h"
+#include "wayland/fbwl_server_window_remember.h"
+#include "wayland/fbwl_spawn.h"
 #include "wayland/fbwl_xembed_sni_proxy.h"
 #include "wayland/fbwl_util.h"
 
@@ -25,11 +27,13 @@ void fbwl_server_finish(struct fbwl_server *server) {
     if (server->slitlist_file != NULL && *server->slitlist_file != '\0') {
         (void)fbwl_ui_slit_save_order_file(&server->slit_ui, server->slitlist_file);
     }
+    server_apps_rules_finish(server);
 
     if (server->wl_display != NULL) {
         wl_display_destroy_clients(server->wl_display);
     }
     fbwl_ipc_finish(&server->ipc);
+    server_config_watch_finish(server);
     free(server->ipc_last_result);
     server->ipc_last_result = NULL;
 #ifdef HAVE_SYSTEMD
@@ -82,6 +86,13 @@ void fbwl_server_finish(struct fbwl_server *server) {
     server->auto_raise_timer = NULL;
     }
     server->auto_raise_pending_view = NULL;
+    if (server->usable_check_idle != NULL) {
+        wl_event_source_remove(server->usable_check_idle);
+        server->usable_check_idle = NULL;
+    }
+    fbwl_view_icon_server_finish(server);
+    server_session_finish(server);
+    fbwl_spawn_finish();
     server_menu_free(server);
     free(server->config_dir);
     server->config_dir = NULL;
@@ -152,6 +163,8 @@ void fbwl_server_finish(struct fbwl_server *server) {
     }
     fbwl_apps_rules_free(&server->apps_rules, &server->apps_rule_count);
     fbwl_keybindings_free(&server->keybindings, &server->keybinding_count);
+    fbwl_keybindings_cycle_session_end(&server->cycle_session);
+    fbwl_snap_index_finish(&server->grab.snap);
     fbwl_mousebindings_free(&server->mousebindings, &server->mousebinding_count);
     free(server->marked_windows.items);
     server->marked_windows.items = NULL;
@@ -12,40 +12,6 @@
 #include "wayland/fbwl_server_internal.h"
 #include "wayland/fbwl_util.h"
 
-static char *trim_inplace(char *s) {
-    if (s == NULL) {
-        return NULL;
-    }
-    while (*s != '\0' && isspace((unsigned char)*s)) {
-        s++;
-    }
-    if (*s == '\0') {
-        return s;
-    }
-    char *end = s + strlen(s) - 1;
-    while (end > s && isspace((unsigned char)*end)) {
-        *end = '\0';
-        end--;
-    }
-    return s;
-}
-
-static bool strip_outer_quotes_inplace(char *s) {
-    if (s == NULL) {
-        return false;
-    }
-    const size_t len = strlen(s);
-    if (len < 2) {
-        return false;
-    }
-    if (!((s[0] == '"' && s[len - 1] == '"') || (s[0] == '\'' && s[len - 1] == '\''))) {
-        return false;
-    }
-    memmove(s, s + 1, len - 1);
-    s[len - 2] = '\0';
-    return true;
-}
-
 char *fbwl_path_join(const char *dir, const char *rel) {
     if (dir == NULL || *dir == '\0' || rel == NULL || *rel == '\0') {
         return NULL;
@@ -124,7 +90,7 @@ char *fbwl_resolve_config_path(const char *config_dir, const char *value) {
     if (tmp == NULL) {
         return NULL;
     }
-    char *s = trim_inplace(tmp);
+    char *s = fbwl_trim_inplace(tmp);
     if (s == NULL || *s == '\0') {
         free(tmp);
         return NULL;
@@ -151,231 +117,6 @@ char *fbwl_resolve_config_path(const char *config_dir, const char *value) {
     return joined;
 }
 
-static bool resource_db_reserve(struct fbwl_resource_db *db, size_t n) {
-    if (db == NULL) {
-        return false;
-    }
-    if (n <= db->items_cap) {
-        return true;
-    }
-    size_t new_cap = db->items_cap > 0 ? db->items_cap : 16;
-    while (new_cap < n) {
-        new_cap *= 2;
-    }
-
-    void *p = realloc(db->items, new_cap * sizeof(db->items[0]));
-    if (p == NULL) {
-        return false;
-    }
-    db->items = p;
-    db->items_cap = new_cap;
-    return true;
-}
-
-static bool resource_db_set_owned(struct fbwl_resource_db *db, char *key, char *value) {
-    if (db == NULL || key == NULL || *key == '\0' || value == NULL) {
-        free(key);
-        free(value);
-        return false;
-    }
-
-    for (size_t i = 0; i < db->items_len; i++) {
-        if (strcasecmp(db->items[i].key, key) == 0) {
-            free(db->items[i].value);
-            db->items[i].value = value;
-            free(key);
-            return true;
-        }
-    }
-
-    if (!resource_db_reserve(db, db->items_len + 1)) {
-        free(key);
-        free(value);
-        return false;
-    }
-
-    db->items[db->items_len].key = key;
-    db->items[db->items_len].value = value;
-    db->items_len++;
-    return true;
-}
-
-void fbwl_resource_db_free(struct fbwl_resource_db *db) {
-    if (db == NULL) {
-        return;
-    }
-    for (size_t i = 0; i < db->items_len; i++) {
-        free(db->items[i].key);
-        free(db->items[i].value);
-    }
-    free(db->items);
-    db->items = NULL;
-    db->items_len = 0;
-    db->items_cap = 0;
-}
-
-static bool fbwl_resource_db_load_file(struct fbwl_resource_db *db, const char *path) {
-    if (db == NULL || path == NULL || *path == '\0') {
-        return false;
-    }
-
-    FILE *f = fopen(path, "r");
-    if (f == NULL) {
-        wlr_log(WLR_ERROR, "Init: failed to open %s: %s", path, strerror(errno));
-        return false;
-    }
-
-    char *line = NULL;
-    size_t cap = 0;
-    ssize_t nread;
-    while ((nread = getline(&line, &cap, f)) != -1) {
-        if (nread > 0 && line[nread - 1] == '\n') {
-            line[nread - 1] = '\0';
-        }
-
-        char *s = trim_inplace(line);
-        if (s == NULL || *s == '\0') {
-            continue;
-        }
-        if (*s == '#' || *s == '!') {
-            continue;
-        }
-
-        char *sep = strchr(s, ':');
-        if (sep == NULL) {
-            continue;
-        }
-        *sep = '\0';
-        char *key = trim_inplace(s);
-        char *val = trim_inplace(sep + 1);
-        if (key == NULL || *key == '\0' || val == NULL || *val == '\0') {
-            continue;
-        }
-
-        char *key_dup = strdup(key);
-        char *val_dup = strdup(val);
-        if (key_dup == NULL || val_dup == NULL) {
-            free(key_dup);
-            free(val_dup);
-            continue;
-        }
-        strip_outer_quotes_inplace(val_dup);
-        (void)resource_db_set_owned(db, key_dup, val_dup);
-    }
-
-    free(line);
-    fclose(f);
-    return true;
-}
-
-bool fbwl_resource_db_load_init(struct fbwl_resource_db *db, const char *config_dir, const char *init_file) {
-    if (db == NULL) {
-        return false;
-    }
-    fbwl_resource_db_free(db);
-
-    char *path = NULL;
-    if (init_file != NULL && *init_file != '\0') {
-        path = fbwl_resolve_config_path(NULL, init_file);
-        if (path == NULL) {
-            path = strdup(init_file);
-        }
-    } else if (config_dir != NULL && *config_dir != '\0') {
-        path = fbwl_path_join(config_dir, "init");
-    } else {
-        return false;
-    }
-    if (path == NULL || !fbwl_file_exists(path)) {
-        free(path);
-        return false;
-    }
-
-    const bool ok = fbwl_resource_db_load_file(db, path);
-    if (ok) {
-        wlr_log(WLR_INFO, "Init: loaded %s", path);
-    }
-    free(path);
-    return ok;
-}
-
-const char *fbwl_resource_db_get(const struct fbwl_resource_db *db, const char *key) {
-    if (db == NULL || key == NULL || *key == '\0') {
-        return NULL;
-    }
-    for (size_t i = 0; i < db->items_len; i++) {
-        if (strcasecmp(db->items[i].key, key) == 0) {
-            return db->items[i].value;
-        }
-    }
-    return NULL;
-}
-
-size_t fbwl_resource_db_max_screen_index(const struct fbwl_resource_db *db) {
-    if (db == NULL) {
-        return 0;
-    }
-    size_t max_idx = 0;
-    const char *prefix = "session.screen";
-    const size_t prefix_len = strlen(prefix);
-    for (size_t i = 0; i < db->items_len; i++) {
-        const char *k = db->items[i].key;
-        if (k == NULL) {
-            continue;
-        }
-        if (strncasecmp(k, prefix, prefix_len) != 0) {
-            continue;
-        }
-        const char *p = k + prefix_len;
-        if (*p == '\0' || !isdigit((unsigned char)*p)) {
-            continue;
-        }
-        unsigned long v = 0;
-        const char *digits = p;
-        while (*p != '\0' && isdigit((unsigned char)*p)) {
-            v = v * 10 + (unsigned long)(*p - '0');
-            p++;
-            if (v > 1000000ul) {
-                break;
-            }
-        }
-        if (p == digits || *p != '.') {
-            continue;
-        }
-        if (v > max_idx) {
-            max_idx = (size_t)v;
-        }
-    }
-    return max_idx;
-}
-
-static bool screen_key(char buf[static 256], size_t screen, const char *suffix) {
-    if (buf == NULL || suffix == NULL || *suffix == '\0') {
-        return false;
-    }
-    int n = snprintf(buf, 256, "session.screen%zu.%s", screen, suffix);
-    return n > 0 && n < 256;
-}
-
-const char *fbwl_resource_db_get_screen(const struct fbwl_resource_db *db, size_t screen, const char *suffix) {
-    if (db == NULL || suffix == NULL || *suffix == '\0') {
-        return NULL;
-    }
-
-    char key[256];
-    if (!screen_key(key, screen, suffix)) {
-        return NULL;
-    }
-    const char *val = fbwl_resource_db_get(db, key);
-    if (val != NULL || screen == 0) {
-        return val;
-    }
-
-    if (!screen_key(key, 0, suffix)) {
-        return NULL;
-    }
-    return fbwl_resource_db_get(db, key);
-}
-
 static bool parse_bool(const char *s, bool *out) {
     if (s == NULL || out == NULL) {
         return false;
@@ -911,7 +652,7 @@ bool fbwl_titlebar_buttons_parse(const char *s, enum fbwl_decor_hit_kind *out, s
         return false;
     }
 
-    char *trim = trim_inplace(copy);
+    char *trim = fbwl_trim_inplace(copy);
     if (trim == NULL || *trim == '\0') {
         *out_len = 0;
         free(copy);
@@ -957,7 +698,7 @@ void fbwl_apply_workspace_names_from_init(struct fbwm_core *wm, const char *csv)
     char *tok = strtok_r(tmp, ",", &saveptr);
     int idx = 0;
     while (tok != NULL && idx < 1000) {
-        char *name = trim_inplace(tok);
+        char *name = fbwl_trim_inplace(tok);
         if (name != NULL && *name != '\0') {
             (void)fbwm_core_set_workspace_name(wm, idx, name);
             idx++;
@@ -0,0 +1,108 @@
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <wayland-server-core.h>
+
+#include <wlr/util/log.h>
+
+#include "wayland/fbwl_server_internal.h"
+#include "wayland/fbwl_string_list.h"
+
+enum {
+    CONFIG_WATCH_DEBOUNCE_MS = 150,
+};
+
+void server_menu_note_source(void *userdata, const char *path) {
+    struct fbwl_server *server = userdata;
+    if (server == NULL || path == NULL || *path == '\0') {
+        return;
+    }
+    char *dup = strdup(path);
+    if (dup == NULL) {
+        return;
+    }
+    char **p = realloc(server->menu_sources, (server->menu_sources_len + 1) * sizeof(*p));
+    if (p == NULL) {
+        free(dup);
+        return;
+    }
+    server->menu_sources = p;
+    server->menu_sources[server->menu_sources_len++] = dup;
+}
+
+static void server_config_watch_add_style_file(void *userdata, const char *path) {
+    (void)fbwl_config_watch_add(userdata, path, FBWL_RECONFIGURE_STYLE_FILES);
+}
+
+static void server_config_watch_apply(void *userdata, uint32_t parts) {
+    struct fbwl_server *server = userdata;
+    if (server == NULL) {
+        return;
+    }
+    wlr_log(WLR_INFO, "ConfigWatch: reloading%s%s%s%s%s",
+        (parts & FBWL_RECONFIGURE_INIT) != 0 ? " init" : "",
+        (parts & FBWL_RECONFIGURE_KEYS) != 0 ? " keys" : "",
+        (parts & FBWL_RECONFIGURE_APPS) != 0 ? " apps" : "",
+        (parts & (FBWL_RECONFIGURE_STYLE | FBWL_RECONFIGURE_STYLE_FILES)) != 0 ? " style" : "",
+        (parts & FBWL_RECONFIGURE_MENU) != 0 ? " menu" : "");
+    server_reconfigure_parts(server, parts, false);
+}
+
+void server_config_watch_init(struct fbwl_server *server) {
+    if (server == NULL || server->wl_display == NULL) {
+        return;
+    }
+    struct wl_event_loop *loop = wl_display_get_event_loop(server->wl_display);
+    if (!fbwl_config_watch_init(&server->config_watch, loop, CONFIG_WATCH_DEBOUNCE_MS, FBWL_RECONFIGURE_ALL,
+            server_config_watch_apply, server)) {
+        wlr_log(WLR_INFO, "ConfigWatch: disabled");
+        return;
+    }
+    server_config_watch_refresh(server);
+}
+
+void server_config_watch_refresh(struct fbwl_server *server) {
+    if (server == NULL || server->config_watch.fd_source == NULL) {
+        return;
+    }
+    struct fbwl_config_watch *watch = &server->config_watch;
+    fbwl_config_watch_begin(watch);
+
+    char *init_path = NULL;
+    if (server->init_file != NULL && *server->init_file != '\0') {
+        init_path = fbwl_resolve_config_path(NULL, server->init_file);
+    } else if (server->config_dir != NULL && *server->config_dir != '\0') {
+        init_path = fbwl_path_join(server->config_dir, "init");
+    }
+    (void)fbwl_config_watch_add(watch, init_path, FBWL_RECONFIGURE_INIT);
+    free(init_path);
+
+    (void)fbwl_config_watch_add(watch, server->keys_file, FBWL_RECONFIGURE_KEYS);
+    (void)fbwl_config_watch_add(watch, server->apps_file, FBWL_RECONFIGURE_APPS);
+    (void)fbwl_config_watch_add(watch, server->style_file, FBWL_RECONFIGURE_STYLE);
+    (void)fbwl_config_watch_add(watch, server->style_overlay_file, FBWL_RECONFIGURE_STYLE);
+    fbwl_decor_theme_for_each_file(&server->decor_theme, server_config_watch_add_style_file, watch);
+    (void)fbwl_config_watch_add(watch, server->menu_file, FBWL_RECONFIGURE_MENU);
+    for (size_t i = 0; i < server->menu_sources_len; i++) {
+        (void)fbwl_config_watch_add(watch, server->menu_sources[i], FBWL_RECONFIGURE_MENU);
+    }
+    (void)fbwl_config_watch_add(watch, server->window_menu_file, FBWL_RECONFIGURE_MENU);
+    fbwl_config_watch_end(watch);
+
+    wlr_log(WLR_DEBUG, "ConfigWatch: watching %zu paths", watch->entries_len);
+}
+
+void server_config_watch_finish(struct fbwl_server *server) {
+    if (server == NULL) {
+        return;
+    }
+    if (server->config_watch.fd_source != NULL) {
+        fbwl_config_watch_finish(&server->config_watch);
+    }
+    fbwl_string_list_free(server->menu_sources, server->menu_sources_len);
+    server->menu_sources = NULL;
+    server->menu_sources_len = 0;
+}
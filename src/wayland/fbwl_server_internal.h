@@ -12,12 +12,15 @@
 
 #include "wmcore/fbwm_core.h"
 #include "wayland/fbwl_apps_rules.h"
+#include "wayland/fbwl_config_watch.h"
 #include "wayland/fbwl_grabs.h"
 #include "wayland/fbwl_ipc.h"
 #include "wayland/fbwl_keybindings.h"
 #include "wayland/fbwl_mousebindings.h"
 #include "wayland/fbwl_shortcuts_inhibit.h"
 #include "wayland/fbwl_session_lock.h"
+#include "wayland/fbwl_session_snapshot.h"
+#include "wayland/fbwl_socket_handover.h"
 #include "wayland/fbwl_text_input.h"
 #include "wayland/fbwl_pointer_constraints.h"
 #include "wayland/fbwl_screencopy.h"
@@ -31,6 +34,8 @@
 #include "wayland/fbwl_xdg_decoration.h"
 #include "wayland/fbwl_wallpaper.h"
 #include "wayland/fbwl_menu.h"
+#include "wayland/fbwl_menu_cache.h"
+#include "wayland/fbwl_resource_db.h"
 #include "wayland/fbwl_ui_menu.h"
 #include "wayland/fbwl_ui_toolbar.h"
 #include "wayland/fbwl_ui_slit.h"
@@ -80,17 +85,7 @@ struct wlr_pointer_button_event;
 struct wlr_pointer_axis_event;
 
 struct fbwl_view;
-
-struct fbwl_resource_kv {
-    char *key;
-    char *value;
-};
-
-struct fbwl_resource_db {
-    struct fbwl_resource_kv *items;
-    size_t items_len;
-    size_t items_cap;
-};
+struct fbwl_xwayland_icon_conn;
 
 enum fbwl_focus_model {
     FBWL_FOCUS_MODEL_CLICK_TO_FOCUS = 0,
@@ -275,6 +270,10 @@ struct fbwl_server {
     char *menu_file;
     char *window_menu_file;
     char *slitlist_file;
+    char **menu_sources;
+    size_t menu_sources_len;
+    struct fbwl_menu_cache menu_cache;
+    struct fbwl_config_watch config_watch;
     bool workspaces_override;
     bool keys_file_override;
     bool apps_file_override;
@@ -302,6 +301,8 @@ struct fbwl_server {
     struct wlr_output_power_manager_v1 *output_power_mgr;
     struct wl_listener output_power_set_mode;
     struct wl_list outputs;
+    uint32_t usable_epoch;
+    struct wl_event_source *usable_check_idle;
     struct wl_listener new_output;
 
     struct wlr_xdg_shell *xdg_shell;
@@ -311,6 +312,10 @@ struct fbwl_server {
     struct wlr_xwayland *xwayland;
     struct wl_listener xwayland_ready;
     struct wl_listener xwayland_new_surface;
+    struct fbwl_xwayland_icon_conn *icon_conn;
+    struct wl_event_source *icon_conn_source;
+    size_t icon_fetches_pending;
+    struct wl_event_source *icon_refresh_idle;
     pid_t xembed_sni_proxy_pid;
 
     struct wlr_layer_shell_v1 *layer_shell;
@@ -376,6 +381,13 @@ struct fbwl_server {
     const char *terminal_cmd;
     bool restart_requested;
     char *restart_cmd;
+    struct fbwl_session_snapshot session_restore;
+    char *session_file;
+    struct wl_event_source *session_timer;
+    uint64_t session_last_hash;
+    bool session_saved;
+    int session_restore_ticks;
+    uint64_t session_loaded_msec;
     bool has_pointer;
     bool ignore_border;
     bool force_pseudo_transparency;
@@ -423,6 +435,7 @@ struct fbwl_server {
 
     struct fbwl_keybinding *keybindings;
     size_t keybinding_count;
+    struct fbwl_keybindings_cycle_session cycle_session;
     char *key_mode;
     bool key_mode_return_active;
     enum fbwl_keybinding_key_kind key_mode_return_kind;
@@ -442,6 +455,15 @@ struct fbwl_server {
     size_t apps_rule_count;
     bool apps_rules_rewrite_safe;
     uint64_t apps_rules_generation;
+    // Remember edits are written once after a quiet period; the stat of our
+    // last write lets the config watch skip reloading our own output.
+    struct wl_event_source *apps_save_timer;
+    bool apps_rules_dirty;
+    bool apps_file_saved_valid;
+    dev_t apps_file_saved_dev;
+    ino_t apps_file_saved_ino;
+    off_t apps_file_saved_size;
+    int64_t apps_file_saved_mtime_ns;
     uint64_t view_create_seq;
 
     struct fbwm_core wm;
@@ -455,8 +477,22 @@ struct fbwl_server {
     struct fbwl_view *auto_raise_pending_view;
 };
 
+enum fbwl_reconfigure_part {
+    FBWL_RECONFIGURE_INIT = 1u << 0,
+    FBWL_RECONFIGURE_KEYS = 1u << 1,
+    FBWL_RECONFIGURE_APPS = 1u << 2,
+    FBWL_RECONFIGURE_STYLE = 1u << 3,
+    FBWL_RECONFIGURE_MENU = 1u << 4,
+    // a pixmap the style references changed: reload it even if the parsed
+    // values are identical
+    FBWL_RECONFIGURE_STYLE_FILES = 1u << 5,
+    FBWL_RECONFIGURE_ALL = (1u << 6) - 1,
+};
+
 struct fbwl_server_bootstrap_options {
     const char *socket_name;
+    // Listening socket kept across Restart; NULL lets libwayland own it.
+    struct fbwl_socket_handover *socket_handover;
     const char *ipc_socket_path;
     const char *startup_cmd;
     const char *terminal_cmd;
@@ -499,11 +535,6 @@ const char *fbwl_tabs_attach_area_str(enum fbwl_tabs_attach_area area);
 bool fbwl_titlebar_buttons_parse(const char *s, enum fbwl_decor_hit_kind *out, size_t cap, size_t *out_len);
 void fbwl_apply_workspace_names_from_init(struct fbwm_core *wm, const char *csv);
 
-void fbwl_resource_db_free(struct fbwl_resource_db *db);
-bool fbwl_resource_db_load_init(struct fbwl_resource_db *db, const char *config_dir, const char *init_file);
-const char *fbwl_resource_db_get(const struct fbwl_resource_db *db, const char *key);
-size_t fbwl_resource_db_max_screen_index(const struct fbwl_resource_db *db);
-const char *fbwl_resource_db_get_screen(const struct fbwl_resource_db *db, size_t screen, const char *suffix);
 bool fbwl_resource_db_get_bool(const struct fbwl_resource_db *db, const char *key, bool *out);
 bool fbwl_resource_db_get_screen_bool(const struct fbwl_resource_db *db, size_t screen, const char *suffix, bool *out);
 bool fbwl_resource_db_get_int(const struct fbwl_resource_db *db, const char *key, int *out);
@@ -585,10 +616,14 @@ bool server_wallpaper_set(struct fbwl_server *server, const char *path, enum fbw
 bool server_wallpaper_set_buffer(struct fbwl_server *server, struct wlr_buffer *buf, enum fbwl_wallpaper_mode mode,
         const char *path_label, const char *why);
 void server_pseudo_transparency_refresh(struct fbwl_server *server, const char *why);
+void server_layers_usable_changed(void *userdata, struct wlr_output *wlr_output);
+void server_usable_schedule_check(struct fbwl_server *server);
+void server_usable_invalidate(struct fbwl_server *server, const char *why);
 void server_background_apply_style(struct fbwl_server *server, const struct fbwl_decor_theme *theme, const char *why);
 bool fbwl_server_bootstrap(struct fbwl_server *server, const struct fbwl_server_bootstrap_options *opts);
 void fbwl_server_finish(struct fbwl_server *server);
 void server_toolbar_ui_rebuild(struct fbwl_server *server);
+void server_toolbar_ui_update_workspace(struct fbwl_server *server);
 void server_toolbar_ui_update_position(struct fbwl_server *server);
 void server_toolbar_ui_update_iconbar_focus(struct fbwl_server *server);
 bool server_toolbar_ui_handle_click(struct fbwl_server *server, int lx, int ly, uint32_t button);
@@ -610,6 +645,7 @@ void server_cmd_dialog_ui_close(struct fbwl_server *server, const char *why);
 void server_cmd_dialog_ui_open(struct fbwl_server *server);
 bool server_cmd_dialog_ui_handle_key(struct fbwl_server *server, xkb_keysym_t sym, uint32_t modifiers);
 int server_osd_hide_timer(void *data);
+int server_move_osd_render_timer(void *data);
 int server_auto_raise_timer(void *data);
 void server_osd_ui_update_position(struct fbwl_server *server);
 void server_osd_ui_destroy(struct fbwl_server *server);
@@ -630,7 +666,19 @@ void fbwl_server_key_mode_set(struct fbwl_server *server, const char *mode);
 
 struct fbwl_keybindings_hooks keybindings_hooks(struct fbwl_server *server);
 void server_reconfigure(struct fbwl_server *server);
+void server_reconfigure_parts(struct fbwl_server *server, uint32_t parts, bool force);
+void server_config_watch_init(struct fbwl_server *server);
+void server_config_watch_refresh(struct fbwl_server *server);
+void server_config_watch_finish(struct fbwl_server *server);
+void server_menu_note_source(void *userdata, const char *path);
 void server_request_restart(struct fbwl_server *server, const char *cmd);
+
+void server_session_init(struct fbwl_server *server, const char *socket);
+void server_session_finish(struct fbwl_server *server);
+bool server_session_save(struct fbwl_server *server, const char *why);
+const struct fbwl_session_entry *server_session_restore_pre_map(struct fbwl_server *server, struct fbwl_view *view);
+void server_session_restore_post_map(struct fbwl_server *server, struct fbwl_view *view,
+        const struct fbwl_session_entry *entry, bool *out_focus);
 void server_keybindings_restart(void *userdata, const char *cmd);
 void server_apps_rules_apply_pre_map(struct fbwl_view *view, const struct fbwl_apps_rule *rule);
 void server_apps_rules_apply_post_map(struct fbwl_view *view, const struct fbwl_apps_rule *rule);
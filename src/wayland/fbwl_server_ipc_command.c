@@ -1,5 +1,7 @@
 #include <ctype.h>
 #include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -9,7 +11,10 @@
 
 #include "wayland/fbwl_cmdlang.h"
 #include "wayland/fbwl_keybindings.h"
+#include "wayland/fbwl_perf.h"
 #include "wayland/fbwl_server_internal.h"
+#include "wayland/fbwl_spawn.h"
+#include "wayland/fbwl_trace.h"
 
 static char *ipc_trim_inplace(char *s) {
     while (s != NULL && *s != '\0' && isspace((unsigned char)*s)) {
@@ -34,12 +39,12 @@ static bool ipc_exec_action_nodup_depth(enum fbwl_keybinding_action action, int
     return fbwl_keybindings_execute_action(action, arg, cmd, target_view, hooks);
 }
 
-void server_ipc_command(void *userdata, int client_fd, char *line) {
-    struct fbwl_server *server = userdata;
-    if (server == NULL || line == NULL) {
-        return;
-    }
+static void ipc_emit_line(void *userdata, const char *line) {
+    const int *client_fd = userdata;
+    fbwl_ipc_send_line(*client_fd, line);
+}
 
+static void ipc_command_dispatch(struct fbwl_server *server, int client_fd, char *line) {
     line = ipc_trim_inplace(line);
     if (line == NULL || *line == '\0') {
         fbwl_ipc_send_line(client_fd, "err empty_command");
@@ -105,6 +110,64 @@ void server_ipc_command(void *userdata, int client_fd, char *line) {
         return;
     }
 
+    if (strcasecmp(cmd, "trace-dump") == 0 || strcasecmp(cmd, "tracedump") == 0) {
+        char *rest = ipc_trim_inplace(saveptr);
+        if (rest == NULL || *rest == '\0') {
+            fbwl_ipc_send_line(client_fd, "ok");
+            (void)fbwl_trace_dump(ipc_emit_line, &client_fd);
+            return;
+        }
+        size_t count = 0;
+        if (!fbwl_trace_dump_file(rest, &count)) {
+            fbwl_ipc_send_line(client_fd, "err trace_dump_failed");
+            return;
+        }
+        char resp[512];
+        snprintf(resp, sizeof(resp), "ok events=%zu path=%s", count, rest);
+        fbwl_ipc_send_line(client_fd, resp);
+        return;
+    }
+
+    if (strcasecmp(cmd, "trace-text") == 0 || strcasecmp(cmd, "tracetext") == 0) {
+        char *rest = ipc_trim_inplace(saveptr);
+        uint32_t mask = 0;
+        if (rest == NULL || *rest == '\0' || !fbwl_trace_parse_mask(rest, &mask)) {
+            fbwl_ipc_send_line(client_fd, "err invalid_trace_categories");
+            return;
+        }
+        fbwl_trace_text_mask = mask;
+        fbwl_ipc_send_line(client_fd, "ok");
+        return;
+    }
+
+    if (strcasecmp(cmd, "perf-stats") == 0 || strcasecmp(cmd, "perfstats") == 0) {
+        char *rest = ipc_trim_inplace(saveptr);
+        fbwl_ipc_send_line(client_fd, "ok");
+        (void)fbwl_perf_dump(ipc_emit_line, &client_fd);
+        if (rest != NULL && strcasecmp(rest, "reset") == 0) {
+            fbwl_perf_reset();
+        }
+        return;
+    }
+
+    if (strcasecmp(cmd, "perf-reset") == 0 || strcasecmp(cmd, "perfreset") == 0) {
+        fbwl_perf_reset();
+        fbwl_ipc_send_line(client_fd, "ok");
+        return;
+    }
+
+    if (strcasecmp(cmd, "launches") == 0 || strcasecmp(cmd, "spawn-stats") == 0) {
+        struct fbwl_spawn_stats stats;
+        fbwl_spawn_get_stats(&stats);
+        char resp[256];
+        snprintf(resp, sizeof(resp), "ok launched=%llu direct=%llu failed=%llu running=%zu",
+            (unsigned long long)stats.launched, (unsigned long long)stats.direct,
+            (unsigned long long)stats.failed, stats.running);
+        fbwl_ipc_send_line(client_fd, resp);
+        (void)fbwl_spawn_dump(ipc_emit_line, &client_fd);
+        return;
+    }
+
     if (strcasecmp(cmd, "wallpaper") == 0 || strcasecmp(cmd, "setwallpaper") == 0 ||
             strcasecmp(cmd, "set-wallpaper") == 0) {
         char *rest = ipc_trim_inplace(saveptr);
@@ -302,3 +365,13 @@ void server_ipc_command(void *userdata, int client_fd, char *line) {
 
     fbwl_ipc_send_line(client_fd, "ok");
 }
+
+void server_ipc_command(void *userdata, int client_fd, char *line) {
+    struct fbwl_server *server = userdata;
+    if (server == NULL || line == NULL) {
+        return;
+    }
+    const uint64_t start = fbwl_perf_now();
+    ipc_command_dispatch(server, client_fd, line);
+    fbwl_perf_record(FBWL_PERF_IPC, start);
+}
@@ -741,7 +741,7 @@ void server_keybindings_remove_last_workspace(void *userdata) {
     const int target_ws = next - 1;
     for (struct fbwm_view *walk = server->wm.views.next; walk != &server->wm.views; walk = walk->next) {
         if (!walk->sticky && walk->workspace >= next) {
-            walk->workspace = target_ws;
+            fbwm_core_view_set_workspace(&server->wm, walk, target_ws);
         }
     }
     fbwm_core_set_workspace_count(&server->wm, next);
@@ -888,7 +888,7 @@ void server_keybindings_deiconify(void *userdata, const char *args, int cursor_x
     if (dest == DEICONIFY_DEST_CURRENT) {
         for (size_t i = 0; i < picks.len; i++) {
             if (!picks.items[i]->wm_view.sticky) {
-                picks.items[i]->wm_view.workspace = ws;
+                fbwm_core_view_set_workspace(&server->wm, &picks.items[i]->wm_view, ws);
             }
         }
     } else if (dest == DEICONIFY_DEST_ORIGIN) {
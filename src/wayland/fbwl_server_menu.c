@@ -8,8 +8,9 @@
 
 #include <wlr/util/log.h>
 
-#include "wayland/fbwl_menu_parse.h"
+#include "wayland/fbwl_menu_cache.h"
 #include "wayland/fbwl_server_internal.h"
+#include "wayland/fbwl_string_list.h"
 
 static const char *window_menu_default_label(const char *key) {
     if (key == NULL) {
@@ -479,7 +480,7 @@ static bool server_window_menu_load_file(struct fbwl_server *server, const char
     if (menu == NULL) {
         return false;
     }
-    if (!fbwl_menu_parse_file(menu, &server->wm, path)) {
+    if (!fbwl_menu_cache_parse_file(&server->menu_cache, menu, &server->wm, path, NULL, NULL)) {
         fbwl_menu_free(menu);
         return false;
     }
@@ -929,7 +930,11 @@ bool server_menu_load_file(struct fbwl_server *server, const char *path) {
         return false;
     }
 
-    if (!fbwl_menu_parse_file(server->root_menu, &server->wm, path)) {
+    fbwl_string_list_free(server->menu_sources, server->menu_sources_len);
+    server->menu_sources = NULL;
+    server->menu_sources_len = 0;
+    if (!fbwl_menu_cache_parse_file(&server->menu_cache, server->root_menu, &server->wm, path,
+            server_menu_note_source, server)) {
         fbwl_menu_free(server->root_menu);
         server->root_menu = NULL;
         return false;
@@ -956,14 +961,15 @@ bool server_menu_load_custom_file(struct fbwl_server *server, const char *path)
         return false;
     }
 
-    if (!fbwl_menu_parse_file(server->custom_menu, &server->wm, resolved)) {
+    if (!fbwl_menu_cache_parse_file(&server->menu_cache, server->custom_menu, &server->wm, resolved, NULL, NULL)) {
         fbwl_menu_free(server->custom_menu);
         server->custom_menu = NULL;
         free(resolved);
         return false;
     }
 
-    wlr_log(WLR_INFO, "CustomMenu: loaded %zu items from %s", server->custom_menu->item_count, resolved);
+    wlr_log(WLR_INFO, "CustomMenu: loaded %zu items from %s title=%s", server->custom_menu->item_count, resolved,
+        server->custom_menu->label != NULL ? server->custom_menu->label : "");
     free(resolved);
     return true;
 }
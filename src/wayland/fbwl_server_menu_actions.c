@@ -495,7 +495,7 @@ void server_menu_handle_server_action(struct fbwl_server *server, enum fbwl_menu
         if (view == NULL) {
             return;
         }
-        view->wm_view.sticky = !view->wm_view.sticky;
+        fbwm_core_view_set_sticky(&server->wm, &view->wm_view, !view->wm_view.sticky);
         wlr_log(WLR_INFO, "Stick: %s %s", fbwl_view_display_title(view), view->wm_view.sticky ? "on" : "off");
         apply_workspace_visibility(server, view->wm_view.sticky ? "stick-on" : "stick-off");
         return;
@@ -555,7 +555,7 @@ void server_menu_handle_server_action(struct fbwl_server *server, enum fbwl_menu
         if (server->wm.focused == &view->wm_view) {
             fbwm_core_move_focused_to_workspace(&server->wm, ws);
         } else {
-            view->wm_view.workspace = ws;
+            fbwm_core_view_set_workspace(&server->wm, &view->wm_view, ws);
             wlr_log(WLR_INFO, "Policy: move window-menu target to workspace %d title=%s app_id=%s",
                 ws + 1, fbwl_view_title(view) != NULL ? fbwl_view_title(view) : "(null)",
                 fbwl_view_app_id(view) != NULL ? fbwl_view_app_id(view) : "(null)");
@@ -578,7 +578,7 @@ void server_menu_handle_server_action(struct fbwl_server *server, enum fbwl_menu
         if (server->wm.focused == &view->wm_view) {
             fbwm_core_move_focused_to_workspace(&server->wm, ws);
         } else {
-            view->wm_view.workspace = ws;
+            fbwm_core_view_set_workspace(&server->wm, &view->wm_view, ws);
             wlr_log(WLR_INFO, "Policy: move window-menu target to workspace %d title=%s app_id=%s",
                 ws + 1, fbwl_view_title(view) != NULL ? fbwl_view_title(view) : "(null)",
                 fbwl_view_app_id(view) != NULL ? fbwl_view_app_id(view) : "(null)");
@@ -1,5 +1,6 @@
 #include "wayland/fbwl_server_internal.h"
 
+#include "wayland/fbwl_cursor.h"
 #include "wayland/fbwl_output.h"
 #include "wayland/fbwl_output_management.h"
 #include "wayland/fbwl_output_power.h"
@@ -366,6 +367,8 @@ static void server_background_update_output(struct fbwl_server *server, struct f
 
     struct wlr_box box = {0};
     wlr_output_layout_get_box(server->output_layout, output->wlr_output, &box);
+    output->background_box = box;
+    fbwl_pseudo_bg_invalidate_all();
 
     if (box.width < 1 || box.height < 1) {
         if (output->background_image != NULL) {
@@ -508,10 +511,28 @@ static void server_background_update_all(struct fbwl_server *server) {
     }
 }
 
+// After a layout change only outputs whose box moved or resized need their
+// background (and a tiled wallpaper copy) rebuilt.
+static size_t server_background_update_moved(struct fbwl_server *server) {
+    size_t updated = 0;
+    struct fbwl_output *out;
+    wl_list_for_each(out, &server->outputs, link) {
+        struct wlr_box box = {0};
+        wlr_output_layout_get_box(server->output_layout, out->wlr_output, &box);
+        if (wlr_box_equal(&box, &out->background_box)) {
+            continue;
+        }
+        server_background_update_output(server, out);
+        updated++;
+    }
+    return updated;
+}
+
 void server_pseudo_transparency_refresh(struct fbwl_server *server, const char *why) {
     if (server == NULL) {
         return;
     }
+    fbwl_pseudo_bg_invalidate_all();
     for (struct fbwm_view *wm_view = server->wm.views.next;
             wm_view != &server->wm.views;
             wm_view = wm_view->next) {
@@ -600,13 +621,85 @@ bool server_wallpaper_set(struct fbwl_server *server, const char *path, enum fbw
     return true;
 }
 
+// Refits the maximized views on every output whose usable box moved since the
+// last check, in a single pass over the views however many sources changed.
+static void server_usable_check(void *data) {
+    struct fbwl_server *server = data;
+    server->usable_check_idle = NULL;
+    if (server->output_layout == NULL) {
+        return;
+    }
+
+    size_t changed = 0;
+    struct fbwl_output *out;
+    wl_list_for_each(out, &server->outputs, link) {
+        struct fbwl_output_usable_cache *cache = &out->usable_cache;
+        struct wlr_box box = {0};
+        fbwl_output_usable_box(server, server->output_layout, &server->outputs, out->wlr_output, &box);
+        cache->refit_pending = cache->notified_valid && !wlr_box_equal(&cache->notified, &box);
+        cache->notified = box;
+        cache->notified_valid = true;
+        if (cache->refit_pending) {
+            changed++;
+            wlr_log(WLR_INFO, "Usable: output=%s box=%d,%d %dx%d",
+                out->wlr_output->name != NULL ? out->wlr_output->name : "(unnamed)",
+                box.x, box.y, box.width, box.height);
+        }
+    }
+    if (changed == 0) {
+        return;
+    }
+
+    for (struct fbwm_view *walk = server->wm.views.next; walk != &server->wm.views; walk = walk->next) {
+        struct fbwl_view *view = walk->userdata;
+        if (view == NULL || !view->mapped || view->fullscreen || (!view->maximized_h && !view->maximized_v)) {
+            continue;
+        }
+        const double cx = view->x + (double)fbwl_view_current_width(view) / 2.0;
+        const double cy = view->y + (double)fbwl_view_current_height(view) / 2.0;
+        struct fbwl_output *view_out = fbwl_output_find(&server->outputs,
+            wlr_output_layout_output_at(server->output_layout, cx, cy));
+        if (view_out == NULL || !view_out->usable_cache.refit_pending) {
+            continue;
+        }
+        fbwl_view_refit_maximized(view, server->output_layout, &server->outputs);
+    }
+    wl_list_for_each(out, &server->outputs, link) {
+        out->usable_cache.refit_pending = false;
+    }
+}
+
+void server_usable_schedule_check(struct fbwl_server *server) {
+    if (server == NULL || server->wl_display == NULL || server->usable_check_idle != NULL) {
+        return;
+    }
+    struct wl_event_loop *loop = wl_display_get_event_loop(server->wl_display);
+    server->usable_check_idle = wl_event_loop_add_idle(loop, server_usable_check, server);
+}
+
+void server_usable_invalidate(struct fbwl_server *server, const char *why) {
+    if (server == NULL) {
+        return;
+    }
+    server->usable_epoch++;
+    wlr_log(WLR_DEBUG, "Usable: invalidated reason=%s", why != NULL ? why : "(null)");
+    server_usable_schedule_check(server);
+}
+
+void server_layers_usable_changed(void *userdata, struct wlr_output *wlr_output) {
+    (void)wlr_output;
+    server_usable_schedule_check(userdata);
+}
+
 static void server_output_management_arrange_layers_on_output(void *userdata, struct wlr_output *wlr_output) {
     struct fbwl_server *server = userdata;
     if (server == NULL) {
         return;
     }
-    fbwl_scene_layers_arrange_layer_surfaces_on_output(server->output_layout, &server->outputs, &server->layer_surfaces,
-        wlr_output);
+    if (fbwl_scene_layers_arrange_layer_surfaces_on_output(server->output_layout, &server->outputs,
+            &server->layer_surfaces, wlr_output)) {
+        server_layers_usable_changed(server, wlr_output);
+    }
 }
 
 static void server_update_head_count(struct fbwl_server *server, const char *why) {
@@ -623,6 +716,7 @@ static void server_update_head_count(struct fbwl_server *server, const char *why
     }
     fbwm_core_set_head_count(&server->wm, heads);
     wlr_log(WLR_INFO, "Workspace: heads=%zu reason=%s", heads, why != NULL ? why : "(null)");
+    server_usable_invalidate(server, why);
 }
 
 static void server_output_manager_test(struct wl_listener *listener, void *data) {
@@ -649,8 +743,14 @@ static void server_output_manager_apply(struct wl_listener *listener, void *data
         config, false, server_output_management_arrange_layers_on_output, server);
     if (ok) {
         wlr_output_configuration_v1_send_succeeded(config);
+        // One round of UI updates for the whole batch, however many heads changed.
         fbwl_output_manager_update(server->output_manager, &server->outputs, server->output_layout);
-        server_background_update_all(server);
+        struct fbwl_output *out;
+        wl_list_for_each(out, &server->outputs, link) {
+            fbwl_cursor_preload(server->cursor_mgr, out->wlr_output->scale);
+        }
+        const size_t backgrounds = server_background_update_moved(server);
+        wlr_log(WLR_DEBUG, "OutputMgmt: backgrounds rebuilt=%zu", backgrounds);
         fbwl_screen_map_log(server->output_layout, &server->outputs, "output-management-apply");
         server_update_head_count(server, "output-management-apply");
         server_toolbar_ui_update_position(server);
@@ -711,6 +811,7 @@ static void server_new_output(struct wl_listener *listener, void *data) {
         return;
     }
 
+    fbwl_cursor_preload(server->cursor_mgr, wlr_output->scale);
     server_background_update_output(server, output);
     fbwl_scene_layers_arrange_layer_surfaces_on_output(server->output_layout, &server->outputs, &server->layer_surfaces,
         wlr_output);
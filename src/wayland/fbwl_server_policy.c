@@ -27,7 +27,9 @@
 #include "wayland/fbwl_output.h"
 #include "wayland/fbwl_screen_map.h"
 #include "wayland/fbwl_server_internal.h"
+#include "wayland/fbwl_server_window_remember.h"
 #include "wayland/fbwl_tabs.h"
+#include "wayland/fbwl_trace.h"
 #include "wayland/fbwl_util.h"
 #include "wayland/fbwl_view.h"
 #include "wayland/fbwl_view_attention.h"
@@ -386,7 +388,7 @@ void focus_view(struct fbwl_view *view) {
 
     fbwl_view_attention_clear(view, &server->decor_theme, "focus");
 
-    wlr_log(WLR_INFO, "Focus: %s (%s)",
+    fbwl_trace(FBWL_TRACE_FOCUS, "Focus: %s (%s)",
         fbwl_view_title(view) != NULL ? fbwl_view_title(view) : "(no-title)",
         fbwl_view_app_id(view) != NULL ? fbwl_view_app_id(view) : "(no-app-id)");
 
@@ -597,12 +599,12 @@ void server_apps_rules_apply_pre_map(struct fbwl_view *view,
                 wlr_log(WLR_ERROR, "Apps: ignoring out-of-range workspace_id=%d (count=%d) for %s",
                 ws, count, fbwl_view_display_title(view));
             } else {
-                view->wm_view.workspace = ws;
+                fbwm_core_view_set_workspace(&server->wm, &view->wm_view, ws);
             }
     }
 
     if (rule->set_sticky) {
-        view->wm_view.sticky = rule->sticky;
+        fbwm_core_view_set_sticky(&server->wm, &view->wm_view, rule->sticky);
     }
 
     if (rule->set_workspace && rule->set_jump && rule->jump) {
@@ -981,7 +983,7 @@ void server_apps_rules_save_on_close(struct fbwl_view *view) {
         }
     }
 
-    if (fbwl_apps_rules_save_file(server->apps_rules, server->apps_rule_count, server->apps_file)) {
+    if (server_apps_rules_write(server)) {
         wlr_log(WLR_INFO, "Apps: save-on-close wrote %s rule=%zu title=%s app_id=%s",
             server->apps_file,
             rule_idx,
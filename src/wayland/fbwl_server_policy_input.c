@@ -21,10 +21,13 @@
 #include <wlr/util/log.h>
 #include <wlr/xwayland.h>
 #include "wayland/fbwl_cursor.h"
+#include "wayland/fbwl_perf.h"
 #include "wayland/fbwl_server_keybinding_actions.h"
 #include "wayland/fbwl_server_menu_actions.h"
 #include "wayland/fbwl_server_internal.h"
+#include "wayland/fbwl_spawn.h"
 #include "wayland/fbwl_tabs.h"
+#include "wayland/fbwl_trace.h"
 #include "wayland/fbwl_util.h"
 #include "wayland/fbwl_view.h"
 
@@ -94,7 +97,7 @@ void server_raise_view(struct fbwl_view *view, const char *why) {
     struct fbwl_server *server = view->server;
     struct fbwl_view *before = server_strict_mousefocus_view_under_cursor(server);
     wlr_scene_node_raise_to_top(&view->scene_tree->node);
-    wlr_log(WLR_INFO, "Raise: %s reason=%s",
+    fbwl_trace(FBWL_TRACE_STACK, "Raise: %s reason=%s",
         fbwl_view_display_title(view),
         why != NULL ? why : "(null)");
     server_strict_mousefocus_recheck_after_restack(server, before, why);
@@ -107,7 +110,7 @@ void server_lower_view(struct fbwl_view *view, const char *why) {
     struct fbwl_server *server = view->server;
     struct fbwl_view *before = server_strict_mousefocus_view_under_cursor(server);
     wlr_scene_node_lower_to_bottom(&view->scene_tree->node);
-    wlr_log(WLR_INFO, "Lower: %s reason=%s",
+    fbwl_trace(FBWL_TRACE_STACK, "Lower: %s reason=%s",
         fbwl_view_display_title(view),
         why != NULL ? why : "(null)");
     server_strict_mousefocus_recheck_after_restack(server, before, why);
@@ -331,6 +334,7 @@ static void server_update_pointer_focus(struct fbwl_server *server, enum fbwl_fo
 void server_cursor_motion(struct wl_listener *listener, void *data) {
     struct fbwl_server *server = wl_container_of(listener, server, cursor_motion);
     struct wlr_pointer_motion_event *event = data;
+    const uint64_t start = fbwl_perf_now();
     fbwl_idle_notify_activity(&server->idle);
     const struct fbwl_cursor_menu_hooks hooks = server_cursor_menu_hooks(server);
     fbwl_cursor_handle_motion(server->cursor, server->cursor_mgr, server->scene, server->seat,
@@ -349,10 +353,12 @@ void server_cursor_motion(struct wl_listener *listener, void *data) {
     if (server->menu_ui.open) {
         fbwl_ui_menu_handle_motion(&server->menu_ui, (int)server->cursor->x, (int)server->cursor->y);
     }
+    fbwl_perf_record(FBWL_PERF_MOTION, start);
 }
 void server_cursor_motion_absolute(struct wl_listener *listener, void *data) {
     struct fbwl_server *server = wl_container_of(listener, server, cursor_motion_absolute);
     struct wlr_pointer_motion_absolute_event *event = data;
+    const uint64_t start = fbwl_perf_now();
     fbwl_idle_notify_activity(&server->idle);
     const struct fbwl_cursor_menu_hooks hooks = server_cursor_menu_hooks(server);
     fbwl_cursor_handle_motion_absolute(server->cursor, server->cursor_mgr, server->scene, server->seat,
@@ -371,6 +377,7 @@ void server_cursor_motion_absolute(struct wl_listener *listener, void *data) {
     if (server->menu_ui.open) {
         fbwl_ui_menu_handle_motion(&server->menu_ui, (int)server->cursor->x, (int)server->cursor->y);
     }
+    fbwl_perf_record(FBWL_PERF_MOTION, start);
 }
 
 void server_cursor_button(struct wl_listener *listener, void *data) {
@@ -600,7 +607,7 @@ void server_cursor_button(struct wl_listener *listener, void *data) {
                     return;
                 }
                 if (hit.kind == FBWL_DECOR_HIT_BTN_STICK) {
-                    view->wm_view.sticky = !view->wm_view.sticky;
+                    fbwm_core_view_set_sticky(&server->wm, &view->wm_view, !view->wm_view.sticky);
                     wlr_log(WLR_INFO, "Stick: %s %s", fbwl_view_display_title(view), view->wm_view.sticky ? "on" : "off");
                     apply_workspace_visibility(server, view->wm_view.sticky ? "stick-on" : "stick-off");
                     return;
@@ -941,6 +948,7 @@ struct fbwl_keybindings_hooks keybindings_hooks(struct fbwl_server *server) {
         .userdata = server,
         .cmdlang_scope = NULL,
         .wm = server != NULL ? &server->wm : NULL,
+        .cycle_session = server != NULL ? &server->cycle_session : NULL,
         .key_mode = server != NULL ? server->key_mode : NULL,
         .key_mode_set = keybindings_key_mode_set,
         .terminate = keybindings_terminate, .restart = server_keybindings_restart,
@@ -8,28 +8,39 @@
 
 #include "wayland/fbwl_keys_parse.h"
 #include "wayland/fbwl_server_internal.h"
+#include "wayland/fbwl_server_window_remember.h"
 #include "wayland/fbwl_string_list.h"
 #include "wayland/fbwl_style_parse.h"
 #include "wayland/fbwl_ui_menu_icon.h"
 #include "wayland/fbwl_ui_menu_search.h"
 
+// Bindings are parsed into a fresh table and only swapped in once parsing is
+// done, so a reload never leaves the live table half-built.
+struct reconfigure_bindings {
+    struct fbwl_server *server;
+    struct fbwl_keybinding *keybindings;
+    size_t keybinding_count;
+    struct fbwl_mousebinding *mousebindings;
+    size_t mousebinding_count;
+};
+
 static bool server_keybindings_add_from_keys_file(void *userdata, enum fbwl_keybinding_key_kind key_kind,
         uint32_t keycode, xkb_keysym_t sym, uint32_t modifiers, enum fbwl_keybinding_action action, int arg,
         const char *cmd, const char *mode) {
-    struct fbwl_server *server = userdata;
+    struct reconfigure_bindings *b = userdata;
     if (key_kind == FBWL_KEYBIND_PLACEHOLDER) {
-        return fbwl_keybindings_add_placeholder(&server->keybindings, &server->keybinding_count, modifiers,
+        return fbwl_keybindings_add_placeholder(&b->keybindings, &b->keybinding_count, modifiers,
             action, arg, cmd, mode);
     }
     if (key_kind == FBWL_KEYBIND_CHANGE_WORKSPACE) {
-        return fbwl_keybindings_add_change_workspace(&server->keybindings, &server->keybinding_count,
+        return fbwl_keybindings_add_change_workspace(&b->keybindings, &b->keybinding_count,
             action, arg, cmd, mode);
     }
     if (key_kind == FBWL_KEYBIND_KEYCODE) {
-        return fbwl_keybindings_add_keycode(&server->keybindings, &server->keybinding_count, keycode, modifiers,
+        return fbwl_keybindings_add_keycode(&b->keybindings, &b->keybinding_count, keycode, modifiers,
             action, arg, cmd, mode);
     }
-    return fbwl_keybindings_add(&server->keybindings, &server->keybinding_count, sym, modifiers, action, arg, cmd, mode);
+    return fbwl_keybindings_add(&b->keybindings, &b->keybinding_count, sym, modifiers, action, arg, cmd, mode);
 }
 
 static bool cmd_contains_startmoving(const char *s) {
@@ -54,21 +65,49 @@ static bool cmd_contains_startmoving(const char *s) {
 static bool server_mousebindings_add_from_keys_file(void *userdata, enum fbwl_mousebinding_context context,
         enum fbwl_mousebinding_event_kind event_kind, int button, uint32_t modifiers, bool is_double,
         enum fbwl_keybinding_action action, int arg, const char *cmd, const char *mode) {
-    struct fbwl_server *server = userdata;
-    if (server != NULL && server->ignore_border && context == FBWL_MOUSEBIND_WINDOW_BORDER) {
+    struct reconfigure_bindings *b = userdata;
+    if (b->server->ignore_border && context == FBWL_MOUSEBIND_WINDOW_BORDER) {
         if (action == FBWL_KEYBIND_START_MOVING || (action == FBWL_KEYBIND_MACRO && cmd_contains_startmoving(cmd))) {
             wlr_log(WLR_INFO, "Keys: ignoring StartMoving on window border (session.ignoreBorder=true)");
             return false;
         }
     }
-    return fbwl_mousebindings_add(&server->mousebindings, &server->mousebinding_count, context, event_kind, button,
+    return fbwl_mousebindings_add(&b->mousebindings, &b->mousebinding_count, context, event_kind, button,
         modifiers, is_double, action, arg, cmd, mode);
 }
 
+static bool path_changed(const char *a, const char *b) {
+    if (a == NULL || b == NULL) {
+        return a != b;
+    }
+    return strcmp(a, b) != 0;
+}
+
+static bool tabs_config_changed(const struct fbwl_tabs_config *a, const struct fbwl_tabs_config *b) {
+    return a->intitlebar != b->intitlebar ||
+        a->max_over != b->max_over ||
+        a->use_pixmap != b->use_pixmap ||
+        a->placement != b->placement ||
+        a->width_px != b->width_px ||
+        a->padding_px != b->padding_px ||
+        a->focus_model != b->focus_model ||
+        a->attach_area != b->attach_area;
+}
+
 void server_reconfigure(struct fbwl_server *server) {
-    if (server == NULL) {
+    server_reconfigure_parts(server, FBWL_RECONFIGURE_ALL, true);
+}
+
+// Reloads the config sources named in `parts`. Unless `force` is set, work
+// whose inputs did not change (theme, titlebar layout, tabs) is skipped, so a
+// keys edit only swaps the binding table and a menu edit only rebuilds menus.
+void server_reconfigure_parts(struct fbwl_server *server, uint32_t parts, bool force) {
+    if (server == NULL || parts == 0) {
         return;
     }
+    if ((parts & FBWL_RECONFIGURE_STYLE_FILES) != 0) {
+        parts |= FBWL_RECONFIGURE_STYLE;
+    }
 
     bool did_any = false;
     bool toolbar_needs_rebuild = false;
@@ -80,7 +119,8 @@ void server_reconfigure(struct fbwl_server *server) {
 
     const char *config_dir = server->config_dir;
     const char *init_file = server->init_file;
-    if ((config_dir != NULL && *config_dir != '\0') || (init_file != NULL && *init_file != '\0')) {
+    if ((parts & FBWL_RECONFIGURE_INIT) != 0 &&
+            ((config_dir != NULL && *config_dir != '\0') || (init_file != NULL && *init_file != '\0'))) {
         struct fbwl_resource_db init = {0};
         if (fbwl_resource_db_load_init(&init, config_dir, init_file)) {
             bool bool_val = false;
@@ -168,6 +208,13 @@ void server_reconfigure(struct fbwl_server *server) {
             const unsigned old_slit_alpha = server->slit_ui.alpha;
             const enum fbwl_slit_direction old_slit_direction = server->slit_ui.direction;
             const unsigned old_menu_alpha = server->menu_ui.alpha;
+            enum fbwl_decor_hit_kind old_titlebar_left[FBWL_TITLEBAR_BUTTONS_MAX];
+            enum fbwl_decor_hit_kind old_titlebar_right[FBWL_TITLEBAR_BUTTONS_MAX];
+            const size_t old_titlebar_left_len = server->titlebar_left_len;
+            const size_t old_titlebar_right_len = server->titlebar_right_len;
+            memcpy(old_titlebar_left, server->titlebar_left, sizeof(old_titlebar_left));
+            memcpy(old_titlebar_right, server->titlebar_right, sizeof(old_titlebar_right));
+            const struct fbwl_tabs_config old_tabs = server->tabs;
             server->window_alpha_defaults_configured = false;
             server->window_alpha_default_focused = 255;
             server->window_alpha_default_unfocused = 255;
@@ -179,7 +226,6 @@ void server_reconfigure(struct fbwl_server *server) {
             server->titlebar_right[1] = FBWL_DECOR_HIT_BTN_MIN;
             server->titlebar_right[2] = FBWL_DECOR_HIT_BTN_MAX;
             server->titlebar_right[3] = FBWL_DECOR_HIT_BTN_CLOSE;
-            decor_needs_update = true;
 
             fbwl_server_load_screen_configs(server, &init);
             const struct fbwl_screen_config *s0 = fbwl_server_screen_config(server, 0);
@@ -363,17 +409,23 @@ void server_reconfigure(struct fbwl_server *server) {
             if (titlebar_left == NULL) {
                 titlebar_left = fbwl_resource_db_get(&init, "session.titlebar.left");
             }
-            if (fbwl_titlebar_buttons_parse(titlebar_left, server->titlebar_left, FBWL_TITLEBAR_BUTTONS_MAX,
-                    &server->titlebar_left_len)) {
-                decor_needs_update = true;
-            }
+            (void)fbwl_titlebar_buttons_parse(titlebar_left, server->titlebar_left, FBWL_TITLEBAR_BUTTONS_MAX,
+                &server->titlebar_left_len);
 
             const char *titlebar_right = fbwl_resource_db_get(&init, "session.screen0.titlebar.right");
             if (titlebar_right == NULL) {
                 titlebar_right = fbwl_resource_db_get(&init, "session.titlebar.right");
             }
-            if (fbwl_titlebar_buttons_parse(titlebar_right, server->titlebar_right, FBWL_TITLEBAR_BUTTONS_MAX,
-                    &server->titlebar_right_len)) {
+            (void)fbwl_titlebar_buttons_parse(titlebar_right, server->titlebar_right, FBWL_TITLEBAR_BUTTONS_MAX,
+                &server->titlebar_right_len);
+            if (force ||
+                    server->titlebar_left_len != old_titlebar_left_len ||
+                    server->titlebar_right_len != old_titlebar_right_len ||
+                    memcmp(server->titlebar_left, old_titlebar_left,
+                        server->titlebar_left_len * sizeof(old_titlebar_left[0])) != 0 ||
+                    memcmp(server->titlebar_right, old_titlebar_right,
+                        server->titlebar_right_len * sizeof(old_titlebar_right[0])) != 0 ||
+                    tabs_config_changed(&server->tabs, &old_tabs)) {
                 decor_needs_update = true;
             }
 
@@ -394,7 +446,7 @@ void server_reconfigure(struct fbwl_server *server) {
                             const int target_ws = ws - 1;
                             for (struct fbwm_view *walk = server->wm.views.next; walk != &server->wm.views; walk = walk->next) {
                                 if (!walk->sticky && walk->workspace >= ws) {
-                                    walk->workspace = target_ws;
+                                    fbwm_core_view_set_workspace(&server->wm, walk, target_ws);
                                 }
                             }
                         }
@@ -407,24 +459,39 @@ void server_reconfigure(struct fbwl_server *server) {
 
             if (!server->keys_file_override) {
                 char *new_path = fbwl_resource_db_discover_path(&init, server->config_dir, "session.keyFile", "keys");
+                if (path_changed(new_path, server->keys_file)) {
+                    parts |= FBWL_RECONFIGURE_KEYS;
+                }
                 free(server->keys_file);
                 server->keys_file = new_path;
             }
             if (!server->apps_file_override) {
                 char *new_path = fbwl_resource_db_discover_path(&init, server->config_dir, "session.appsFile", "apps");
+                if (path_changed(new_path, server->apps_file)) {
+                    parts |= FBWL_RECONFIGURE_APPS;
+                }
                 free(server->apps_file);
                 server->apps_file = new_path;
             }
             if (!server->style_file_override) {
                 char *new_path = fbwl_resource_db_resolve_path(&init, server->config_dir, "session.styleFile");
+                if (path_changed(new_path, server->style_file)) {
+                    parts |= FBWL_RECONFIGURE_STYLE;
+                }
                 free(server->style_file);
                 server->style_file = new_path;
             }
             char *new_overlay_path = fbwl_resource_db_resolve_path(&init, server->config_dir, "session.styleOverlay");
+            if (path_changed(new_overlay_path, server->style_overlay_file)) {
+                parts |= FBWL_RECONFIGURE_STYLE;
+            }
             free(server->style_overlay_file);
             server->style_overlay_file = new_overlay_path;
             if (!server->menu_file_override) {
                 char *new_path = fbwl_resource_db_discover_path(&init, server->config_dir, "session.menuFile", "menu");
+                if (path_changed(new_path, server->menu_file)) {
+                    parts |= FBWL_RECONFIGURE_MENU;
+                }
                 free(server->menu_file);
                 server->menu_file = new_path;
             }
@@ -434,6 +501,9 @@ void server_reconfigure(struct fbwl_server *server) {
                 new_window_menu_path =
                     fbwl_resource_db_discover_path(&init, server->config_dir, "session.windowMenu", "windowmenu");
             }
+            if (path_changed(new_window_menu_path, server->window_menu_file)) {
+                parts |= FBWL_RECONFIGURE_MENU;
+            }
             free(server->window_menu_file);
             server->window_menu_file = new_window_menu_path;
 
@@ -522,38 +592,57 @@ void server_reconfigure(struct fbwl_server *server) {
     }
 
     const char *keys_file = server->keys_file;
-    if (keys_file != NULL && *keys_file != '\0') {
-        fbwl_keybindings_free(&server->keybindings, &server->keybinding_count);
-        fbwl_mousebindings_free(&server->mousebindings, &server->mousebinding_count);
-        free(server->key_mode);
-        server->key_mode = NULL;
-        server->key_mode_return_active = false;
-        server->key_mode_return_kind = FBWL_KEYBIND_KEYSYM;
-        server->key_mode_return_keycode = 0;
-        server->key_mode_return_sym = XKB_KEY_NoSymbol;
-        server->key_mode_return_modifiers = 0;
-
-        fbwl_keybindings_add_defaults(&server->keybindings, &server->keybinding_count, server->terminal_cmd);
-        (void)fbwl_keys_parse_file(keys_file, server_keybindings_add_from_keys_file, server, NULL);
-        (void)fbwl_keys_parse_file_mouse(keys_file, server_mousebindings_add_from_keys_file, server, NULL);
-
-        wlr_log(WLR_INFO, "Reconfigure: reloaded keys from %s", keys_file);
-        did_any = true;
-    } else {
-        wlr_log(WLR_INFO, "Reconfigure: no keys file configured");
+    if ((parts & FBWL_RECONFIGURE_KEYS) != 0) {
+        if (keys_file != NULL && *keys_file != '\0') {
+            struct reconfigure_bindings b = {.server = server};
+            fbwl_keybindings_add_defaults(&b.keybindings, &b.keybinding_count, server->terminal_cmd);
+            const bool keys_ok = fbwl_keys_parse_file(keys_file, server_keybindings_add_from_keys_file, &b, NULL);
+            (void)fbwl_keys_parse_file_mouse(keys_file, server_mousebindings_add_from_keys_file, &b, NULL);
+
+            if (!keys_ok && !force) {
+                fbwl_keybindings_free(&b.keybindings, &b.keybinding_count);
+                fbwl_mousebindings_free(&b.mousebindings, &b.mousebinding_count);
+                wlr_log(WLR_ERROR, "Reconfigure: keeping current bindings, failed to read %s", keys_file);
+            } else {
+                fbwl_keybindings_free(&server->keybindings, &server->keybinding_count);
+                fbwl_mousebindings_free(&server->mousebindings, &server->mousebinding_count);
+                server->keybindings = b.keybindings;
+                server->keybinding_count = b.keybinding_count;
+                server->mousebindings = b.mousebindings;
+                server->mousebinding_count = b.mousebinding_count;
+                free(server->key_mode);
+                server->key_mode = NULL;
+                server->key_mode_return_active = false;
+                server->key_mode_return_kind = FBWL_KEYBIND_KEYSYM;
+                server->key_mode_return_keycode = 0;
+                server->key_mode_return_sym = XKB_KEY_NoSymbol;
+                server->key_mode_return_modifiers = 0;
+                wlr_log(WLR_INFO, "Reconfigure: reloaded keys from %s", keys_file);
+            }
+            did_any = true;
+        } else {
+            wlr_log(WLR_INFO, "Reconfigure: no keys file configured");
+        }
     }
 
     const char *apps_file = server->apps_file;
-    if (apps_file != NULL && *apps_file != '\0') {
-        fbwl_apps_rules_free(&server->apps_rules, &server->apps_rule_count);
-        bool rewrite_safe = false;
-        if (fbwl_apps_rules_load_file(&server->apps_rules, &server->apps_rule_count, apps_file, &rewrite_safe)) {
-            server->apps_rules_generation++;
-            server->apps_rules_rewrite_safe = rewrite_safe;
-            wlr_log(WLR_INFO, "Reconfigure: reloaded apps from %s", apps_file);
+    if ((parts & FBWL_RECONFIGURE_APPS) != 0 && apps_file != NULL && *apps_file != '\0') {
+        // Pending Remember edits go to disk first so the reload doesn't drop them.
+        server_apps_rules_flush(server);
+        if (server_apps_file_is_own_write(server)) {
+            // The file holds exactly the rules in memory; keep them and their compiled regexes.
+            wlr_log(WLR_INFO, "Reconfigure: apps unchanged since last write: %s", apps_file);
         } else {
-            server->apps_rules_rewrite_safe = false;
-            wlr_log(WLR_ERROR, "Reconfigure: failed to reload apps from %s", apps_file);
+            fbwl_apps_rules_free(&server->apps_rules, &server->apps_rule_count);
+            bool rewrite_safe = false;
+            if (fbwl_apps_rules_load_file(&server->apps_rules, &server->apps_rule_count, apps_file, &rewrite_safe)) {
+                server->apps_rules_generation++;
+                server->apps_rules_rewrite_safe = rewrite_safe;
+                wlr_log(WLR_INFO, "Reconfigure: reloaded apps from %s", apps_file);
+            } else {
+                server->apps_rules_rewrite_safe = false;
+                wlr_log(WLR_ERROR, "Reconfigure: failed to reload apps from %s", apps_file);
+            }
         }
         did_any = true;
     }
@@ -561,7 +650,7 @@ void server_reconfigure(struct fbwl_server *server) {
     const char *style_file = server->style_file;
     const char *style_overlay_file = server->style_overlay_file;
     const bool have_overlay = style_overlay_file != NULL && fbwl_file_exists(style_overlay_file);
-    if ((style_file != NULL && *style_file != '\0') || have_overlay) {
+    if ((parts & FBWL_RECONFIGURE_STYLE) != 0 && ((style_file != NULL && *style_file != '\0') || have_overlay)) {
         struct fbwl_decor_theme new_theme = {0};
         decor_theme_set_defaults(&new_theme);
 
@@ -582,6 +671,12 @@ void server_reconfigure(struct fbwl_server *server) {
             did_any = true;
         }
 
+        if (!force && (parts & FBWL_RECONFIGURE_STYLE_FILES) == 0 &&
+                fbwl_decor_theme_equal(&new_theme, &server->decor_theme)) {
+            wlr_log(WLR_INFO, "Reconfigure: style unchanged");
+            goto done_style;
+        }
+
         server->decor_theme = new_theme;
         server_toolbar_ui_rebuild(server);
         server_slit_ui_rebuild(server);
@@ -593,7 +688,7 @@ void server_reconfigure(struct fbwl_server *server) {
 done_style:
 
     const char *menu_file = server->menu_file;
-    if (menu_file != NULL && *menu_file != '\0') {
+    if ((parts & FBWL_RECONFIGURE_MENU) != 0 && menu_file != NULL && *menu_file != '\0') {
         if (!server_menu_load_file(server, menu_file)) {
             wlr_log(WLR_ERROR, "Reconfigure: failed to reload menu from %s", menu_file);
             server_menu_create_default(server);
@@ -603,7 +698,9 @@ done_style:
         did_any = true;
     }
 
-    server_menu_create_window(server);
+    if ((parts & FBWL_RECONFIGURE_MENU) != 0) {
+        server_menu_create_window(server);
+    }
 
     if (window_alpha_defaults_changed) {
         for (struct fbwm_view *wm_view = server->wm.views.next;
@@ -659,9 +756,17 @@ done_style:
         server_slit_ui_rebuild(server);
     }
 
-    server_pseudo_transparency_refresh(server, "reconfigure");
+    if ((parts & FBWL_RECONFIGURE_INIT) != 0) {
+        server_usable_invalidate(server, "reconfigure");
+    }
+
+    if ((parts & (FBWL_RECONFIGURE_INIT | FBWL_RECONFIGURE_STYLE)) != 0) {
+        server_pseudo_transparency_refresh(server, "reconfigure");
+    }
 
     if (!did_any) {
         wlr_log(WLR_INFO, "Reconfigure: nothing to reload");
     }
+
+    server_config_watch_refresh(server);
 }
@@ -35,6 +35,7 @@ void server_request_restart(struct fbwl_server *server, const char *cmd) {
     }
 
     wlr_log(WLR_INFO, "Restart: requested cmd=%s", server->restart_cmd != NULL ? server->restart_cmd : "(self)");
+    (void)server_session_save(server, "restart");
 
     if (server->wl_display != NULL) {
         wl_display_terminate(server->wl_display);
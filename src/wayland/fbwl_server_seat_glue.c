@@ -27,6 +27,15 @@ static void seat_notify_activity(void *userdata) {
     fbwl_idle_notify_activity(&server->idle);
 }
 
+static void seat_notify_modifiers(void *userdata, uint32_t modifiers) {
+    struct fbwl_server *server = userdata;
+    // Releasing the last held modifier (NumLock stays latched) ends Alt-Tab.
+    if (server != NULL && server->cycle_session.active &&
+            (modifiers & FBWL_KEYMOD_MASK & ~(uint32_t)WLR_MODIFIER_MOD2) == 0) {
+        fbwl_keybindings_cycle_session_end(&server->cycle_session);
+    }
+}
+
 static bool seat_menu_is_open(void *userdata) {
     struct fbwl_server *server = userdata;
     return server != NULL && server->menu_ui.open;
@@ -340,6 +349,7 @@ static struct fbwl_seat_keyboard_hooks seat_keyboard_hooks(struct fbwl_server *s
     return (struct fbwl_seat_keyboard_hooks){
         .userdata = server,
         .notify_activity = seat_notify_activity,
+        .notify_modifiers = seat_notify_modifiers,
         .menu_is_open = seat_menu_is_open,
         .menu_handle_key = seat_menu_handle_key,
         .cmd_dialog_is_open = seat_cmd_dialog_is_open,
@@ -0,0 +1,429 @@
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <wayland-server-core.h>
+#include <wlr/types/wlr_scene.h>
+#include <wlr/types/wlr_xdg_shell.h>
+#include <wlr/util/log.h>
+#include <wlr/xwayland.h>
+
+#include "wayland/fbwl_server_internal.h"
+#include "wayland/fbwl_session_snapshot.h"
+#include "wayland/fbwl_tabs.h"
+#include "wayland/fbwl_util.h"
+#include "wayland/fbwl_view.h"
+
+enum {
+    SESSION_SAVE_INTERVAL_MS = 30 * 1000,
+    // Unclaimed entries are kept (and re-saved) for this many save ticks after
+    // startup, then dropped so late-started apps are placed normally.
+    SESSION_RESTORE_TICKS = 2,
+    // Matching on app_id alone is only trusted this long after the snapshot
+    // was loaded, while the clients of the previous run are reconnecting;
+    // later windows need a title/role or pid match.
+    SESSION_APP_ID_GRACE_MS = 10 * 1000,
+};
+
+static uint64_t session_buf_hash(const uint8_t *buf, size_t len) {
+    uint64_t h = 1469598103934665603ull;
+    for (size_t i = 0; i < len; i++) {
+        h ^= buf[i];
+        h *= 1099511628211ull;
+    }
+    return h;
+}
+
+static int32_t session_view_pid(const struct fbwl_view *view) {
+    if (view->type == FBWL_VIEW_XWAYLAND && view->xwayland_surface != NULL) {
+        return (int32_t)view->xwayland_surface->pid;
+    }
+    if (view->type == FBWL_VIEW_XDG && view->xdg_toplevel != NULL && view->xdg_toplevel->resource != NULL) {
+        pid_t pid = 0;
+        wl_client_get_credentials(wl_resource_get_client(view->xdg_toplevel->resource), &pid, NULL, NULL);
+        return (int32_t)pid;
+    }
+    return 0;
+}
+
+static uint8_t session_layer_from_tree(const struct fbwl_server *server, const struct wlr_scene_tree *tree) {
+    if (tree == server->layer_background) {
+        return FBWL_SESSION_LAYER_BACKGROUND;
+    }
+    if (tree == server->layer_bottom) {
+        return FBWL_SESSION_LAYER_BOTTOM;
+    }
+    if (tree == server->layer_top) {
+        return FBWL_SESSION_LAYER_TOP;
+    }
+    if (tree == server->layer_overlay) {
+        return FBWL_SESSION_LAYER_OVERLAY;
+    }
+    return FBWL_SESSION_LAYER_NORMAL;
+}
+
+static struct wlr_scene_tree *session_layer_tree(struct fbwl_server *server, uint8_t layer) {
+    switch (layer) {
+    case FBWL_SESSION_LAYER_BACKGROUND:
+        return server->layer_background;
+    case FBWL_SESSION_LAYER_BOTTOM:
+        return server->layer_bottom;
+    case FBWL_SESSION_LAYER_TOP:
+        return server->layer_top;
+    case FBWL_SESSION_LAYER_OVERLAY:
+        return server->layer_overlay;
+    default:
+        return server->layer_normal;
+    }
+}
+
+struct session_node {
+    const struct wlr_scene_node *node;
+    size_t idx;
+};
+
+static int session_node_cmp(const void *a, const void *b) {
+    const struct session_node *na = a;
+    const struct session_node *nb = b;
+    if (na->node == nb->node) {
+        return 0;
+    }
+    return (uintptr_t)na->node < (uintptr_t)nb->node ? -1 : 1;
+}
+
+// Bottom-to-top stacking index of every view, from one walk over the layer trees.
+static void session_fill_stack(struct fbwl_server *server, struct fbwl_view **views, size_t n,
+        struct fbwl_session_entry *entries) {
+    struct session_node *nodes = calloc(n > 0 ? n : 1, sizeof(*nodes));
+    if (nodes == NULL) {
+        return;
+    }
+    size_t nodes_len = 0;
+    for (size_t i = 0; i < n; i++) {
+        if (views[i]->scene_tree != NULL) {
+            nodes[nodes_len++] = (struct session_node){ .node = &views[i]->scene_tree->node, .idx = i };
+        }
+    }
+    qsort(nodes, nodes_len, sizeof(*nodes), session_node_cmp);
+
+    struct wlr_scene_tree *layers[] = {
+        server->layer_background,
+        server->layer_bottom,
+        server->layer_normal,
+        server->layer_fullscreen,
+        server->layer_top,
+        server->layer_overlay,
+    };
+    int32_t stack = 0;
+    for (size_t l = 0; l < sizeof(layers) / sizeof(layers[0]); l++) {
+        if (layers[l] == NULL) {
+            continue;
+        }
+        struct wlr_scene_node *child;
+        wl_list_for_each(child, &layers[l]->children, link) {
+            const struct session_node key = { .node = child };
+            const struct session_node *hit = bsearch(&key, nodes, nodes_len, sizeof(*nodes), session_node_cmp);
+            if (hit != NULL) {
+                entries[hit->idx].stack = stack++;
+            }
+        }
+    }
+    free(nodes);
+}
+
+static int32_t session_group_id(struct fbwl_view **views, size_t i, struct fbwl_session_entry *entries) {
+    if (views[i]->tab_group == NULL) {
+        return 0;
+    }
+    for (size_t j = 0; j < i; j++) {
+        if (views[j]->tab_group == views[i]->tab_group) {
+            return entries[j].group;
+        }
+    }
+    return (int32_t)i + 1;
+}
+
+static bool session_snapshot_views(struct fbwl_server *server, struct fbwl_session_snapshot *snap) {
+    size_t n = 0;
+    for (struct fbwm_view *walk = server->wm.views.next; walk != &server->wm.views; walk = walk->next) {
+        n++;
+    }
+    struct fbwl_view **views = calloc(n > 0 ? n : 1, sizeof(*views));
+    struct fbwl_session_entry *entries = calloc(n > 0 ? n : 1, sizeof(*entries));
+    if (views == NULL || entries == NULL) {
+        free(views);
+        free(entries);
+        return false;
+    }
+
+    size_t len = 0;
+    for (struct fbwm_view *walk = server->wm.views.next; walk != &server->wm.views; walk = walk->next) {
+        struct fbwl_view *view = walk->userdata;
+        if (view == NULL || view->in_slit || (!view->mapped && !view->minimized)) {
+            continue;
+        }
+        views[len++] = view;
+    }
+
+    for (size_t i = 0; i < len; i++) {
+        struct fbwl_view *view = views[i];
+        struct fbwl_session_entry *e = &entries[i];
+        const bool max_any = view->maximized || view->maximized_h || view->maximized_v;
+        const bool restore_saved = view->fullscreen || max_any;
+        e->app_id = (char *)fbwl_view_app_id(view);
+        e->title = (char *)fbwl_view_title(view);
+        e->role = (char *)fbwl_view_role(view);
+        e->pid = session_view_pid(view);
+        e->workspace = view->wm_view.workspace;
+        // Fullscreen/maximized views store their unmaximized geometry.
+        e->x = restore_saved ? view->saved_x : view->x;
+        e->y = restore_saved ? view->saved_y : view->y;
+        e->width = restore_saved ? view->saved_w : fbwl_view_current_width(view);
+        e->height = restore_saved ? view->saved_h : fbwl_view_current_height(view);
+        e->group = session_group_id(views, i, entries);
+        e->layer = session_layer_from_tree(server, view->base_layer);
+        e->flags = (view->wm_view.sticky ? FBWL_SESSION_STICKY : 0) |
+            ((view->maximized || view->maximized_h) ? FBWL_SESSION_MAXIMIZED_H : 0) |
+            ((view->maximized || view->maximized_v) ? FBWL_SESSION_MAXIMIZED_V : 0) |
+            (view->fullscreen ? FBWL_SESSION_FULLSCREEN : 0) |
+            (view->minimized ? FBWL_SESSION_MINIMIZED : 0) |
+            (view->shaded ? FBWL_SESSION_SHADED : 0) |
+            (view == server->focused_view ? FBWL_SESSION_FOCUSED : 0);
+    }
+    session_fill_stack(server, views, len, entries);
+
+    bool ok = true;
+    for (size_t i = 0; i < len && ok; i++) {
+        ok = fbwl_session_snapshot_add(snap, &entries[i]);
+    }
+    for (size_t i = 0; i < server->session_restore.len && ok; i++) {
+        const struct fbwl_session_entry *pending = &server->session_restore.entries[i];
+        if (!pending->claimed) {
+            ok = fbwl_session_snapshot_add(snap, pending);
+        }
+    }
+    free(views);
+    free(entries);
+    return ok;
+}
+
+bool server_session_save(struct fbwl_server *server, const char *why) {
+    if (server == NULL || server->session_file == NULL) {
+        return false;
+    }
+    struct fbwl_session_snapshot snap;
+    fbwl_session_snapshot_init(&snap);
+    uint8_t *buf = NULL;
+    size_t len = 0;
+    bool ok = session_snapshot_views(server, &snap) && fbwl_session_snapshot_serialize(&snap, &buf, &len);
+    const size_t count = snap.len;
+    fbwl_session_snapshot_finish(&snap);
+    if (!ok) {
+        free(buf);
+        return false;
+    }
+
+    const uint64_t hash = session_buf_hash(buf, len);
+    if (server->session_saved && hash == server->session_last_hash) {
+        free(buf);
+        return true;
+    }
+    ok = fbwl_session_snapshot_write_file(server->session_file, buf, len);
+    free(buf);
+    if (ok) {
+        server->session_saved = true;
+        server->session_last_hash = hash;
+        wlr_log(WLR_INFO, "Session: saved %zu windows to %s reason=%s",
+            count, server->session_file, why != NULL ? why : "(null)");
+    }
+    return ok;
+}
+
+static int session_save_timer(void *data) {
+    struct fbwl_server *server = data;
+    if (server->session_restore.len > 0 && ++server->session_restore_ticks >= SESSION_RESTORE_TICKS) {
+        fbwl_session_snapshot_finish(&server->session_restore);
+    }
+    (void)server_session_save(server, "periodic");
+    wl_event_source_timer_update(server->session_timer, SESSION_SAVE_INTERVAL_MS);
+    return 0;
+}
+
+void server_session_init(struct fbwl_server *server, const char *socket) {
+    if (server == NULL || socket == NULL) {
+        return;
+    }
+    fbwl_session_snapshot_init(&server->session_restore);
+    const char *runtime_dir = getenv("XDG_RUNTIME_DIR");
+    if (runtime_dir == NULL || *runtime_dir == '\0') {
+        return;
+    }
+    char path[4096];
+    if (snprintf(path, sizeof(path), "%s/fluxbox-wayland-%s.session", runtime_dir, socket) >= (int)sizeof(path)) {
+        return;
+    }
+    server->session_file = strdup(path);
+    if (server->session_file == NULL) {
+        return;
+    }
+
+    if (fbwl_session_snapshot_load_file(&server->session_restore, server->session_file)) {
+        server->session_loaded_msec = fbwl_now_msec();
+        wlr_log(WLR_INFO, "Session: loaded %zu windows from %s", server->session_restore.len, server->session_file);
+    }
+
+    struct wl_event_loop *loop = wl_display_get_event_loop(server->wl_display);
+    server->session_timer = wl_event_loop_add_timer(loop, session_save_timer, server);
+    if (server->session_timer != NULL) {
+        wl_event_source_timer_update(server->session_timer, SESSION_SAVE_INTERVAL_MS);
+    }
+}
+
+void server_session_finish(struct fbwl_server *server) {
+    if (server == NULL) {
+        return;
+    }
+    if (server->session_timer != NULL) {
+        wl_event_source_remove(server->session_timer);
+        server->session_timer = NULL;
+    }
+    // A clean exit leaves nothing to recover; restarts saved before terminating.
+    if (server->session_file != NULL && !server->restart_requested) {
+        (void)unlink(server->session_file);
+    }
+    fbwl_session_snapshot_finish(&server->session_restore);
+    free(server->session_file);
+    server->session_file = NULL;
+}
+
+const struct fbwl_session_entry *server_session_restore_pre_map(struct fbwl_server *server, struct fbwl_view *view) {
+    if (server == NULL || view == NULL || server->session_restore.len == 0 ||
+            view->placed || view->apps_rules_applied || view->in_slit) {
+        return NULL;
+    }
+    const bool allow_app_id = fbwl_now_msec() - server->session_loaded_msec < SESSION_APP_ID_GRACE_MS;
+    const struct fbwl_session_entry *e = fbwl_session_snapshot_claim(&server->session_restore,
+        fbwl_view_app_id(view), fbwl_view_title(view), fbwl_view_role(view), session_view_pid(view), allow_app_id);
+    if (e == NULL) {
+        return NULL;
+    }
+
+    // The snapshot already reflects the apps rules and placement of the
+    // previous run; skip both.
+    view->apps_rules_applied = true;
+    view->session_restore_pending = true;
+    view->session_restored = true;
+    view->session_group = e->group;
+    view->session_stack = e->stack;
+
+    const int count = fbwm_core_workspace_count(&server->wm);
+    fbwm_core_view_set_workspace(&server->wm, &view->wm_view,
+        e->workspace >= 0 && e->workspace < count ? e->workspace : 0);
+    fbwm_core_view_set_sticky(&server->wm, &view->wm_view, (e->flags & FBWL_SESSION_STICKY) != 0);
+
+    struct wlr_scene_tree *layer = session_layer_tree(server, e->layer);
+    if (layer != NULL) {
+        view->base_layer = layer;
+        if (view->scene_tree != NULL) {
+            wlr_scene_node_reparent(&view->scene_tree->node, layer);
+        }
+    }
+
+    if (e->width > 0 && e->height > 0) {
+        if (view->type == FBWL_VIEW_XDG && view->xdg_toplevel != NULL) {
+            wlr_xdg_toplevel_set_size(view->xdg_toplevel, e->width, e->height);
+        } else if (view->type == FBWL_VIEW_XWAYLAND) {
+            view->width = e->width;
+            view->height = e->height;
+        }
+    }
+    view->x = e->x;
+    view->y = e->y;
+    if (view->scene_tree != NULL) {
+        wlr_scene_node_set_position(&view->scene_tree->node, view->x, view->y);
+    }
+    view->placed = true;
+    fbwl_view_foreign_update_output_from_position(view, server->output_layout);
+
+    wlr_log(WLR_INFO, "Session: restored title=%s app_id=%s workspace=%d pos=%d,%d size=%dx%d",
+        fbwl_view_display_title(view),
+        fbwl_view_app_id(view) != NULL ? fbwl_view_app_id(view) : "(no-app-id)",
+        view->wm_view.workspace + 1, e->x, e->y, e->width, e->height);
+    return e;
+}
+
+// Places the view among the restored views that share its layer, by the
+// stacking index they had when the snapshot was taken.
+static void session_restack(struct fbwl_server *server, struct fbwl_view *view) {
+    if (view->scene_tree == NULL) {
+        return;
+    }
+    const struct wlr_scene_tree *parent = view->scene_tree->node.parent;
+    struct fbwl_view *below = NULL;
+    struct fbwl_view *above = NULL;
+    for (struct fbwm_view *walk = server->wm.views.next; walk != &server->wm.views; walk = walk->next) {
+        struct fbwl_view *other = walk->userdata;
+        if (other == NULL || other == view || !other->session_restored || other->scene_tree == NULL ||
+                other->scene_tree->node.parent != parent) {
+            continue;
+        }
+        if (other->session_stack < view->session_stack) {
+            if (below == NULL || other->session_stack > below->session_stack) {
+                below = other;
+            }
+        } else if (above == NULL || other->session_stack < above->session_stack) {
+            above = other;
+        }
+    }
+    if (below != NULL) {
+        wlr_scene_node_place_above(&view->scene_tree->node, &below->scene_tree->node);
+    } else if (above != NULL) {
+        wlr_scene_node_place_below(&view->scene_tree->node, &above->scene_tree->node);
+    }
+}
+
+void server_session_restore_post_map(struct fbwl_server *server, struct fbwl_view *view,
+        const struct fbwl_session_entry *e, bool *out_focus) {
+    if (out_focus != NULL) {
+        *out_focus = false;
+    }
+    if (server == NULL || view == NULL || e == NULL || !view->session_restore_pending) {
+        return;
+    }
+    view->session_restore_pending = false;
+
+    if (view->session_group > 0 && view->tab_group == NULL) {
+        for (struct fbwm_view *walk = server->wm.views.next; walk != &server->wm.views; walk = walk->next) {
+            struct fbwl_view *anchor = walk->userdata;
+            if (anchor != NULL && anchor != view && anchor->mapped && anchor->session_restored &&
+                    anchor->session_group == view->session_group) {
+                (void)fbwl_tabs_attach(view, anchor, "session");
+                break;
+            }
+        }
+    }
+
+    const bool max_h = (e->flags & FBWL_SESSION_MAXIMIZED_H) != 0;
+    const bool max_v = (e->flags & FBWL_SESSION_MAXIMIZED_V) != 0;
+    if (max_h || max_v) {
+        fbwl_view_set_maximized_axes(view, max_h, max_v, server->output_layout, &server->outputs);
+    }
+    if ((e->flags & FBWL_SESSION_FULLSCREEN) != 0) {
+        fbwl_view_set_fullscreen(view, true, server->output_layout, &server->outputs,
+            server->layer_normal, server->layer_fullscreen, NULL);
+    }
+    session_restack(server, view);
+    if ((e->flags & FBWL_SESSION_SHADED) != 0) {
+        fbwl_view_set_shaded(view, true, "session");
+    }
+    if ((e->flags & FBWL_SESSION_MINIMIZED) != 0) {
+        view_set_minimized(view, true, "session");
+    }
+    if (out_focus != NULL) {
+        *out_focus = (e->flags & (FBWL_SESSION_FOCUSED | FBWL_SESSION_MINIMIZED)) == FBWL_SESSION_FOCUSED;
+    }
+}
@@ -14,57 +14,104 @@
 #include "wayland/fbwl_fluxbox_cmd.h"
 #include "wayland/fbwl_icon_theme.h"
 #include "wayland/fbwl_keybindings.h"
+#include "wayland/fbwl_perf.h"
 #include "wayland/fbwl_server_internal.h"
 #include "wayland/fbwl_server_menu_actions.h"
 #include "wayland/fbwl_server_menu_state.h"
+#include "wayland/fbwl_spawn.h"
 #include "wayland/fbwl_string_list.h"
+#include "wayland/fbwl_trace.h"
 #include "wayland/fbwl_ui_toolbar_iconbar_pattern.h"
 #include "wayland/fbwl_ui_menu_icon.h"
 #include "wayland/fbwl_util.h"
 #include "wayland/fbwl_view.h"
 
-void apply_workspace_visibility(struct fbwl_server *server, const char *why) {
+static void apply_view_visibility(struct fbwl_server *server, const struct fbwm_view *wm_view) {
+    struct fbwl_view *view = wm_view->userdata;
+    if (view == NULL || view->scene_tree == NULL) {
+        return;
+    }
+
+    const bool visible_ws = fbwm_core_view_is_visible(&server->wm, wm_view);
+    const bool visible = visible_ws && fbwl_tabs_view_is_active(view);
+    wlr_scene_node_set_enabled(&view->scene_tree->node, visible);
+    if (!fbwl_trace_enabled(FBWL_TRACE_WORKSPACE)) {
+        return;
+    }
+
+    const char *title = NULL;
+    if (wm_view->ops != NULL && wm_view->ops->title != NULL) {
+        title = wm_view->ops->title(wm_view);
+    }
+    const int view_head = wm_view->ops != NULL && wm_view->ops->head != NULL ? wm_view->ops->head(wm_view) : 0;
+    const size_t view_head0 = view_head > 0 ? (size_t)view_head : 0;
+    const int head_ws = fbwm_core_workspace_current_for_head(&server->wm, view_head0);
+    fbwl_trace(FBWL_TRACE_WORKSPACE, "Workspace: view=%s ws=%d visible=%d head=%d head_ws=%d",
+        title != NULL ? title : "(no-title)", wm_view->workspace + 1, visible ? 1 : 0, view_head, head_ws + 1);
+}
+
+static void apply_workspace_finish(struct fbwl_server *server, const char *why) {
+    if (server->wm.focused == NULL) {
+        clear_keyboard_focus(server);
+    }
+
+    server_strict_mousefocus_recheck(server, why);
+}
+
+static void trace_workspace_apply(struct fbwl_server *server, const char *why) {
+    if (!fbwl_trace_enabled(FBWL_TRACE_WORKSPACE)) {
+        return;
+    }
     const size_t heads = fbwm_core_head_count(&server->wm);
     size_t cursor_head = 0;
     if (server->cursor != NULL) {
         cursor_head = fbwl_server_screen_index_at(server, server->cursor->x, server->cursor->y);
     }
     const int cur = fbwm_core_workspace_current_for_head(&server->wm, cursor_head);
-    wlr_log(WLR_INFO, "Workspace: apply current=%d reason=%s head=%zu heads=%zu",
+    fbwl_trace(FBWL_TRACE_WORKSPACE, "Workspace: apply current=%d reason=%s head=%zu heads=%zu",
         cur + 1, why != NULL ? why : "(null)", cursor_head, heads);
+}
+
+void apply_workspace_visibility(struct fbwl_server *server, const char *why) {
+    trace_workspace_apply(server, why);
 
+    // Full pass: also re-files views whose workspace/sticky were written
+    // directly, so the per-workspace lists stay exact for the switch path.
+    (void)fbwm_core_workspace_reindex(&server->wm);
     fbwl_tabs_repair(server);
 
     for (struct fbwm_view *wm_view = server->wm.views.next;
             wm_view != &server->wm.views;
             wm_view = wm_view->next) {
-        struct fbwl_view *view = wm_view->userdata;
-        if (view == NULL || view->scene_tree == NULL) {
-            continue;
-        }
-
-        const bool visible_ws = fbwm_core_view_is_visible(&server->wm, wm_view);
-        const bool visible = visible_ws && fbwl_tabs_view_is_active(view);
-        wlr_scene_node_set_enabled(&view->scene_tree->node, visible);
-
-        const char *title = NULL;
-        if (wm_view->ops != NULL && wm_view->ops->title != NULL) {
-            title = wm_view->ops->title(wm_view);
-        }
-        const int view_head = wm_view->ops != NULL && wm_view->ops->head != NULL ? wm_view->ops->head(wm_view) : 0;
-        const size_t view_head0 = view_head > 0 ? (size_t)view_head : 0;
-        const int head_ws = fbwm_core_workspace_current_for_head(&server->wm, view_head0);
-        wlr_log(WLR_INFO, "Workspace: view=%s ws=%d visible=%d head=%d head_ws=%d",
-            title != NULL ? title : "(no-title)", wm_view->workspace + 1, visible ? 1 : 0, view_head, head_ws + 1);
+        apply_view_visibility(server, wm_view);
     }
 
     server_toolbar_ui_rebuild(server);
+    apply_workspace_finish(server, why);
+}
 
-    if (server->wm.focused == NULL) {
-        clear_keyboard_focus(server);
+// A plain switch changes no view state and no tab membership; only views filed
+// under the workspace being left or entered can change visibility. Sticky
+// views stay as they are and are not walked.
+static void apply_workspace_switch(struct fbwl_server *server, int from, int to, const char *why) {
+    const struct fbwm_view *lists[] = {
+        fbwm_core_workspace_list(&server->wm, from),
+        fbwm_core_workspace_list(&server->wm, to),
+    };
+    if (lists[0] == NULL || lists[1] == NULL) {
+        apply_workspace_visibility(server, why);
+        return;
     }
 
-    server_strict_mousefocus_recheck(server, why);
+    trace_workspace_apply(server, why);
+    for (size_t i = 0; i < sizeof(lists) / sizeof(lists[0]); i++) {
+        for (const struct fbwm_view *walk = lists[i]->ws_next; walk != lists[i]; walk = walk->ws_next) {
+            apply_view_visibility(server, walk);
+        }
+    }
+
+    server_toolbar_ui_update_workspace(server);
+    apply_workspace_finish(server, why);
 }
 
 void server_workspace_switch_on_head(struct fbwl_server *server, size_t head, int workspace0, const char *why) {
@@ -82,6 +129,7 @@ void server_workspace_switch_on_head(struct fbwl_server *server, size_t head, in
         return;
     }
 
+    const uint64_t start = fbwl_perf_now();
     fbwm_core_workspace_switch_on_head(&server->wm, head, workspace0);
     wlr_log(WLR_INFO, "Workspace: switch head=%zu ws=%d reason=%s",
         head, workspace0 + 1, why != NULL ? why : "(null)");
@@ -92,7 +140,8 @@ void server_workspace_switch_on_head(struct fbwl_server *server, size_t head, in
             &server->decor_theme, server->output_layout, workspace0, name);
     }
 
-    apply_workspace_visibility(server, why);
+    apply_workspace_switch(server, cur, workspace0, why);
+    fbwl_perf_record(FBWL_PERF_WORKSPACE, start);
 
     if (!server->change_workspace_binding_active) {
         server->change_workspace_binding_active = true;
@@ -371,6 +420,20 @@ void server_toolbar_ui_rebuild(struct fbwl_server *server) {
 
     const struct fbwl_ui_toolbar_env env = toolbar_ui_env(server);
     fbwl_ui_toolbar_rebuild(&server->toolbar_ui, &env);
+    server_usable_schedule_check(server);
+}
+
+// The toolbar layout does not depend on the current workspace; only the name
+// label and the iconbar entries can change.
+void server_toolbar_ui_update_workspace(struct fbwl_server *server) {
+    if (server == NULL) {
+        return;
+    }
+
+    const struct fbwl_ui_toolbar_env env = toolbar_ui_env(server);
+    if (!fbwl_ui_toolbar_update_workspace(&server->toolbar_ui, &env)) {
+        server_toolbar_ui_rebuild(server);
+    }
 }
 
 void server_slit_ui_rebuild(struct fbwl_server *server) {
@@ -380,11 +443,20 @@ void server_slit_ui_rebuild(struct fbwl_server *server) {
 
     const struct fbwl_ui_slit_env env = slit_ui_env(server);
     fbwl_ui_slit_rebuild(&server->slit_ui, &env);
+    server_usable_schedule_check(server);
 }
 
 #ifdef HAVE_SYSTEMD
 void server_sni_on_change(void *userdata) {
-    server_toolbar_ui_rebuild(userdata);
+    struct fbwl_server *server = userdata;
+    if (server == NULL) {
+        return;
+    }
+
+    const struct fbwl_ui_toolbar_env env = toolbar_ui_env(server);
+    if (!fbwl_ui_toolbar_update_tray(&server->toolbar_ui, &env)) {
+        server_toolbar_ui_rebuild(server);
+    }
 }
 #endif
 
@@ -430,6 +502,7 @@ bool server_slit_ui_attach_view(struct fbwl_server *server, struct fbwl_view *vi
     }
     const struct fbwl_ui_slit_env env = slit_ui_env(server);
     bool ok = fbwl_ui_slit_attach_view(&server->slit_ui, &env, view, why);
+    server_usable_schedule_check(server);
     if (ok && server->slitlist_file != NULL && *server->slitlist_file != '\0') {
         (void)fbwl_ui_slit_save_order_file(&server->slit_ui, server->slitlist_file);
     }
@@ -442,6 +515,7 @@ void server_slit_ui_detach_view(struct fbwl_server *server, struct fbwl_view *vi
     }
     const struct fbwl_ui_slit_env env = slit_ui_env(server);
     fbwl_ui_slit_detach_view(&server->slit_ui, &env, view, why);
+    server_usable_schedule_check(server);
 }
 
 void server_slit_ui_handle_view_commit(struct fbwl_server *server, struct fbwl_view *view, const char *why) {
@@ -449,7 +523,9 @@ void server_slit_ui_handle_view_commit(struct fbwl_server *server, struct fbwl_v
         return;
     }
     const struct fbwl_ui_slit_env env = slit_ui_env(server);
-    fbwl_ui_slit_handle_view_commit(&server->slit_ui, &env, view, why);
+    if (fbwl_ui_slit_handle_view_commit(&server->slit_ui, &env, view, why)) {
+        server_usable_schedule_check(server);
+    }
 }
 
 void server_slit_ui_apply_view_geometry(struct fbwl_server *server, struct fbwl_view *view, const char *why) {
@@ -458,6 +534,7 @@ void server_slit_ui_apply_view_geometry(struct fbwl_server *server, struct fbwl_
     }
     const struct fbwl_ui_slit_env env = slit_ui_env(server);
     fbwl_ui_slit_apply_view_geometry(&server->slit_ui, &env, view, why);
+    server_usable_schedule_check(server);
 }
 
 static void server_toolbar_buttons_free(struct fbwl_toolbar_button_cfg *buttons, size_t len) {
@@ -717,6 +794,14 @@ int server_osd_hide_timer(void *data) {
     return 0;
 }
 
+int server_move_osd_render_timer(void *data) {
+    struct fbwl_server *server = data;
+    if (server != NULL) {
+        fbwl_ui_osd_flush(&server->move_osd_ui);
+    }
+    return 0;
+}
+
 void server_osd_ui_update_position(struct fbwl_server *server) {
     if (server == NULL || server->output_layout == NULL) {
         return;
@@ -838,6 +923,7 @@ void server_menu_ui_open_root(struct fbwl_server *server, int x, int y, const ch
     if (server == NULL) {
         return;
     }
+    const uint64_t start = fbwl_perf_now();
     struct fbwl_menu *menu = server->root_menu;
     if (menu_file != NULL && *menu_file != '\0') {
         if (!server_menu_load_custom_file(server, menu_file)) { wlr_log(WLR_ERROR, "CustomMenu: failed to load: %s", menu_file); return; }
@@ -852,6 +938,7 @@ void server_menu_ui_open_root(struct fbwl_server *server, int x, int y, const ch
     server_menu_sync_toggle_states(server, menu, NULL, x, y);
     const struct fbwl_ui_menu_env env = menu_ui_env(server);
     fbwl_ui_menu_open_root(&server->menu_ui, &env, menu, x, y);
+    fbwl_perf_record(FBWL_PERF_MENU_OPEN, start);
 }
 
 void server_menu_ui_open_window(struct fbwl_server *server, struct fbwl_view *view, int x, int y) {
@@ -992,6 +1079,7 @@ void server_menu_free(struct fbwl_server *server) {
     server->client_menu = NULL;
     fbwl_menu_free(server->slit_menu);
     server->slit_menu = NULL;
+    fbwl_menu_cache_finish(&server->menu_cache);
     free(server->menu_file);
     server->menu_file = NULL;
     free(server->window_menu_file);
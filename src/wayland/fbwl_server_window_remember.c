@@ -7,7 +7,9 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <sys/stat.h>
 
+#include <wayland-server-core.h>
 #include <wlr/util/log.h>
 
 #include "wayland/fbwl_apps_rules.h"
@@ -15,6 +17,10 @@
 #include "wayland/fbwl_server_internal.h"
 #include "wayland/fbwl_view.h"
 
+enum {
+    APPS_SAVE_DEBOUNCE_MS = 500,
+};
+
 static bool apps_rule_match_is_set(const struct fbwl_apps_rule_match *match) {
     return match != NULL && match->set && match->pattern != NULL && match->regex_valid;
 }
@@ -94,6 +100,10 @@ static bool apps_rule_match_set_regex(struct fbwl_apps_rule_match *match, const
     if (match == NULL || pattern == NULL) {
         return false;
     }
+    if (match->set && match->regex_valid && match->pattern != NULL && strcmp(match->pattern, pattern) == 0) {
+        match->negate = negate;
+        return true;
+    }
 
     apps_rule_match_free(match);
     match->set = true;
@@ -368,22 +378,98 @@ static int remember_snapshot_layer(const struct fbwl_server *server, const struc
     return 8;
 }
 
-static bool save_apps_file(struct fbwl_server *server) {
+static void apps_file_note_saved(struct fbwl_server *server) {
+    struct stat st;
+    server->apps_file_saved_valid = stat(server->apps_file, &st) == 0;
+    if (!server->apps_file_saved_valid) {
+        return;
+    }
+    server->apps_file_saved_dev = st.st_dev;
+    server->apps_file_saved_ino = st.st_ino;
+    server->apps_file_saved_size = st.st_size;
+    server->apps_file_saved_mtime_ns = (int64_t)st.st_mtim.tv_sec * 1000000000 + st.st_mtim.tv_nsec;
+}
+
+bool server_apps_file_is_own_write(struct fbwl_server *server) {
+    if (server == NULL || !server->apps_file_saved_valid || server->apps_file == NULL) {
+        return false;
+    }
+    struct stat st;
+    if (stat(server->apps_file, &st) != 0) {
+        return false;
+    }
+    return st.st_dev == server->apps_file_saved_dev && st.st_ino == server->apps_file_saved_ino &&
+        st.st_size == server->apps_file_saved_size &&
+        (int64_t)st.st_mtim.tv_sec * 1000000000 + st.st_mtim.tv_nsec == server->apps_file_saved_mtime_ns;
+}
+
+bool server_apps_rules_write(struct fbwl_server *server) {
     if (server == NULL || server->apps_file == NULL || *server->apps_file == '\0') {
         return false;
     }
+    server->apps_rules_dirty = false;
+    if (server->apps_save_timer != NULL) {
+        wl_event_source_timer_update(server->apps_save_timer, 0);
+    }
     if (!ensure_apps_file_exists(server)) {
         return false;
     }
+    bool ok = false;
     if (server->apps_rule_count == 0 || server->apps_rules == NULL) {
         FILE *f = fopen(server->apps_file, "w");
-        if (f == NULL) {
-            return false;
+        if (f != NULL) {
+            fclose(f);
+            ok = true;
         }
-        fclose(f);
-        return true;
+    } else {
+        ok = fbwl_apps_rules_save_file(server->apps_rules, server->apps_rule_count, server->apps_file);
+    }
+    if (ok) {
+        apps_file_note_saved(server);
+    } else {
+        server->apps_file_saved_valid = false;
+    }
+    return ok;
+}
+
+void server_apps_rules_flush(struct fbwl_server *server) {
+    if (server == NULL || !server->apps_rules_dirty) {
+        return;
+    }
+    if (server_apps_rules_write(server)) {
+        wlr_log(WLR_INFO, "Remember: wrote %s rules=%zu", server->apps_file, server->apps_rule_count);
+    } else {
+        wlr_log(WLR_ERROR, "Remember: failed to write %s", server->apps_file != NULL ? server->apps_file : "(null)");
+    }
+}
+
+static int apps_save_timer(void *data) {
+    server_apps_rules_flush(data);
+    return 0;
+}
+
+static void apps_rules_schedule_save(struct fbwl_server *server) {
+    server->apps_rules_dirty = true;
+    if (server->apps_save_timer == NULL && server->wl_display != NULL) {
+        server->apps_save_timer = wl_event_loop_add_timer(wl_display_get_event_loop(server->wl_display),
+            apps_save_timer, server);
+    }
+    if (server->apps_save_timer == NULL) {
+        server_apps_rules_flush(server);
+        return;
+    }
+    wl_event_source_timer_update(server->apps_save_timer, APPS_SAVE_DEBOUNCE_MS);
+}
+
+void server_apps_rules_finish(struct fbwl_server *server) {
+    if (server == NULL) {
+        return;
+    }
+    server_apps_rules_flush(server);
+    if (server->apps_save_timer != NULL) {
+        wl_event_source_remove(server->apps_save_timer);
+        server->apps_save_timer = NULL;
     }
-    return fbwl_apps_rules_save_file(server->apps_rules, server->apps_rule_count, server->apps_file);
 }
 
 void server_window_remember_toggle(struct fbwl_server *server, struct fbwl_view *view, enum fbwl_menu_remember_attr attr) {
@@ -552,11 +638,8 @@ void server_window_remember_toggle(struct fbwl_server *server, struct fbwl_view
         wlr_log(WLR_INFO, "Remember: keeping empty rule idx=%zu (no settings)", rule_idx);
     }
 
-    if (save_apps_file(server)) {
-        wlr_log(WLR_INFO, "Remember: wrote %s rule=%zu", server->apps_file, rule_idx);
-    } else {
-        wlr_log(WLR_ERROR, "Remember: failed to write %s", server->apps_file != NULL ? server->apps_file : "(null)");
-    }
+    wlr_log(WLR_INFO, "Remember: updated rule=%zu", rule_idx);
+    apps_rules_schedule_save(server);
 }
 
 void server_window_remember_forget(struct fbwl_server *server, struct fbwl_view *view) {
@@ -582,9 +665,6 @@ void server_window_remember_forget(struct fbwl_server *server, struct fbwl_view
     server->apps_rules_generation++;
     server->apps_rules_rewrite_safe = true;
 
-    if (save_apps_file(server)) {
-        wlr_log(WLR_INFO, "Remember: forgot rule idx=%zu wrote %s", idx, server->apps_file);
-    } else {
-        wlr_log(WLR_ERROR, "Remember: failed to write %s", server->apps_file != NULL ? server->apps_file : "(null)");
-    }
+    wlr_log(WLR_INFO, "Remember: forgot rule idx=%zu", idx);
+    apps_rules_schedule_save(server);
 }
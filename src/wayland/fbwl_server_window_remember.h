@@ -1,5 +1,7 @@
 #pragma once
 
+#include <stdbool.h>
+
 #include "wayland/fbwl_menu.h"
 
 struct fbwl_server;
@@ -8,3 +10,10 @@ struct fbwl_view;
 void server_window_remember_toggle(struct fbwl_server *server, struct fbwl_view *view, enum fbwl_menu_remember_attr attr);
 void server_window_remember_forget(struct fbwl_server *server, struct fbwl_view *view);
 
+// Writes the in-memory apps rules now, dropping any pending deferred save.
+bool server_apps_rules_write(struct fbwl_server *server);
+// Writes pending Remember edits, if any (shutdown, before a reload).
+void server_apps_rules_flush(struct fbwl_server *server);
+void server_apps_rules_finish(struct fbwl_server *server);
+// True when the apps file on disk is exactly what we last wrote.
+bool server_apps_file_is_own_write(struct fbwl_server *server);
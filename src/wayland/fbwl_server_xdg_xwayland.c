@@ -15,6 +15,7 @@
 #include <wlr/xwayland.h>
 
 #include "wmcore/fbwm_output.h"
+#include "wayland/fbwl_perf.h"
 #include "wayland/fbwl_server_internal.h"
 #include "wayland/fbwl_xembed_sni_proxy.h"
 #include "wayland/fbwl_view.h"
@@ -282,23 +283,27 @@ static void server_apps_rule_matchlimit_dec(struct fbwl_server *server, const st
     }
 }
 
-static void xdg_toplevel_map(struct wl_listener *listener, void *data) {
-    (void)data;
-    struct fbwl_view *view = wl_container_of(listener, view, map);
+static void xdg_toplevel_handle_map(struct fbwl_view *view) {
     struct fbwl_server *server = view->server;
     struct fbwl_xdg_shell_hooks hooks = xdg_shell_hooks(server);
+    const struct fbwl_session_entry *session = server_session_restore_pre_map(server, view);
     const bool rules_applied_before = view->apps_rules_applied;
     fbwl_xdg_shell_handle_toplevel_map(view, &server->wm, server->output_layout, &server->outputs,
         server->cursor->x, server->cursor->y, server->apps_rules, server->apps_rule_count, &hooks);
     if (!rules_applied_before && view->apps_rules_applied) {
         server_apps_rule_matchlimit_inc(server, view);
     }
+    bool session_focus = false;
+    server_session_restore_post_map(server, view, session, &session_focus);
     if (!fbwm_core_view_is_visible(&server->wm, &view->wm_view)) {
         return;
     }
 
     const struct fbwl_screen_config *cfg = fbwl_server_screen_config_for_view(server, view);
     bool focus_new = cfg != NULL ? cfg->focus.focus_new_windows : server->focus.focus_new_windows;
+    if (session != NULL) {
+        focus_new = session_focus;
+    }
     if (view->focus_protection & FBWL_APPS_FOCUS_PROTECT_GAIN) {
         focus_new = true;
     } else if (view->focus_protection & FBWL_APPS_FOCUS_PROTECT_REFUSE) {
@@ -325,6 +330,14 @@ static void xdg_toplevel_map(struct wl_listener *listener, void *data) {
     server->focus_reason = prev_reason;
 }
 
+static void xdg_toplevel_map(struct wl_listener *listener, void *data) {
+    (void)data;
+    struct fbwl_view *view = wl_container_of(listener, view, map);
+    const uint64_t start = fbwl_perf_now();
+    xdg_toplevel_handle_map(view);
+    fbwl_perf_record(FBWL_PERF_MAP, start);
+}
+
 static void xdg_toplevel_unmap(struct wl_listener *listener, void *data) {
     (void)data;
     struct fbwl_view *view = wl_container_of(listener, view, unmap);
@@ -367,8 +380,10 @@ static void xdg_toplevel_set_title(struct wl_listener *listener, void *data) {
     (void)data;
     struct fbwl_view *view = wl_container_of(listener, view, set_title);
     struct fbwl_server *server = view->server;
+    const uint64_t start = fbwl_perf_now();
     struct fbwl_xdg_shell_hooks hooks = xdg_shell_hooks(server);
     fbwl_xdg_shell_handle_toplevel_set_title(view, &server->decor_theme, &hooks);
+    fbwl_perf_record(FBWL_PERF_TITLE, start);
 }
 
 static void xdg_toplevel_set_app_id(struct wl_listener *listener, void *data) {
@@ -447,7 +462,7 @@ static void xwayland_surface_map(struct wl_listener *listener, void *data) {
     if (view != NULL && server != NULL && view->xwayland_surface != NULL &&
             xwayland_surface_should_be_in_slit(server, view->xwayland_surface)) {
         view->in_slit = true;
-        view->wm_view.sticky = true;
+        fbwm_core_view_set_sticky(&server->wm, &view->wm_view, true);
         fbwl_view_decor_set_enabled(view, false);
         view->decor_forced = true;
 
@@ -464,17 +479,24 @@ static void xwayland_surface_map(struct wl_listener *listener, void *data) {
         return;
     }
 
+    const struct fbwl_session_entry *session = server_session_restore_pre_map(server, view);
     fbwl_xwayland_handle_surface_map(view, &server->wm, server->output_layout, &server->outputs,
         server->cursor->x, server->cursor->y, server->apps_rules, server->apps_rule_count, &hooks);
+    fbwl_view_icon_fetch(view);
     if (!rules_applied_before && view->apps_rules_applied) {
         server_apps_rule_matchlimit_inc(server, view);
     }
+    bool session_focus = false;
+    server_session_restore_post_map(server, view, session, &session_focus);
     if (!fbwm_core_view_is_visible(&server->wm, &view->wm_view)) {
         return;
     }
 
     const struct fbwl_screen_config *cfg = fbwl_server_screen_config_for_view(server, view);
     bool focus_new = cfg != NULL ? cfg->focus.focus_new_windows : server->focus.focus_new_windows;
+    if (session != NULL) {
+        focus_new = session_focus;
+    }
     if (view->focus_protection & FBWL_APPS_FOCUS_PROTECT_GAIN) {
         focus_new = true;
     } else if (view->focus_protection & FBWL_APPS_FOCUS_PROTECT_REFUSE) {
@@ -661,6 +683,14 @@ static void xwayland_surface_set_hints(struct wl_listener *listener, void *data)
     xwayland_surface_sync_urgency(view, "xwayland-set-hints");
 }
 
+#if WLR_VERSION_NUM >= ((0 << 16) | (19 << 8) | 0)
+static void xwayland_surface_set_icon(struct wl_listener *listener, void *data) {
+    (void)data;
+    struct fbwl_view *view = wl_container_of(listener, view, xwayland_set_icon);
+    fbwl_view_icon_invalidate(view, "xwayland-set-icon");
+}
+#endif
+
 static void xwayland_surface_destroy(struct wl_listener *listener, void *data) {
     (void)data;
     struct fbwl_view *view = wl_container_of(listener, view, destroy);
@@ -680,6 +710,7 @@ void server_xwayland_ready(struct wl_listener *listener, void *data) {
     struct fbwl_server *server = wl_container_of(listener, server, xwayland_ready);
     const char *display_name = server->xwayland != NULL ? server->xwayland->display_name : NULL;
     fbwl_xwayland_handle_ready(display_name);
+    fbwl_view_icon_xwayland_ready(server);
     fbwl_xembed_sni_proxy_maybe_start(server, display_name);
 }
 
@@ -712,6 +743,15 @@ void server_xwayland_new_surface(struct wl_listener *listener, void *data) {
         xwayland_surface_set_hints,
         server != NULL ? server->foreign_toplevel_mgr : NULL,
         foreign_handlers);
+
+#if WLR_VERSION_NUM >= ((0 << 16) | (19 << 8) | 0)
+    // Older wlroots has no _NET_WM_ICON notification; those views refetch on map.
+    struct fbwl_view *view = xsurface != NULL && !xsurface->override_redirect ? xsurface->data : NULL;
+    if (view != NULL) {
+        view->xwayland_set_icon.notify = xwayland_surface_set_icon;
+        wl_signal_add(&xsurface->events.set_icon, &view->xwayland_set_icon);
+    }
+#endif
 }
 
 static void xdg_toplevel_destroy(struct wl_listener *listener, void *data) {
@@ -0,0 +1,406 @@
+#include "wayland/fbwl_session_snapshot.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <wlr/util/log.h>
+
+static const char session_magic[8] = {'F', 'B', 'W', 'L', 'S', 'E', 'S', '1'};
+
+enum {
+    SESSION_MAX_ENTRIES = 4096,
+    SESSION_MAX_STRING = 4096,
+    SESSION_MAX_FILE = 4 * 1024 * 1024,
+};
+
+enum session_index {
+    SESSION_INDEX_EXACT = 0,
+    SESSION_INDEX_PID,
+    SESSION_INDEX_APP_ID,
+    SESSION_INDEX_COUNT,
+};
+
+struct session_record {
+    int32_t pid;
+    int32_t workspace;
+    int32_t x, y;
+    int32_t width, height;
+    int32_t group;
+    int32_t stack;
+    uint8_t layer;
+    uint8_t flags;
+    uint16_t app_id_len;
+    uint16_t title_len;
+    uint16_t role_len;
+};
+
+static uint64_t hash_mix(uint64_t h, const char *s) {
+    if (s != NULL) {
+        for (const unsigned char *p = (const unsigned char *)s; *p != '\0'; p++) {
+            h ^= *p;
+            h *= 1099511628211ull;
+        }
+    }
+    h ^= 0xff;
+    h *= 1099511628211ull;
+    return h;
+}
+
+static uint64_t session_key_hash(enum session_index index, const char *app_id, const char *title, const char *role,
+        int32_t pid) {
+    uint64_t h = 1469598103934665603ull ^ (uint64_t)index;
+    h = hash_mix(h, app_id);
+    switch (index) {
+    case SESSION_INDEX_EXACT:
+        h = hash_mix(h, title);
+        h = hash_mix(h, role);
+        break;
+    case SESSION_INDEX_PID:
+        h ^= (uint64_t)(uint32_t)pid;
+        h *= 1099511628211ull;
+        break;
+    default:
+        break;
+    }
+    return h;
+}
+
+static bool str_eq(const char *a, const char *b) {
+    return strcmp(a != NULL ? a : "", b != NULL ? b : "") == 0;
+}
+
+static bool session_entry_matches(const struct fbwl_session_entry *e, enum session_index index,
+        const char *app_id, const char *title, const char *role, int32_t pid) {
+    if (e->claimed || !str_eq(e->app_id, app_id)) {
+        return false;
+    }
+    switch (index) {
+    case SESSION_INDEX_EXACT:
+        return str_eq(e->title, title) && str_eq(e->role, role);
+    case SESSION_INDEX_PID:
+        return pid > 0 && e->pid == pid;
+    default:
+        return true;
+    }
+}
+
+static void session_index_free(struct fbwl_session_snapshot *snap) {
+    for (size_t i = 0; i < SESSION_INDEX_COUNT; i++) {
+        free(snap->heads[i]);
+        free(snap->next[i]);
+        snap->heads[i] = NULL;
+        snap->next[i] = NULL;
+    }
+    snap->bucket_count = 0;
+}
+
+static bool session_index_build(struct fbwl_session_snapshot *snap) {
+    session_index_free(snap);
+    size_t buckets = 16;
+    while (buckets < snap->len * 2) {
+        buckets *= 2;
+    }
+    for (size_t i = 0; i < SESSION_INDEX_COUNT; i++) {
+        snap->heads[i] = malloc(buckets * sizeof(size_t));
+        snap->next[i] = malloc((snap->len > 0 ? snap->len : 1) * sizeof(size_t));
+        if (snap->heads[i] == NULL || snap->next[i] == NULL) {
+            session_index_free(snap);
+            return false;
+        }
+        for (size_t b = 0; b < buckets; b++) {
+            snap->heads[i][b] = SIZE_MAX;
+        }
+    }
+    snap->bucket_count = buckets;
+
+    // Insert back to front so each chain yields entries in snapshot order.
+    for (size_t n = snap->len; n-- > 0;) {
+        const struct fbwl_session_entry *e = &snap->entries[n];
+        for (size_t i = 0; i < SESSION_INDEX_COUNT; i++) {
+            const size_t b = session_key_hash(i, e->app_id, e->title, e->role, e->pid) & (buckets - 1);
+            snap->next[i][n] = snap->heads[i][b];
+            snap->heads[i][b] = n;
+        }
+    }
+    return true;
+}
+
+void fbwl_session_snapshot_init(struct fbwl_session_snapshot *snap) {
+    if (snap != NULL) {
+        memset(snap, 0, sizeof(*snap));
+    }
+}
+
+void fbwl_session_snapshot_finish(struct fbwl_session_snapshot *snap) {
+    if (snap == NULL) {
+        return;
+    }
+    for (size_t i = 0; i < snap->len; i++) {
+        free(snap->entries[i].app_id);
+        free(snap->entries[i].title);
+        free(snap->entries[i].role);
+    }
+    free(snap->entries);
+    session_index_free(snap);
+    memset(snap, 0, sizeof(*snap));
+}
+
+static char *dup_or_null(const char *s) {
+    return s != NULL && *s != '\0' ? strdup(s) : NULL;
+}
+
+bool fbwl_session_snapshot_add(struct fbwl_session_snapshot *snap, const struct fbwl_session_entry *entry) {
+    if (snap == NULL || entry == NULL || snap->len >= SESSION_MAX_ENTRIES) {
+        return false;
+    }
+    if (snap->len == snap->cap) {
+        const size_t new_cap = snap->cap > 0 ? snap->cap * 2 : 16;
+        struct fbwl_session_entry *p = realloc(snap->entries, new_cap * sizeof(*p));
+        if (p == NULL) {
+            return false;
+        }
+        snap->entries = p;
+        snap->cap = new_cap;
+    }
+    struct fbwl_session_entry *e = &snap->entries[snap->len];
+    *e = *entry;
+    e->app_id = dup_or_null(entry->app_id);
+    e->title = dup_or_null(entry->title);
+    e->role = dup_or_null(entry->role);
+    e->claimed = entry->claimed;
+    snap->len++;
+    session_index_free(snap);
+    return true;
+}
+
+struct fbwl_session_entry *fbwl_session_snapshot_claim(struct fbwl_session_snapshot *snap,
+        const char *app_id, const char *title, const char *role, int32_t pid, bool allow_app_id) {
+    if (snap == NULL || snap->len == 0) {
+        return NULL;
+    }
+    if (snap->bucket_count == 0 && !session_index_build(snap)) {
+        return NULL;
+    }
+    for (size_t i = 0; i < SESSION_INDEX_COUNT; i++) {
+        if ((i == SESSION_INDEX_PID && pid <= 0) || (i == SESSION_INDEX_APP_ID && !allow_app_id)) {
+            continue;
+        }
+        const size_t b = session_key_hash(i, app_id, title, role, pid) & (snap->bucket_count - 1);
+        for (size_t n = snap->heads[i][b]; n != SIZE_MAX; n = snap->next[i][n]) {
+            struct fbwl_session_entry *e = &snap->entries[n];
+            if (session_entry_matches(e, i, app_id, title, role, pid)) {
+                e->claimed = true;
+                return e;
+            }
+        }
+    }
+    return NULL;
+}
+
+static size_t str_len16(const char *s) {
+    const size_t len = s != NULL ? strlen(s) : 0;
+    return len < SESSION_MAX_STRING ? len : SESSION_MAX_STRING;
+}
+
+bool fbwl_session_snapshot_serialize(const struct fbwl_session_snapshot *snap, uint8_t **out_buf, size_t *out_len) {
+    if (snap == NULL || out_buf == NULL || out_len == NULL) {
+        return false;
+    }
+    *out_buf = NULL;
+    *out_len = 0;
+
+    size_t total = sizeof(session_magic) + sizeof(uint32_t);
+    for (size_t i = 0; i < snap->len; i++) {
+        const struct fbwl_session_entry *e = &snap->entries[i];
+        total += sizeof(struct session_record) + str_len16(e->app_id) + str_len16(e->title) + str_len16(e->role);
+    }
+    uint8_t *buf = malloc(total);
+    if (buf == NULL) {
+        return false;
+    }
+
+    uint8_t *p = buf;
+    memcpy(p, session_magic, sizeof(session_magic));
+    p += sizeof(session_magic);
+    const uint32_t count = (uint32_t)snap->len;
+    memcpy(p, &count, sizeof(count));
+    p += sizeof(count);
+    for (size_t i = 0; i < snap->len; i++) {
+        const struct fbwl_session_entry *e = &snap->entries[i];
+        struct session_record rec;
+        memset(&rec, 0, sizeof(rec));
+        rec.pid = e->pid;
+        rec.workspace = e->workspace;
+        rec.x = e->x;
+        rec.y = e->y;
+        rec.width = e->width;
+        rec.height = e->height;
+        rec.group = e->group;
+        rec.stack = e->stack;
+        rec.layer = e->layer;
+        rec.flags = e->flags;
+        rec.app_id_len = (uint16_t)str_len16(e->app_id);
+        rec.title_len = (uint16_t)str_len16(e->title);
+        rec.role_len = (uint16_t)str_len16(e->role);
+        memcpy(p, &rec, sizeof(rec));
+        p += sizeof(rec);
+        memcpy(p, e->app_id != NULL ? e->app_id : "", rec.app_id_len);
+        p += rec.app_id_len;
+        memcpy(p, e->title != NULL ? e->title : "", rec.title_len);
+        p += rec.title_len;
+        memcpy(p, e->role != NULL ? e->role : "", rec.role_len);
+        p += rec.role_len;
+    }
+
+    *out_buf = buf;
+    *out_len = total;
+    return true;
+}
+
+static char *take_string(const uint8_t **p, size_t len) {
+    if (len == 0) {
+        return NULL;
+    }
+    char *s = malloc(len + 1);
+    if (s == NULL) {
+        return NULL;
+    }
+    memcpy(s, *p, len);
+    s[len] = '\0';
+    *p += len;
+    return s;
+}
+
+bool fbwl_session_snapshot_parse(struct fbwl_session_snapshot *snap, const uint8_t *buf, size_t len) {
+    if (snap == NULL || buf == NULL) {
+        return false;
+    }
+    if (len < sizeof(session_magic) + sizeof(uint32_t) ||
+            memcmp(buf, session_magic, sizeof(session_magic)) != 0) {
+        return false;
+    }
+    const uint8_t *p = buf + sizeof(session_magic);
+    const uint8_t *end = buf + len;
+    uint32_t count = 0;
+    memcpy(&count, p, sizeof(count));
+    p += sizeof(count);
+    if (count > SESSION_MAX_ENTRIES) {
+        return false;
+    }
+
+    for (uint32_t i = 0; i < count; i++) {
+        struct session_record rec;
+        if ((size_t)(end - p) < sizeof(rec)) {
+            return false;
+        }
+        memcpy(&rec, p, sizeof(rec));
+        p += sizeof(rec);
+        const size_t strings = (size_t)rec.app_id_len + rec.title_len + rec.role_len;
+        if (rec.app_id_len > SESSION_MAX_STRING || rec.title_len > SESSION_MAX_STRING ||
+                rec.role_len > SESSION_MAX_STRING || (size_t)(end - p) < strings) {
+            return false;
+        }
+
+        struct fbwl_session_entry e = {
+            .pid = rec.pid,
+            .workspace = rec.workspace,
+            .x = rec.x,
+            .y = rec.y,
+            .width = rec.width,
+            .height = rec.height,
+            .group = rec.group,
+            .stack = rec.stack,
+            .layer = rec.layer,
+            .flags = rec.flags,
+        };
+        e.app_id = take_string(&p, rec.app_id_len);
+        e.title = take_string(&p, rec.title_len);
+        e.role = take_string(&p, rec.role_len);
+        const bool ok = fbwl_session_snapshot_add(snap, &e);
+        free(e.app_id);
+        free(e.title);
+        free(e.role);
+        if (!ok) {
+            return false;
+        }
+    }
+    return p == end;
+}
+
+bool fbwl_session_snapshot_load_file(struct fbwl_session_snapshot *snap, const char *path) {
+    if (snap == NULL || path == NULL) {
+        return false;
+    }
+    const int fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return false;
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size <= 0 || st.st_size > SESSION_MAX_FILE) {
+        close(fd);
+        return false;
+    }
+    const size_t len = (size_t)st.st_size;
+    uint8_t *buf = malloc(len);
+    if (buf == NULL) {
+        close(fd);
+        return false;
+    }
+    size_t off = 0;
+    while (off < len) {
+        const ssize_t n = read(fd, buf + off, len - off);
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n <= 0) {
+            break;
+        }
+        off += (size_t)n;
+    }
+    close(fd);
+
+    const bool ok = off == len && fbwl_session_snapshot_parse(snap, buf, len);
+    free(buf);
+    if (!ok) {
+        wlr_log(WLR_ERROR, "Session: ignoring malformed snapshot %s", path);
+        fbwl_session_snapshot_finish(snap);
+    }
+    return ok;
+}
+
+bool fbwl_session_snapshot_write_file(const char *path, const uint8_t *buf, size_t len) {
+    if (path == NULL || buf == NULL) {
+        return false;
+    }
+    char tmp[4096];
+    if (snprintf(tmp, sizeof(tmp), "%s.tmp", path) >= (int)sizeof(tmp)) {
+        return false;
+    }
+    const int fd = open(tmp, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0600);
+    if (fd < 0) {
+        wlr_log(WLR_ERROR, "Session: failed to open %s: %s", tmp, strerror(errno));
+        return false;
+    }
+    size_t off = 0;
+    while (off < len) {
+        const ssize_t n = write(fd, buf + off, len - off);
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n <= 0) {
+            break;
+        }
+        off += (size_t)n;
+    }
+    if (close(fd) != 0 || off != len || rename(tmp, path) != 0) {
+        wlr_log(WLR_ERROR, "Session: failed to write %s: %s", path, strerror(errno));
+        unlink(tmp);
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+enum fbwl_session_flag {
+    FBWL_SESSION_STICKY = 1u << 0,
+    FBWL_SESSION_MAXIMIZED_H = 1u << 1,
+    FBWL_SESSION_MAXIMIZED_V = 1u << 2,
+    FBWL_SESSION_FULLSCREEN = 1u << 3,
+    FBWL_SESSION_MINIMIZED = 1u << 4,
+    FBWL_SESSION_SHADED = 1u << 5,
+    FBWL_SESSION_FOCUSED = 1u << 6,
+};
+
+enum fbwl_session_layer {
+    FBWL_SESSION_LAYER_BACKGROUND = 0,
+    FBWL_SESSION_LAYER_BOTTOM,
+    FBWL_SESSION_LAYER_NORMAL,
+    FBWL_SESSION_LAYER_TOP,
+    FBWL_SESSION_LAYER_OVERLAY,
+};
+
+struct fbwl_session_entry {
+    char *app_id;
+    char *title;
+    char *role;
+    int32_t pid;
+    int32_t workspace;
+    int32_t x, y;
+    int32_t width, height;
+    int32_t group; // 0 == not tabbed; members of one tab group share the id
+    int32_t stack; // 0 == bottom-most
+    uint8_t layer;
+    uint8_t flags;
+    bool claimed;
+};
+
+// Window state keyed by app_id/title/role/pid, so views that reconnect after a
+// restart (or a crash) get their old placement back with a hash lookup instead
+// of apps rule evaluation and placement.
+struct fbwl_session_snapshot {
+    struct fbwl_session_entry *entries;
+    size_t len;
+    size_t cap;
+
+    // Chained indexes: exact (app_id, title, role), (app_id, pid) and app_id.
+    size_t *heads[3];
+    size_t *next[3];
+    size_t bucket_count;
+};
+
+void fbwl_session_snapshot_init(struct fbwl_session_snapshot *snap);
+void fbwl_session_snapshot_finish(struct fbwl_session_snapshot *snap);
+
+// Copies the strings; the index is rebuilt lazily on the next claim.
+bool fbwl_session_snapshot_add(struct fbwl_session_snapshot *snap, const struct fbwl_session_entry *entry);
+
+// Returns the best unclaimed entry for a reconnecting window and marks it
+// claimed, or NULL. The app_id-only match is tried only with `allow_app_id`,
+// since it would hand one window's state to any other of the same app.
+struct fbwl_session_entry *fbwl_session_snapshot_claim(struct fbwl_session_snapshot *snap,
+        const char *app_id, const char *title, const char *role, int32_t pid, bool allow_app_id);
+
+// Serialized form is native-endian; it only ever round-trips through the
+// same binary on the same machine.
+bool fbwl_session_snapshot_serialize(const struct fbwl_session_snapshot *snap, uint8_t **out_buf, size_t *out_len);
+bool fbwl_session_snapshot_parse(struct fbwl_session_snapshot *snap, const uint8_t *buf, size_t len);
+
+bool fbwl_session_snapshot_load_file(struct fbwl_session_snapshot *snap, const char *path);
+bool fbwl_session_snapshot_write_file(const char *path, const uint8_t *buf, size_t len);
@@ -0,0 +1,103 @@
+#include "wayland/fbwl_snap_index.h"
+
+#include <stdlib.h>
+
+void fbwl_snap_index_clear(struct fbwl_snap_index *index) {
+    if (index == NULL) {
+        return;
+    }
+    for (size_t axis = 0; axis < 2; axis++) {
+        index->len[axis] = 0;
+        index->dirty[axis] = false;
+    }
+    index->built = false;
+    index->serial = 0;
+}
+
+void fbwl_snap_index_finish(struct fbwl_snap_index *index) {
+    if (index == NULL) {
+        return;
+    }
+    for (size_t axis = 0; axis < 2; axis++) {
+        free(index->edges[axis]);
+    }
+    *index = (struct fbwl_snap_index){0};
+}
+
+static bool push_edge(struct fbwl_snap_index *index, size_t axis, int pos, int lo, int hi) {
+    if (index->len[axis] >= index->cap[axis]) {
+        const size_t new_cap = index->cap[axis] > 0 ? index->cap[axis] * 2 : 32;
+        struct fbwl_snap_edge *tmp = realloc(index->edges[axis], new_cap * sizeof(*tmp));
+        if (tmp == NULL) {
+            return false;
+        }
+        index->edges[axis] = tmp;
+        index->cap[axis] = new_cap;
+    }
+    index->edges[axis][index->len[axis]++] = (struct fbwl_snap_edge){ .pos = pos, .lo = lo, .hi = hi };
+    index->dirty[axis] = true;
+    return true;
+}
+
+bool fbwl_snap_index_add_box(struct fbwl_snap_index *index, int x, int y, int width, int height) {
+    if (index == NULL || width < 1 || height < 1) {
+        return false;
+    }
+    const int right = x + width;
+    const int bottom = y + height;
+    return push_edge(index, FBWL_SNAP_AXIS_X, x, y, bottom) &&
+        push_edge(index, FBWL_SNAP_AXIS_X, right, y, bottom) &&
+        push_edge(index, FBWL_SNAP_AXIS_Y, y, x, right) &&
+        push_edge(index, FBWL_SNAP_AXIS_Y, bottom, x, right);
+}
+
+static int edge_cmp(const void *a, const void *b) {
+    const struct fbwl_snap_edge *ea = a;
+    const struct fbwl_snap_edge *eb = b;
+    return (ea->pos > eb->pos) - (ea->pos < eb->pos);
+}
+
+static size_t lower_bound(const struct fbwl_snap_edge *edges, size_t len, int pos) {
+    size_t lo = 0;
+    size_t hi = len;
+    while (lo < hi) {
+        const size_t mid = lo + (hi - lo) / 2;
+        if (edges[mid].pos < pos) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    return lo;
+}
+
+bool fbwl_snap_index_nearest(struct fbwl_snap_index *index, enum fbwl_snap_axis axis, int pos, int lo, int hi,
+        int threshold, int *delta) {
+    if (index == NULL || threshold <= 0 || (axis != FBWL_SNAP_AXIS_X && axis != FBWL_SNAP_AXIS_Y)) {
+        return false;
+    }
+    if (index->dirty[axis]) {
+        qsort(index->edges[axis], index->len[axis], sizeof(*index->edges[axis]), edge_cmp);
+        index->dirty[axis] = false;
+    }
+
+    const struct fbwl_snap_edge *edges = index->edges[axis];
+    const size_t len = index->len[axis];
+    bool found = false;
+    int best = 0;
+    for (size_t i = lower_bound(edges, len, pos - threshold); i < len && edges[i].pos <= pos + threshold; i++) {
+        // Only edges the frame actually runs along, as in Fluxbox/X11.
+        if (edges[i].hi < lo || edges[i].lo > hi) {
+            continue;
+        }
+        const int d = edges[i].pos - pos;
+        if (!found || abs(d) < abs(best)) {
+            best = d;
+            found = true;
+        }
+    }
+    if (found && delta != NULL) {
+        *delta = best;
+    }
+    return found;
+}
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+enum fbwl_snap_axis {
+    FBWL_SNAP_AXIS_X = 0,
+    FBWL_SNAP_AXIS_Y,
+};
+
+// A vertical (X axis) or horizontal (Y axis) frame edge at `pos`, covering
+// [lo, hi] along the other axis.
+struct fbwl_snap_edge {
+    int pos;
+    int lo;
+    int hi;
+};
+
+// Window edges sorted by position, so a move/resize step only looks at the
+// edges within the snap threshold instead of every window.
+struct fbwl_snap_index {
+    struct fbwl_snap_edge *edges[2];
+    size_t len[2];
+    size_t cap[2];
+    bool dirty[2];
+    bool built;
+    uint64_t serial;
+};
+
+void fbwl_snap_index_clear(struct fbwl_snap_index *index);
+void fbwl_snap_index_finish(struct fbwl_snap_index *index);
+
+// Adds the four edges of a frame box; sorting is deferred to the next query.
+bool fbwl_snap_index_add_box(struct fbwl_snap_index *index, int x, int y, int width, int height);
+
+// Finds the edge nearest to `pos` (at most `threshold` away) whose span
+// overlaps [lo, hi]; stores edge - pos in *delta.
+bool fbwl_snap_index_nearest(struct fbwl_snap_index *index, enum fbwl_snap_axis axis, int pos, int lo, int hi,
+        int threshold, int *delta);
@@ -64,14 +64,43 @@ void sni_item_destroy(struct fbwl_sni_item *item) {
     free(item);
 }
 
+// The New* signals name the property that changed; NewStatus and
+// NewIconThemePath carry the new value as their argument.
 static int sni_item_icon_signal(sd_bus_message *m, void *userdata, sd_bus_error *ret_error) {
-    (void)m;
     (void)ret_error;
     struct fbwl_sni_item *item = userdata;
-    if (item == NULL) {
+    if (item == NULL || m == NULL) {
+        return 0;
+    }
+
+    const char *member = sd_bus_message_get_member(m);
+    if (member == NULL) {
+        sni_item_request_all(item);
+        return 0;
+    }
+
+    const bool new_status = strcmp(member, "NewStatus") == 0;
+    if (new_status || strcmp(member, "NewIconThemePath") == 0) {
+        const char *value = NULL;
+        if (sd_bus_message_read(m, "s", &value) < 0) {
+            sni_item_request(item, new_status ? SNI_PROP_STATUS : SNI_PROP_ICON_THEME_PATH);
+        } else if (new_status) {
+            sni_item_set_status(item, value);
+        } else {
+            sni_item_set_icon_theme_path(item, value);
+        }
         return 0;
     }
-    sni_item_request_all(item);
+
+    if (strcmp(member, "NewIcon") == 0) {
+        sni_item_request(item, SNI_PROP_ICON);
+    } else if (strcmp(member, "NewAttentionIcon") == 0) {
+        sni_item_request(item, SNI_PROP_ATTENTION_ICON);
+    } else if (strcmp(member, "NewOverlayIcon") == 0) {
+        sni_item_request(item, SNI_PROP_OVERLAY_ICON);
+    } else {
+        sni_item_request_all(item);
+    }
     return 0;
 }
 
@@ -90,7 +119,7 @@ static int sni_item_properties_changed(sd_bus_message *m, void *userdata, sd_bus
         return 0;
     }
 
-    sni_item_request_all(item);
+    sni_item_handle_properties_changed(item, m);
     return 0;
 }
 
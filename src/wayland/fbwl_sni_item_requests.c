@@ -34,9 +34,7 @@ static void sni_item_update_render_icon(struct fbwl_sni_item *item) {
         item->render_overlay_buf = NULL;
         item->render_status = item->status;
 
-        if (item->watcher != NULL && item->watcher->on_change != NULL) {
-            item->watcher->on_change(item->watcher->on_change_userdata);
-        }
+        sni_watcher_notify_change(item->watcher);
         return;
     }
 
@@ -91,9 +89,7 @@ static void sni_item_update_render_icon(struct fbwl_sni_item *item) {
             sni_status_str(item->status));
     }
 
-    if (item->watcher != NULL && item->watcher->on_change != NULL) {
-        item->watcher->on_change(item->watcher->on_change_userdata);
-    }
+    sni_watcher_notify_change(item->watcher);
 }
 
 static int sni_item_get_icon_name_reply(sd_bus_message *m, void *userdata, sd_bus_error *ret_error) {
@@ -513,6 +509,29 @@ static int sni_item_get_overlay_icon_name_reply(sd_bus_message *m, void *userdat
 
 static void sni_item_request_overlay_icon(struct fbwl_sni_item *item);
 
+// Icon names resolve against the theme path, so every icon is re-fetched.
+void sni_item_set_icon_theme_path(struct fbwl_sni_item *item, const char *path) {
+    if (item == NULL) {
+        return;
+    }
+
+    const char *new_path = path != NULL && path[0] != '\0' ? path : NULL;
+    const bool same = (new_path == NULL && item->icon_theme_path == NULL) ||
+        (new_path != NULL && item->icon_theme_path != NULL && strcmp(new_path, item->icon_theme_path) == 0);
+    if (same) {
+        return;
+    }
+
+    free(item->icon_theme_path);
+    item->icon_theme_path = new_path != NULL ? strdup(new_path) : NULL;
+    wlr_log(WLR_INFO, "SNI: icon theme path updated id=%s path=%s",
+        item->id != NULL ? item->id : "", item->icon_theme_path != NULL ? item->icon_theme_path : "");
+
+    sni_item_request_icon(item);
+    sni_item_request_attention_icon(item);
+    sni_item_request_overlay_icon(item);
+}
+
 static int sni_item_get_icon_theme_path_reply(sd_bus_message *m, void *userdata, sd_bus_error *ret_error) {
     (void)ret_error;
 
@@ -544,26 +563,9 @@ static int sni_item_get_icon_theme_path_reply(sd_bus_message *m, void *userdata,
     const char *path = NULL;
     r = sd_bus_message_read(m, "s", &path);
     (void)sd_bus_message_exit_container(m);
-    if (r < 0) {
-        return 0;
+    if (r >= 0) {
+        sni_item_set_icon_theme_path(item, path);
     }
-
-    const char *new_path = path != NULL && path[0] != '\0' ? path : NULL;
-    const bool same = (new_path == NULL && item->icon_theme_path == NULL) ||
-        (new_path != NULL && item->icon_theme_path != NULL && strcmp(new_path, item->icon_theme_path) == 0);
-    if (same) {
-        return 0;
-    }
-
-    free(item->icon_theme_path);
-    item->icon_theme_path = new_path != NULL ? strdup(new_path) : NULL;
-    wlr_log(WLR_INFO, "SNI: icon theme path updated id=%s path=%s",
-        item->id != NULL ? item->id : "", item->icon_theme_path != NULL ? item->icon_theme_path : "");
-
-    sni_item_request_icon(item);
-    sni_item_request_attention_icon(item);
-    sni_item_request_overlay_icon(item);
-
     return 0;
 }
 
@@ -667,54 +669,37 @@ static void sni_item_request_overlay_icon(struct fbwl_sni_item *item) {
     }
 }
 
-static int sni_item_get_status_reply(sd_bus_message *m, void *userdata, sd_bus_error *ret_error) {
-    (void)ret_error;
-
-    struct fbwl_sni_item *item = userdata;
-    if (item == NULL) {
-        return 0;
+void sni_item_set_status(struct fbwl_sni_item *item, const char *status) {
+    if (item == NULL || status == NULL || status[0] == '\0') {
+        return;
     }
 
-    item->slot_get_status = sd_bus_slot_unref(item->slot_get_status);
-
-    if (m == NULL) {
-        return 0;
+    enum fbwl_sni_status parsed = sni_status_parse(status);
+    if (parsed == item->status) {
+        return;
     }
 
-    if (sd_bus_message_is_method_error(m, NULL)) {
-        const sd_bus_error *err = sd_bus_message_get_error(m);
-        wlr_log(WLR_INFO, "SNI: Status query error for id=%s: %s: %s",
-            item->id != NULL ? item->id : "",
-            err != NULL && err->name != NULL ? err->name : "",
-            err != NULL && err->message != NULL ? err->message : "");
-        return 0;
-    }
+    item->status = parsed;
+    wlr_log(WLR_INFO, "SNI: status updated id=%s status=%s", item->id != NULL ? item->id : "",
+        sni_status_str(item->status));
+    sni_item_update_render_icon(item);
+}
 
+static void sni_item_apply_status(struct fbwl_sni_item *item, sd_bus_message *m) {
     int r = sd_bus_message_enter_container(m, SD_BUS_TYPE_VARIANT, "s");
     if (r < 0) {
-        return 0;
+        return;
     }
 
     const char *status = NULL;
     r = sd_bus_message_read(m, "s", &status);
     (void)sd_bus_message_exit_container(m);
-    if (r < 0 || status == NULL || status[0] == '\0') {
-        return 0;
-    }
-
-    enum fbwl_sni_status parsed = sni_status_parse(status);
-    if (parsed == item->status) {
-        return 0;
+    if (r >= 0) {
+        sni_item_set_status(item, status);
     }
-
-    item->status = parsed;
-    wlr_log(WLR_INFO, "SNI: status updated id=%s status=%s", item->id != NULL ? item->id : "",
-        sni_status_str(item->status));
-    sni_item_update_render_icon(item);
-    return 0;
 }
 
-static int sni_item_get_item_id_reply(sd_bus_message *m, void *userdata, sd_bus_error *ret_error) {
+static int sni_item_get_status_reply(sd_bus_message *m, void *userdata, sd_bus_error *ret_error) {
     (void)ret_error;
 
     struct fbwl_sni_item *item = userdata;
@@ -722,7 +707,7 @@ static int sni_item_get_item_id_reply(sd_bus_message *m, void *userdata, sd_bus_
         return 0;
     }
 
-    item->slot_get_item_id = sd_bus_slot_unref(item->slot_get_item_id);
+    item->slot_get_status = sd_bus_slot_unref(item->slot_get_status);
 
     if (m == NULL) {
         return 0;
@@ -730,44 +715,47 @@ static int sni_item_get_item_id_reply(sd_bus_message *m, void *userdata, sd_bus_
 
     if (sd_bus_message_is_method_error(m, NULL)) {
         const sd_bus_error *err = sd_bus_message_get_error(m);
-        wlr_log(WLR_INFO, "SNI: Id query error for id=%s: %s: %s",
+        wlr_log(WLR_INFO, "SNI: Status query error for id=%s: %s: %s",
             item->id != NULL ? item->id : "",
             err != NULL && err->name != NULL ? err->name : "",
             err != NULL && err->message != NULL ? err->message : "");
         return 0;
     }
 
+    sni_item_apply_status(item, m);
+    return 0;
+}
+
+static void sni_item_apply_item_id(struct fbwl_sni_item *item, sd_bus_message *m) {
     int r = sd_bus_message_enter_container(m, SD_BUS_TYPE_VARIANT, "s");
     if (r < 0) {
-        return 0;
+        return;
     }
 
     const char *item_id = NULL;
     r = sd_bus_message_read(m, "s", &item_id);
     (void)sd_bus_message_exit_container(m);
     if (r < 0 || item_id == NULL) {
-        return 0;
+        return;
     }
 
     if (item_id[0] == '\0') {
         if (item->item_id == NULL) {
-            return 0;
+            return;
         }
         free(item->item_id);
         item->item_id = NULL;
-        if (item->watcher != NULL && item->watcher->on_change != NULL) {
-            item->watcher->on_change(item->watcher->on_change_userdata);
-        }
-        return 0;
+        sni_watcher_notify_change(item->watcher);
+        return;
     }
 
     if (item->item_id != NULL && strcmp(item->item_id, item_id) == 0) {
-        return 0;
+        return;
     }
 
     char *dup = strdup(item_id);
     if (dup == NULL) {
-        return 0;
+        return;
     }
 
     free(item->item_id);
@@ -775,9 +763,33 @@ static int sni_item_get_item_id_reply(sd_bus_message *m, void *userdata, sd_bus_
     wlr_log(WLR_INFO, "SNI: item id updated id=%s item_id=%s", item->id != NULL ? item->id : "",
         item->item_id != NULL ? item->item_id : "");
 
-    if (item->watcher != NULL && item->watcher->on_change != NULL) {
-        item->watcher->on_change(item->watcher->on_change_userdata);
+    sni_watcher_notify_change(item->watcher);
+}
+
+static int sni_item_get_item_id_reply(sd_bus_message *m, void *userdata, sd_bus_error *ret_error) {
+    (void)ret_error;
+
+    struct fbwl_sni_item *item = userdata;
+    if (item == NULL) {
+        return 0;
+    }
+
+    item->slot_get_item_id = sd_bus_slot_unref(item->slot_get_item_id);
+
+    if (m == NULL) {
+        return 0;
+    }
+
+    if (sd_bus_message_is_method_error(m, NULL)) {
+        const sd_bus_error *err = sd_bus_message_get_error(m);
+        wlr_log(WLR_INFO, "SNI: Id query error for id=%s: %s: %s",
+            item->id != NULL ? item->id : "",
+            err != NULL && err->name != NULL ? err->name : "",
+            err != NULL && err->message != NULL ? err->message : "");
+        return 0;
     }
+
+    sni_item_apply_item_id(item, m);
     return 0;
 }
 
@@ -821,17 +833,190 @@ static void sni_item_request_status(struct fbwl_sni_item *item) {
     }
 }
 
-void sni_item_request_all(struct fbwl_sni_item *item) {
+void sni_item_request(struct fbwl_sni_item *item, uint32_t props) {
     if (item == NULL) {
         return;
     }
 
-    sni_item_request_status(item);
-    sni_item_request_item_id(item);
-    sni_item_request_icon_theme_path(item);
-    sni_item_request_icon(item);
-    sni_item_request_attention_icon(item);
-    sni_item_request_overlay_icon(item);
+    if ((props & SNI_PROP_STATUS) != 0) {
+        sni_item_request_status(item);
+    }
+    if ((props & SNI_PROP_ITEM_ID) != 0) {
+        sni_item_request_item_id(item);
+    }
+    if ((props & SNI_PROP_ICON_THEME_PATH) != 0) {
+        sni_item_request_icon_theme_path(item);
+    }
+    if ((props & SNI_PROP_ICON) != 0) {
+        sni_item_request_icon(item);
+    }
+    if ((props & SNI_PROP_ATTENTION_ICON) != 0) {
+        sni_item_request_attention_icon(item);
+    }
+    if ((props & SNI_PROP_OVERLAY_ICON) != 0) {
+        sni_item_request_overlay_icon(item);
+    }
+}
+
+void sni_item_request_all(struct fbwl_sni_item *item) {
+    sni_item_request(item, SNI_PROP_ALL);
+}
+
+static const struct {
+    const char *name;
+    uint32_t prop;
+    // Values of these can be applied from a PropertiesChanged payload as is.
+    const char *inline_type;
+} sni_props[] = {
+    {"Status", SNI_PROP_STATUS, "s"},
+    {"Id", SNI_PROP_ITEM_ID, "s"},
+    {"IconThemePath", SNI_PROP_ICON_THEME_PATH, "s"},
+    {"IconPixmap", SNI_PROP_ICON, "a(iiay)"},
+    {"AttentionIconPixmap", SNI_PROP_ATTENTION_ICON, "a(iiay)"},
+    {"OverlayIconPixmap", SNI_PROP_OVERLAY_ICON, "a(iiay)"},
+    // Names only count through the pixmap-then-name fallback chain.
+    {"IconName", SNI_PROP_ICON, NULL},
+    {"AttentionIconName", SNI_PROP_ATTENTION_ICON, NULL},
+    {"OverlayIconName", SNI_PROP_OVERLAY_ICON, NULL},
+};
+
+static size_t sni_prop_lookup(const char *name) {
+    for (size_t i = 0; name != NULL && i < sizeof(sni_props) / sizeof(sni_props[0]); i++) {
+        if (strcmp(sni_props[i].name, name) == 0) {
+            return i;
+        }
+    }
+    return SIZE_MAX;
+}
+
+static void sni_item_apply_inline(struct fbwl_sni_item *item, uint32_t prop, sd_bus_message *m) {
+    struct wlr_buffer *buf = NULL;
+    switch (prop) {
+    case SNI_PROP_STATUS:
+        item->slot_get_status = sd_bus_slot_unref(item->slot_get_status);
+        sni_item_apply_status(item, m);
+        return;
+    case SNI_PROP_ITEM_ID:
+        item->slot_get_item_id = sd_bus_slot_unref(item->slot_get_item_id);
+        sni_item_apply_item_id(item, m);
+        return;
+    case SNI_PROP_ICON_THEME_PATH: {
+        item->slot_get_icon_theme_path = sd_bus_slot_unref(item->slot_get_icon_theme_path);
+        const char *path = NULL;
+        if (sd_bus_message_enter_container(m, SD_BUS_TYPE_VARIANT, "s") >= 0) {
+            const int r = sd_bus_message_read(m, "s", &path);
+            (void)sd_bus_message_exit_container(m);
+            if (r >= 0) {
+                sni_item_set_icon_theme_path(item, path);
+            }
+        }
+        return;
+    }
+    case SNI_PROP_ICON:
+        // A newer value supersedes any Get still in flight.
+        item->slot_get_icon = sd_bus_slot_unref(item->slot_get_icon);
+        item->slot_get_icon_name = sd_bus_slot_unref(item->slot_get_icon_name);
+        buf = sni_item_parse_icon_pixmap_get_reply(m);
+        if (buf == NULL) {
+            sni_item_request_icon_name(item);
+            return;
+        }
+        if (item->base_buf != NULL) {
+            wlr_buffer_drop(item->base_buf);
+        }
+        item->base_buf = buf;
+        break;
+    case SNI_PROP_ATTENTION_ICON:
+        item->slot_get_attention_icon = sd_bus_slot_unref(item->slot_get_attention_icon);
+        item->slot_get_attention_icon_name = sd_bus_slot_unref(item->slot_get_attention_icon_name);
+        buf = sni_item_parse_icon_pixmap_get_reply(m);
+        if (buf == NULL) {
+            sni_item_request_attention_icon_name(item);
+            return;
+        }
+        if (item->attention_buf != NULL) {
+            wlr_buffer_drop(item->attention_buf);
+        }
+        item->attention_buf = buf;
+        break;
+    case SNI_PROP_OVERLAY_ICON:
+        item->slot_get_overlay_icon = sd_bus_slot_unref(item->slot_get_overlay_icon);
+        item->slot_get_overlay_icon_name = sd_bus_slot_unref(item->slot_get_overlay_icon_name);
+        buf = sni_item_parse_icon_pixmap_get_reply(m);
+        if (buf == NULL) {
+            sni_item_request_overlay_icon_name(item);
+            return;
+        }
+        if (item->overlay_buf != NULL) {
+            wlr_buffer_drop(item->overlay_buf);
+        }
+        item->overlay_buf = buf;
+        break;
+    default:
+        (void)sd_bus_message_skip(m, "v");
+        return;
+    }
+    sni_item_update_render_icon(item);
+}
+
+// org.freedesktop.DBus.Properties.PropertiesChanged(s interface, a{sv} changed, as invalidated):
+// changed values are applied directly and only invalidated properties we show are re-fetched.
+// An empty signal carries no hint, so everything is re-fetched as before.
+void sni_item_handle_properties_changed(struct fbwl_sni_item *item, sd_bus_message *m) {
+    if (item == NULL || m == NULL) {
+        return;
+    }
+
+    const char *iface = NULL;
+    if (sd_bus_message_read(m, "s", &iface) < 0 ||
+            sd_bus_message_enter_container(m, SD_BUS_TYPE_ARRAY, "{sv}") < 0) {
+        sni_item_request_all(item);
+        return;
+    }
+
+    uint32_t refetch = 0;
+    size_t seen = 0;
+    while (sd_bus_message_enter_container(m, SD_BUS_TYPE_DICT_ENTRY, "sv") > 0) {
+        const char *name = NULL;
+        if (sd_bus_message_read(m, "s", &name) < 0) {
+            (void)sd_bus_message_exit_container(m);
+            break;
+        }
+        seen++;
+
+        const size_t idx = sni_prop_lookup(name);
+        const char *contents = NULL;
+        char type = 0;
+        if (idx != SIZE_MAX && sni_props[idx].inline_type != NULL &&
+                sd_bus_message_peek_type(m, &type, &contents) > 0 && type == SD_BUS_TYPE_VARIANT &&
+                contents != NULL && strcmp(contents, sni_props[idx].inline_type) == 0) {
+            sni_item_apply_inline(item, sni_props[idx].prop, m);
+        } else {
+            if (idx != SIZE_MAX) {
+                refetch |= sni_props[idx].prop;
+            }
+            (void)sd_bus_message_skip(m, "v");
+        }
+        (void)sd_bus_message_exit_container(m);
+    }
+    (void)sd_bus_message_exit_container(m);
+
+    if (sd_bus_message_enter_container(m, SD_BUS_TYPE_ARRAY, "s") >= 0) {
+        const char *name = NULL;
+        while (sd_bus_message_read(m, "s", &name) > 0) {
+            seen++;
+            const size_t idx = sni_prop_lookup(name);
+            if (idx != SIZE_MAX) {
+                refetch |= sni_props[idx].prop;
+            }
+        }
+        (void)sd_bus_message_exit_container(m);
+    }
+
+    if (seen == 0) {
+        refetch = SNI_PROP_ALL;
+    }
+    sni_item_request(item, refetch);
 }
 
 #endif
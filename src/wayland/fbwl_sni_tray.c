@@ -14,11 +14,24 @@
 
 #include <wlr/util/log.h>
 
-static void sni_watcher_notify_change(struct fbwl_sni_watcher *watcher) {
-    if (watcher == NULL || watcher->on_change == NULL) {
+static void sni_watcher_change_idle(void *data) {
+    struct fbwl_sni_watcher *watcher = data;
+    watcher->change_idle = NULL;
+    if (watcher->on_change != NULL) {
+        watcher->on_change(watcher->on_change_userdata);
+    }
+}
+
+void sni_watcher_notify_change(struct fbwl_sni_watcher *watcher) {
+    if (watcher == NULL || watcher->on_change == NULL || watcher->change_idle != NULL) {
         return;
     }
-    watcher->on_change(watcher->on_change_userdata);
+    if (watcher->loop != NULL) {
+        watcher->change_idle = wl_event_loop_add_idle(watcher->loop, sni_watcher_change_idle, watcher);
+    }
+    if (watcher->change_idle == NULL) {
+        watcher->on_change(watcher->on_change_userdata);
+    }
 }
 
 static uint32_t wl_event_mask_from_sdbus_events(uint32_t events) {
@@ -428,6 +441,7 @@ bool fbwl_sni_start(struct fbwl_sni_watcher *watcher, struct wl_event_loop *loop
     wl_list_init(&watcher->items);
     watcher->on_change = on_change_local;
     watcher->on_change_userdata = userdata_local;
+    watcher->loop = loop;
 
     int r = sd_bus_open_user(&watcher->bus);
     if (r < 0) {
@@ -505,6 +519,10 @@ void fbwl_sni_finish(struct fbwl_sni_watcher *watcher) {
         wl_event_source_remove(watcher->event_source_timer);
         watcher->event_source_timer = NULL;
     }
+    if (watcher->change_idle != NULL) {
+        wl_event_source_remove(watcher->change_idle);
+        watcher->change_idle = NULL;
+    }
 
     watcher->slot_name_owner_changed = sd_bus_slot_unref(watcher->slot_name_owner_changed);
     watcher->slot_vtable = sd_bus_slot_unref(watcher->slot_vtable);
@@ -63,6 +63,8 @@ struct fbwl_sni_watcher {
     sd_bus_slot *slot_name_owner_changed;
     struct wl_event_source *event_source_fd;
     struct wl_event_source *event_source_timer;
+    struct wl_event_loop *loop;
+    struct wl_event_source *change_idle;
     bool host_registered;
     struct wl_list items; // fbwl_sni_item
 
@@ -9,9 +9,28 @@
 
 struct wlr_buffer;
 
+typedef struct sd_bus_message sd_bus_message;
+
+enum {
+    SNI_PROP_STATUS = 1u << 0,
+    SNI_PROP_ITEM_ID = 1u << 1,
+    SNI_PROP_ICON_THEME_PATH = 1u << 2,
+    SNI_PROP_ICON = 1u << 3,
+    SNI_PROP_ATTENTION_ICON = 1u << 4,
+    SNI_PROP_OVERLAY_ICON = 1u << 5,
+    SNI_PROP_ALL = (1u << 6) - 1,
+};
+
+// Coalesces tray change notifications into one on_change per loop iteration.
+void sni_watcher_notify_change(struct fbwl_sni_watcher *watcher);
+
 void sni_item_destroy(struct fbwl_sni_item *item);
 void sni_item_subscribe(struct fbwl_sni_item *item);
+void sni_item_request(struct fbwl_sni_item *item, uint32_t props);
 void sni_item_request_all(struct fbwl_sni_item *item);
+void sni_item_handle_properties_changed(struct fbwl_sni_item *item, sd_bus_message *m);
+void sni_item_set_status(struct fbwl_sni_item *item, const char *status);
+void sni_item_set_icon_theme_path(struct fbwl_sni_item *item, const char *path);
 
 struct wlr_buffer *sni_icon_buffer_from_argb32(const uint8_t *argb, size_t len, int width, int height);
 const char *sni_status_str(enum fbwl_sni_status status);
@@ -0,0 +1,161 @@
+#include "wayland/fbwl_socket_handover.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/file.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <wlr/util/log.h>
+
+#define HANDOVER_ENV "FBWL_SOCKET_HANDOVER"
+
+enum {
+    HANDOVER_AUTO_MAX = 32,
+};
+
+void fbwl_socket_handover_init(struct fbwl_socket_handover *handover) {
+    if (handover == NULL) {
+        return;
+    }
+    handover->listen_fd = -1;
+    handover->lock_fd = -1;
+    handover->name[0] = '\0';
+}
+
+static bool fd_valid(int fd) {
+    return fd >= 0 && fcntl(fd, F_GETFD) != -1;
+}
+
+static void set_cloexec(int fd, bool on) {
+    const int flags = fcntl(fd, F_GETFD);
+    if (flags == -1) {
+        return;
+    }
+    (void)fcntl(fd, F_SETFD, on ? (flags | FD_CLOEXEC) : (flags & ~FD_CLOEXEC));
+}
+
+bool fbwl_socket_handover_take(struct fbwl_socket_handover *handover) {
+    if (handover == NULL) {
+        return false;
+    }
+    const char *env = getenv(HANDOVER_ENV);
+    if (env == NULL || *env == '\0') {
+        return false;
+    }
+
+    int listen_fd = -1;
+    int lock_fd = -1;
+    char name[sizeof(handover->name)] = {0};
+    const int n = sscanf(env, "%d:%d:%63s", &listen_fd, &lock_fd, name);
+    unsetenv(HANDOVER_ENV);
+    if (n != 3 || !fd_valid(listen_fd) || !fd_valid(lock_fd) || name[0] == '\0') {
+        wlr_log(WLR_ERROR, "Restart: ignoring invalid %s", HANDOVER_ENV);
+        return false;
+    }
+
+    set_cloexec(listen_fd, true);
+    set_cloexec(lock_fd, true);
+    handover->listen_fd = listen_fd;
+    handover->lock_fd = lock_fd;
+    snprintf(handover->name, sizeof(handover->name), "%s", name);
+    wlr_log(WLR_INFO, "Restart: inherited socket %s fd=%d", handover->name, handover->listen_fd);
+    return true;
+}
+
+static bool listen_on(struct fbwl_socket_handover *handover, const char *runtime_dir, const char *name) {
+    struct sockaddr_un addr = {.sun_family = AF_UNIX};
+    const int path_len = snprintf(addr.sun_path, sizeof(addr.sun_path), "%s/%s", runtime_dir, name);
+    if (path_len < 0 || (size_t)path_len >= sizeof(addr.sun_path)) {
+        return false;
+    }
+    char lock_path[sizeof(addr.sun_path) + 8];
+    snprintf(lock_path, sizeof(lock_path), "%s.lock", addr.sun_path);
+
+    const int lock_fd = open(lock_path, O_CREAT | O_CLOEXEC | O_RDWR, 0660);
+    if (lock_fd < 0) {
+        return false;
+    }
+    if (flock(lock_fd, LOCK_EX | LOCK_NB) != 0) {
+        close(lock_fd);
+        return false;
+    }
+
+    // Holding the lock means any socket file left behind is stale.
+    (void)unlink(addr.sun_path);
+    const int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd < 0) {
+        close(lock_fd);
+        return false;
+    }
+    if (bind(fd, (struct sockaddr *)&addr, sizeof(addr)) != 0 || listen(fd, 128) != 0) {
+        wlr_log(WLR_ERROR, "Restart: failed to listen on %s: %s", addr.sun_path, strerror(errno));
+        close(fd);
+        close(lock_fd);
+        return false;
+    }
+
+    handover->listen_fd = fd;
+    handover->lock_fd = lock_fd;
+    snprintf(handover->name, sizeof(handover->name), "%s", name);
+    return true;
+}
+
+bool fbwl_socket_handover_listen(struct fbwl_socket_handover *handover, const char *name) {
+    if (handover == NULL) {
+        return false;
+    }
+    const char *runtime_dir = getenv("XDG_RUNTIME_DIR");
+    if (runtime_dir == NULL || *runtime_dir == '\0') {
+        wlr_log(WLR_ERROR, "Restart: XDG_RUNTIME_DIR is not set");
+        return false;
+    }
+    if (name != NULL) {
+        return strlen(name) < sizeof(handover->name) && listen_on(handover, runtime_dir, name);
+    }
+    for (int i = 1; i <= HANDOVER_AUTO_MAX; i++) {
+        char auto_name[sizeof(handover->name)];
+        snprintf(auto_name, sizeof(auto_name), "wayland-%d", i);
+        if (listen_on(handover, runtime_dir, auto_name)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool fbwl_socket_handover_export(struct fbwl_socket_handover *handover) {
+    if (handover == NULL || !fd_valid(handover->listen_fd) || !fd_valid(handover->lock_fd)) {
+        return false;
+    }
+    char env[128];
+    snprintf(env, sizeof(env), "%d:%d:%s", handover->listen_fd, handover->lock_fd, handover->name);
+    set_cloexec(handover->listen_fd, false);
+    set_cloexec(handover->lock_fd, false);
+    return setenv(HANDOVER_ENV, env, true) == 0;
+}
+
+void fbwl_socket_handover_close(struct fbwl_socket_handover *handover) {
+    if (handover == NULL) {
+        return;
+    }
+    if (handover->listen_fd >= 0) {
+        const char *runtime_dir = getenv("XDG_RUNTIME_DIR");
+        if (runtime_dir != NULL && handover->name[0] != '\0') {
+            char path[sizeof(((struct sockaddr_un *)0)->sun_path) + 8];
+            snprintf(path, sizeof(path), "%s/%s", runtime_dir, handover->name);
+            (void)unlink(path);
+            snprintf(path, sizeof(path), "%s/%s.lock", runtime_dir, handover->name);
+            (void)unlink(path);
+        }
+        close(handover->listen_fd);
+    }
+    if (handover->lock_fd >= 0) {
+        close(handover->lock_fd);
+    }
+    fbwl_socket_handover_init(handover);
+}
@@ -0,0 +1,25 @@
+#pragma once
+
+#include <stdbool.h>
+
+// Listening Wayland socket owned by the compositor rather than libwayland, so
+// a self re-exec on Restart can inherit it: clients that reconnect while the
+// new process starts up queue in the backlog instead of failing to connect.
+struct fbwl_socket_handover {
+    int listen_fd;
+    int lock_fd;
+    char name[64];
+};
+
+void fbwl_socket_handover_init(struct fbwl_socket_handover *handover);
+
+// Adopts the fds announced by a restarting parent in FBWL_SOCKET_HANDOVER.
+bool fbwl_socket_handover_take(struct fbwl_socket_handover *handover);
+
+// Binds and locks $XDG_RUNTIME_DIR/<name> (or the first free wayland-N).
+bool fbwl_socket_handover_listen(struct fbwl_socket_handover *handover, const char *name);
+
+// Makes the fds survive exec and announces them to the next process.
+bool fbwl_socket_handover_export(struct fbwl_socket_handover *handover);
+
+void fbwl_socket_handover_close(struct fbwl_socket_handover *handover);
@@ -0,0 +1,299 @@
+#include "wayland/fbwl_spawn.h"
+
+#include <errno.h>
+#include <signal.h>
+#include <spawn.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/wait.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <wayland-server-core.h>
+#include <wlr/util/log.h>
+
+extern char **environ;
+
+enum {
+    SPAWN_HISTORY = 64,
+    SPAWN_CMD_MAX = 96,
+};
+
+struct spawn_record {
+    uint64_t seq;
+    pid_t pid;
+    bool direct;
+    bool running;
+    int status;
+    uint64_t start_ns;
+    uint64_t end_ns;
+    uint32_t spawn_us;
+    char cmd[SPAWN_CMD_MAX];
+};
+
+struct spawn_child {
+    pid_t pid;
+    uint64_t seq;
+};
+
+static struct {
+    struct wl_event_source *sigchld;
+    struct spawn_record history[SPAWN_HISTORY];
+    uint64_t next_seq;
+    struct spawn_child *running;
+    size_t running_len;
+    size_t running_cap;
+    struct fbwl_spawn_stats stats;
+} spawn;
+
+static uint64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+}
+
+static struct spawn_record *record_for_seq(uint64_t seq) {
+    struct spawn_record *rec = &spawn.history[seq % SPAWN_HISTORY];
+    return rec->seq == seq ? rec : NULL;
+}
+
+static void reap_children(void) {
+    size_t i = 0;
+    while (i < spawn.running_len) {
+        int status = 0;
+        const pid_t r = waitpid(spawn.running[i].pid, &status, WNOHANG);
+        if (r == 0 || (r < 0 && errno == EINTR)) {
+            i++;
+            continue;
+        }
+        struct spawn_record *rec = record_for_seq(spawn.running[i].seq);
+        if (rec != NULL) {
+            rec->running = false;
+            rec->status = r > 0 ? status : -1;
+            rec->end_ns = now_ns();
+        }
+        spawn.running[i] = spawn.running[--spawn.running_len];
+    }
+    spawn.stats.running = spawn.running_len;
+}
+
+static int handle_sigchld(int signo, void *data) {
+    (void)signo;
+    (void)data;
+    reap_children();
+    return 0;
+}
+
+bool fbwl_spawn_init(struct wl_event_loop *loop) {
+    if (loop == NULL || spawn.sigchld != NULL) {
+        return false;
+    }
+    spawn.sigchld = wl_event_loop_add_signal(loop, SIGCHLD, handle_sigchld, NULL);
+    if (spawn.sigchld == NULL) {
+        wlr_log(WLR_ERROR, "Spawn: failed to watch SIGCHLD");
+        return false;
+    }
+    // Children that exited before the signal was blocked sent nothing.
+    reap_children();
+    return true;
+}
+
+void fbwl_spawn_finish(void) {
+    if (spawn.sigchld != NULL) {
+        wl_event_source_remove(spawn.sigchld);
+        spawn.sigchld = NULL;
+    }
+    // Still-running children are left alone; they outlive the compositor as before.
+    free(spawn.running);
+    spawn.running = NULL;
+    spawn.running_len = 0;
+    spawn.running_cap = 0;
+    spawn.stats.running = 0;
+}
+
+static bool is_shell_char(char c) {
+    return strchr("|&;<>()$`\\\"'*?[]#~={}!\n", c) != NULL;
+}
+
+// Builtins and reserved words parse like plain commands but only mean
+// something to a shell (`exit 3`, `cd dir`, `if ...`), so they keep going
+// through /bin/sh.
+static bool is_shell_word(const char *word) {
+    static const char *const shell_words[] = {
+        ".", ":", "alias", "bg", "break", "case", "cd", "command", "continue", "do", "done", "elif",
+        "else", "esac", "eval", "exec", "exit", "export", "fc", "fg", "fi", "for", "function",
+        "getopts", "hash", "if", "in", "jobs", "local", "read", "readonly", "return", "select", "set",
+        "shift", "source", "then", "time", "times", "trap", "type", "ulimit", "umask", "unalias",
+        "unset", "until", "wait", "while",
+    };
+    for (size_t i = 0; i < sizeof(shell_words) / sizeof(shell_words[0]); i++) {
+        if (strcmp(word, shell_words[i]) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+char **fbwl_spawn_split_simple(const char *cmd) {
+    if (cmd == NULL) {
+        return NULL;
+    }
+    size_t words = 0;
+    bool in_word = false;
+    for (const char *p = cmd; *p != '\0'; p++) {
+        if (is_shell_char(*p)) {
+            return NULL;
+        }
+        const bool blank = *p == ' ' || *p == '\t';
+        if (!blank && !in_word) {
+            words++;
+        }
+        in_word = !blank;
+    }
+    if (words == 0) {
+        return NULL;
+    }
+
+    // argv pointers followed by a copy of the command, split in place.
+    const size_t len = strlen(cmd);
+    char **argv = malloc((words + 1) * sizeof(*argv) + len + 1);
+    if (argv == NULL) {
+        return NULL;
+    }
+    char *buf = (char *)(argv + words + 1);
+    memcpy(buf, cmd, len + 1);
+
+    size_t n = 0;
+    char *save = NULL;
+    for (char *tok = strtok_r(buf, " \t", &save); tok != NULL; tok = strtok_r(NULL, " \t", &save)) {
+        argv[n++] = tok;
+    }
+    argv[n] = NULL;
+    if (is_shell_word(argv[0])) {
+        free(argv);
+        return NULL;
+    }
+    return argv;
+}
+
+static bool track_child(pid_t pid, uint64_t seq) {
+    if (spawn.running_len == spawn.running_cap) {
+        const size_t cap = spawn.running_cap > 0 ? spawn.running_cap * 2 : 16;
+        struct spawn_child *grown = realloc(spawn.running, cap * sizeof(*grown));
+        if (grown == NULL) {
+            return false;
+        }
+        spawn.running = grown;
+        spawn.running_cap = cap;
+    }
+    spawn.running[spawn.running_len++] = (struct spawn_child){ .pid = pid, .seq = seq };
+    spawn.stats.running = spawn.running_len;
+    return true;
+}
+
+pid_t fbwl_spawn(const char *cmd) {
+    if (cmd == NULL || *cmd == '\0') {
+        return -1;
+    }
+
+    char **argv = fbwl_spawn_split_simple(cmd);
+    char *sh_argv[] = { "/bin/sh", "-c", (char *)cmd, NULL };
+
+    // The compositor blocks the signals its event loop handles; children
+    // start with an empty mask and default dispositions instead.
+    posix_spawnattr_t attr;
+    posix_spawnattr_init(&attr);
+    sigset_t set;
+    sigemptyset(&set);
+    posix_spawnattr_setsigmask(&attr, &set);
+    sigfillset(&set);
+    sigdelset(&set, SIGKILL);
+    sigdelset(&set, SIGSTOP);
+    posix_spawnattr_setsigdefault(&attr, &set);
+    posix_spawnattr_setflags(&attr, POSIX_SPAWN_SETSIGMASK | POSIX_SPAWN_SETSIGDEF);
+
+    const uint64_t start = now_ns();
+    pid_t pid = -1;
+    bool direct = argv != NULL;
+    int err = direct ?
+        posix_spawnp(&pid, argv[0], NULL, &attr, argv, environ) :
+        posix_spawn(&pid, "/bin/sh", NULL, &attr, sh_argv, environ);
+    if (direct && err == ENOENT) {
+        // Not on PATH: let the shell resolve it (functions, hashed paths) and
+        // report "not found" the way a shell launch always did.
+        direct = false;
+        err = posix_spawn(&pid, "/bin/sh", NULL, &attr, sh_argv, environ);
+    }
+    const uint64_t spawned = now_ns();
+    posix_spawnattr_destroy(&attr);
+    free(argv);
+
+    spawn.stats.launched++;
+    if (err != 0) {
+        spawn.stats.failed++;
+        wlr_log(WLR_ERROR, "Spawn: failed cmd=%s: %s", cmd, strerror(err));
+        return -1;
+    }
+    if (direct) {
+        spawn.stats.direct++;
+    }
+
+    const uint64_t seq = ++spawn.next_seq;
+    struct spawn_record *rec = &spawn.history[seq % SPAWN_HISTORY];
+    *rec = (struct spawn_record){
+        .seq = seq,
+        .pid = pid,
+        .direct = direct,
+        .running = true,
+        .start_ns = start,
+        .spawn_us = (uint32_t)((spawned - start) / 1000u),
+    };
+    snprintf(rec->cmd, sizeof(rec->cmd), "%s", cmd);
+    if (!track_child(pid, seq)) {
+        rec->running = false;
+    }
+
+    wlr_log(WLR_DEBUG, "Spawn: pid=%d direct=%d spawn_us=%u cmd=%s", (int)pid, direct ? 1 : 0,
+        rec->spawn_us, cmd);
+    return pid;
+}
+
+void fbwl_spawn_get_stats(struct fbwl_spawn_stats *out) {
+    if (out != NULL) {
+        *out = spawn.stats;
+    }
+}
+
+size_t fbwl_spawn_dump(void (*emit)(void *userdata, const char *line), void *userdata) {
+    if (emit == NULL) {
+        return 0;
+    }
+    const uint64_t now = now_ns();
+    const uint64_t first = spawn.next_seq > SPAWN_HISTORY ? spawn.next_seq - SPAWN_HISTORY + 1 : 1;
+    size_t count = 0;
+    for (uint64_t seq = first; seq <= spawn.next_seq; seq++) {
+        const struct spawn_record *rec = record_for_seq(seq);
+        if (rec == NULL) {
+            continue;
+        }
+        char state[48];
+        if (rec->running) {
+            snprintf(state, sizeof(state), "running");
+        } else if (rec->status >= 0 && WIFEXITED(rec->status)) {
+            snprintf(state, sizeof(state), "exited=%d", WEXITSTATUS(rec->status));
+        } else if (rec->status >= 0 && WIFSIGNALED(rec->status)) {
+            snprintf(state, sizeof(state), "signaled=%d", WTERMSIG(rec->status));
+        } else {
+            snprintf(state, sizeof(state), "untracked");
+        }
+        const uint64_t end = rec->running || rec->end_ns == 0 ? now : rec->end_ns;
+        char line[256];
+        snprintf(line, sizeof(line), "pid=%d direct=%d spawn_us=%u life_ms=%llu state=%s cmd=%s",
+            (int)rec->pid, rec->direct ? 1 : 0, rec->spawn_us,
+            (unsigned long long)((end - rec->start_ns) / 1000000u), state, rec->cmd);
+        emit(userdata, line);
+        count++;
+    }
+    return count;
+}
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <sys/types.h>
+
+struct wl_event_loop;
+
+struct fbwl_spawn_stats {
+    uint64_t launched;
+    uint64_t failed;
+    uint64_t direct;
+    size_t running;
+};
+
+// Reaps launched children from the event loop on SIGCHLD. Only pids started
+// by fbwl_spawn() are waited for; other child owners keep their own.
+bool fbwl_spawn_init(struct wl_event_loop *loop);
+void fbwl_spawn_finish(void);
+
+// Launches `cmd` with posix_spawn. Commands without shell syntax are exec'd
+// directly; anything else (including builtins, and programs not found on
+// PATH) goes through /bin/sh -c. Returns -1 on failure.
+pid_t fbwl_spawn(const char *cmd);
+
+// Splits `cmd` on blanks into a NULL-terminated argv (one allocation), or
+// returns NULL when it needs a shell (shell syntax, or a builtin/keyword).
+char **fbwl_spawn_split_simple(const char *cmd);
+
+void fbwl_spawn_get_stats(struct fbwl_spawn_stats *out);
+
+// Formats recent launches oldest first; returns the number emitted.
+size_t fbwl_spawn_dump(void (*emit)(void *userdata, const char *line), void *userdata);
@@ -153,6 +153,12 @@ static void tab_group_apply_visibility(struct fbwl_tab_group *group) {
     }
 }
 
+static void tabs_sync_workspace(struct fbwl_view *view, const struct fbwl_view *ref) {
+    struct fbwm_core *wm = view->server != NULL ? &view->server->wm : NULL;
+    fbwm_core_view_set_workspace(wm, &view->wm_view, ref->wm_view.workspace);
+    fbwm_core_view_set_sticky(wm, &view->wm_view, ref->wm_view.sticky);
+}
+
 static void tab_group_repair_workspace(struct fbwl_tab_group *group) {
     if (group == NULL) {
         return;
@@ -168,8 +174,7 @@ static void tab_group_repair_workspace(struct fbwl_tab_group *group) {
         if (v == NULL) {
             continue;
         }
-        v->wm_view.workspace = ref->wm_view.workspace;
-        v->wm_view.sticky = ref->wm_view.sticky;
+        tabs_sync_workspace(v, ref);
     }
 }
 
@@ -282,8 +287,7 @@ bool fbwl_tabs_attach(struct fbwl_view *view, struct fbwl_view *anchor, const ch
 
     tabs_add_to_group(group, view);
     sync_view_to_anchor_geometry(view, anchor);
-    view->wm_view.workspace = anchor->wm_view.workspace;
-    view->wm_view.sticky = anchor->wm_view.sticky;
+    tabs_sync_workspace(view, anchor);
     view->placed = true;
 
     wlr_log(WLR_INFO, "Tabs: attach reason=%s anchor=%s view=%s tabs=%zu",
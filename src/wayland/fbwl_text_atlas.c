@@ -0,0 +1,166 @@
+#include "wayland/fbwl_text_atlas.h"
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <drm_fourcc.h>
+
+#include <wlr/interfaces/wlr_buffer.h>
+
+#include "wayland/fbwl_ui_text.h"
+
+void fbwl_text_atlas_finish(struct fbwl_text_atlas *atlas) {
+    if (atlas == NULL) {
+        return;
+    }
+    for (size_t i = 0; i < FBWL_TEXT_ATLAS_LEN; i++) {
+        if (atlas->cells[i] != NULL) {
+            cairo_surface_destroy(atlas->cells[i]);
+            atlas->cells[i] = NULL;
+        }
+        atlas->advance[i] = 0;
+    }
+    atlas->valid = false;
+}
+
+static bool atlas_matches(const struct fbwl_text_atlas *atlas, int height, const float rgba[static 4],
+        const char *font, const struct fbwl_text_effect *effect) {
+    return atlas->valid && atlas->height == height && memcmp(atlas->rgba, rgba, sizeof(atlas->rgba)) == 0 &&
+        strcmp(atlas->font, font) == 0 &&
+        (effect != NULL ? memcmp(&atlas->effect, effect, sizeof(*effect)) == 0 :
+            atlas->effect.kind == FBWL_TEXT_EFFECT_NONE);
+}
+
+// Copies the pixels of a cairo-backed buffer into a surface of its own; all
+// cairo work on the buffer's memory is done before its access ends.
+static cairo_surface_t *atlas_cell_surface(struct wlr_buffer *buf) {
+    void *data = NULL;
+    uint32_t format = 0;
+    size_t stride = 0;
+    if (!wlr_buffer_begin_data_ptr_access(buf, WLR_BUFFER_DATA_PTR_ACCESS_READ, &data, &format, &stride)) {
+        return NULL;
+    }
+    if (format != DRM_FORMAT_ARGB8888) {
+        wlr_buffer_end_data_ptr_access(buf);
+        return NULL;
+    }
+    cairo_surface_t *src = cairo_image_surface_create_for_data(data, CAIRO_FORMAT_ARGB32,
+        buf->width, buf->height, (int)stride);
+    cairo_surface_t *surface = cairo_image_surface_create(CAIRO_FORMAT_ARGB32, buf->width, buf->height);
+    if (cairo_surface_status(src) == CAIRO_STATUS_SUCCESS && cairo_surface_status(surface) == CAIRO_STATUS_SUCCESS) {
+        cairo_t *cr = cairo_create(surface);
+        cairo_set_operator(cr, CAIRO_OPERATOR_SOURCE);
+        cairo_set_source_surface(cr, src, 0, 0);
+        cairo_paint(cr);
+        cairo_destroy(cr);
+        cairo_surface_flush(surface);
+    }
+    cairo_surface_destroy(src);
+    wlr_buffer_end_data_ptr_access(buf);
+    if (cairo_surface_status(surface) != CAIRO_STATUS_SUCCESS) {
+        cairo_surface_destroy(surface);
+        return NULL;
+    }
+    return surface;
+}
+
+bool fbwl_text_atlas_prepare(struct fbwl_text_atlas *atlas, int height, const float rgba[static 4],
+        const char *font, const struct fbwl_text_effect *effect) {
+    if (atlas == NULL || height < 1) {
+        return false;
+    }
+    const char *font_use = font != NULL ? font : "";
+    if (strlen(font_use) >= sizeof(atlas->font)) {
+        return false;
+    }
+    if (atlas_matches(atlas, height, rgba, font_use, effect)) {
+        return true;
+    }
+
+    fbwl_text_atlas_finish(atlas);
+    atlas->height = height;
+    memcpy(atlas->rgba, rgba, sizeof(atlas->rgba));
+    snprintf(atlas->font, sizeof(atlas->font), "%s", font_use);
+    if (effect != NULL) {
+        atlas->effect = *effect;
+    } else {
+        memset(&atlas->effect, 0, sizeof(atlas->effect));
+    }
+
+    // Room for the shadow or halo to spill past the glyph's advance.
+    int margin = 2;
+    if (atlas->effect.kind == FBWL_TEXT_EFFECT_SHADOW) {
+        const int sx = abs(atlas->effect.shadow_x);
+        const int sy = abs(atlas->effect.shadow_y);
+        margin += sx > sy ? sx : sy;
+    }
+    atlas->margin = margin;
+
+    for (size_t i = 0; i < FBWL_TEXT_ATLAS_LEN; i++) {
+        const char ch[2] = {FBWL_TEXT_ATLAS_CHARS[i], '\0'};
+        int w = 0;
+        if (!fbwl_text_measure(ch, height, font, &w, NULL) || w < 0) {
+            fbwl_text_atlas_finish(atlas);
+            return false;
+        }
+        atlas->advance[i] = w;
+        if (ch[0] == ' ' || w == 0) {
+            continue;
+        }
+        struct wlr_buffer *buf = fbwl_text_buffer_create(ch, w + 2 * margin, height, margin, rgba, font, effect, 0);
+        if (buf != NULL) {
+            atlas->cells[i] = atlas_cell_surface(buf);
+            wlr_buffer_drop(buf);
+        }
+        if (atlas->cells[i] == NULL) {
+            fbwl_text_atlas_finish(atlas);
+            return false;
+        }
+    }
+    atlas->valid = true;
+    return true;
+}
+
+bool fbwl_text_atlas_draw(const struct fbwl_text_atlas *atlas, cairo_surface_t *dst, const char *text, int pad_x) {
+    if (atlas == NULL || !atlas->valid || dst == NULL || text == NULL) {
+        return false;
+    }
+
+    const int x0 = pad_x > 0 ? pad_x : 0;
+    int width = x0;
+    for (const char *p = text; *p != '\0'; p++) {
+        const char *hit = strchr(FBWL_TEXT_ATLAS_CHARS, *p);
+        if (hit == NULL) {
+            return false;
+        }
+        width += atlas->advance[hit - FBWL_TEXT_ATLAS_CHARS];
+    }
+    if (width + x0 > cairo_image_surface_get_width(dst)) {
+        return false;
+    }
+
+    cairo_t *cr = cairo_create(dst);
+    if (cairo_status(cr) != CAIRO_STATUS_SUCCESS) {
+        cairo_destroy(cr);
+        return false;
+    }
+    cairo_set_operator(cr, CAIRO_OPERATOR_SOURCE);
+    cairo_set_source_rgba(cr, 0.0, 0.0, 0.0, 0.0);
+    cairo_paint(cr);
+    cairo_set_operator(cr, CAIRO_OPERATOR_OVER);
+
+    int x = x0;
+    for (const char *p = text; *p != '\0'; p++) {
+        const size_t i = (size_t)(strchr(FBWL_TEXT_ATLAS_CHARS, *p) - FBWL_TEXT_ATLAS_CHARS);
+        if (atlas->cells[i] != NULL) {
+            cairo_set_source_surface(cr, atlas->cells[i], x - atlas->margin, 0);
+            cairo_paint(cr);
+        }
+        x += atlas->advance[i];
+    }
+    cairo_destroy(cr);
+    cairo_surface_flush(dst);
+    return true;
+}
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <stdbool.h>
+
+#include <cairo/cairo.h>
+
+#include "wayland/fbwl_text_effect.h"
+
+// Characters of numeric readouts such as "640 x 480" or "-12 x 30".
+#define FBWL_TEXT_ATLAS_CHARS "0123456789 x-+,:"
+
+enum {
+    FBWL_TEXT_ATLAS_LEN = sizeof(FBWL_TEXT_ATLAS_CHARS) - 1,
+};
+
+// Glyph cells shaped once per (font, height, color, effect). Strings made
+// only of atlas characters are composed by blitting cells, without Pango.
+struct fbwl_text_atlas {
+    bool valid;
+    int height;
+    int margin;
+    float rgba[4];
+    struct fbwl_text_effect effect;
+    char font[256];
+    cairo_surface_t *cells[FBWL_TEXT_ATLAS_LEN];
+    int advance[FBWL_TEXT_ATLAS_LEN];
+};
+
+// Re-shapes the cells unless they already match; false when unusable.
+bool fbwl_text_atlas_prepare(struct fbwl_text_atlas *atlas, int height, const float rgba[static 4],
+    const char *font, const struct fbwl_text_effect *effect);
+
+// Clears `dst` and draws `text` left-aligned at pad_x, like
+// fbwl_text_buffer_create() with justify 0. Returns false (leaving `dst`
+// untouched) when the text has characters outside the atlas or overflows.
+bool fbwl_text_atlas_draw(const struct fbwl_text_atlas *atlas, cairo_surface_t *dst, const char *text, int pad_x);
+
+void fbwl_text_atlas_finish(struct fbwl_text_atlas *atlas);
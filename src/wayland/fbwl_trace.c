@@ -0,0 +1,482 @@
+#include "wayland/fbwl_trace.h"
+
+#include <ctype.h>
+#include <errno.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <time.h>
+
+enum {
+    TRACE_RING_EVENTS = 2048,
+    TRACE_MAX_ARGS = 12,
+    TRACE_STR_BYTES = 96,
+    TRACE_STR_NONE = 0xffff,
+    TRACE_CATEGORY_COUNT = 6,
+};
+
+enum trace_arg_kind {
+    TRACE_ARG_INT = 0,
+    TRACE_ARG_UINT,
+    TRACE_ARG_DOUBLE,
+    TRACE_ARG_PTR,
+    TRACE_ARG_STR,
+};
+
+union trace_arg {
+    long long i;
+    unsigned long long u;
+    double d;
+    const void *p;
+    uint16_t str_off;
+};
+
+// Fixed-size so recording never allocates; strings are copied (truncated)
+// because the titles etc. they point at do not outlive the call.
+struct trace_event {
+    uint64_t time_ns;
+    const char *fmt;
+    uint32_t cat;
+    uint8_t nargs;
+    uint8_t kinds[TRACE_MAX_ARGS];
+    union trace_arg args[TRACE_MAX_ARGS];
+    char strs[TRACE_STR_BYTES];
+};
+
+struct trace_spec {
+    const char *end;
+    size_t head_len; // '%', flags, width, precision
+    int stars;
+    char len_mod; // 0, 'H' (hh), 'h', 'l', 'q' (ll), 'z', 'j', 't', 'L'
+    char conv;
+};
+
+struct trace_text_state {
+    uint64_t window_ms;
+    uint32_t count;
+    uint32_t suppressed;
+};
+
+// By default nothing is recorded and every category keeps going to the text
+// log unthrottled, exactly as the INFO lines these call sites replaced.
+uint32_t fbwl_trace_ring_mask = 0;
+uint32_t fbwl_trace_text_mask = FBWL_TRACE_ALL;
+
+static struct trace_event trace_ring[TRACE_RING_EVENTS];
+static uint64_t trace_head;
+
+static int trace_text_rate = 0;
+static struct trace_text_state trace_text[TRACE_CATEGORY_COUNT];
+
+static const char *const trace_category_names[TRACE_CATEGORY_COUNT] = {
+    "workspace",
+    "surface",
+    "focus",
+    "stack",
+    "layers",
+    "toolbar",
+};
+
+static uint64_t trace_now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+static int trace_category_index(uint32_t cat) {
+    for (int i = 0; i < TRACE_CATEGORY_COUNT; i++) {
+        if ((cat & (1u << i)) != 0) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+const char *fbwl_trace_category_name(uint32_t cat) {
+    const int idx = trace_category_index(cat);
+    return idx >= 0 ? trace_category_names[idx] : "unknown";
+}
+
+// `p` points at a '%' that does not start "%%".
+static bool trace_parse_spec(const char *p, struct trace_spec *spec) {
+    const char *start = p;
+    *spec = (struct trace_spec){0};
+    p++;
+    while (*p != '\0' && strchr("-+ #0'", *p) != NULL) {
+        p++;
+    }
+    if (*p == '*') {
+        spec->stars++;
+        p++;
+    } else {
+        while (isdigit((unsigned char)*p)) {
+            p++;
+        }
+    }
+    if (*p == '.') {
+        p++;
+        if (*p == '*') {
+            spec->stars++;
+            p++;
+        } else {
+            while (isdigit((unsigned char)*p)) {
+                p++;
+            }
+        }
+    }
+    spec->head_len = (size_t)(p - start);
+
+    if (p[0] == 'h' && p[1] == 'h') {
+        spec->len_mod = 'H';
+        p += 2;
+    } else if (p[0] == 'l' && p[1] == 'l') {
+        spec->len_mod = 'q';
+        p += 2;
+    } else if (*p != '\0' && strchr("hlzjtL", *p) != NULL) {
+        spec->len_mod = *p;
+        p++;
+    }
+    if (*p == '\0' || strchr("diouxXcfFeEgGaAsp", *p) == NULL) {
+        return false;
+    }
+    spec->conv = *p;
+    spec->end = p + 1;
+    return true;
+}
+
+static bool trace_push(struct trace_event *ev, enum trace_arg_kind kind, union trace_arg arg) {
+    if (ev->nargs >= TRACE_MAX_ARGS) {
+        return false;
+    }
+    ev->kinds[ev->nargs] = (uint8_t)kind;
+    ev->args[ev->nargs] = arg;
+    ev->nargs++;
+    return true;
+}
+
+void fbwl_trace_record(uint32_t cat, const char *fmt, ...) {
+    struct trace_event *ev = &trace_ring[trace_head % TRACE_RING_EVENTS];
+    trace_head++;
+    ev->time_ns = trace_now_ns();
+    ev->fmt = fmt;
+    ev->cat = cat;
+    ev->nargs = 0;
+    size_t str_used = 0;
+
+    va_list ap;
+    va_start(ap, fmt);
+    for (const char *p = fmt; p != NULL && *p != '\0'; p++) {
+        if (*p != '%') {
+            continue;
+        }
+        if (p[1] == '%') {
+            p++;
+            continue;
+        }
+        struct trace_spec spec;
+        if (!trace_parse_spec(p, &spec)) {
+            break;
+        }
+        bool ok = true;
+        for (int i = 0; i < spec.stars && ok; i++) {
+            ok = trace_push(ev, TRACE_ARG_INT, (union trace_arg){.i = va_arg(ap, int)});
+        }
+        if (!ok) {
+            break;
+        }
+
+        union trace_arg arg = {0};
+        enum trace_arg_kind kind = TRACE_ARG_INT;
+        switch (spec.conv) {
+        case 'd':
+        case 'i':
+            switch (spec.len_mod) {
+            case 'l':
+                arg.i = va_arg(ap, long);
+                break;
+            case 'q':
+                arg.i = va_arg(ap, long long);
+                break;
+            case 'z':
+                arg.i = (long long)va_arg(ap, size_t);
+                break;
+            case 'j':
+                arg.i = (long long)va_arg(ap, intmax_t);
+                break;
+            case 't':
+                arg.i = (long long)va_arg(ap, ptrdiff_t);
+                break;
+            default:
+                arg.i = va_arg(ap, int);
+                break;
+            }
+            break;
+        case 'o':
+        case 'u':
+        case 'x':
+        case 'X':
+            kind = TRACE_ARG_UINT;
+            switch (spec.len_mod) {
+            case 'l':
+                arg.u = va_arg(ap, unsigned long);
+                break;
+            case 'q':
+                arg.u = va_arg(ap, unsigned long long);
+                break;
+            case 'z':
+                arg.u = va_arg(ap, size_t);
+                break;
+            case 'j':
+                arg.u = (unsigned long long)va_arg(ap, uintmax_t);
+                break;
+            case 't':
+                arg.u = (unsigned long long)va_arg(ap, ptrdiff_t);
+                break;
+            default:
+                arg.u = va_arg(ap, unsigned int);
+                break;
+            }
+            break;
+        case 'c':
+            arg.i = va_arg(ap, int);
+            break;
+        case 's': {
+            kind = TRACE_ARG_STR;
+            const char *s = va_arg(ap, const char *);
+            arg.str_off = TRACE_STR_NONE;
+            if (s != NULL && str_used + 1 < TRACE_STR_BYTES) {
+                const size_t room = TRACE_STR_BYTES - str_used - 1;
+                const size_t n = strnlen(s, room);
+                memcpy(ev->strs + str_used, s, n);
+                ev->strs[str_used + n] = '\0';
+                arg.str_off = (uint16_t)str_used;
+                str_used += n + 1;
+            } else if (s != NULL) {
+                arg.str_off = TRACE_STR_NONE - 1;
+            }
+            break;
+        }
+        case 'p':
+            kind = TRACE_ARG_PTR;
+            arg.p = va_arg(ap, void *);
+            break;
+        default:
+            kind = TRACE_ARG_DOUBLE;
+            arg.d = spec.len_mod == 'L' ? (double)va_arg(ap, long double) : va_arg(ap, double);
+            break;
+        }
+        if (!trace_push(ev, kind, arg)) {
+            break;
+        }
+        p = spec.end - 1;
+    }
+    va_end(ap);
+}
+
+bool fbwl_trace_text_allow(uint32_t cat) {
+    if (trace_text_rate <= 0) {
+        return true;
+    }
+    const int idx = trace_category_index(cat);
+    if (idx < 0) {
+        return true;
+    }
+    struct trace_text_state *st = &trace_text[idx];
+    const uint64_t now_ms = trace_now_ns() / 1000000ull;
+    if (now_ms - st->window_ms >= 1000) {
+        if (st->suppressed > 0) {
+            wlr_log(WLR_INFO, "Trace: suppressed %u %s lines", st->suppressed, trace_category_names[idx]);
+        }
+        st->window_ms = now_ms;
+        st->count = 0;
+        st->suppressed = 0;
+    }
+    if (st->count < (uint32_t)trace_text_rate) {
+        st->count++;
+        return true;
+    }
+    st->suppressed++;
+    return false;
+}
+
+void fbwl_trace_configure(uint32_t ring_mask, uint32_t text_mask, int text_rate) {
+    fbwl_trace_ring_mask = ring_mask & FBWL_TRACE_ALL;
+    fbwl_trace_text_mask = text_mask & FBWL_TRACE_ALL;
+    trace_text_rate = text_rate > 0 ? text_rate : 0;
+    memset(trace_text, 0, sizeof(trace_text));
+}
+
+bool fbwl_trace_parse_mask(const char *s, uint32_t *out) {
+    if (s == NULL || out == NULL) {
+        return false;
+    }
+    uint32_t mask = 0;
+    const char *p = s;
+    while (*p != '\0') {
+        while (*p == ',' || *p == '+' || isspace((unsigned char)*p)) {
+            p++;
+        }
+        const char *start = p;
+        while (*p != '\0' && *p != ',' && *p != '+' && !isspace((unsigned char)*p)) {
+            p++;
+        }
+        const size_t n = (size_t)(p - start);
+        if (n == 0) {
+            continue;
+        }
+        if (n == 3 && strncasecmp(start, "all", n) == 0) {
+            mask |= FBWL_TRACE_ALL;
+            continue;
+        }
+        if (n == 4 && strncasecmp(start, "none", n) == 0) {
+            continue;
+        }
+        bool found = false;
+        for (int i = 0; i < TRACE_CATEGORY_COUNT; i++) {
+            if (strlen(trace_category_names[i]) == n && strncasecmp(start, trace_category_names[i], n) == 0) {
+                mask |= 1u << i;
+                found = true;
+                break;
+            }
+        }
+        if (!found) {
+            return false;
+        }
+    }
+    *out = mask;
+    return true;
+}
+
+static void trace_append(char *out, size_t out_size, size_t *len, const char *s) {
+    while (*s != '\0' && *len + 1 < out_size) {
+        out[(*len)++] = *s++;
+    }
+    out[*len] = '\0';
+}
+
+static void trace_format_event(const struct trace_event *ev, char *out, size_t out_size) {
+    size_t len = 0;
+    out[0] = '\0';
+    char tmp[256];
+    snprintf(tmp, sizeof(tmp), "%llu.%06llu %s ",
+        (unsigned long long)(ev->time_ns / 1000000000ull),
+        (unsigned long long)((ev->time_ns / 1000ull) % 1000000ull),
+        fbwl_trace_category_name(ev->cat));
+    trace_append(out, out_size, &len, tmp);
+
+    size_t ai = 0;
+    const char *p = ev->fmt != NULL ? ev->fmt : "";
+    while (*p != '\0' && len + 1 < out_size) {
+        if (*p != '%') {
+            out[len++] = *p++;
+            out[len] = '\0';
+            continue;
+        }
+        if (p[1] == '%') {
+            out[len++] = '%';
+            out[len] = '\0';
+            p += 2;
+            continue;
+        }
+        struct trace_spec spec;
+        if (!trace_parse_spec(p, &spec) || ai + (size_t)spec.stars + 1 > ev->nargs || spec.head_len > 24) {
+            trace_append(out, out_size, &len, "...");
+            break;
+        }
+
+        // Re-issue the conversion with a length modifier matching how the
+        // argument was stored.
+        char nspec[32];
+        memcpy(nspec, p, spec.head_len);
+        size_t nlen = spec.head_len;
+        const enum trace_arg_kind kind = ev->kinds[ai + (size_t)spec.stars];
+        if ((kind == TRACE_ARG_INT || kind == TRACE_ARG_UINT) && spec.conv != 'c') {
+            nspec[nlen++] = 'l';
+            nspec[nlen++] = 'l';
+        }
+        nspec[nlen++] = spec.conv;
+        nspec[nlen] = '\0';
+
+        int star[2] = {0, 0};
+        for (int i = 0; i < spec.stars; i++) {
+            star[i] = (int)ev->args[ai++].i;
+        }
+        const union trace_arg *a = &ev->args[ai++];
+
+#define TRACE_FORMAT_ARG(val) \
+    (spec.stars == 0 ? snprintf(tmp, sizeof(tmp), nspec, val) : \
+     spec.stars == 1 ? snprintf(tmp, sizeof(tmp), nspec, star[0], val) : \
+                       snprintf(tmp, sizeof(tmp), nspec, star[0], star[1], val))
+        switch (kind) {
+        case TRACE_ARG_INT:
+            if (spec.conv == 'c') {
+                (void)TRACE_FORMAT_ARG((int)a->i);
+            } else {
+                (void)TRACE_FORMAT_ARG(a->i);
+            }
+            break;
+        case TRACE_ARG_UINT:
+            (void)TRACE_FORMAT_ARG(a->u);
+            break;
+        case TRACE_ARG_DOUBLE:
+            (void)TRACE_FORMAT_ARG(a->d);
+            break;
+        case TRACE_ARG_PTR:
+            (void)TRACE_FORMAT_ARG(a->p);
+            break;
+        case TRACE_ARG_STR: {
+            const char *s = a->str_off == TRACE_STR_NONE ? "(null)" :
+                a->str_off == TRACE_STR_NONE - 1 ? "..." : ev->strs + a->str_off;
+            (void)TRACE_FORMAT_ARG(s);
+            break;
+        }
+        }
+#undef TRACE_FORMAT_ARG
+
+        trace_append(out, out_size, &len, tmp);
+        p = spec.end;
+    }
+}
+
+size_t fbwl_trace_dump(void (*emit)(void *userdata, const char *line), void *userdata) {
+    if (emit == NULL) {
+        return 0;
+    }
+    const uint64_t count = trace_head < TRACE_RING_EVENTS ? trace_head : TRACE_RING_EVENTS;
+    char line[512];
+    for (uint64_t i = trace_head - count; i < trace_head; i++) {
+        trace_format_event(&trace_ring[i % TRACE_RING_EVENTS], line, sizeof(line));
+        emit(userdata, line);
+    }
+    return (size_t)count;
+}
+
+static void trace_emit_file(void *userdata, const char *line) {
+    FILE *f = userdata;
+    fputs(line, f);
+    fputc('\n', f);
+}
+
+bool fbwl_trace_dump_file(const char *path, size_t *out_count) {
+    if (path == NULL || *path == '\0') {
+        return false;
+    }
+    FILE *f = fopen(path, "w");
+    if (f == NULL) {
+        wlr_log(WLR_ERROR, "Trace: failed to open %s: %s", path, strerror(errno));
+        return false;
+    }
+    const size_t count = fbwl_trace_dump(trace_emit_file, f);
+    const bool ok = ferror(f) == 0;
+    if (fclose(f) != 0 || !ok) {
+        wlr_log(WLR_ERROR, "Trace: failed to write %s", path);
+        return false;
+    }
+    if (out_count != NULL) {
+        *out_count = count;
+    }
+    wlr_log(WLR_INFO, "Trace: dumped %zu events to %s", count, path);
+    return true;
+}
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include <wlr/util/log.h>
+
+enum fbwl_trace_category {
+    FBWL_TRACE_WORKSPACE = 1u << 0,
+    FBWL_TRACE_SURFACE = 1u << 1,
+    FBWL_TRACE_FOCUS = 1u << 2,
+    FBWL_TRACE_STACK = 1u << 3,
+    FBWL_TRACE_LAYERS = 1u << 4,
+    FBWL_TRACE_TOOLBAR = 1u << 5,
+    FBWL_TRACE_ALL = (1u << 6) - 1,
+};
+
+// Categories whose call sites are compiled in at all; build with
+// -DFBWL_TRACE_COMPILED=0 to drop every fbwl_trace() from the binary.
+#ifndef FBWL_TRACE_COMPILED
+#define FBWL_TRACE_COMPILED FBWL_TRACE_ALL
+#endif
+
+extern uint32_t fbwl_trace_ring_mask;
+extern uint32_t fbwl_trace_text_mask;
+
+#define fbwl_trace_enabled(cat) \
+    ((FBWL_TRACE_COMPILED & (cat)) != 0 && ((fbwl_trace_ring_mask | fbwl_trace_text_mask) & (cat)) != 0)
+
+// Hot-path event. The ring keeps the format pointer and raw arguments and
+// only formats them when dumped; categories in the text mask additionally go
+// through wlr_log (optionally rate-limited), so existing log scrapers keep
+// working.
+// Arguments may be evaluated twice, keep them free of side effects.
+#define fbwl_trace(cat, fmt, ...) \
+    do { \
+        if ((FBWL_TRACE_COMPILED & (cat)) != 0) { \
+            if ((fbwl_trace_ring_mask & (cat)) != 0) { \
+                fbwl_trace_record((cat), fmt, ##__VA_ARGS__); \
+            } \
+            if ((fbwl_trace_text_mask & (cat)) != 0 && fbwl_trace_text_allow(cat)) { \
+                wlr_log(WLR_INFO, fmt, ##__VA_ARGS__); \
+            } \
+        } \
+    } while (0)
+
+void fbwl_trace_record(uint32_t cat, const char *fmt, ...) __attribute__((format(printf, 2, 3)));
+bool fbwl_trace_text_allow(uint32_t cat);
+
+// `text_rate` is the per-category text line budget per second (0 = unlimited).
+void fbwl_trace_configure(uint32_t ring_mask, uint32_t text_mask, int text_rate);
+bool fbwl_trace_parse_mask(const char *s, uint32_t *out);
+const char *fbwl_trace_category_name(uint32_t cat);
+
+// Formats the recorded events oldest first; returns the number emitted.
+size_t fbwl_trace_dump(void (*emit)(void *userdata, const char *line), void *userdata);
+bool fbwl_trace_dump_file(const char *path, size_t *out_count);
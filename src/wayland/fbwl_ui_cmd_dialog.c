@@ -1,5 +1,6 @@
 #include "wayland/fbwl_ui_cmd_dialog.h"
 
+#include "wayland/fbwl_spawn.h"
 #include "wayland/fbwl_ui_decor_theme.h"
 #include "wayland/fbwl_ui_text.h"
 #include "wayland/fbwl_util.h"
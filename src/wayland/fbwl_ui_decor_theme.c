@@ -0,0 +1,83 @@
+#include "wayland/fbwl_ui_decor_theme.h"
+
+#include <string.h>
+
+static bool color_equal(const float a[static 4], const float b[static 4]) {
+    return a[0] == b[0] && a[1] == b[1] && a[2] == b[2] && a[3] == b[3];
+}
+
+static bool text_effect_equal(const struct fbwl_text_effect *a, const struct fbwl_text_effect *b) {
+    return a->kind == b->kind &&
+        color_equal(a->shadow_color, b->shadow_color) &&
+        a->shadow_x == b->shadow_x &&
+        a->shadow_y == b->shadow_y &&
+        color_equal(a->halo_color, b->halo_color) &&
+        a->prio_kind == b->prio_kind &&
+        a->prio_shadow_color == b->prio_shadow_color &&
+        a->prio_shadow_x == b->prio_shadow_x &&
+        a->prio_shadow_y == b->prio_shadow_y &&
+        a->prio_halo_color == b->prio_halo_color;
+}
+
+static bool pixmap_triplet_equal(const struct fbwl_pixmap_triplet *a, const struct fbwl_pixmap_triplet *b) {
+    return strcmp(a->focus, b->focus) == 0 &&
+        strcmp(a->unfocus, b->unfocus) == 0 &&
+        strcmp(a->pressed, b->pressed) == 0;
+}
+
+static bool texture_equal(const struct fbwl_texture *a, const struct fbwl_texture *b) {
+    return a->type == b->type &&
+        color_equal(a->color, b->color) &&
+        color_equal(a->color_to, b->color_to) &&
+        color_equal(a->pic_color, b->pic_color) &&
+        strcmp(a->pixmap, b->pixmap) == 0;
+}
+
+static bool str_equal(const char *a, const char *b) {
+    return strcmp(a, b) == 0;
+}
+
+// Field-wise, so stale bytes past a string's terminator or struct padding
+// never make two identical parses look different.
+#define THEME_EQ_VAL(f) (a->f == b->f)
+#define THEME_EQ_STR(f) str_equal(a->f, b->f)
+#define THEME_EQ_PATH(f) str_equal(a->f, b->f)
+#define THEME_EQ_COLOR(f) color_equal(a->f, b->f)
+#define THEME_EQ_EFFECT(f) text_effect_equal(&a->f, &b->f)
+#define THEME_EQ_PIXMAPS(f) pixmap_triplet_equal(&a->f, &b->f)
+#define THEME_EQ_TEXTURE(f) texture_equal(&a->f, &b->f)
+#define THEME_SAME(kind, type, name, dims) if (!THEME_EQ_##kind(name)) return false;
+
+bool fbwl_decor_theme_equal(const struct fbwl_decor_theme *a, const struct fbwl_decor_theme *b) {
+    if (a == NULL || b == NULL) {
+        return a == b;
+    }
+    FBWL_DECOR_THEME_FIELDS(THEME_SAME)
+    return true;
+}
+
+static void theme_file(const char *path, void (*fn)(void *userdata, const char *path), void *userdata) {
+    if (path[0] != '\0') {
+        fn(userdata, path);
+    }
+}
+
+#define THEME_FILES_VAL(f)
+#define THEME_FILES_STR(f)
+#define THEME_FILES_COLOR(f)
+#define THEME_FILES_EFFECT(f)
+#define THEME_FILES_PATH(f) theme_file(theme->f, fn, userdata);
+#define THEME_FILES_PIXMAPS(f) \
+    theme_file(theme->f.focus, fn, userdata); \
+    theme_file(theme->f.unfocus, fn, userdata); \
+    theme_file(theme->f.pressed, fn, userdata);
+#define THEME_FILES_TEXTURE(f) theme_file(theme->f.pixmap, fn, userdata);
+#define THEME_FILES(kind, type, name, dims) THEME_FILES_##kind(name)
+
+void fbwl_decor_theme_for_each_file(const struct fbwl_decor_theme *theme,
+        void (*fn)(void *userdata, const char *path), void *userdata) {
+    if (theme == NULL || fn == NULL) {
+        return;
+    }
+    FBWL_DECOR_THEME_FIELDS(THEME_FILES)
+}
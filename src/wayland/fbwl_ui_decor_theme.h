@@ -9,188 +9,198 @@ struct fbwl_pixmap_triplet {
     char pressed[256];
 };
 
-struct fbwl_decor_theme {
-    int border_width;
-    int bevel_width;
-    int window_bevel_width;
-    int handle_width;
-    int title_height;
-    int button_margin;
-    int button_spacing;
-    int window_justify; // 0=left, 1=center, 2=right
-    uint32_t window_round_corners; // bitmask: TopLeft/TopRight/BottomLeft/BottomRight
-    bool background_loaded;
-    char background_options[128];
-    char background_pixmap[256];
-    int background_mod_x;
-    int background_mod_y;
-    int menu_item_height;
-    int menu_title_height;
-    int menu_border_width;
-    int menu_bevel_width;
-    int menu_frame_justify; // 0=left, 1=center, 2=right
-    int menu_hilite_justify; // 0=left, 1=center, 2=right
-    int menu_title_justify; // 0=left, 1=center, 2=right
-    int menu_bullet; // 0=empty, 1=square, 2=triangle, 3=diamond
-    int menu_bullet_pos; // 0=left, 2=right
-    uint32_t menu_round_corners; // bitmask: TopLeft/TopRight/BottomLeft/BottomRight
-    int toolbar_height;
-    int toolbar_border_width;
-    int toolbar_bevel_width;
-    bool toolbar_shaped;
-    int toolbar_button_scale; // scale factor: arrow size = button_size * (100 / scale)
-    int toolbar_clock_justify; // 0=left, 1=center, 2=right
-    int toolbar_workspace_justify; // 0=left, 1=center, 2=right
-    int toolbar_iconbar_focused_justify; // 0=left, 1=center, 2=right
-    int toolbar_iconbar_unfocused_justify; // 0=left, 1=center, 2=right
-    int toolbar_clock_border_width;
-    int toolbar_workspace_border_width;
-    int toolbar_iconbar_border_width;
-    int toolbar_iconbar_focused_border_width;
-    int toolbar_iconbar_unfocused_border_width;
-    int slit_border_width;
-    int slit_bevel_width;
-    char window_font[128];
-    char menu_font[128];
-    char menu_title_font[128]; // optional; falls back to menu_font
-    char menu_hilite_font[128]; // optional; falls back to menu_font
-    char toolbar_font[128];
-
-    // Fluxbox/X11 font effects (shadow/halo). These match the style resources
-    // `*.font.effect`, `*.font.shadow.*`, and `*.font.halo.*`.
-    struct fbwl_text_effect window_label_focus_effect;
-    struct fbwl_text_effect window_label_unfocus_effect;
-    struct fbwl_text_effect menu_frame_effect;
-    struct fbwl_text_effect menu_title_effect;
-    struct fbwl_text_effect menu_hilite_effect;
-    struct fbwl_text_effect toolbar_workspace_effect;
-    struct fbwl_text_effect toolbar_iconbar_focused_effect;
-    struct fbwl_text_effect toolbar_iconbar_unfocused_effect;
-    struct fbwl_text_effect toolbar_clock_effect;
-    struct fbwl_text_effect toolbar_label_effect;
-    struct fbwl_text_effect toolbar_windowlabel_effect;
-
-    float titlebar_active[4];
-    float titlebar_inactive[4];
-    float border_color_focus[4];
-    float border_color_unfocus[4];
-    float title_text_active[4];
-    float title_text_inactive[4];
-    float menu_bg[4];
-    float menu_hilite[4];
-    float menu_text[4];
-    float menu_title_text[4];
-    float menu_hilite_text[4];
-    float menu_disable_text[4];
-    float menu_underline_color[4];
-    float menu_border_color[4];
-    float toolbar_bg[4];
-    float toolbar_hilite[4];
-    float toolbar_text[4];
-    float toolbar_iconbar_focused[4];
-    float toolbar_border_color[4];
-    float toolbar_clock_border_color[4];
-    float toolbar_workspace_border_color[4];
-    float toolbar_iconbar_border_color[4];
-    float toolbar_iconbar_focused_border_color[4];
-    float toolbar_iconbar_unfocused_border_color[4];
-    float slit_border_color[4];
-    float btn_menu_color[4];
-    float btn_shade_color[4];
-    float btn_stick_color[4];
-    float btn_close_color[4];
-    float btn_max_color[4];
-    float btn_min_color[4];
-    float btn_lhalf_color[4];
-    float btn_rhalf_color[4];
-
-    int window_tab_border_width;
-    float window_tab_border_color[4];
-    int window_tab_justify; // 0=left, 1=center, 2=right
-    char window_tab_font[128];
-    float window_tab_label_focus_text[4];
-    float window_tab_label_unfocus_text[4];
+// Every theme field, once: X(kind, type, name, dims). The struct, the
+// equality check and the pixmap walk are generated from this list, so a new
+// field is compared and watched as soon as it is declared. Kinds: VAL (==),
+// STR (string), PATH (string naming a pixmap file), COLOR (rgba),
+// EFFECT (font effect), PIXMAPS (button pixmap triplet), TEXTURE.
+#define FBWL_DECOR_THEME_FIELDS(X) \
+    X(VAL, int, border_width, ) \
+    X(VAL, int, bevel_width, ) \
+    X(VAL, int, window_bevel_width, ) \
+    X(VAL, int, handle_width, ) \
+    X(VAL, int, title_height, ) \
+    X(VAL, int, button_margin, ) \
+    X(VAL, int, button_spacing, ) \
+    X(VAL, int, window_justify, ) /* 0=left, 1=center, 2=right */ \
+    X(VAL, uint32_t, window_round_corners, ) /* bitmask: TopLeft/TopRight/BottomLeft/BottomRight */ \
+    X(VAL, bool, background_loaded, ) \
+    X(STR, char, background_options, [128]) \
+    X(PATH, char, background_pixmap, [256]) \
+    X(VAL, int, background_mod_x, ) \
+    X(VAL, int, background_mod_y, ) \
+    X(VAL, int, menu_item_height, ) \
+    X(VAL, int, menu_title_height, ) \
+    X(VAL, int, menu_border_width, ) \
+    X(VAL, int, menu_bevel_width, ) \
+    X(VAL, int, menu_frame_justify, ) /* 0=left, 1=center, 2=right */ \
+    X(VAL, int, menu_hilite_justify, ) /* 0=left, 1=center, 2=right */ \
+    X(VAL, int, menu_title_justify, ) /* 0=left, 1=center, 2=right */ \
+    X(VAL, int, menu_bullet, ) /* 0=empty, 1=square, 2=triangle, 3=diamond */ \
+    X(VAL, int, menu_bullet_pos, ) /* 0=left, 2=right */ \
+    X(VAL, uint32_t, menu_round_corners, ) /* bitmask: TopLeft/TopRight/BottomLeft/BottomRight */ \
+    X(VAL, int, toolbar_height, ) \
+    X(VAL, int, toolbar_border_width, ) \
+    X(VAL, int, toolbar_bevel_width, ) \
+    X(VAL, bool, toolbar_shaped, ) \
+    X(VAL, int, toolbar_button_scale, ) /* scale factor: arrow size = button_size * (100 / scale) */ \
+    X(VAL, int, toolbar_clock_justify, ) /* 0=left, 1=center, 2=right */ \
+    X(VAL, int, toolbar_workspace_justify, ) /* 0=left, 1=center, 2=right */ \
+    X(VAL, int, toolbar_iconbar_focused_justify, ) /* 0=left, 1=center, 2=right */ \
+    X(VAL, int, toolbar_iconbar_unfocused_justify, ) /* 0=left, 1=center, 2=right */ \
+    X(VAL, int, toolbar_clock_border_width, ) \
+    X(VAL, int, toolbar_workspace_border_width, ) \
+    X(VAL, int, toolbar_iconbar_border_width, ) \
+    X(VAL, int, toolbar_iconbar_focused_border_width, ) \
+    X(VAL, int, toolbar_iconbar_unfocused_border_width, ) \
+    X(VAL, int, slit_border_width, ) \
+    X(VAL, int, slit_bevel_width, ) \
+    X(STR, char, window_font, [128]) \
+    X(STR, char, menu_font, [128]) \
+    X(STR, char, menu_title_font, [128]) /* optional; falls back to menu_font */ \
+    X(STR, char, menu_hilite_font, [128]) /* optional; falls back to menu_font */ \
+    X(STR, char, toolbar_font, [128]) \
+    /* Fluxbox/X11 font effects (shadow/halo). These match the style resources */ \
+    /* `*.font.effect`, `*.font.shadow.*`, and `*.font.halo.*`. */ \
+    X(EFFECT, struct fbwl_text_effect, window_label_focus_effect, ) \
+    X(EFFECT, struct fbwl_text_effect, window_label_unfocus_effect, ) \
+    X(EFFECT, struct fbwl_text_effect, menu_frame_effect, ) \
+    X(EFFECT, struct fbwl_text_effect, menu_title_effect, ) \
+    X(EFFECT, struct fbwl_text_effect, menu_hilite_effect, ) \
+    X(EFFECT, struct fbwl_text_effect, toolbar_workspace_effect, ) \
+    X(EFFECT, struct fbwl_text_effect, toolbar_iconbar_focused_effect, ) \
+    X(EFFECT, struct fbwl_text_effect, toolbar_iconbar_unfocused_effect, ) \
+    X(EFFECT, struct fbwl_text_effect, toolbar_clock_effect, ) \
+    X(EFFECT, struct fbwl_text_effect, toolbar_label_effect, ) \
+    X(EFFECT, struct fbwl_text_effect, toolbar_windowlabel_effect, ) \
+    X(COLOR, float, titlebar_active, [4]) \
+    X(COLOR, float, titlebar_inactive, [4]) \
+    X(COLOR, float, border_color_focus, [4]) \
+    X(COLOR, float, border_color_unfocus, [4]) \
+    X(COLOR, float, title_text_active, [4]) \
+    X(COLOR, float, title_text_inactive, [4]) \
+    X(COLOR, float, menu_bg, [4]) \
+    X(COLOR, float, menu_hilite, [4]) \
+    X(COLOR, float, menu_text, [4]) \
+    X(COLOR, float, menu_title_text, [4]) \
+    X(COLOR, float, menu_hilite_text, [4]) \
+    X(COLOR, float, menu_disable_text, [4]) \
+    X(COLOR, float, menu_underline_color, [4]) \
+    X(COLOR, float, menu_border_color, [4]) \
+    X(COLOR, float, toolbar_bg, [4]) \
+    X(COLOR, float, toolbar_hilite, [4]) \
+    X(COLOR, float, toolbar_text, [4]) \
+    X(COLOR, float, toolbar_iconbar_focused, [4]) \
+    X(COLOR, float, toolbar_border_color, [4]) \
+    X(COLOR, float, toolbar_clock_border_color, [4]) \
+    X(COLOR, float, toolbar_workspace_border_color, [4]) \
+    X(COLOR, float, toolbar_iconbar_border_color, [4]) \
+    X(COLOR, float, toolbar_iconbar_focused_border_color, [4]) \
+    X(COLOR, float, toolbar_iconbar_unfocused_border_color, [4]) \
+    X(COLOR, float, slit_border_color, [4]) \
+    X(COLOR, float, btn_menu_color, [4]) \
+    X(COLOR, float, btn_shade_color, [4]) \
+    X(COLOR, float, btn_stick_color, [4]) \
+    X(COLOR, float, btn_close_color, [4]) \
+    X(COLOR, float, btn_max_color, [4]) \
+    X(COLOR, float, btn_min_color, [4]) \
+    X(COLOR, float, btn_lhalf_color, [4]) \
+    X(COLOR, float, btn_rhalf_color, [4]) \
+    X(VAL, int, window_tab_border_width, ) \
+    X(COLOR, float, window_tab_border_color, [4]) \
+    X(VAL, int, window_tab_justify, ) /* 0=left, 1=center, 2=right */ \
+    X(STR, char, window_tab_font, [128]) \
+    X(COLOR, float, window_tab_label_focus_text, [4]) \
+    X(COLOR, float, window_tab_label_unfocus_text, [4]) \
+    X(PIXMAPS, struct fbwl_pixmap_triplet, window_menuicon_pm, ) \
+    X(PIXMAPS, struct fbwl_pixmap_triplet, window_shade_pm, ) \
+    X(PIXMAPS, struct fbwl_pixmap_triplet, window_unshade_pm, ) \
+    X(PIXMAPS, struct fbwl_pixmap_triplet, window_stick_pm, ) \
+    X(PIXMAPS, struct fbwl_pixmap_triplet, window_stuck_pm, ) \
+    X(PIXMAPS, struct fbwl_pixmap_triplet, window_close_pm, ) \
+    X(PIXMAPS, struct fbwl_pixmap_triplet, window_maximize_pm, ) \
+    X(PIXMAPS, struct fbwl_pixmap_triplet, window_iconify_pm, ) \
+    X(PIXMAPS, struct fbwl_pixmap_triplet, window_lhalf_pm, ) \
+    X(PIXMAPS, struct fbwl_pixmap_triplet, window_rhalf_pm, ) \
+    /* Fluxbox/X11 style textures (used by the Wayland UI renderer). */ \
+    X(TEXTURE, struct fbwl_texture, window_title_focus_tex, ) \
+    X(TEXTURE, struct fbwl_texture, window_title_unfocus_tex, ) \
+    X(TEXTURE, struct fbwl_texture, window_label_focus_tex, ) \
+    X(TEXTURE, struct fbwl_texture, window_label_unfocus_tex, ) \
+    X(TEXTURE, struct fbwl_texture, window_button_focus_tex, ) \
+    X(TEXTURE, struct fbwl_texture, window_button_unfocus_tex, ) \
+    X(TEXTURE, struct fbwl_texture, window_button_pressed_tex, ) \
+    X(TEXTURE, struct fbwl_texture, window_handle_focus_tex, ) \
+    X(TEXTURE, struct fbwl_texture, window_handle_unfocus_tex, ) \
+    X(TEXTURE, struct fbwl_texture, window_grip_focus_tex, ) \
+    X(TEXTURE, struct fbwl_texture, window_grip_unfocus_tex, ) \
+    X(TEXTURE, struct fbwl_texture, window_tab_label_focus_tex, ) \
+    X(TEXTURE, struct fbwl_texture, window_tab_label_unfocus_tex, ) \
+    X(TEXTURE, struct fbwl_texture, menu_title_tex, ) \
+    X(TEXTURE, struct fbwl_texture, menu_frame_tex, ) \
+    X(TEXTURE, struct fbwl_texture, menu_hilite_tex, ) \
+    X(TEXTURE, struct fbwl_texture, toolbar_tex, ) \
+    X(TEXTURE, struct fbwl_texture, slit_tex, ) /* when unset, Fluxbox uses toolbar look */ \
+    X(TEXTURE, struct fbwl_texture, toolbar_clock_tex, ) \
+    X(TEXTURE, struct fbwl_texture, toolbar_workspace_tex, ) \
+    X(TEXTURE, struct fbwl_texture, toolbar_label_tex, ) /* legacy alias for toolbar.workspace */ \
+    X(TEXTURE, struct fbwl_texture, toolbar_windowlabel_tex, ) /* legacy alias used as iconbar fallback */ \
+    X(TEXTURE, struct fbwl_texture, toolbar_button_tex, ) \
+    X(TEXTURE, struct fbwl_texture, toolbar_button_pressed_tex, ) \
+    X(TEXTURE, struct fbwl_texture, toolbar_systray_tex, ) \
+    X(TEXTURE, struct fbwl_texture, toolbar_iconbar_tex, ) \
+    X(TEXTURE, struct fbwl_texture, toolbar_iconbar_empty_tex, ) \
+    X(TEXTURE, struct fbwl_texture, toolbar_iconbar_focused_tex, ) \
+    X(TEXTURE, struct fbwl_texture, toolbar_iconbar_unfocused_tex, ) \
+    X(TEXTURE, struct fbwl_texture, background_tex, ) \
+    /* Menu pixmaps (best-effort). */ \
+    X(PATH, char, menu_submenu_pixmap, [256]) \
+    X(PATH, char, menu_selected_pixmap, [256]) \
+    X(PATH, char, menu_unselected_pixmap, [256]) \
+    X(PATH, char, menu_hilite_submenu_pixmap, [256]) \
+    X(PATH, char, menu_hilite_selected_pixmap, [256]) \
+    X(PATH, char, menu_hilite_unselected_pixmap, [256]) \
+    /* Style parser bookkeeping. These flags are used to preserve Fluxbox/X11 */ \
+    /* fallback semantics across multiple style loads (e.g. style + overlay). */ \
+    X(VAL, bool, toolbar_border_width_explicit, ) \
+    X(VAL, bool, toolbar_border_color_explicit, ) \
+    X(VAL, bool, toolbar_bevel_width_explicit, ) \
+    X(VAL, bool, toolbar_clock_border_width_explicit, ) \
+    X(VAL, bool, toolbar_clock_border_color_explicit, ) \
+    X(VAL, bool, toolbar_workspace_border_width_explicit, ) \
+    X(VAL, bool, toolbar_workspace_border_color_explicit, ) \
+    X(VAL, bool, toolbar_iconbar_border_width_explicit, ) \
+    X(VAL, bool, toolbar_iconbar_border_color_explicit, ) \
+    X(VAL, bool, toolbar_iconbar_focused_border_width_explicit, ) \
+    X(VAL, bool, toolbar_iconbar_focused_border_color_explicit, ) \
+    X(VAL, bool, toolbar_iconbar_unfocused_border_width_explicit, ) \
+    X(VAL, bool, toolbar_iconbar_unfocused_border_color_explicit, ) \
+    X(VAL, bool, slit_border_width_explicit, ) \
+    X(VAL, bool, slit_border_color_explicit, ) \
+    X(VAL, bool, slit_bevel_width_explicit, ) \
+    X(VAL, bool, slit_texture_explicit, ) \
+    X(VAL, bool, toolbar_clock_texture_explicit, ) \
+    X(VAL, bool, toolbar_workspace_texture_explicit, ) \
+    X(VAL, bool, toolbar_label_texture_explicit, ) \
+    X(VAL, bool, toolbar_windowlabel_texture_explicit, ) \
+    X(VAL, bool, toolbar_button_texture_explicit, ) \
+    X(VAL, bool, toolbar_button_pressed_texture_explicit, ) \
+    X(VAL, bool, toolbar_systray_texture_explicit, ) \
+    X(VAL, bool, toolbar_iconbar_texture_explicit, ) \
+    X(VAL, bool, toolbar_iconbar_empty_texture_explicit, ) \
+    X(VAL, bool, toolbar_iconbar_focused_texture_explicit, ) \
+    X(VAL, bool, toolbar_iconbar_unfocused_texture_explicit, ) \
+    X(VAL, bool, window_bevel_width_explicit, )
 
-    struct fbwl_pixmap_triplet window_menuicon_pm;
-    struct fbwl_pixmap_triplet window_shade_pm;
-    struct fbwl_pixmap_triplet window_unshade_pm;
-    struct fbwl_pixmap_triplet window_stick_pm;
-    struct fbwl_pixmap_triplet window_stuck_pm;
-    struct fbwl_pixmap_triplet window_close_pm;
-    struct fbwl_pixmap_triplet window_maximize_pm;
-    struct fbwl_pixmap_triplet window_iconify_pm;
-    struct fbwl_pixmap_triplet window_lhalf_pm;
-    struct fbwl_pixmap_triplet window_rhalf_pm;
-
-    // Fluxbox/X11 style textures (used by the Wayland UI renderer).
-    struct fbwl_texture window_title_focus_tex;
-    struct fbwl_texture window_title_unfocus_tex;
-    struct fbwl_texture window_label_focus_tex;
-    struct fbwl_texture window_label_unfocus_tex;
-    struct fbwl_texture window_button_focus_tex;
-    struct fbwl_texture window_button_unfocus_tex;
-    struct fbwl_texture window_button_pressed_tex;
-    struct fbwl_texture window_handle_focus_tex;
-    struct fbwl_texture window_handle_unfocus_tex;
-    struct fbwl_texture window_grip_focus_tex;
-    struct fbwl_texture window_grip_unfocus_tex;
-    struct fbwl_texture window_tab_label_focus_tex;
-    struct fbwl_texture window_tab_label_unfocus_tex;
-    struct fbwl_texture menu_title_tex;
-    struct fbwl_texture menu_frame_tex;
-    struct fbwl_texture menu_hilite_tex;
-    struct fbwl_texture toolbar_tex;
-    struct fbwl_texture slit_tex; // when unset, Fluxbox uses toolbar look
-    struct fbwl_texture toolbar_clock_tex;
-    struct fbwl_texture toolbar_workspace_tex;
-    struct fbwl_texture toolbar_label_tex; // legacy alias for toolbar.workspace
-    struct fbwl_texture toolbar_windowlabel_tex; // legacy alias used as iconbar fallback
-    struct fbwl_texture toolbar_button_tex;
-    struct fbwl_texture toolbar_button_pressed_tex;
-    struct fbwl_texture toolbar_systray_tex;
-    struct fbwl_texture toolbar_iconbar_tex;
-    struct fbwl_texture toolbar_iconbar_empty_tex;
-    struct fbwl_texture toolbar_iconbar_focused_tex;
-    struct fbwl_texture toolbar_iconbar_unfocused_tex;
-    struct fbwl_texture background_tex;
+#define FBWL_DECOR_THEME_DECLARE(kind, type, name, dims) type name dims;
+struct fbwl_decor_theme {
+    FBWL_DECOR_THEME_FIELDS(FBWL_DECOR_THEME_DECLARE)
+};
+#undef FBWL_DECOR_THEME_DECLARE
 
-    // Menu pixmaps (best-effort).
-    char menu_submenu_pixmap[256];
-    char menu_selected_pixmap[256];
-    char menu_unselected_pixmap[256];
-    char menu_hilite_submenu_pixmap[256];
-    char menu_hilite_selected_pixmap[256];
-    char menu_hilite_unselected_pixmap[256];
+bool fbwl_decor_theme_equal(const struct fbwl_decor_theme *a, const struct fbwl_decor_theme *b);
 
-    // Style parser bookkeeping. These flags are used to preserve Fluxbox/X11
-    // fallback semantics across multiple style loads (e.g. style + overlay).
-    bool toolbar_border_width_explicit;
-    bool toolbar_border_color_explicit;
-    bool toolbar_bevel_width_explicit;
-    bool toolbar_clock_border_width_explicit;
-    bool toolbar_clock_border_color_explicit;
-    bool toolbar_workspace_border_width_explicit;
-    bool toolbar_workspace_border_color_explicit;
-    bool toolbar_iconbar_border_width_explicit;
-    bool toolbar_iconbar_border_color_explicit;
-    bool toolbar_iconbar_focused_border_width_explicit;
-    bool toolbar_iconbar_focused_border_color_explicit;
-    bool toolbar_iconbar_unfocused_border_width_explicit;
-    bool toolbar_iconbar_unfocused_border_color_explicit;
-    bool slit_border_width_explicit;
-    bool slit_border_color_explicit;
-    bool slit_bevel_width_explicit;
-    bool slit_texture_explicit;
-    bool toolbar_clock_texture_explicit;
-    bool toolbar_workspace_texture_explicit;
-    bool toolbar_label_texture_explicit;
-    bool toolbar_windowlabel_texture_explicit;
-    bool toolbar_button_texture_explicit;
-    bool toolbar_button_pressed_texture_explicit;
-    bool toolbar_systray_texture_explicit;
-    bool toolbar_iconbar_texture_explicit;
-    bool toolbar_iconbar_empty_texture_explicit;
-    bool toolbar_iconbar_focused_texture_explicit;
-    bool toolbar_iconbar_unfocused_texture_explicit;
-    bool window_bevel_width_explicit;
-};
+// Calls `fn` for every pixmap path the theme references (textures, button
+// pixmaps, menu bullets, background).
+void fbwl_decor_theme_for_each_file(const struct fbwl_decor_theme *theme,
+        void (*fn)(void *userdata, const char *path), void *userdata);
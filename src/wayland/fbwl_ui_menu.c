@@ -1,6 +1,7 @@
 #include "wayland/fbwl_ui_menu.h"
 
 #include "wayland/fbwl_menu.h"
+#include "wayland/fbwl_perf.h"
 #include "wayland/fbwl_round_corners.h"
 #include "wayland/fbwl_ui_decor_theme.h"
 #include "wayland/fbwl_ui_menu_icon.h"
@@ -547,6 +548,7 @@ void fbwl_ui_menu_set_selected(struct fbwl_menu_ui *ui, size_t idx) {
     if (idx >= ui->current->item_count) {
         idx = ui->current->item_count - 1;
     }
+    const uint64_t start = fbwl_perf_now();
     const size_t prev = ui->selected;
     ui->selected = idx;
     if (ui->highlight != NULL) {
@@ -562,6 +564,7 @@ void fbwl_ui_menu_set_selected(struct fbwl_menu_ui *ui, size_t idx) {
         fbwl_ui_menu_update_item_label(ui, ui->selected);
         fbwl_ui_menu_update_item_mark(ui, prev);
         fbwl_ui_menu_update_item_mark(ui, ui->selected);
+        fbwl_perf_record(FBWL_PERF_MENU_SELECT, start);
     }
 }
 
@@ -820,17 +823,21 @@ bool fbwl_ui_menu_handle_keypress(struct fbwl_menu_ui *ui, const struct fbwl_ui_
         return true;
     }
     if (sym == XKB_KEY_Down) {
+        const uint64_t start = fbwl_perf_now();
         fbwl_ui_menu_search_reset(ui);
         fbwl_ui_menu_set_selected(ui, ui->selected + 1);
+        fbwl_perf_record(FBWL_PERF_MENU_NAV, start);
         return true;
     }
     if (sym == XKB_KEY_Up) {
+        const uint64_t start = fbwl_perf_now();
         fbwl_ui_menu_search_reset(ui);
         size_t idx = ui->selected;
         if (idx > 0) {
             idx--;
         }
         fbwl_ui_menu_set_selected(ui, idx);
+        fbwl_perf_record(FBWL_PERF_MENU_NAV, start);
         return true;
     }
     if (sym == XKB_KEY_Left || sym == XKB_KEY_BackSpace) {
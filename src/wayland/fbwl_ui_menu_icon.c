@@ -470,18 +470,14 @@ static cairo_surface_t *icon_surface_from_xpm_path(const char *path, int icon_px
 
 #endif
 
-struct wlr_buffer *fbwl_ui_menu_icon_buffer_create(const char *path, int icon_px) {
+cairo_surface_t *fbwl_ui_menu_icon_surface_create(const char *path, int icon_px) {
     if (path == NULL || *path == '\0' || icon_px < 1) {
         return NULL;
     }
 
     cairo_surface_t *cached = icon_cache_lookup_surface(path, icon_px);
     if (cached != NULL) {
-        struct wlr_buffer *buf = fbwl_cairo_buffer_create(cached);
-        if (buf != NULL) {
-            return buf;
-        }
-        cairo_surface_destroy(cached);
+        return cached;
     }
 
     cairo_surface_t *surface = NULL;
@@ -501,15 +497,26 @@ struct wlr_buffer *fbwl_ui_menu_icon_buffer_create(const char *path, int icon_px
         return NULL;
     }
 
+    icon_cache_store_surface(path, icon_px, surface);
+    return surface;
+}
+
+static struct wlr_buffer *icon_buffer_from_surface(cairo_surface_t *surface) {
+    if (surface == NULL) {
+        return NULL;
+    }
     struct wlr_buffer *buf = fbwl_cairo_buffer_create(surface);
     if (buf == NULL) {
         cairo_surface_destroy(surface);
         return NULL;
     }
-    icon_cache_store_surface(path, icon_px, surface);
     return buf;
 }
 
+struct wlr_buffer *fbwl_ui_menu_icon_buffer_create(const char *path, int icon_px) {
+    return icon_buffer_from_surface(fbwl_ui_menu_icon_surface_create(path, icon_px));
+}
+
 static uint32_t icon_premultiply_argb(uint32_t argb) {
     const uint32_t a = (argb >> 24) & 0xFFu;
     uint32_t r = (argb >> 16) & 0xFFu;
@@ -525,7 +532,7 @@ static uint32_t icon_premultiply_argb(uint32_t argb) {
     return (a << 24) | (r << 16) | (g << 8) | b;
 }
 
-struct wlr_buffer *fbwl_ui_menu_icon_buffer_create_argb32(const uint32_t *argb, int w, int h, int icon_px) {
+cairo_surface_t *fbwl_ui_menu_icon_surface_create_argb32(const uint32_t *argb, int w, int h, int icon_px) {
     if (argb == NULL || w < 1 || h < 1 || icon_px < 1 || w > 2048 || h > 2048) {
         return NULL;
     }
@@ -549,15 +556,9 @@ struct wlr_buffer *fbwl_ui_menu_icon_buffer_create_argb32(const uint32_t *argb,
     }
     cairo_surface_mark_dirty(surface);
 
-    surface = icon_surface_scale_to_square(surface, icon_px);
-    if (surface == NULL) {
-        return NULL;
-    }
+    return icon_surface_scale_to_square(surface, icon_px);
+}
 
-    struct wlr_buffer *buf = fbwl_cairo_buffer_create(surface);
-    if (buf == NULL) {
-        cairo_surface_destroy(surface);
-        return NULL;
-    }
-    return buf;
+struct wlr_buffer *fbwl_ui_menu_icon_buffer_create_argb32(const uint32_t *argb, int w, int h, int icon_px) {
+    return icon_buffer_from_surface(fbwl_ui_menu_icon_surface_create_argb32(argb, w, h, icon_px));
 }
@@ -2,6 +2,8 @@
 
 #include <stdint.h>
 
+#include <cairo/cairo.h>
+
 struct wlr_buffer;
 
 // Configure the internal icon buffer cache (best-effort).
@@ -11,5 +13,10 @@ struct wlr_buffer;
 // Setting either value to 0 disables caching and clears any existing entries.
 void fbwl_ui_menu_icon_cache_configure(int cache_life_minutes, int cache_max_kb);
 
+// The surface variants return a new cairo reference, for callers that keep
+// their own copy of the scaled icon.
+cairo_surface_t *fbwl_ui_menu_icon_surface_create(const char *path, int icon_px);
+cairo_surface_t *fbwl_ui_menu_icon_surface_create_argb32(const uint32_t *argb, int w, int h, int icon_px);
+
 struct wlr_buffer *fbwl_ui_menu_icon_buffer_create(const char *path, int icon_px);
 struct wlr_buffer *fbwl_ui_menu_icon_buffer_create_argb32(const uint32_t *argb, int w, int h, int icon_px);
@@ -1,5 +1,6 @@
 #include "wayland/fbwl_ui_osd.h"
 
+#include "wayland/fbwl_text_atlas.h"
 #include "wayland/fbwl_ui_decor_theme.h"
 #include "wayland/fbwl_ui_text.h"
 
@@ -8,9 +9,11 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <time.h>
 
 #include <wayland-server-core.h>
 #include <wlr/interfaces/wlr_buffer.h>
+#include <wlr/types/wlr_output.h>
 #include <wlr/types/wlr_output_layout.h>
 #include <wlr/types/wlr_scene.h>
 #include <wlr/util/box.h>
@@ -26,6 +29,96 @@ static void fbwl_ui_osd_destroy_scene(struct fbwl_osd_ui *ui) {
     }
     ui->bg = NULL;
     ui->label = NULL;
+    ui->text_valid = false;
+    ui->pending = false;
+    for (size_t i = 0; i < 2; i++) {
+        if (ui->label_bufs[i] != NULL) {
+            wlr_buffer_drop(ui->label_bufs[i]);
+            ui->label_bufs[i] = NULL;
+        }
+        ui->label_surfaces[i] = NULL;
+    }
+    fbwl_text_atlas_finish(&ui->atlas);
+}
+
+static uint64_t osd_now_msec(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000u + (uint64_t)ts.tv_nsec / 1000000u;
+}
+
+// Redraws numeric readouts from the glyph atlas into whichever of the two
+// label buffers the scene is not showing, then flips to it.
+static bool osd_draw_in_place(struct fbwl_osd_ui *ui, const struct fbwl_decor_theme *decor_theme,
+        const float fg[static 4], const char *msg) {
+    if (ui->label == NULL || !fbwl_text_atlas_prepare(&ui->atlas, ui->height, fg, decor_theme->window_font,
+            &decor_theme->window_label_focus_effect)) {
+        return false;
+    }
+
+    const size_t back = ui->label_back;
+    struct wlr_buffer *buf = ui->label_bufs[back];
+    if (buf != NULL && (buf->width != ui->width || buf->height != ui->height || buf->n_locks > 1)) {
+        wlr_buffer_drop(buf);
+        ui->label_bufs[back] = NULL;
+        ui->label_surfaces[back] = NULL;
+    }
+    if (ui->label_bufs[back] == NULL) {
+        cairo_surface_t *surface = cairo_image_surface_create(CAIRO_FORMAT_ARGB32, ui->width, ui->height);
+        if (cairo_surface_status(surface) != CAIRO_STATUS_SUCCESS) {
+            cairo_surface_destroy(surface);
+            return false;
+        }
+        ui->label_bufs[back] = fbwl_cairo_buffer_create(surface);
+        if (ui->label_bufs[back] == NULL) {
+            cairo_surface_destroy(surface);
+            return false;
+        }
+        ui->label_surfaces[back] = surface;
+    }
+
+    if (!fbwl_text_atlas_draw(&ui->atlas, ui->label_surfaces[back], msg, 8)) {
+        return false;
+    }
+    wlr_scene_buffer_set_buffer(ui->label, ui->label_bufs[back]);
+    ui->label_back = back ^ 1;
+    return true;
+}
+
+static void osd_render_label(struct fbwl_osd_ui *ui, const struct fbwl_decor_theme *decor_theme, const char *msg) {
+    ui->pending = false;
+    if (ui->text_valid && strcmp(ui->text, msg) == 0) {
+        return;
+    }
+
+    const float fg[4] = {1.0f, 1.0f, 1.0f, 1.0f};
+    if (osd_draw_in_place(ui, decor_theme, fg, msg)) {
+        snprintf(ui->text, sizeof(ui->text), "%s", msg);
+        ui->text_valid = true;
+        ui->rendered_msec = osd_now_msec();
+        return;
+    }
+
+    struct wlr_buffer *buf = fbwl_text_buffer_create(msg, ui->width, ui->height, 8, fg,
+        decor_theme->window_font, &decor_theme->window_label_focus_effect, 0);
+    if (buf == NULL) {
+        return;
+    }
+    if (ui->label != NULL) {
+        wlr_scene_buffer_set_buffer(ui->label, buf);
+    }
+    wlr_buffer_drop(buf);
+
+    snprintf(ui->text, sizeof(ui->text), "%s", msg);
+    ui->text_valid = true;
+    ui->rendered_msec = osd_now_msec();
+}
+
+void fbwl_ui_osd_flush(struct fbwl_osd_ui *ui) {
+    if (ui == NULL || !ui->pending || !ui->visible || ui->pending_theme == NULL) {
+        return;
+    }
+    osd_render_label(ui, ui->pending_theme, ui->pending_text);
 }
 
 void fbwl_ui_osd_hide(struct fbwl_osd_ui *ui, const char *why) {
@@ -36,6 +129,8 @@ void fbwl_ui_osd_hide(struct fbwl_osd_ui *ui, const char *why) {
         return;
     }
     ui->visible = false;
+    ui->pending = false;
+    ui->text_valid = false;
     if (ui->tree != NULL) {
         wlr_scene_node_set_enabled(&ui->tree->node, false);
     }
@@ -79,6 +174,24 @@ void fbwl_ui_osd_update_position(struct fbwl_osd_ui *ui, struct wlr_output_layou
     wlr_scene_node_set_position(&ui->tree->node, ui->x, ui->y);
 }
 
+// One frame of the output the OSD sits on. Live readouts repeat, so the
+// position from the previous show is the one to go by.
+static uint64_t osd_frame_msec(const struct fbwl_osd_ui *ui, struct wlr_output_layout *output_layout) {
+    if (output_layout == NULL) {
+        return FBWL_OSD_LIVE_MIN_MS;
+    }
+    struct wlr_output *out = wlr_output_layout_output_at(output_layout,
+        ui->x + ui->width / 2, ui->y + ui->height / 2);
+    if (out == NULL) {
+        out = wlr_output_layout_get_center_output(output_layout);
+    }
+    if (out == NULL || out->refresh <= 0) {
+        return FBWL_OSD_LIVE_MIN_MS;
+    }
+    const uint64_t ms = (1000000u + (uint64_t)out->refresh - 1) / (uint64_t)out->refresh;
+    return ms > 0 ? ms : 1;
+}
+
 static void fbwl_ui_osd_show_text(struct fbwl_osd_ui *ui,
         struct wlr_scene *scene, struct wlr_scene_tree *layer_top,
         const struct fbwl_decor_theme *decor_theme, struct wlr_output_layout *output_layout,
@@ -122,14 +235,22 @@ static void fbwl_ui_osd_show_text(struct fbwl_osd_ui *ui,
     }
     ui->visible = true;
 
-    const float fg[4] = {1.0f, 1.0f, 1.0f, 1.0f};
-    struct wlr_buffer *buf = fbwl_text_buffer_create(msg != NULL ? msg : "", ui->width, ui->height, 8, fg,
-        decor_theme->window_font, &decor_theme->window_label_focus_effect, 0);
-    if (buf != NULL) {
-        if (ui->label != NULL) {
-            wlr_scene_buffer_set_buffer(ui->label, buf);
+    if (msg == NULL) {
+        msg = "";
+    }
+    const uint64_t now = osd_now_msec();
+    const bool live = hide_ms < 0 && ui->render_timer != NULL && strlen(msg) < sizeof(ui->pending_text);
+    const uint64_t frame = live ? osd_frame_msec(ui, output_layout) : 0;
+    if (live && ui->text_valid && now - ui->rendered_msec < frame) {
+        snprintf(ui->pending_text, sizeof(ui->pending_text), "%s", msg);
+        ui->pending_theme = decor_theme;
+        if (!ui->pending) {
+            ui->pending = true;
+            wl_event_source_timer_update(ui->render_timer,
+                (int)(frame - (now - ui->rendered_msec)));
         }
-        wlr_buffer_drop(buf);
+    } else {
+        osd_render_label(ui, decor_theme, msg);
     }
 
     if (hide_ms >= 0 && ui->hide_timer != NULL) {
@@ -221,6 +342,10 @@ void fbwl_ui_osd_destroy(struct fbwl_osd_ui *ui) {
         wl_event_source_remove(ui->hide_timer);
         ui->hide_timer = NULL;
     }
+    if (ui->render_timer != NULL) {
+        wl_event_source_remove(ui->render_timer);
+        ui->render_timer = NULL;
+    }
     fbwl_ui_osd_destroy_scene(ui);
     ui->enabled = false;
     ui->visible = false;
@@ -1,6 +1,12 @@
 #pragma once
 
 #include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include <cairo/cairo.h>
+
+#include "wayland/fbwl_text_atlas.h"
 
 struct wl_event_source;
 struct wlr_output_layout;
@@ -11,6 +17,10 @@ struct wlr_scene_tree;
 
 struct fbwl_decor_theme;
 
+enum {
+    FBWL_OSD_LIVE_MIN_MS = 33,
+};
+
 struct fbwl_osd_ui {
     bool enabled;
     bool visible;
@@ -24,9 +34,27 @@ struct fbwl_osd_ui {
 
     struct wl_event_source *hide_timer;
 
+    // Live labels (hide_ms < 0) re-render at most once per output frame
+    // (FBWL_OSD_LIVE_MIN_MS when the refresh rate is unknown) when
+    // render_timer is set; the newest text is flushed from the timer.
+    // An unchanged text is never rendered twice while the OSD stays visible.
+    struct wl_event_source *render_timer;
+    const struct fbwl_decor_theme *pending_theme;
+    bool pending;
+    bool text_valid;
+    uint64_t rendered_msec;
+    char pending_text[64];
+    char text[256];
+
     struct wlr_scene_tree *tree;
     struct wlr_scene_rect *bg;
     struct wlr_scene_buffer *label;
+
+    // Numeric labels are drawn in place into these from the atlas.
+    struct fbwl_text_atlas atlas;
+    struct wlr_buffer *label_bufs[2];
+    cairo_surface_t *label_surfaces[2];
+    size_t label_back;
 };
 
 void fbwl_ui_osd_hide(struct fbwl_osd_ui *ui, const char *why);
@@ -47,4 +75,5 @@ void fbwl_ui_osd_show_window_geometry(struct fbwl_osd_ui *ui,
     struct wlr_scene *scene, struct wlr_scene_tree *layer_top,
     const struct fbwl_decor_theme *decor_theme, struct wlr_output_layout *output_layout,
     int width, int height);
+void fbwl_ui_osd_flush(struct fbwl_osd_ui *ui);
 void fbwl_ui_osd_destroy(struct fbwl_osd_ui *ui);
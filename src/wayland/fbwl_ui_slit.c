@@ -371,10 +371,23 @@ static void slit_cancel_auto_timer(struct fbwl_slit_ui *ui) {
     ui->auto_pending = 0;
 }
 
+static void slit_item_current_size(const struct fbwl_slit_item *it, int *w, int *h) {
+    *w = 0;
+    *h = 0;
+    if (it->visible && it->view != NULL && it->view->mapped) {
+        *w = fbwl_view_current_width(it->view);
+        *h = fbwl_view_current_height(it->view);
+    }
+}
+
 static void slit_update_layout(struct fbwl_slit_ui *ui, const struct fbwl_ui_slit_env *env, const char *why) {
     if (ui == NULL || env == NULL) {
         return;
     }
+    struct fbwl_slit_item *it;
+    wl_list_for_each(it, &ui->items, link) {
+        slit_item_current_size(it, &it->laid_w, &it->laid_h);
+    }
     ui->pseudo_output_layout = env->output_layout;
     ui->pseudo_wallpaper_mode = env->wallpaper_mode;
     ui->pseudo_wallpaper_buf = env->wallpaper_buf;
@@ -419,6 +432,7 @@ static void slit_update_layout(struct fbwl_slit_ui *ui, const struct fbwl_ui_sli
         if (ui->bg != NULL) {
             wlr_scene_node_lower_to_bottom(&ui->bg->node);
         }
+        ui->bg_valid = false;
     }
 
     if (ui->tree != NULL && env->layer_tree != NULL && ui->tree->node.parent != env->layer_tree) {
@@ -511,10 +525,18 @@ static void slit_update_layout(struct fbwl_slit_ui *ui, const struct fbwl_ui_sli
         const float alpha = (float)ui->alpha / 255.0f;
         const bool parentrel = env->decor_theme != NULL && fbwl_texture_is_parentrelative(&env->decor_theme->slit_tex);
         if (env->decor_theme != NULL && !parentrel) {
-            struct wlr_buffer *buf = fbwl_texture_render_buffer(&env->decor_theme->slit_tex, inner_w, inner_h);
-            wlr_scene_buffer_set_buffer(ui->bg, buf);
-            if (buf != NULL) {
-                wlr_buffer_drop(buf);
+            const struct fbwl_texture *tex = &env->decor_theme->slit_tex;
+            if (!ui->bg_valid || ui->bg_w != inner_w || ui->bg_h != inner_h ||
+                    memcmp(&ui->bg_tex, tex, sizeof(*tex)) != 0) {
+                struct wlr_buffer *buf = fbwl_texture_render_buffer(tex, inner_w, inner_h);
+                wlr_scene_buffer_set_buffer(ui->bg, buf);
+                if (buf != NULL) {
+                    wlr_buffer_drop(buf);
+                }
+                ui->bg_valid = buf != NULL;
+                ui->bg_w = inner_w;
+                ui->bg_h = inner_h;
+                ui->bg_tex = *tex;
             }
             wlr_scene_buffer_set_dest_size(ui->bg, inner_w, inner_h);
             wlr_scene_buffer_set_opacity(ui->bg, alpha);
@@ -522,9 +544,11 @@ static void slit_update_layout(struct fbwl_slit_ui *ui, const struct fbwl_ui_sli
         } else {
             wlr_scene_buffer_set_buffer(ui->bg, NULL);
             wlr_scene_node_set_enabled(&ui->bg->node, false);
+            ui->bg_valid = false;
         }
     }
 
+    // The border rects are kept across layouts and only resized.
     if (border_w > 0 && env->decor_theme != NULL) {
         const float alpha = (float)ui->alpha / 255.0f;
         float c[4] = {
@@ -533,21 +557,31 @@ static void slit_update_layout(struct fbwl_slit_ui *ui, const struct fbwl_ui_sli
             env->decor_theme->slit_border_color[2],
             env->decor_theme->slit_border_color[3] * alpha,
         };
-        struct wlr_scene_rect *top = wlr_scene_rect_create(ui->tree, ui->width, border_w, c);
-        struct wlr_scene_rect *bottom = wlr_scene_rect_create(ui->tree, ui->width, border_w, c);
-        struct wlr_scene_rect *left = wlr_scene_rect_create(ui->tree, border_w, ui->height - 2 * border_w, c);
-        struct wlr_scene_rect *right = wlr_scene_rect_create(ui->tree, border_w, ui->height - 2 * border_w, c);
-        if (top != NULL) {
-            wlr_scene_node_set_position(&top->node, 0, 0);
-        }
-        if (bottom != NULL) {
-            wlr_scene_node_set_position(&bottom->node, 0, ui->height - border_w);
-        }
-        if (left != NULL) {
-            wlr_scene_node_set_position(&left->node, 0, border_w);
+        const int side_h = ui->height - 2 * border_w;
+        const int geo[4][4] = {
+            {0, 0, ui->width, border_w},
+            {0, ui->height - border_w, ui->width, border_w},
+            {0, border_w, border_w, side_h},
+            {ui->width - border_w, border_w, border_w, side_h},
+        };
+        for (size_t i = 0; i < 4; i++) {
+            if (ui->border[i] == NULL) {
+                ui->border[i] = wlr_scene_rect_create(ui->tree, geo[i][2], geo[i][3], c);
+                if (ui->border[i] == NULL) {
+                    continue;
+                }
+            } else {
+                wlr_scene_rect_set_size(ui->border[i], geo[i][2], geo[i][3]);
+                wlr_scene_rect_set_color(ui->border[i], c);
+            }
+            wlr_scene_node_set_position(&ui->border[i]->node, geo[i][0], geo[i][1]);
+            wlr_scene_node_set_enabled(&ui->border[i]->node, true);
         }
-        if (right != NULL) {
-            wlr_scene_node_set_position(&right->node, ui->width - border_w, border_w);
+    } else {
+        for (size_t i = 0; i < 4; i++) {
+            if (ui->border[i] != NULL) {
+                wlr_scene_node_set_enabled(&ui->border[i]->node, false);
+            }
         }
     }
     const bool parentrel = ui->pseudo_decor_theme != NULL && fbwl_texture_is_parentrelative(&ui->pseudo_decor_theme->slit_tex);
@@ -567,7 +601,6 @@ static void slit_update_layout(struct fbwl_slit_ui *ui, const struct fbwl_ui_sli
     } else {
         xoff = bevel_w;
     }
-    struct fbwl_slit_item *it;
     wl_list_for_each(it, &ui->items, link) {
         if (!it->visible) {
             continue;
@@ -745,6 +778,10 @@ void fbwl_ui_slit_destroy(struct fbwl_slit_ui *ui) {
         ui->tree = NULL;
     }
     ui->bg = NULL;
+    for (size_t i = 0; i < 4; i++) {
+        ui->border[i] = NULL;
+    }
+    ui->bg_valid = false;
 }
 
 bool fbwl_ui_slit_attach_view(struct fbwl_slit_ui *ui, const struct fbwl_ui_slit_env *env, struct fbwl_view *view,
@@ -808,15 +845,24 @@ void fbwl_ui_slit_detach_view(struct fbwl_slit_ui *ui, const struct fbwl_ui_slit
     slit_update_layout(ui, env, "detach");
 }
 
-void fbwl_ui_slit_handle_view_commit(struct fbwl_slit_ui *ui, const struct fbwl_ui_slit_env *env, struct fbwl_view *view,
+bool fbwl_ui_slit_handle_view_commit(struct fbwl_slit_ui *ui, const struct fbwl_ui_slit_env *env, struct fbwl_view *view,
         const char *why) {
     if (ui == NULL || env == NULL || view == NULL) {
-        return;
+        return false;
     }
-    if (slit_find_item(ui, view) == NULL) {
-        return;
+    const struct fbwl_slit_item *it = slit_find_item(ui, view);
+    if (it == NULL) {
+        return false;
+    }
+    // Dockapps redraw often; only a new client size moves anything.
+    int w = 0;
+    int h = 0;
+    slit_item_current_size(it, &w, &h);
+    if (w == it->laid_w && h == it->laid_h) {
+        return false;
     }
     slit_update_layout(ui, env, why != NULL ? why : "commit");
+    return true;
 }
 
 void fbwl_ui_slit_apply_view_geometry(struct fbwl_slit_ui *ui, const struct fbwl_ui_slit_env *env, struct fbwl_view *view,
@@ -836,6 +882,9 @@ void fbwl_ui_slit_apply_view_geometry(struct fbwl_slit_ui *ui, const struct fbwl
 }
 
 void fbwl_ui_slit_rebuild(struct fbwl_slit_ui *ui, const struct fbwl_ui_slit_env *env) {
+    if (ui != NULL) {
+        ui->bg_valid = false;
+    }
     slit_update_layout(ui, env, "rebuild");
 }
 
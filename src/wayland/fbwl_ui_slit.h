@@ -8,6 +8,7 @@
 
 #include "wayland/fbwl_ui_toolbar.h"
 #include "wayland/fbwl_pseudo_bg.h"
+#include "wayland/fbwl_texture.h"
 
 struct fbwl_decor_theme;
 struct fbwl_view;
@@ -27,6 +28,9 @@ struct fbwl_slit_item {
     struct wl_list link;
     struct fbwl_view *view;
     bool visible;
+    // Client size at the last layout (0x0 when it was not laid out).
+    int laid_w;
+    int laid_h;
 };
 
 struct fbwl_slit_ui {
@@ -67,6 +71,13 @@ struct fbwl_slit_ui {
     const struct fbwl_decor_theme *pseudo_decor_theme;
     bool pseudo_force_pseudo_transparency;
     struct wlr_scene_buffer *bg;
+    struct wlr_scene_rect *border[4];
+
+    // The background buffer on bg was rendered from bg_tex at bg_w x bg_h.
+    bool bg_valid;
+    int bg_w;
+    int bg_h;
+    struct fbwl_texture bg_tex;
 
     struct wl_list items; // struct fbwl_slit_item.link
     size_t items_len;
@@ -98,7 +109,9 @@ bool fbwl_ui_slit_attach_view(struct fbwl_slit_ui *ui, const struct fbwl_ui_slit
 void fbwl_ui_slit_detach_view(struct fbwl_slit_ui *ui, const struct fbwl_ui_slit_env *env, struct fbwl_view *view,
         const char *why);
 
-void fbwl_ui_slit_handle_view_commit(struct fbwl_slit_ui *ui, const struct fbwl_ui_slit_env *env, struct fbwl_view *view,
+// Returns true when the commit changed the item's size and the slit was laid
+// out again.
+bool fbwl_ui_slit_handle_view_commit(struct fbwl_slit_ui *ui, const struct fbwl_ui_slit_env *env, struct fbwl_view *view,
         const char *why);
 void fbwl_ui_slit_apply_view_geometry(struct fbwl_slit_ui *ui, const struct fbwl_ui_slit_env *env, struct fbwl_view *view,
         const char *why);
@@ -1,5 +1,6 @@
 #include "wayland/fbwl_ui_toolbar.h"
 #include "wmcore/fbwm_core.h"
+#include "wayland/fbwl_trace.h"
 #include "wayland/fbwl_ui_toolbar_build.h"
 #include "wayland/fbwl_ui_toolbar_layout.h"
 #include "wayland/fbwl_ui_toolbar_shape.h"
@@ -232,6 +233,8 @@ static void fbwl_ui_toolbar_destroy_scene(struct fbwl_toolbar_ui *ui) {
     free(ui->iconbar_item_w);
     ui->iconbar_item_w = NULL;
     ui->iconbar_bg = NULL;
+    free(ui->iconbar_items);
+    ui->iconbar_items = NULL;
     free(ui->iconbar_bgs);
     ui->iconbar_bgs = NULL;
     free(ui->iconbar_labels);
@@ -345,7 +348,7 @@ static void fbwl_ui_toolbar_clock_render(struct fbwl_toolbar_ui *ui) {
     buf = fbwl_ui_toolbar_shaped_mask_buffer_owned(ui->placement, ui->pseudo_decor_theme, buf, base_x, base_y, ui->width, ui->height);
     wlr_scene_buffer_set_buffer(ui->clock_label, buf);
     wlr_buffer_drop(buf);
-    wlr_log(WLR_INFO, "Toolbar: clock text=%s justify=%d", ui->clock_text, justify);
+    fbwl_trace(FBWL_TRACE_TOOLBAR, "Toolbar: clock text=%s justify=%d", ui->clock_text, justify);
 }
 static int fbwl_ui_toolbar_clock_timer(void *data) {
     struct fbwl_toolbar_ui *ui = data;
@@ -402,7 +405,7 @@ void fbwl_ui_toolbar_update_iconbar_focus(struct fbwl_toolbar_ui *ui, const stru
         }
         if (urgent && view != focused_view && urgent_logged < 3) {
             urgent_logged++;
-            wlr_log(WLR_INFO, "Toolbar: iconbar attention title=%s", fbwl_view_display_title(view));
+            fbwl_trace(FBWL_TRACE_TOOLBAR, "Toolbar: iconbar attention title=%s", fbwl_view_display_title(view));
         }
     }
 }
@@ -536,11 +539,29 @@ void fbwl_ui_toolbar_rebuild(struct fbwl_toolbar_ui *ui, const struct fbwl_ui_to
     }
     fbwl_ui_toolbar_update_iconbar_focus(ui, env->decor_theme, env->focused_view);
     wlr_scene_node_raise_to_top(&ui->tree->node);
-    wlr_log(WLR_INFO, "Toolbar: built x=%d y=%d w=%d h=%d cell_w=%d onhead=%d layer=%d workspaces=%zu buttons=%zu iconbar=%zu tray=%zu clock_w=%d",
+    fbwl_trace(FBWL_TRACE_TOOLBAR, "Toolbar: built x=%d y=%d w=%d h=%d cell_w=%d onhead=%d layer=%d workspaces=%zu buttons=%zu iconbar=%zu tray=%zu clock_w=%d",
         ui->x, ui->y, ui->width, ui->height, ui->cell_w, ui->on_head + 1, ui->layer_num, ui->cell_count,
         ui->button_count, ui->iconbar_count, ui->tray_count, ui->clock_w);
     fbwl_ui_toolbar_update_position(ui, env);
 }
+bool fbwl_ui_toolbar_update_workspace(struct fbwl_toolbar_ui *ui, const struct fbwl_ui_toolbar_env *env) {
+    if (ui == NULL || env == NULL || env->wm == NULL || env->decor_theme == NULL) {
+        return false;
+    }
+    if (!ui->enabled) {
+        return true;
+    }
+    if (ui->tree == NULL || ui->pseudo_decor_theme != env->decor_theme) {
+        return false;
+    }
+    const bool vertical = toolbar_edge_is_vertical(toolbar_placement_edge(ui->placement));
+    fbwl_ui_toolbar_update_workspace_name(ui, env, vertical, ui->text_color);
+    if (!fbwl_ui_toolbar_update_iconbar(ui, env, vertical, ui->text_color)) {
+        return false;
+    }
+    fbwl_ui_toolbar_update_iconbar_focus(ui, env->decor_theme, env->focused_view);
+    return true;
+}
 void fbwl_ui_toolbar_update_position(struct fbwl_toolbar_ui *ui, const struct fbwl_ui_toolbar_env *env) {
     if (ui == NULL || env == NULL || env->output_layout == NULL) {
         return;
@@ -654,7 +675,7 @@ void fbwl_ui_toolbar_update_position(struct fbwl_toolbar_ui *ui, const struct fb
         fbwl_pseudo_bg_destroy(&ui->pseudo_bg);
     }
     if (ui->x != prev_x || ui->y != prev_y) {
-        wlr_log(WLR_INFO, "Toolbar: position x=%d y=%d h=%d cell_w=%d workspaces=%zu w=%d thickness=%d alpha=%u",
+        fbwl_trace(FBWL_TRACE_TOOLBAR, "Toolbar: position x=%d y=%d h=%d cell_w=%d workspaces=%zu w=%d thickness=%d alpha=%u",
             ui->x, ui->y, ui->height, ui->cell_w, ui->cell_count, ui->width, ui->thickness, (unsigned)ui->alpha);
     }
 }
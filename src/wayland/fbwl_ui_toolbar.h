@@ -129,6 +129,8 @@ struct fbwl_toolbar_ui {
     int *iconbar_item_lx;
     int *iconbar_item_w;
     struct wlr_scene_buffer *iconbar_bg;
+    // One subtree per entry (holding its bg, icon and label).
+    struct wlr_scene_tree **iconbar_items;
     struct wlr_scene_buffer **iconbar_bgs;
     struct wlr_scene_buffer **iconbar_labels;
     bool *iconbar_needs_tooltip;
@@ -215,6 +217,11 @@ void fbwl_ui_toolbar_rebuild(struct fbwl_toolbar_ui *ui, const struct fbwl_ui_to
 void fbwl_ui_toolbar_update_position(struct fbwl_toolbar_ui *ui, const struct fbwl_ui_toolbar_env *env);
 void fbwl_ui_toolbar_handle_motion(struct fbwl_toolbar_ui *ui, const struct fbwl_ui_toolbar_env *env,
     int lx, int ly, int delay_ms);
+// Swaps tray icon buffers in place; false when the tray needs a relayout.
+bool fbwl_ui_toolbar_update_tray(struct fbwl_toolbar_ui *ui, const struct fbwl_ui_toolbar_env *env);
+// Redraws the workspace name and adds/drops the iconbar entries of views that
+// entered or left; false when the toolbar needs a full rebuild.
+bool fbwl_ui_toolbar_update_workspace(struct fbwl_toolbar_ui *ui, const struct fbwl_ui_toolbar_env *env);
 void fbwl_ui_toolbar_update_iconbar_focus(struct fbwl_toolbar_ui *ui, const struct fbwl_decor_theme *decor_theme,
     const struct fbwl_view *focused_view);
 bool fbwl_ui_toolbar_handle_click(struct fbwl_toolbar_ui *ui, const struct fbwl_ui_toolbar_env *env,
@@ -13,3 +13,10 @@ void fbwl_ui_toolbar_build_tray(struct fbwl_toolbar_ui *ui, const struct fbwl_ui
 
 void fbwl_ui_toolbar_build_buttons(struct fbwl_toolbar_ui *ui, const struct fbwl_ui_toolbar_env *env,
     bool vertical, const float fg[4]);
+
+// In-place pieces of fbwl_ui_toolbar_update_workspace().
+void fbwl_ui_toolbar_update_workspace_name(struct fbwl_toolbar_ui *ui, const struct fbwl_ui_toolbar_env *env,
+    bool vertical, const float fg[4]);
+
+bool fbwl_ui_toolbar_update_iconbar(struct fbwl_toolbar_ui *ui, const struct fbwl_ui_toolbar_env *env,
+    bool vertical, const float fg[4]);
@@ -10,6 +10,7 @@
 #include <wlr/types/wlr_scene.h>
 #include <wlr/util/log.h>
 
+#include "wayland/fbwl_trace.h"
 #include "wayland/fbwl_ui_decor_theme.h"
 #include "wayland/fbwl_ui_toolbar.h"
 #include "wayland/fbwl_ui_toolbar_shape.h"
@@ -174,6 +175,40 @@ bool fbwl_ui_toolbar_buttons_replace(struct fbwl_toolbar_ui *ui, struct fbwl_too
     return true;
 }
 
+static const char *workspace_label(const struct fbwl_toolbar_ui *ui, const struct fbwl_ui_toolbar_env *env,
+        char *buf, size_t buf_len) {
+    const size_t head = ui->on_head >= 0 ? (size_t)ui->on_head : 0;
+    int cur = fbwm_core_workspace_current_for_head(env->wm, head);
+    if (cur < 0) {
+        cur = 0;
+    }
+    const char *ws_name = fbwm_core_workspace_name(env->wm, cur);
+    if (ws_name != NULL && *ws_name != '\0') {
+        return ws_name;
+    }
+    if (snprintf(buf, buf_len, "%d", cur + 1) > 0) {
+        return buf;
+    }
+    return "";
+}
+
+static struct wlr_buffer *button_label_buffer(const struct fbwl_toolbar_ui *ui, const struct fbwl_ui_toolbar_env *env,
+        const char *tok, const char *label, int base_x, int base_y, int w, int h, const float fg[4]) {
+    const int pad = ui->thickness >= 24 ? 8 : 2;
+    const bool workspace = strcmp(tok, "workspacename") == 0;
+    const struct fbwl_text_effect *effect = NULL;
+    int justify = 0;
+    if (env->decor_theme != NULL) {
+        effect = workspace ? &env->decor_theme->toolbar_workspace_effect : &env->decor_theme->toolbar_label_effect;
+        justify = workspace ? env->decor_theme->toolbar_workspace_justify : 0;
+    }
+    struct wlr_buffer *buf = fbwl_text_buffer_create(label, w, h, pad, fg, ui->font, effect, justify);
+    if (buf == NULL) {
+        return NULL;
+    }
+    return fbwl_ui_toolbar_shaped_mask_buffer_owned(ui->placement, env->decor_theme, buf, base_x, base_y, ui->width, ui->height);
+}
+
 void fbwl_ui_toolbar_build_buttons(struct fbwl_toolbar_ui *ui, const struct fbwl_ui_toolbar_env *env,
         bool vertical, const float fg[4]) {
     if (ui == NULL || fg == NULL) {
@@ -200,7 +235,6 @@ void fbwl_ui_toolbar_build_buttons(struct fbwl_toolbar_ui *ui, const struct fbwl
     }
 
     const float alpha = (float)ui->alpha / 255.0f;
-    const int pad = ui->thickness >= 24 ? 8 : 2;
     const int cross = ui->border_w + ui->bevel_w;
 
     for (size_t i = 0; i < ui->button_count; i++) {
@@ -239,7 +273,7 @@ void fbwl_ui_toolbar_build_buttons(struct fbwl_toolbar_ui *ui, const struct fbwl
             continue;
         }
 
-        wlr_log(WLR_INFO, "Toolbar: tool tok=%s lx=%d w=%d", tok, off, tool_w);
+        fbwl_trace(FBWL_TRACE_TOOLBAR, "Toolbar: tool tok=%s lx=%d w=%d", tok, off, tool_w);
 
         const char *label = "";
         char label_buf[128];
@@ -282,17 +316,7 @@ void fbwl_ui_toolbar_build_buttons(struct fbwl_toolbar_ui *ui, const struct fbwl
             }
             label = arrow_prev ? "<" : ">";
         } else if (strcmp(tok, "workspacename") == 0) {
-            const size_t head = ui->on_head >= 0 ? (size_t)ui->on_head : 0;
-            int cur = fbwm_core_workspace_current_for_head(env->wm, head);
-            if (cur < 0) {
-                cur = 0;
-            }
-            const char *ws_name = fbwm_core_workspace_name(env->wm, cur);
-            if (ws_name != NULL && *ws_name != '\0') {
-                label = ws_name;
-            } else if (snprintf(label_buf, sizeof(label_buf), "%d", cur + 1) > 0) {
-                label = label_buf;
-            }
+            label = workspace_label(ui, env, label_buf, sizeof(label_buf));
         } else if (strncmp(tok, "button.", 7) == 0) {
             const char *name = tok + 7;
             const struct fbwl_toolbar_button_cfg *cfg = toolbar_button_cfg_find(ui, name);
@@ -305,20 +329,11 @@ void fbwl_ui_toolbar_build_buttons(struct fbwl_toolbar_ui *ui, const struct fbwl
             continue;
         }
 
-        const struct fbwl_text_effect *effect = NULL;
-        if (env->decor_theme != NULL) {
-            effect = strcmp(tok, "workspacename") == 0 ? &env->decor_theme->toolbar_workspace_effect : &env->decor_theme->toolbar_label_effect;
-        }
-        int justify = 0;
-        if (env->decor_theme != NULL && strcmp(tok, "workspacename") == 0) {
-            justify = env->decor_theme->toolbar_workspace_justify;
-        }
-        struct wlr_buffer *buf = fbwl_text_buffer_create(label, w, h, pad, fg, ui->font, effect, justify);
+        struct wlr_buffer *buf = button_label_buffer(ui, env, tok, label, base_x, base_y, w, h, fg);
         if (buf == NULL) {
             continue;
         }
 
-        buf = fbwl_ui_toolbar_shaped_mask_buffer_owned(ui->placement, env->decor_theme, buf, base_x, base_y, ui->width, ui->height);
         ui->button_labels[i] = wlr_scene_buffer_create(ui->tree, buf);
         if (ui->button_labels[i] != NULL) {
             wlr_scene_node_set_position(&ui->button_labels[i]->node, base_x, base_y);
@@ -326,5 +341,44 @@ void fbwl_ui_toolbar_build_buttons(struct fbwl_toolbar_ui *ui, const struct fbwl
         wlr_buffer_drop(buf);
     }
 
-    wlr_log(WLR_INFO, "Toolbar: toolbuttons count=%zu", ui->button_count);
+    fbwl_trace(FBWL_TRACE_TOOLBAR, "Toolbar: toolbuttons count=%zu", ui->button_count);
+}
+
+void fbwl_ui_toolbar_update_workspace_name(struct fbwl_toolbar_ui *ui, const struct fbwl_ui_toolbar_env *env,
+        bool vertical, const float fg[4]) {
+    if (ui == NULL || env == NULL || env->wm == NULL || fg == NULL || ui->tree == NULL || ui->button_labels == NULL ||
+            ui->button_item_lx == NULL || ui->button_item_w == NULL || ui->button_item_tokens == NULL) {
+        return;
+    }
+
+    const int cross = ui->border_w + ui->bevel_w;
+    for (size_t i = 0; i < ui->button_count; i++) {
+        const char *tok = ui->button_item_tokens[i];
+        if (tok == NULL || strcmp(tok, "workspacename") != 0) {
+            continue;
+        }
+
+        const int off = ui->button_item_lx[i];
+        const int tool_w = ui->button_item_w[i];
+        const int w = vertical ? ui->thickness : tool_w;
+        const int h = vertical ? tool_w : ui->thickness;
+        const int base_x = vertical ? cross : off;
+        const int base_y = vertical ? off : cross;
+
+        char label_buf[128];
+        const char *label = workspace_label(ui, env, label_buf, sizeof(label_buf));
+        struct wlr_buffer *buf = *label != '\0' ? button_label_buffer(ui, env, tok, label, base_x, base_y, w, h, fg) : NULL;
+        if (ui->button_labels[i] != NULL) {
+            wlr_scene_buffer_set_buffer(ui->button_labels[i], buf);
+        } else if (buf != NULL) {
+            ui->button_labels[i] = wlr_scene_buffer_create(ui->tree, buf);
+            if (ui->button_labels[i] != NULL) {
+                wlr_scene_node_set_position(&ui->button_labels[i]->node, base_x, base_y);
+            }
+        }
+        if (buf != NULL) {
+            wlr_buffer_drop(buf);
+        }
+        fbwl_trace(FBWL_TRACE_TOOLBAR, "Toolbar: workspacename label=%s", label);
+    }
 }
@@ -13,16 +13,14 @@
 #include <wlr/util/log.h>
 
 #include "wmcore/fbwm_core.h"
-#include "wayland/fbwl_icon_theme.h"
 #include "wayland/fbwl_tabs.h"
+#include "wayland/fbwl_trace.h"
 #include "wayland/fbwl_ui_decor_theme.h"
-#include "wayland/fbwl_ui_menu_icon.h"
 #include "wayland/fbwl_ui_toolbar.h"
 #include "wayland/fbwl_ui_toolbar_iconbar_pattern.h"
 #include "wayland/fbwl_ui_toolbar_shape.h"
 #include "wayland/fbwl_ui_text.h"
 #include "wayland/fbwl_view.h"
-#include "wayland/fbwl_xwayland_icon.h"
 
 static char *trim_inplace(char *s) {
     if (s == NULL) {
@@ -142,44 +140,61 @@ static char *iconbar_label_text(const struct fbwl_toolbar_ui *ui, const struct f
     return out;
 }
 
-static void iconbar_alloc_fail_cleanup(struct fbwl_toolbar_ui *ui) {
-    if (ui == NULL) {
-        return;
-    }
-
-    free(ui->iconbar_views);
+static void iconbar_arrays_forget(struct fbwl_toolbar_ui *ui) {
     ui->iconbar_views = NULL;
-    free(ui->iconbar_texts);
     ui->iconbar_texts = NULL;
-    free(ui->iconbar_item_lx);
     ui->iconbar_item_lx = NULL;
-    free(ui->iconbar_item_w);
     ui->iconbar_item_w = NULL;
-    ui->iconbar_bg = NULL;
-    free(ui->iconbar_bgs);
+    ui->iconbar_items = NULL;
     ui->iconbar_bgs = NULL;
-    free(ui->iconbar_labels);
     ui->iconbar_labels = NULL;
-    free(ui->iconbar_needs_tooltip);
     ui->iconbar_needs_tooltip = NULL;
     ui->iconbar_count = 0;
 }
 
-void fbwl_ui_toolbar_build_iconbar(struct fbwl_toolbar_ui *ui, const struct fbwl_ui_toolbar_env *env,
-        bool vertical, const float fg[4]) {
-    if (ui == NULL || env == NULL || env->wm == NULL || ui->tree == NULL) {
-        return;
-    }
-    if ((ui->tools & FBWL_TOOLBAR_TOOL_ICONBAR) == 0 || ui->iconbar_w < 1) {
-        return;
+static void iconbar_arrays_free(struct fbwl_toolbar_ui *ui) {
+    free(ui->iconbar_views);
+    free(ui->iconbar_texts);
+    free(ui->iconbar_item_lx);
+    free(ui->iconbar_item_w);
+    free(ui->iconbar_items);
+    free(ui->iconbar_bgs);
+    free(ui->iconbar_labels);
+    free(ui->iconbar_needs_tooltip);
+    iconbar_arrays_forget(ui);
+}
+
+static bool iconbar_arrays_alloc(struct fbwl_toolbar_ui *ui, size_t count) {
+    ui->iconbar_views = calloc(count, sizeof(*ui->iconbar_views));
+    ui->iconbar_texts = calloc(count, sizeof(*ui->iconbar_texts));
+    ui->iconbar_item_lx = calloc(count, sizeof(*ui->iconbar_item_lx));
+    ui->iconbar_item_w = calloc(count, sizeof(*ui->iconbar_item_w));
+    ui->iconbar_items = calloc(count, sizeof(*ui->iconbar_items));
+    ui->iconbar_bgs = calloc(count, sizeof(*ui->iconbar_bgs));
+    ui->iconbar_labels = calloc(count, sizeof(*ui->iconbar_labels));
+    ui->iconbar_needs_tooltip = calloc(count, sizeof(*ui->iconbar_needs_tooltip));
+    if (ui->iconbar_views == NULL || ui->iconbar_texts == NULL || ui->iconbar_item_lx == NULL || ui->iconbar_item_w == NULL ||
+            ui->iconbar_items == NULL || ui->iconbar_bgs == NULL || ui->iconbar_labels == NULL ||
+            ui->iconbar_needs_tooltip == NULL) {
+        iconbar_arrays_free(ui);
+        return false;
     }
+    ui->iconbar_count = count;
+    return true;
+}
+
+// Views the iconbar shows on the toolbar's head, in display order; NULL (and
+// 0) when the mode hides the iconbar or nothing matches.
+static struct fbwl_view **iconbar_select(const struct fbwl_toolbar_ui *ui, const struct fbwl_ui_toolbar_env *env,
+        size_t *out_count) {
+    *out_count = 0;
 
     char mode_buf[sizeof(ui->iconbar_mode)];
     strncpy(mode_buf, ui->iconbar_mode, sizeof(mode_buf));
     mode_buf[sizeof(mode_buf) - 1] = '\0';
     char *mode = trim_inplace(mode_buf);
     if (mode == NULL || *mode == '\0' || strcasecmp(mode, "none") == 0) {
-        return;
+        return NULL;
     }
 
     bool groups = false;
@@ -195,31 +210,17 @@ void fbwl_ui_toolbar_build_iconbar(struct fbwl_toolbar_ui *ui, const struct fbwl
 
     size_t icon_count = 0;
     for (struct fbwm_view *wm_view = env->wm->views.next; wm_view != &env->wm->views; wm_view = wm_view->next) {
-        struct fbwl_view *view = wm_view->userdata;
-        if (view == NULL || !view->mapped) {
-            continue;
-        }
-        const int view_head = wm_view->ops != NULL && wm_view->ops->head != NULL ? wm_view->ops->head(wm_view) : 0;
-        if (view_head != toolbar_head) {
-            continue;
-        }
-        if (groups && !fbwl_tabs_view_is_active(view)) {
-            continue;
-        }
-        if (!fbwl_iconbar_pattern_matches(&pat, env, view, cur_ws)) {
-            continue;
-        }
         icon_count++;
     }
     if (icon_count == 0) {
         fbwl_iconbar_pattern_free(&pat);
-        return;
+        return NULL;
     }
 
     struct fbwl_view **selected = calloc(icon_count, sizeof(*selected));
     if (selected == NULL) {
         fbwl_iconbar_pattern_free(&pat);
-        return;
+        return NULL;
     }
 
     size_t idx = 0;
@@ -243,39 +244,19 @@ void fbwl_ui_toolbar_build_iconbar(struct fbwl_toolbar_ui *ui, const struct fbwl
         }
         selected[idx++] = view;
     }
-    icon_count = idx;
-    if (icon_count == 0) {
-        fbwl_iconbar_pattern_free(&pat);
+    fbwl_iconbar_pattern_free(&pat);
+    if (idx == 0) {
         free(selected);
-        return;
+        return NULL;
     }
     if (static_order) {
-        qsort(selected, icon_count, sizeof(*selected), view_create_seq_cmp);
-    }
-
-    ui->iconbar_views = calloc(icon_count, sizeof(*ui->iconbar_views));
-    ui->iconbar_texts = calloc(icon_count, sizeof(*ui->iconbar_texts));
-    ui->iconbar_item_lx = calloc(icon_count, sizeof(*ui->iconbar_item_lx));
-    ui->iconbar_item_w = calloc(icon_count, sizeof(*ui->iconbar_item_w));
-    ui->iconbar_bgs = calloc(icon_count, sizeof(*ui->iconbar_bgs));
-    ui->iconbar_labels = calloc(icon_count, sizeof(*ui->iconbar_labels));
-    ui->iconbar_needs_tooltip = calloc(icon_count, sizeof(*ui->iconbar_needs_tooltip));
-    if (ui->iconbar_views == NULL || ui->iconbar_texts == NULL || ui->iconbar_item_lx == NULL || ui->iconbar_item_w == NULL ||
-            ui->iconbar_bgs == NULL || ui->iconbar_labels == NULL || ui->iconbar_needs_tooltip == NULL) {
-        iconbar_alloc_fail_cleanup(ui);
-        fbwl_iconbar_pattern_free(&pat);
-        free(selected);
-        return;
-    }
-
-    ui->iconbar_count = icon_count;
-    const float alpha = (float)ui->alpha / 255.0f;
-
-    int pad = ui->iconbar_icon_text_padding_px;
-    if (pad < 0) {
-        pad = 0;
+        qsort(selected, idx, sizeof(*selected), view_create_seq_cmp);
     }
+    *out_count = idx;
+    return selected;
+}
 
+static int iconbar_icon_px(const struct fbwl_toolbar_ui *ui) {
     int icon_px = ui->thickness >= 18 ? ui->thickness - 8 : ui->thickness;
     if (icon_px < 8) {
         icon_px = 8;
@@ -286,32 +267,19 @@ void fbwl_ui_toolbar_build_iconbar(struct fbwl_toolbar_ui *ui, const struct fbwl
     if (icon_px > 64) {
         icon_px = 64;
     }
+    return icon_px;
+}
 
-    enum fbwl_iconbar_alignment align = ui->iconbar_alignment;
+static int iconbar_text_pad(const struct fbwl_toolbar_ui *ui) {
+    return ui->iconbar_icon_text_padding_px > 0 ? ui->iconbar_icon_text_padding_px : 0;
+}
 
-    const int cross = ui->border_w + ui->bevel_w;
-    const int bg_w = vertical ? ui->thickness : ui->iconbar_w;
-    const int bg_h = vertical ? ui->iconbar_w : ui->thickness;
-    ui->iconbar_bg = wlr_scene_buffer_create(ui->tree, NULL);
-    if (ui->iconbar_bg != NULL) {
-        const int base_x = vertical ? cross : ui->iconbar_x;
-        const int base_y = vertical ? ui->iconbar_x : cross;
-        wlr_scene_node_set_position(&ui->iconbar_bg->node, base_x, base_y);
-        const struct fbwl_texture *tex = env->decor_theme != NULL ? &env->decor_theme->toolbar_iconbar_empty_tex : NULL;
-        const bool parentrel = fbwl_texture_is_parentrelative(tex);
-        if (tex != NULL && !parentrel) {
-            struct wlr_buffer *buf = fbwl_texture_render_buffer(tex, bg_w > 0 ? bg_w : 1, bg_h > 0 ? bg_h : 1);
-            buf = fbwl_ui_toolbar_shaped_mask_buffer_owned(ui->placement, env->decor_theme, buf, base_x, base_y, ui->width, ui->height);
-            wlr_scene_buffer_set_buffer(ui->iconbar_bg, buf);
-            if (buf != NULL) {
-                wlr_buffer_drop(buf);
-            }
-            wlr_scene_buffer_set_dest_size(ui->iconbar_bg, bg_w > 0 ? bg_w : 1, bg_h > 0 ? bg_h : 1);
-            wlr_scene_buffer_set_opacity(ui->iconbar_bg, alpha);
-        } else {
-            wlr_scene_node_set_enabled(&ui->iconbar_bg->node, false);
-        }
-    }
+// Fills the slot (offset along the toolbar, width) of each selected view.
+static void iconbar_layout(const struct fbwl_toolbar_ui *ui, struct fbwl_view *const *selected, size_t icon_count,
+        int *out_lx, int *out_w) {
+    const int pad = iconbar_text_pad(ui);
+    const int icon_px = iconbar_icon_px(ui);
+    enum fbwl_iconbar_alignment align = ui->iconbar_alignment;
     int xoff = ui->iconbar_x;
     int base_w = 0;
     int rem = 0;
@@ -415,11 +383,6 @@ void fbwl_ui_toolbar_build_iconbar(struct fbwl_toolbar_ui *ui, const struct fbwl
     }
 
     for (size_t i = 0; i < icon_count; i++) {
-        struct fbwl_view *view = selected[i];
-        if (view == NULL) {
-            continue;
-        }
-
         int extra = 0;
         if (align == FBWL_ICONBAR_ALIGN_RELATIVE_SMART && smart_rounding_error > 0) {
             smart_rounding_error--;
@@ -437,115 +400,253 @@ void fbwl_ui_toolbar_build_iconbar(struct fbwl_toolbar_ui *ui, const struct fbwl
             iw = 1;
         }
 
-        ui->iconbar_views[i] = view;
-        ui->iconbar_item_lx[i] = xoff;
-        ui->iconbar_item_w[i] = iw;
-
-        const int w = vertical ? ui->thickness : iw;
-        const int h = vertical ? iw : ui->thickness;
-        const int base_x = vertical ? cross : xoff;
-        const int base_y = vertical ? xoff : cross;
-
-        ui->iconbar_bgs[i] = wlr_scene_buffer_create(ui->tree, NULL);
-        if (ui->iconbar_bgs[i] != NULL) {
-            wlr_scene_node_set_position(&ui->iconbar_bgs[i]->node, base_x, base_y);
-            const bool urgent = fbwl_view_is_urgent(view);
-            const bool focused_or_urgent = view == env->focused_view || urgent;
-            const struct fbwl_texture *tex = env->decor_theme != NULL
-                ? (focused_or_urgent ? &env->decor_theme->toolbar_iconbar_focused_tex : &env->decor_theme->toolbar_iconbar_unfocused_tex)
-                : NULL;
-            const bool parentrel = fbwl_texture_is_parentrelative(tex);
-            if (tex != NULL && !parentrel) {
-                struct wlr_buffer *buf = fbwl_texture_render_buffer(tex, w > 0 ? w : 1, h > 0 ? h : 1);
-                buf = fbwl_ui_toolbar_shaped_mask_buffer_owned(ui->placement, env->decor_theme, buf, base_x, base_y, ui->width, ui->height);
-                wlr_scene_buffer_set_buffer(ui->iconbar_bgs[i], buf);
-                if (buf != NULL) {
-                    wlr_buffer_drop(buf);
-                }
-                wlr_scene_buffer_set_dest_size(ui->iconbar_bgs[i], w > 0 ? w : 1, h > 0 ? h : 1);
-                wlr_scene_buffer_set_opacity(ui->iconbar_bgs[i], alpha);
-            } else {
-                wlr_scene_node_set_enabled(&ui->iconbar_bgs[i]->node, false);
-            }
-        }
+        out_lx[i] = xoff;
+        out_w[i] = iw;
+        xoff += iw;
+    }
 
-        char *label_text = iconbar_label_text(ui, view);
-        if (label_text == NULL) {
-            label_text = strdup(fbwl_view_display_title(view));
-        }
-        ui->iconbar_texts[i] = label_text;
+    free(smart_demands);
+}
 
-        bool icon_loaded = false;
-        int text_x = base_x;
-        int text_w = w;
+static void iconbar_bg_create(struct fbwl_toolbar_ui *ui, const struct fbwl_ui_toolbar_env *env, bool vertical) {
+    const float alpha = (float)ui->alpha / 255.0f;
+    const int cross = ui->border_w + ui->bevel_w;
+    const int bg_w = vertical ? ui->thickness : ui->iconbar_w;
+    const int bg_h = vertical ? ui->iconbar_w : ui->thickness;
+    ui->iconbar_bg = wlr_scene_buffer_create(ui->tree, NULL);
+    if (ui->iconbar_bg == NULL) {
+        return;
+    }
+    const int base_x = vertical ? cross : ui->iconbar_x;
+    const int base_y = vertical ? ui->iconbar_x : cross;
+    wlr_scene_node_set_position(&ui->iconbar_bg->node, base_x, base_y);
+    const struct fbwl_texture *tex = env->decor_theme != NULL ? &env->decor_theme->toolbar_iconbar_empty_tex : NULL;
+    const bool parentrel = fbwl_texture_is_parentrelative(tex);
+    if (tex != NULL && !parentrel) {
+        struct wlr_buffer *buf = fbwl_texture_render_buffer(tex, bg_w > 0 ? bg_w : 1, bg_h > 0 ? bg_h : 1);
+        buf = fbwl_ui_toolbar_shaped_mask_buffer_owned(ui->placement, env->decor_theme, buf, base_x, base_y, ui->width, ui->height);
+        wlr_scene_buffer_set_buffer(ui->iconbar_bg, buf);
+        if (buf != NULL) {
+            wlr_buffer_drop(buf);
+        }
+        wlr_scene_buffer_set_dest_size(ui->iconbar_bg, bg_w > 0 ? bg_w : 1, bg_h > 0 ? bg_h : 1);
+        wlr_scene_buffer_set_opacity(ui->iconbar_bg, alpha);
+    } else {
+        wlr_scene_node_set_enabled(&ui->iconbar_bg->node, false);
+    }
+}
 
-        if (ui->iconbar_use_pixmap) {
-            struct wlr_buffer *icon_buf = NULL;
+// Renders entry `i` (view and slot already filed) into its own subtree, so it
+// can later be dropped without touching its neighbours.
+static void iconbar_entry_create(struct fbwl_toolbar_ui *ui, const struct fbwl_ui_toolbar_env *env, bool vertical,
+        const float fg[4], size_t i) {
+    struct fbwl_view *view = ui->iconbar_views[i];
+    const int xoff = ui->iconbar_item_lx[i];
+    const int iw = ui->iconbar_item_w[i];
+    const float alpha = (float)ui->alpha / 255.0f;
+    const int pad = iconbar_text_pad(ui);
+    const int icon_px = iconbar_icon_px(ui);
+    const int cross = ui->border_w + ui->bevel_w;
 
-            if (view->type == FBWL_VIEW_XWAYLAND && env != NULL && env->xwayland != NULL) {
-                icon_buf = fbwl_xwayland_icon_buffer_create(env->xwayland, view->xwayland_surface, icon_px);
-            }
+    const int w = vertical ? ui->thickness : iw;
+    const int h = vertical ? iw : ui->thickness;
+    const int base_x = vertical ? cross : xoff;
+    const int base_y = vertical ? xoff : cross;
 
-            if (icon_buf == NULL) {
-                const char *icon_name = fbwl_view_app_id(view);
-                char *icon_path = fbwl_icon_theme_resolve_path(icon_name);
-                if (icon_path != NULL) {
-                    icon_buf = fbwl_ui_menu_icon_buffer_create(icon_path, icon_px);
-                    free(icon_path);
-                }
-            }
+    struct wlr_scene_tree *item = wlr_scene_tree_create(ui->tree);
+    ui->iconbar_items[i] = item;
+    if (item == NULL) {
+        return;
+    }
 
-            if (icon_buf != NULL) {
-                const int ix = base_x + pad;
-                const int iy = base_y + (h > icon_px ? (h - icon_px) / 2 : 0);
-                icon_buf = fbwl_ui_toolbar_shaped_mask_buffer_owned(ui->placement, env->decor_theme, icon_buf, ix, iy, ui->width, ui->height);
-                struct wlr_scene_buffer *sb_icon = wlr_scene_buffer_create(ui->tree, icon_buf);
-                if (sb_icon != NULL) {
-                    wlr_scene_node_set_position(&sb_icon->node, ix, iy);
-                    wlr_scene_buffer_set_dest_size(sb_icon, icon_px, icon_px);
-                    icon_loaded = true;
-                }
-                wlr_buffer_drop(icon_buf);
+    ui->iconbar_bgs[i] = wlr_scene_buffer_create(item, NULL);
+    if (ui->iconbar_bgs[i] != NULL) {
+        wlr_scene_node_set_position(&ui->iconbar_bgs[i]->node, base_x, base_y);
+        const bool urgent = fbwl_view_is_urgent(view);
+        const bool focused_or_urgent = view == env->focused_view || urgent;
+        const struct fbwl_texture *tex = env->decor_theme != NULL
+            ? (focused_or_urgent ? &env->decor_theme->toolbar_iconbar_focused_tex : &env->decor_theme->toolbar_iconbar_unfocused_tex)
+            : NULL;
+        const bool parentrel = fbwl_texture_is_parentrelative(tex);
+        if (tex != NULL && !parentrel) {
+            struct wlr_buffer *buf = fbwl_texture_render_buffer(tex, w > 0 ? w : 1, h > 0 ? h : 1);
+            buf = fbwl_ui_toolbar_shaped_mask_buffer_owned(ui->placement, env->decor_theme, buf, base_x, base_y, ui->width, ui->height);
+            wlr_scene_buffer_set_buffer(ui->iconbar_bgs[i], buf);
+            if (buf != NULL) {
+                wlr_buffer_drop(buf);
             }
+            wlr_scene_buffer_set_dest_size(ui->iconbar_bgs[i], w > 0 ? w : 1, h > 0 ? h : 1);
+            wlr_scene_buffer_set_opacity(ui->iconbar_bgs[i], alpha);
+        } else {
+            wlr_scene_node_set_enabled(&ui->iconbar_bgs[i]->node, false);
         }
+    }
+
+    char *label_text = iconbar_label_text(ui, view);
+    if (label_text == NULL) {
+        label_text = strdup(fbwl_view_display_title(view));
+    }
+    ui->iconbar_texts[i] = label_text;
+
+    bool icon_loaded = false;
+    int text_x = base_x;
+    int text_w = w;
 
-        if (icon_loaded) {
-            text_x = base_x + pad + icon_px;
-            text_w = w - (pad + icon_px);
-            if (text_w < 1) {
-                text_w = 1;
+    if (ui->iconbar_use_pixmap) {
+        struct wlr_buffer *icon_buf = fbwl_view_icon_buffer(view, icon_px);
+
+        if (icon_buf != NULL) {
+            const int ix = base_x + pad;
+            const int iy = base_y + (h > icon_px ? (h - icon_px) / 2 : 0);
+            icon_buf = fbwl_ui_toolbar_shaped_mask_buffer_owned(ui->placement, env->decor_theme, icon_buf, ix, iy, ui->width, ui->height);
+            struct wlr_scene_buffer *sb_icon = wlr_scene_buffer_create(item, icon_buf);
+            if (sb_icon != NULL) {
+                wlr_scene_node_set_position(&sb_icon->node, ix, iy);
+                wlr_scene_buffer_set_dest_size(sb_icon, icon_px, icon_px);
+                icon_loaded = true;
             }
+            wlr_buffer_drop(icon_buf);
         }
+    }
 
-        const struct fbwl_text_effect *effect = NULL;
-        int justify = 0;
-        if (env != NULL && env->decor_theme != NULL) {
-            const bool urgent = view != NULL && fbwl_view_is_urgent(view);
-            const bool focused_or_urgent = view != NULL && (view == env->focused_view || urgent);
-            effect = focused_or_urgent ? &env->decor_theme->toolbar_iconbar_focused_effect : &env->decor_theme->toolbar_iconbar_unfocused_effect;
-            justify = focused_or_urgent ? env->decor_theme->toolbar_iconbar_focused_justify : env->decor_theme->toolbar_iconbar_unfocused_justify;
+    if (icon_loaded) {
+        text_x = base_x + pad + icon_px;
+        text_w = w - (pad + icon_px);
+        if (text_w < 1) {
+            text_w = 1;
         }
-        struct wlr_buffer *buf = fbwl_text_buffer_create(label_text != NULL ? label_text : "", text_w, h, pad, fg, ui->font, effect, justify);
-        if (buf != NULL) {
-            buf = fbwl_ui_toolbar_shaped_mask_buffer_owned(ui->placement, env->decor_theme, buf, text_x, base_y, ui->width, ui->height);
-            struct wlr_scene_buffer *sb = wlr_scene_buffer_create(ui->tree, buf);
-            if (sb != NULL) {
-                wlr_scene_node_set_position(&sb->node, text_x, base_y);
-                ui->iconbar_labels[i] = sb;
-            }
-            wlr_buffer_drop(buf);
+    }
+
+    const struct fbwl_text_effect *effect = NULL;
+    int justify = 0;
+    if (env->decor_theme != NULL) {
+        const bool urgent = view != NULL && fbwl_view_is_urgent(view);
+        const bool focused_or_urgent = view != NULL && (view == env->focused_view || urgent);
+        effect = focused_or_urgent ? &env->decor_theme->toolbar_iconbar_focused_effect : &env->decor_theme->toolbar_iconbar_unfocused_effect;
+        justify = focused_or_urgent ? env->decor_theme->toolbar_iconbar_focused_justify : env->decor_theme->toolbar_iconbar_unfocused_justify;
+    }
+    struct wlr_buffer *buf = fbwl_text_buffer_create(label_text != NULL ? label_text : "", text_w, h, pad, fg, ui->font, effect, justify);
+    if (buf != NULL) {
+        buf = fbwl_ui_toolbar_shaped_mask_buffer_owned(ui->placement, env->decor_theme, buf, text_x, base_y, ui->width, ui->height);
+        struct wlr_scene_buffer *sb = wlr_scene_buffer_create(item, buf);
+        if (sb != NULL) {
+            wlr_scene_node_set_position(&sb->node, text_x, base_y);
+            ui->iconbar_labels[i] = sb;
         }
+        wlr_buffer_drop(buf);
+    }
 
-        ui->iconbar_needs_tooltip[i] = !fbwl_text_fits(label_text, text_w, h, pad, ui->font);
+    ui->iconbar_needs_tooltip[i] = !fbwl_text_fits(label_text, text_w, h, pad, ui->font);
 
-        wlr_log(WLR_INFO, "Toolbar: iconbar item idx=%zu lx=%d w=%d title=%s minimized=%d label=%s icon=%d",
-            i, xoff, iw, fbwl_view_display_title(view), view->minimized ? 1 : 0,
-            label_text != NULL ? label_text : "", icon_loaded ? 1 : 0);
+    fbwl_trace(FBWL_TRACE_TOOLBAR, "Toolbar: iconbar item idx=%zu lx=%d w=%d title=%s minimized=%d label=%s icon=%d",
+        i, xoff, iw, fbwl_view_display_title(view), view->minimized ? 1 : 0,
+        label_text != NULL ? label_text : "", icon_loaded ? 1 : 0);
+}
 
-        xoff += iw;
+static bool iconbar_shown(const struct fbwl_toolbar_ui *ui) {
+    return (ui->tools & FBWL_TOOLBAR_TOOL_ICONBAR) != 0 && ui->iconbar_w >= 1;
+}
+
+void fbwl_ui_toolbar_build_iconbar(struct fbwl_toolbar_ui *ui, const struct fbwl_ui_toolbar_env *env,
+        bool vertical, const float fg[4]) {
+    if (ui == NULL || env == NULL || env->wm == NULL || ui->tree == NULL) {
+        return;
+    }
+    if (!iconbar_shown(ui)) {
+        return;
     }
 
-    fbwl_iconbar_pattern_free(&pat);
-    free(smart_demands);
+    size_t icon_count = 0;
+    struct fbwl_view **selected = iconbar_select(ui, env, &icon_count);
+    if (selected == NULL) {
+        return;
+    }
+    if (!iconbar_arrays_alloc(ui, icon_count)) {
+        free(selected);
+        return;
+    }
+    memcpy(ui->iconbar_views, selected, icon_count * sizeof(*selected));
+    free(selected);
+    iconbar_layout(ui, ui->iconbar_views, icon_count, ui->iconbar_item_lx, ui->iconbar_item_w);
+
+    iconbar_bg_create(ui, env, vertical);
+    for (size_t i = 0; i < icon_count; i++) {
+        iconbar_entry_create(ui, env, vertical, fg, i);
+    }
+}
+
+bool fbwl_ui_toolbar_update_iconbar(struct fbwl_toolbar_ui *ui, const struct fbwl_ui_toolbar_env *env,
+        bool vertical, const float fg[4]) {
+    if (ui == NULL || env == NULL || env->wm == NULL || ui->tree == NULL) {
+        return false;
+    }
+    if (!iconbar_shown(ui)) {
+        return true;
+    }
+
+    size_t icon_count = 0;
+    struct fbwl_view **selected = iconbar_select(ui, env, &icon_count);
+
+    // `old` only owns the previous entry arrays; everything else in it is a
+    // plain copy that is never written back.
+    struct fbwl_toolbar_ui old = *ui;
+    iconbar_arrays_forget(ui);
+    if (icon_count > 0) {
+        if (!iconbar_arrays_alloc(ui, icon_count)) {
+            *ui = old;
+            free(selected);
+            return false;
+        }
+        memcpy(ui->iconbar_views, selected, icon_count * sizeof(*selected));
+        iconbar_layout(ui, ui->iconbar_views, icon_count, ui->iconbar_item_lx, ui->iconbar_item_w);
+    }
     free(selected);
+
+    // An entry survives when the same view lands in the same slot; the rest
+    // of the old entries belong to views that left (or shifted) and go.
+    size_t kept = 0;
+    for (size_t i = 0; i < icon_count; i++) {
+        for (size_t j = 0; j < old.iconbar_count; j++) {
+            if (old.iconbar_items[j] == NULL || old.iconbar_views[j] != ui->iconbar_views[i] ||
+                    old.iconbar_item_lx[j] != ui->iconbar_item_lx[i] || old.iconbar_item_w[j] != ui->iconbar_item_w[i]) {
+                continue;
+            }
+            ui->iconbar_items[i] = old.iconbar_items[j];
+            ui->iconbar_bgs[i] = old.iconbar_bgs[j];
+            ui->iconbar_labels[i] = old.iconbar_labels[j];
+            ui->iconbar_texts[i] = old.iconbar_texts[j];
+            ui->iconbar_needs_tooltip[i] = old.iconbar_needs_tooltip[j];
+            old.iconbar_items[j] = NULL;
+            old.iconbar_texts[j] = NULL;
+            kept++;
+            break;
+        }
+    }
+    for (size_t j = 0; j < old.iconbar_count; j++) {
+        if (old.iconbar_items[j] != NULL) {
+            wlr_scene_node_destroy(&old.iconbar_items[j]->node);
+        }
+        free(old.iconbar_texts[j]);
+    }
+    const size_t removed = old.iconbar_count - kept;
+    iconbar_arrays_free(&old);
+
+    if (icon_count == 0 && ui->iconbar_bg != NULL) {
+        wlr_scene_node_destroy(&ui->iconbar_bg->node);
+        ui->iconbar_bg = NULL;
+    } else if (icon_count > 0 && ui->iconbar_bg == NULL) {
+        iconbar_bg_create(ui, env, vertical);
+        if (ui->iconbar_bg != NULL && ui->bg != NULL) {
+            wlr_scene_node_place_above(&ui->iconbar_bg->node, &ui->bg->node);
+        }
+    }
+    for (size_t i = 0; i < icon_count; i++) {
+        if (ui->iconbar_items[i] == NULL) {
+            iconbar_entry_create(ui, env, vertical, fg, i);
+        }
+    }
+
+    fbwl_trace(FBWL_TRACE_TOOLBAR, "Toolbar: iconbar updated count=%zu kept=%zu added=%zu removed=%zu",
+        icon_count, kept, icon_count - kept, removed);
+    return true;
 }
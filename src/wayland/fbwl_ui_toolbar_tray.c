@@ -7,6 +7,7 @@
 #include <wlr/types/wlr_scene.h>
 #include <wlr/util/log.h>
 
+#include "wayland/fbwl_trace.h"
 #include "wayland/fbwl_ui_decor_theme.h"
 #include "wayland/fbwl_ui_toolbar.h"
 #include "wayland/fbwl_ui_toolbar_shape.h"
@@ -132,7 +133,7 @@ void fbwl_ui_toolbar_build_tray(struct fbwl_toolbar_ui *ui, const struct fbwl_ui
                 wlr_scene_node_set_position(&ui->tray_icons[idx]->node, ix, iy);
                 wlr_scene_buffer_set_dest_size(ui->tray_icons[idx], size, size);
             }
-            wlr_log(WLR_INFO, "Toolbar: tray item idx=%zu lx=%d w=%d id=%s item_id=%s",
+            fbwl_trace(FBWL_TRACE_TOOLBAR, "Toolbar: tray item idx=%zu lx=%d w=%d id=%s item_id=%s",
                 idx, xoff, ui->tray_icon_w, sni->id != NULL ? sni->id : "",
                 sni->item_id != NULL ? sni->item_id : "");
             xoff += ui->tray_icon_w;
@@ -143,3 +144,64 @@ void fbwl_ui_toolbar_build_tray(struct fbwl_toolbar_ui *ui, const struct fbwl_ui
     ui->tray_count = idx;
 #endif
 }
+
+bool fbwl_ui_toolbar_update_tray(struct fbwl_toolbar_ui *ui, const struct fbwl_ui_toolbar_env *env) {
+    if (ui == NULL || env == NULL || ui->tree == NULL) {
+        return false;
+    }
+
+#ifndef HAVE_SYSTEMD
+    return false;
+#else
+    if (env->sni == NULL || env->sni->items.prev == NULL || env->sni->items.next == NULL) {
+        return false;
+    }
+    const int len = wl_list_length(&env->sni->items);
+    if (len < 1) {
+        return ui->tray_count == 0;
+    }
+    if (ui->tray_count > 0 && (ui->tray_ids == NULL || ui->tray_icons == NULL)) {
+        return false;
+    }
+
+    struct fbwl_sni_item **items = calloc((size_t)len, sizeof(*items));
+    if (items == NULL) {
+        return false;
+    }
+    const size_t ordered = fbwl_sni_pin_order_items(env->sni, items, (size_t)len, ui->systray_pin_left,
+        ui->systray_pin_left_len, ui->systray_pin_right, ui->systray_pin_right_len);
+
+    // Only icon buffers may differ; any change to which items show, or in
+    // which order, needs the full toolbar layout.
+    size_t idx = 0;
+    bool same = true;
+    for (size_t i = 0; i < ordered && same; i++) {
+        const struct fbwl_sni_item *sni = items[i];
+        if (sni->status == FBWL_SNI_STATUS_PASSIVE) {
+            continue;
+        }
+        same = idx < ui->tray_count && ui->tray_icons[idx] != NULL &&
+            strcmp(ui->tray_ids[idx] != NULL ? ui->tray_ids[idx] : "", sni->id != NULL ? sni->id : "") == 0;
+        idx++;
+    }
+    if (!same || idx != ui->tray_count) {
+        free(items);
+        return false;
+    }
+
+    idx = 0;
+    for (size_t i = 0; i < ordered; i++) {
+        const struct fbwl_sni_item *sni = items[i];
+        if (sni->status == FBWL_SNI_STATUS_PASSIVE) {
+            continue;
+        }
+        if (ui->tray_icons[idx]->buffer != sni->icon_buf) {
+            wlr_scene_buffer_set_buffer(ui->tray_icons[idx], sni->icon_buf);
+        }
+        idx++;
+    }
+    free(items);
+    fbwl_trace(FBWL_TRACE_TOOLBAR, "Toolbar: tray icons updated count=%zu", ui->tray_count);
+    return true;
+#endif
+}
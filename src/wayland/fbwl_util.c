@@ -40,6 +40,24 @@ void fbwl_cleanup_fd(int *fd) {
     }
 }
 
+char *fbwl_trim_inplace(char *s) {
+    if (s == NULL) {
+        return NULL;
+    }
+    while (*s != '\0' && isspace((unsigned char)*s)) {
+        s++;
+    }
+    if (*s == '\0') {
+        return s;
+    }
+    char *end = s + strlen(s) - 1;
+    while (end > s && isspace((unsigned char)*end)) {
+        *end = '\0';
+        end--;
+    }
+    return s;
+}
+
 bool fbwl_parse_hex_color(const char *s, float rgba[static 4]) {
     if (s == NULL || rgba == NULL) {
         return false;
@@ -328,17 +346,6 @@ bool fbwl_parse_color(const char *s, float rgba[static 4]) {
     return false;
 }
 
-void fbwl_spawn(const char *cmd) {
-    if (cmd == NULL || *cmd == '\0') {
-        return;
-    }
-    pid_t pid = fork();
-    if (pid == 0) {
-        execl("/bin/sh", "/bin/sh", "-c", cmd, (void *)NULL);
-        _exit(127);
-    }
-}
-
 uint64_t fbwl_now_msec(void) {
     struct timespec ts;
     clock_gettime(CLOCK_MONOTONIC, &ts);
@@ -447,10 +454,30 @@ static bool pseudo_bg_compute_wallpaper_src_box(enum fbwl_wallpaper_mode wallpap
     return true;
 }
 
+static uint64_t pseudo_bg_generation = 1;
+
+uint64_t fbwl_pseudo_bg_generation(void) {
+    return pseudo_bg_generation;
+}
+
+void fbwl_pseudo_bg_invalidate_all(void) {
+    pseudo_bg_generation++;
+}
+
+bool fbwl_pseudo_bg_key_matches(const struct fbwl_pseudo_bg_key *a, const struct fbwl_pseudo_bg_key *b) {
+    return a->valid && a->generation == b->generation && a->parent == b->parent &&
+        a->wallpaper_buf == b->wallpaper_buf && a->wallpaper_mode == b->wallpaper_mode &&
+        a->global_x == b->global_x && a->global_y == b->global_y &&
+        a->rel_x == b->rel_x && a->rel_y == b->rel_y &&
+        a->width == b->width && a->height == b->height &&
+        a->color[0] == b->color[0] && a->color[1] == b->color[1] && a->color[2] == b->color[2];
+}
+
 void fbwl_pseudo_bg_destroy(struct fbwl_pseudo_bg *bg) {
     if (bg == NULL) {
         return;
     }
+    bg->key.valid = false;
     if (bg->image != NULL) {
         wlr_scene_node_destroy(&bg->image->node);
         bg->image = NULL;
@@ -492,6 +519,40 @@ void fbwl_pseudo_bg_update(struct fbwl_pseudo_bg *bg,
         }
     }
 
+    struct fbwl_pseudo_bg_key key = {
+        .valid = true,
+        .generation = pseudo_bg_generation,
+        .parent = parent,
+        .wallpaper_buf = output_layout != NULL ? use_wallpaper_buf : NULL,
+        .wallpaper_mode = wallpaper_mode,
+        .global_x = global_x,
+        .global_y = global_y,
+        .rel_x = rel_x,
+        .rel_y = rel_y,
+        .width = width,
+        .height = height,
+    };
+    if (background_color != NULL) {
+        key.color[0] = background_color[0];
+        key.color[1] = background_color[1];
+        key.color[2] = background_color[2];
+    }
+    if (fbwl_pseudo_bg_key_matches(&bg->key, &key)) {
+        // Same region of the same wallpaper: only keep the stacking, which
+        // is a no-op unless something was inserted below it since.
+        if (bg->rect != NULL) {
+            wlr_scene_node_lower_to_bottom(&bg->rect->node);
+        }
+        if (bg->image != NULL && bg->rect != NULL) {
+            wlr_scene_node_raise_to_top(&bg->image->node);
+        } else if (bg->image != NULL) {
+            wlr_scene_node_lower_to_bottom(&bg->image->node);
+        }
+        return;
+    }
+    bg->key = key;
+    bg->key.valid = false;
+
     if (use_wallpaper_buf != NULL && output_layout != NULL && wallpaper_mode == FBWL_WALLPAPER_MODE_CENTER) {
         float color[4] = {0};
         if (background_color != NULL) {
@@ -576,6 +637,7 @@ void fbwl_pseudo_bg_update(struct fbwl_pseudo_bg *bg,
             .height = (double)ih,
         };
         wlr_scene_buffer_set_source_box(bg->image, &src);
+        bg->key.valid = true;
 
         return;
 
@@ -584,6 +646,7 @@ center_done:
             wlr_scene_node_destroy(&bg->image->node);
             bg->image = NULL;
         }
+        bg->key.valid = true;
         return;
     }
 
@@ -616,6 +679,7 @@ center_done:
         } else {
             wlr_scene_buffer_set_source_box(bg->image, NULL);
         }
+        bg->key.valid = true;
 
         return;
     }
@@ -649,6 +713,7 @@ center_done:
     }
     wlr_scene_node_set_position(&bg->rect->node, rel_x, rel_y);
     wlr_scene_node_lower_to_bottom(&bg->rect->node);
+    bg->key.valid = true;
 }
 
 struct view_pseudo_bg_bounds {
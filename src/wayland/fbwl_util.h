@@ -9,5 +9,6 @@ void fbwl_cleanup_listener(struct wl_listener *listener);
 void fbwl_cleanup_fd(int *fd);
 bool fbwl_parse_hex_color(const char *s, float rgba[static 4]);
 bool fbwl_parse_color(const char *s, float rgba[static 4]);
-void fbwl_spawn(const char *cmd);
 uint64_t fbwl_now_msec(void);
+// Strips leading/trailing whitespace in place; returns the new start.
+char *fbwl_trim_inplace(char *s);
@@ -14,8 +14,7 @@
 #include <wlr/xwayland.h>
 #include <xcb/xcb_icccm.h>
 #include "wmcore/fbwm_output.h"
-#include "wayland/fbwl_output.h"
-#include "wayland/fbwl_screen_map.h"
+#include "wayland/fbwl_output_usable.h"
 #include "wayland/fbwl_server_internal.h"
 #include "wayland/fbwl_tabs.h"
 #include "wayland/fbwl_ui_decor_theme.h"
@@ -285,185 +284,6 @@ void fbwl_view_get_output_box(const struct fbwl_view *view, struct wlr_output_la
     }
     wlr_output_layout_get_box(output_layout, output, box);
 }
-static void apply_toolbar_strut_box(const struct fbwl_server *server, struct wlr_output_layout *output_layout,
-        struct wl_list *outputs, struct wlr_output *output, struct wlr_box *box) {
-    if (server == NULL || output_layout == NULL || outputs == NULL || output == NULL || box == NULL) {
-        return;
-    }
-    if (box->width < 1 || box->height < 1) {
-        return;
-    }
-    if (!server->toolbar_ui.enabled || server->toolbar_ui.max_over || server->toolbar_ui.auto_hide) { return; }
-    const size_t on_head = server->toolbar_ui.on_head >= 0 ? (size_t)server->toolbar_ui.on_head : 0;
-    struct wlr_output *toolbar_out = fbwl_screen_map_output_for_screen(output_layout, outputs, on_head);
-    if (toolbar_out == NULL || toolbar_out != output) {
-        return;
-    }
-    int thickness = server->toolbar_ui.thickness;
-    if (thickness < 1) {
-        thickness = server->toolbar_ui.height_override;
-        if (thickness <= 0) {
-            thickness = server->decor_theme.toolbar_height > 0 ? server->decor_theme.toolbar_height :
-                (server->decor_theme.title_height > 0 ? server->decor_theme.title_height : 24);
-        }
-    }
-    if (thickness < 1) thickness = 1;
-    int border_w = server->decor_theme.toolbar_border_width;
-    if (border_w < 0) border_w = 0;
-    if (border_w > 20) border_w = 20;
-    int bevel_w = server->decor_theme.toolbar_bevel_width;
-    if (bevel_w < 0) bevel_w = 0;
-    if (bevel_w > 20) bevel_w = 20;
-    int t = thickness + 2 * bevel_w + 2 * border_w;
-    if (t < 1) return;
-    switch (server->toolbar_ui.placement) {
-    case FBWL_TOOLBAR_PLACEMENT_TOP_LEFT:
-    case FBWL_TOOLBAR_PLACEMENT_TOP_CENTER:
-    case FBWL_TOOLBAR_PLACEMENT_TOP_RIGHT:
-        if (box->height <= t) {
-            box->height = 0;
-            return;
-        }
-        box->y += t;
-        box->height -= t;
-        break;
-    case FBWL_TOOLBAR_PLACEMENT_BOTTOM_LEFT:
-    case FBWL_TOOLBAR_PLACEMENT_BOTTOM_CENTER:
-    case FBWL_TOOLBAR_PLACEMENT_BOTTOM_RIGHT:
-        if (box->height <= t) {
-            box->height = 0;
-            return;
-        }
-        box->height -= t;
-        break;
-    case FBWL_TOOLBAR_PLACEMENT_LEFT_BOTTOM:
-    case FBWL_TOOLBAR_PLACEMENT_LEFT_CENTER:
-    case FBWL_TOOLBAR_PLACEMENT_LEFT_TOP:
-        if (box->width <= t) {
-            box->width = 0;
-            return;
-        }
-        box->x += t;
-        box->width -= t;
-        break;
-    case FBWL_TOOLBAR_PLACEMENT_RIGHT_BOTTOM:
-    case FBWL_TOOLBAR_PLACEMENT_RIGHT_CENTER:
-    case FBWL_TOOLBAR_PLACEMENT_RIGHT_TOP:
-        if (box->width <= t) {
-            box->width = 0;
-            return;
-        }
-        box->width -= t;
-        break;
-    }
-}
-
-static void apply_slit_strut_box(const struct fbwl_server *server, struct wlr_output_layout *output_layout,
-        struct wl_list *outputs, struct wlr_output *output, struct wlr_box *box) {
-    if (server == NULL || output_layout == NULL || outputs == NULL || output == NULL || box == NULL) {
-        return;
-    }
-    if (box->width < 1 || box->height < 1) {
-        return;
-    }
-    if (!server->slit_ui.enabled || server->slit_ui.max_over || server->slit_ui.auto_hide) {
-        return;
-    }
-
-    const size_t on_head = server->slit_ui.on_head >= 0 ? (size_t)server->slit_ui.on_head : 0;
-    struct wlr_output *slit_out = fbwl_screen_map_output_for_screen(output_layout, outputs, on_head);
-    if (slit_out == NULL || slit_out != output) {
-        return;
-    }
-
-    const enum fbwl_toolbar_placement placement = server->slit_ui.placement;
-    const int t = placement == FBWL_TOOLBAR_PLACEMENT_LEFT_BOTTOM || placement == FBWL_TOOLBAR_PLACEMENT_LEFT_CENTER ||
-            placement == FBWL_TOOLBAR_PLACEMENT_LEFT_TOP || placement == FBWL_TOOLBAR_PLACEMENT_RIGHT_BOTTOM ||
-            placement == FBWL_TOOLBAR_PLACEMENT_RIGHT_CENTER || placement == FBWL_TOOLBAR_PLACEMENT_RIGHT_TOP ?
-        server->slit_ui.width : server->slit_ui.height;
-    if (t < 1) {
-        return;
-    }
-    switch (server->slit_ui.placement) {
-    case FBWL_TOOLBAR_PLACEMENT_TOP_LEFT:
-    case FBWL_TOOLBAR_PLACEMENT_TOP_CENTER:
-    case FBWL_TOOLBAR_PLACEMENT_TOP_RIGHT:
-        if (box->height <= t) {
-            box->height = 0;
-            return;
-        }
-        box->y += t;
-        box->height -= t;
-        break;
-    case FBWL_TOOLBAR_PLACEMENT_BOTTOM_LEFT:
-    case FBWL_TOOLBAR_PLACEMENT_BOTTOM_CENTER:
-    case FBWL_TOOLBAR_PLACEMENT_BOTTOM_RIGHT:
-        if (box->height <= t) {
-            box->height = 0;
-            return;
-        }
-        box->height -= t;
-        break;
-    case FBWL_TOOLBAR_PLACEMENT_LEFT_BOTTOM:
-    case FBWL_TOOLBAR_PLACEMENT_LEFT_CENTER:
-    case FBWL_TOOLBAR_PLACEMENT_LEFT_TOP:
-        if (box->width <= t) {
-            box->width = 0;
-            return;
-        }
-        box->x += t;
-        box->width -= t;
-        break;
-    case FBWL_TOOLBAR_PLACEMENT_RIGHT_BOTTOM:
-    case FBWL_TOOLBAR_PLACEMENT_RIGHT_CENTER:
-    case FBWL_TOOLBAR_PLACEMENT_RIGHT_TOP:
-        if (box->width <= t) {
-            box->width = 0;
-            return;
-        }
-        box->width -= t;
-        break;
-    }
-}
-
-static void apply_configured_struts_box(const struct fbwl_server *server, struct wlr_output_layout *output_layout,
-        struct wl_list *outputs, struct wlr_output *output, struct wlr_box *box) {
-    if (server == NULL || output_layout == NULL || outputs == NULL || output == NULL || box == NULL) {
-        return;
-    }
-    if (box->width < 1 || box->height < 1) {
-        return;
-    }
-
-    bool found = false;
-    const size_t screen = fbwl_screen_map_screen_for_output(output_layout, outputs, output, &found);
-    const struct fbwl_screen_config *cfg = fbwl_server_screen_config(server, found ? screen : 0);
-    if (cfg == NULL) {
-        return;
-    }
-
-    int l = cfg->struts.left_px;
-    int r = cfg->struts.right_px;
-    int t = cfg->struts.top_px;
-    int b = cfg->struts.bottom_px;
-    if (l < 0) { l = 0; }
-    if (r < 0) { r = 0; }
-    if (t < 0) { t = 0; }
-    if (b < 0) { b = 0; }
-
-    const int64_t w = box->width;
-    const int64_t h = box->height;
-    if ((int64_t)l + (int64_t)r >= w || (int64_t)t + (int64_t)b >= h) {
-        box->width = 0;
-        box->height = 0;
-        return;
-    }
-
-    box->x += l;
-    box->y += t;
-    box->width -= l + r;
-    box->height -= t + b;
-}
 void fbwl_view_get_output_usable_box(const struct fbwl_view *view, struct wlr_output_layout *output_layout,
         struct wl_list *outputs, struct wlr_output *preferred, struct wlr_box *box) {
     *box = (struct wlr_box){0};
@@ -484,18 +304,7 @@ void fbwl_view_get_output_usable_box(const struct fbwl_view *view, struct wlr_ou
     if (output == NULL) {
         return;
     }
-    struct fbwl_output *out = fbwl_output_find(outputs, output);
-    if (out != NULL && out->usable_area.width > 0 && out->usable_area.height > 0) {
-        *box = out->usable_area;
-        apply_toolbar_strut_box(view->server, output_layout, outputs, output, box);
-        apply_slit_strut_box(view->server, output_layout, outputs, output, box);
-        apply_configured_struts_box(view->server, output_layout, outputs, output, box);
-        return;
-    }
-    wlr_output_layout_get_box(output_layout, output, box);
-    apply_toolbar_strut_box(view->server, output_layout, outputs, output, box);
-    apply_slit_strut_box(view->server, output_layout, outputs, output, box);
-    apply_configured_struts_box(view->server, output_layout, outputs, output, box);
+    fbwl_output_usable_box(view->server, output_layout, outputs, output, box);
 }
 
 void fbwl_view_apply_tabs_maxover_box(const struct fbwl_view *view, struct wlr_box *box) {
@@ -650,14 +459,8 @@ static bool fbwl_wm_output_usable_box(const struct fbwm_output *wm_output, struc
     if (output == NULL || output->outputs == NULL || output->wlr_output == NULL || out == NULL) {
         return false;
     }
-    struct fbwl_output *out_data = fbwl_output_find(output->outputs, output->wlr_output);
-    if (out_data == NULL || out_data->usable_area.width < 1 || out_data->usable_area.height < 1) {
-        return false;
-    }
-    struct wlr_box box = out_data->usable_area;
-    apply_toolbar_strut_box(output->server, output->output_layout, output->outputs, output->wlr_output, &box);
-    apply_slit_strut_box(output->server, output->output_layout, output->outputs, output->wlr_output, &box);
-    apply_configured_struts_box(output->server, output->output_layout, output->outputs, output->wlr_output, &box);
+    struct wlr_box box = {0};
+    fbwl_output_usable_box(output->server, output->output_layout, output->outputs, output->wlr_output, &box);
     if (box.width < 1 || box.height < 1) {
         return false;
     }
@@ -9,6 +9,7 @@
 
 #include "wmcore/fbwm_core.h"
 #include "wayland/fbwl_pseudo_bg.h"
+#include "wayland/fbwl_view_icon.h"
 
 struct fbwl_decor_theme;
 struct fbwl_server;
@@ -61,6 +62,10 @@ struct fbwl_view {
     struct wlr_scene_tree *decor_tree;
     struct fbwl_pseudo_bg decor_titlebar_pseudo_bg;
     struct wlr_scene_buffer *decor_titlebar_tex;
+    struct fbwl_pseudo_bg_key decor_titlebar_masked_key;
+    uint32_t decor_titlebar_masked_round;
+    int decor_titlebar_masked_frame_w;
+    int decor_titlebar_masked_frame_h;
     struct wlr_scene_rect *decor_titlebar;
     struct wlr_scene_buffer *decor_label_tex;
     struct wlr_scene_rect *decor_label;
@@ -138,6 +143,7 @@ struct fbwl_view {
     struct wl_listener xwayland_set_class;
     struct wl_listener xwayland_set_role;
     struct wl_listener xwayland_set_hints;
+    struct wl_listener xwayland_set_icon;
 
     struct wlr_foreign_toplevel_handle_v1 *foreign_toplevel;
     struct wlr_output *foreign_output;
@@ -188,6 +194,13 @@ struct fbwl_view {
     bool tabs_enabled_override;
 
     bool in_slit;
+
+    bool session_restore_pending;
+    bool session_restored;
+    int session_group;
+    int session_stack;
+
+    struct fbwl_view_icon_cache icon_cache;
 };
 
 enum fbwl_decor_hit_kind {
@@ -265,6 +278,8 @@ void fbwl_view_set_maximized(struct fbwl_view *view, bool maximized, struct wlr_
         struct wl_list *outputs);
 void fbwl_view_set_maximized_axes(struct fbwl_view *view, bool maximized_h, bool maximized_v,
         struct wlr_output_layout *output_layout, struct wl_list *outputs);
+void fbwl_view_refit_maximized(struct fbwl_view *view, struct wlr_output_layout *output_layout,
+        struct wl_list *outputs);
 void fbwl_view_set_fullscreen(struct fbwl_view *view, bool fullscreen, struct wlr_output_layout *output_layout,
         struct wl_list *outputs, struct wlr_scene_tree *layer_normal, struct wlr_scene_tree *layer_fullscreen,
         struct wlr_output *output);
@@ -178,6 +178,7 @@ void fbwl_view_decor_update(struct fbwl_view *view, const struct fbwl_decor_them
     const bool title_parentrel = fbwl_texture_is_parentrelative(title_tex);
     const bool title_use_rect = fbwl_view_decor_texture_can_use_flat_rect(title_tex);
     bool title_use_buffer = show_titlebar && !title_use_rect && !title_parentrel;
+    bool title_masked_cached = false;
     if (round_on) {
         if (view->decor_titlebar != NULL) {
             wlr_scene_node_set_enabled(&view->decor_titlebar->node, false);
@@ -189,8 +190,43 @@ void fbwl_view_decor_update(struct fbwl_view *view, const struct fbwl_decor_them
                 const int off_y = -frame_title_h - frame_y;
                 struct wlr_buffer *buf = NULL;
                 if (title_parentrel) {
-                    buf = fbwl_view_decor_wallpaper_region_buffer_masked(view->server, view->x, view->y - frame_title_h, w, frame_title_h,
-                        round_mask, off_x, off_y, frame_w, frame_h);
+                    // The rounded mask needs its own copy of the wallpaper
+                    // region; keep it while region and wallpaper are the same.
+                    const struct fbwl_server *server = view->server;
+                    struct fbwl_pseudo_bg_key key = {
+                        .valid = true,
+                        .generation = fbwl_pseudo_bg_generation(),
+                        .parent = view->decor_tree,
+                        .wallpaper_buf = server != NULL ? server->wallpaper_buf : NULL,
+                        .wallpaper_mode = server != NULL ? server->wallpaper_mode : FBWL_WALLPAPER_MODE_STRETCH,
+                        .global_x = view->x,
+                        .global_y = view->y - frame_title_h,
+                        .rel_x = off_x,
+                        .rel_y = off_y,
+                        .width = w,
+                        .height = frame_title_h,
+                    };
+                    if (server != NULL) {
+                        key.color[0] = server->background_color[0];
+                        key.color[1] = server->background_color[1];
+                        key.color[2] = server->background_color[2];
+                    }
+                    title_masked_cached = view->decor_titlebar_tex->buffer != NULL &&
+                        fbwl_pseudo_bg_key_matches(&view->decor_titlebar_masked_key, &key) &&
+                        view->decor_titlebar_masked_round == round_mask &&
+                        view->decor_titlebar_masked_frame_w == frame_w &&
+                        view->decor_titlebar_masked_frame_h == frame_h;
+                    if (!title_masked_cached) {
+                        buf = fbwl_view_decor_wallpaper_region_buffer_masked(view->server, view->x, view->y - frame_title_h, w, frame_title_h,
+                            round_mask, off_x, off_y, frame_w, frame_h);
+                    }
+                    if (buf != NULL) {
+                        view->decor_titlebar_masked_key = key;
+                        view->decor_titlebar_masked_round = round_mask;
+                        view->decor_titlebar_masked_frame_w = frame_w;
+                        view->decor_titlebar_masked_frame_h = frame_h;
+                        title_masked_cached = true;
+                    }
                 } else {
                     buf = fbwl_texture_render_buffer(title_tex, w, frame_title_h);
                     buf = fbwl_round_corners_mask_buffer_owned(buf, off_x, off_y, frame_w, frame_h, round_mask);
@@ -201,6 +237,8 @@ void fbwl_view_decor_update(struct fbwl_view *view, const struct fbwl_decor_them
                     wlr_scene_buffer_set_dest_size(view->decor_titlebar_tex, w, frame_title_h);
                     wlr_scene_node_set_position(&view->decor_titlebar_tex->node, 0, -frame_title_h);
                     wlr_scene_node_lower_to_bottom(&view->decor_titlebar_tex->node);
+                } else if (title_masked_cached) {
+                    wlr_scene_node_lower_to_bottom(&view->decor_titlebar_tex->node);
                 } else {
                     wlr_scene_node_set_enabled(&view->decor_titlebar_tex->node, false);
                     wlr_scene_buffer_set_buffer(view->decor_titlebar_tex, NULL);
@@ -211,6 +249,7 @@ void fbwl_view_decor_update(struct fbwl_view *view, const struct fbwl_decor_them
         }
         fbwl_pseudo_bg_destroy(&view->decor_titlebar_pseudo_bg);
     } else {
+        title_masked_cached = false;
         if (view->decor_titlebar != NULL) {
             wlr_scene_node_set_enabled(&view->decor_titlebar->node, show_titlebar);
             if (show_titlebar) {
@@ -257,6 +296,9 @@ void fbwl_view_decor_update(struct fbwl_view *view, const struct fbwl_decor_them
             }
         }
     }
+    if (!title_masked_cached) {
+        view->decor_titlebar_masked_key.valid = false;
+    }
 
     const struct fbwl_server *server = view->server;
     const int bevel = fbwl_view_decor_window_bevel_px(theme, frame_title_h);
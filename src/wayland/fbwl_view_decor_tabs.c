@@ -11,11 +11,8 @@
 #include <wlr/util/log.h>
 
 #include "wayland/fbwl_deco_mask.h"
-#include "wayland/fbwl_icon_theme.h"
 #include "wayland/fbwl_server_internal.h"
-#include "wayland/fbwl_ui_menu_icon.h"
 #include "wayland/fbwl_ui_text.h"
-#include "wayland/fbwl_xwayland_icon.h"
 
 static int decor_theme_button_size(const struct fbwl_decor_theme *theme) {
     if (theme == NULL) {
@@ -536,18 +533,7 @@ void fbwl_view_decor_tabs_ui_build(struct fbwl_view *view, const struct fbwl_dec
             if (icon_px_use < 1) {
                 icon_px_use = 1;
             }
-            struct wlr_buffer *icon_buf = NULL;
-            if (tab_view->type == FBWL_VIEW_XWAYLAND && view->server->xwayland != NULL) {
-                icon_buf = fbwl_xwayland_icon_buffer_create(view->server->xwayland, tab_view->xwayland_surface, icon_px_use);
-            }
-            if (icon_buf == NULL) {
-                const char *icon_name = fbwl_view_app_id(tab_view);
-                char *icon_path = fbwl_icon_theme_resolve_path(icon_name);
-                if (icon_path != NULL) {
-                    icon_buf = fbwl_ui_menu_icon_buffer_create(icon_path, icon_px_use);
-                    free(icon_path);
-                }
-            }
+            struct wlr_buffer *icon_buf = fbwl_view_icon_buffer(tab_view, icon_px_use);
             if (icon_buf != NULL) {
                 struct wlr_scene_buffer *sb_icon = wlr_scene_buffer_create(view->decor_tabs_tree, icon_buf);
                 if (sb_icon != NULL) {
@@ -0,0 +1,328 @@
+#include "wayland/fbwl_view_icon.h"
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <wayland-server-core.h>
+#include <wlr/util/log.h>
+#include <wlr/xwayland.h>
+
+#include "wayland/fbwl_icon_theme.h"
+#include "wayland/fbwl_server_internal.h"
+#include "wayland/fbwl_ui_menu_icon.h"
+#include "wayland/fbwl_ui_text.h"
+#include "wayland/fbwl_xwayland_icon.h"
+
+enum {
+    // Replies are collected when the icon connection turns readable. The
+    // sweep is only a backstop, giving up after VIEW_ICON_SWEEP_MAX rounds.
+    VIEW_ICON_SWEEP_MS = 100,
+    VIEW_ICON_SWEEP_MAX = 20,
+};
+
+static void view_icon_clear_slots(struct fbwl_view_icon_cache *cache) {
+    for (size_t i = 0; i < FBWL_VIEW_ICON_SLOTS; i++) {
+        if (cache->slots[i].surface != NULL) {
+            cairo_surface_destroy(cache->slots[i].surface);
+        }
+        cache->slots[i].surface = NULL;
+        cache->slots[i].px = 0;
+    }
+    cache->next_slot = 0;
+}
+
+static struct wlr_buffer *view_icon_buffer_from_surface(cairo_surface_t *surface) {
+    if (surface == NULL) {
+        return NULL;
+    }
+    struct wlr_buffer *buf = fbwl_cairo_buffer_create(cairo_surface_reference(surface));
+    if (buf == NULL) {
+        cairo_surface_destroy(surface);
+    }
+    return buf;
+}
+
+static void view_icon_set_pending(struct fbwl_view *view, bool pending) {
+    struct fbwl_view_icon_cache *cache = &view->icon_cache;
+    if (cache->fetch_pending == pending) {
+        return;
+    }
+    cache->fetch_pending = pending;
+    if (view->server == NULL) {
+        return;
+    }
+    if (pending) {
+        view->server->icon_fetches_pending++;
+    } else if (view->server->icon_fetches_pending > 0) {
+        view->server->icon_fetches_pending--;
+    }
+}
+
+static void view_icon_cancel_fetch(struct fbwl_view *view) {
+    struct fbwl_view_icon_cache *cache = &view->icon_cache;
+    if (cache->fetch_pending) {
+        fbwl_xwayland_icon_discard(view->server != NULL ? view->server->icon_conn : NULL, cache->fetch_seq);
+        view_icon_set_pending(view, false);
+    }
+}
+
+// Several replies usually land together (session start, many maps), so the
+// toolbar and tab rebuilds they trigger are batched into one idle pass.
+static void view_icon_refresh_idle(void *data) {
+    struct fbwl_server *server = data;
+    server->icon_refresh_idle = NULL;
+    server_toolbar_ui_rebuild(server);
+    for (struct fbwm_view *walk = server->wm.views.next; walk != &server->wm.views; walk = walk->next) {
+        struct fbwl_view *view = walk->userdata;
+        if (view == NULL || !view->icon_cache.refresh_pending) {
+            continue;
+        }
+        view->icon_cache.refresh_pending = false;
+        if (!view->mapped || view->tab_group == NULL || !server->tabs.use_pixmap) {
+            continue;
+        }
+        for (struct fbwm_view *other_walk = server->wm.views.next; other_walk != &server->wm.views;
+                other_walk = other_walk->next) {
+            struct fbwl_view *other = other_walk->userdata;
+            if (other != NULL && other->tab_group == view->tab_group) {
+                fbwl_view_decor_update(other, &server->decor_theme);
+            }
+        }
+    }
+}
+
+static void view_icon_ready(struct fbwl_view *view) {
+    struct fbwl_server *server = view->server;
+    if (server == NULL || server->wl_display == NULL || !view->mapped) {
+        return;
+    }
+    view->icon_cache.refresh_pending = true;
+    if (server->icon_refresh_idle == NULL) {
+        struct wl_event_loop *loop = wl_display_get_event_loop(server->wl_display);
+        server->icon_refresh_idle = wl_event_loop_add_idle(loop, view_icon_refresh_idle, server);
+    }
+}
+
+static void view_icon_collect(struct fbwl_view *view, bool give_up) {
+    struct fbwl_view_icon_cache *cache = &view->icon_cache;
+    if (!cache->fetch_pending) {
+        return;
+    }
+
+    uint32_t *icon = NULL;
+    size_t icon_len = 0;
+    const int r = fbwl_xwayland_icon_poll(view->server->icon_conn, cache->fetch_seq, &icon, &icon_len);
+    if (r == 0) {
+        if (!give_up) {
+            return;
+        }
+        fbwl_xwayland_icon_discard(view->server->icon_conn, cache->fetch_seq);
+        wlr_log(WLR_DEBUG, "Icon: _NET_WM_ICON fetch timed out (win=0x%x)",
+            view->xwayland_surface != NULL ? (unsigned)view->xwayland_surface->window_id : 0u);
+    }
+
+    view_icon_set_pending(view, false);
+    if (cache->fetch_timer != NULL) {
+        wl_event_source_timer_update(cache->fetch_timer, 0);
+    }
+    free(cache->net_wm_icon);
+    cache->net_wm_icon = icon;
+    cache->net_wm_icon_len = icon_len;
+    cache->net_wm_icon_fetched = true;
+    view_icon_clear_slots(cache);
+    view_icon_ready(view);
+}
+
+static int view_icon_fetch_timer(void *data) {
+    struct fbwl_view *view = data;
+    struct fbwl_view_icon_cache *cache = &view->icon_cache;
+    view_icon_collect(view, ++cache->fetch_sweeps >= VIEW_ICON_SWEEP_MAX);
+    if (cache->fetch_pending) {
+        wl_event_source_timer_update(cache->fetch_timer, VIEW_ICON_SWEEP_MS);
+    }
+    return 0;
+}
+
+static void view_icon_disconnect(struct fbwl_server *server) {
+    if (server->icon_conn_source != NULL) {
+        wl_event_source_remove(server->icon_conn_source);
+        server->icon_conn_source = NULL;
+    }
+    if (server->icon_conn == NULL) {
+        return;
+    }
+    // Sequence numbers die with the connection; drop the fetches in flight so
+    // the next lookup asks again.
+    for (struct fbwm_view *walk = server->wm.views.next; walk != &server->wm.views; walk = walk->next) {
+        struct fbwl_view *view = walk->userdata;
+        if (view != NULL && view->icon_cache.fetch_pending) {
+            view_icon_set_pending(view, false);
+            view->icon_cache.net_wm_icon_fetched = false;
+        }
+    }
+    fbwl_xwayland_icon_disconnect(server->icon_conn);
+    server->icon_conn = NULL;
+}
+
+static int view_icon_conn_readable(int fd, uint32_t mask, void *data) {
+    (void)fd;
+    struct fbwl_server *server = data;
+    if ((mask & (WL_EVENT_HANGUP | WL_EVENT_ERROR)) != 0 || !fbwl_xwayland_icon_drain(server->icon_conn)) {
+        wlr_log(WLR_INFO, "Icon: XWayland icon connection closed");
+        view_icon_disconnect(server);
+        return 0;
+    }
+    if (server->icon_fetches_pending == 0) {
+        return 0;
+    }
+    for (struct fbwm_view *walk = server->wm.views.next; walk != &server->wm.views; walk = walk->next) {
+        struct fbwl_view *view = walk->userdata;
+        if (view != NULL && view->type == FBWL_VIEW_XWAYLAND && view->icon_cache.fetch_pending) {
+            view_icon_collect(view, false);
+        }
+    }
+    return 0;
+}
+
+void fbwl_view_icon_xwayland_ready(struct fbwl_server *server) {
+    if (server == NULL || server->wl_display == NULL) {
+        return;
+    }
+    // A restarted XWayland gets a fresh connection (and atom).
+    view_icon_disconnect(server);
+    const char *display_name = server->xwayland != NULL ? server->xwayland->display_name : NULL;
+    server->icon_conn = fbwl_xwayland_icon_connect(display_name);
+    const int fd = fbwl_xwayland_icon_fd(server->icon_conn);
+    if (fd < 0) {
+        return;
+    }
+    struct wl_event_loop *loop = wl_display_get_event_loop(server->wl_display);
+    server->icon_conn_source = wl_event_loop_add_fd(loop, fd, WL_EVENT_READABLE, view_icon_conn_readable, server);
+}
+
+void fbwl_view_icon_server_finish(struct fbwl_server *server) {
+    if (server == NULL) {
+        return;
+    }
+    view_icon_disconnect(server);
+    if (server->icon_refresh_idle != NULL) {
+        wl_event_source_remove(server->icon_refresh_idle);
+        server->icon_refresh_idle = NULL;
+    }
+}
+
+void fbwl_view_icon_fetch(struct fbwl_view *view) {
+    if (view == NULL || view->type != FBWL_VIEW_XWAYLAND || view->xwayland_surface == NULL ||
+            view->server == NULL) {
+        return;
+    }
+    struct fbwl_view_icon_cache *cache = &view->icon_cache;
+    view_icon_cancel_fetch(view);
+
+    if (cache->fetch_timer == NULL) {
+        struct wl_event_loop *loop = wl_display_get_event_loop(view->server->wl_display);
+        cache->fetch_timer = wl_event_loop_add_timer(loop, view_icon_fetch_timer, view);
+    }
+    if (cache->fetch_timer == NULL ||
+            !fbwl_xwayland_icon_request(view->server->icon_conn, view->xwayland_surface->window_id, &cache->fetch_seq)) {
+        cache->net_wm_icon_fetched = true;
+        return;
+    }
+    view_icon_set_pending(view, true);
+    cache->fetch_sweeps = 0;
+    wl_event_source_timer_update(cache->fetch_timer, VIEW_ICON_SWEEP_MS);
+}
+
+void fbwl_view_icon_invalidate(struct fbwl_view *view, const char *why) {
+    if (view == NULL) {
+        return;
+    }
+    struct fbwl_view_icon_cache *cache = &view->icon_cache;
+    view_icon_clear_slots(cache);
+    if (view->type == FBWL_VIEW_XWAYLAND) {
+        free(cache->net_wm_icon);
+        cache->net_wm_icon = NULL;
+        cache->net_wm_icon_len = 0;
+        cache->net_wm_icon_fetched = false;
+        if (view->mapped) {
+            fbwl_view_icon_fetch(view);
+        }
+    }
+    wlr_log(WLR_DEBUG, "Icon: invalidated title=%s reason=%s",
+        fbwl_view_display_title(view), why != NULL ? why : "(null)");
+}
+
+struct wlr_buffer *fbwl_view_icon_buffer(struct fbwl_view *view, int icon_px) {
+    if (view == NULL || icon_px < 1) {
+        return NULL;
+    }
+    struct fbwl_view_icon_cache *cache = &view->icon_cache;
+
+    const char *app_id = fbwl_view_app_id(view);
+    if ((app_id == NULL) != (cache->app_id == NULL) ||
+            (app_id != NULL && strcmp(app_id, cache->app_id) != 0)) {
+        view_icon_clear_slots(cache);
+        free(cache->app_id);
+        cache->app_id = app_id != NULL ? strdup(app_id) : NULL;
+    }
+
+    for (size_t i = 0; i < FBWL_VIEW_ICON_SLOTS; i++) {
+        if (cache->slots[i].px == icon_px) {
+            return view_icon_buffer_from_surface(cache->slots[i].surface);
+        }
+    }
+
+    if (view->type == FBWL_VIEW_XWAYLAND && !cache->net_wm_icon_fetched) {
+        if (!cache->fetch_pending) {
+            fbwl_view_icon_fetch(view);
+        }
+        if (cache->fetch_pending) {
+            // view_icon_ready() rebuilds the users once the reply is in.
+            return NULL;
+        }
+    }
+
+    cairo_surface_t *surface = NULL;
+    if (cache->net_wm_icon != NULL) {
+        surface = fbwl_xwayland_icon_surface_from_data(cache->net_wm_icon, cache->net_wm_icon_len, icon_px);
+    }
+    if (surface == NULL && app_id != NULL) {
+        char *icon_path = fbwl_icon_theme_resolve_path(app_id);
+        if (icon_path != NULL) {
+            surface = fbwl_ui_menu_icon_surface_create(icon_path, icon_px);
+            free(icon_path);
+        }
+    }
+
+    struct fbwl_view_icon_slot *slot = &cache->slots[cache->next_slot];
+    cache->next_slot = (cache->next_slot + 1) % FBWL_VIEW_ICON_SLOTS;
+    if (slot->surface != NULL) {
+        cairo_surface_destroy(slot->surface);
+    }
+    slot->px = icon_px;
+    slot->surface = surface;
+    return view_icon_buffer_from_surface(surface);
+}
+
+void fbwl_view_icon_cache_finish(struct fbwl_view *view) {
+    if (view == NULL) {
+        return;
+    }
+    struct fbwl_view_icon_cache *cache = &view->icon_cache;
+    view_icon_cancel_fetch(view);
+    if (cache->fetch_timer != NULL) {
+        wl_event_source_remove(cache->fetch_timer);
+        cache->fetch_timer = NULL;
+    }
+    view_icon_clear_slots(cache);
+    free(cache->app_id);
+    cache->app_id = NULL;
+    free(cache->net_wm_icon);
+    cache->net_wm_icon = NULL;
+    cache->net_wm_icon_len = 0;
+    cache->net_wm_icon_fetched = false;
+    cache->refresh_pending = false;
+}
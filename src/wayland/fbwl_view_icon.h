@@ -0,0 +1,50 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include <cairo/cairo.h>
+
+struct fbwl_server;
+struct fbwl_view;
+struct wl_event_source;
+struct wlr_buffer;
+
+enum {
+    FBWL_VIEW_ICON_SLOTS = 4,
+};
+
+struct fbwl_view_icon_slot {
+    int px; // 0 == unused
+    cairo_surface_t *surface; // NULL caches "no icon at this size"
+};
+
+// Decoded, pre-scaled window icons, so iconbar/tab rebuilds never go back to
+// the X server or the icon theme. XWayland icons are fetched asynchronously
+// on map and whenever _NET_WM_ICON changes, and collected when the XWM socket
+// turns readable; theme lookups are keyed by app_id.
+struct fbwl_view_icon_cache {
+    struct fbwl_view_icon_slot slots[FBWL_VIEW_ICON_SLOTS];
+    size_t next_slot;
+    char *app_id;
+
+    uint32_t *net_wm_icon;
+    size_t net_wm_icon_len;
+    bool net_wm_icon_fetched;
+
+    bool fetch_pending;
+    unsigned int fetch_seq;
+    int fetch_sweeps;
+    struct wl_event_source *fetch_timer;
+    bool refresh_pending;
+};
+
+// Returns a fresh buffer over the cached surface (drop with wlr_buffer_drop) or NULL.
+struct wlr_buffer *fbwl_view_icon_buffer(struct fbwl_view *view, int icon_px);
+void fbwl_view_icon_fetch(struct fbwl_view *view);
+void fbwl_view_icon_invalidate(struct fbwl_view *view, const char *why);
+void fbwl_view_icon_cache_finish(struct fbwl_view *view);
+
+void fbwl_view_icon_xwayland_ready(struct fbwl_server *server);
+void fbwl_view_icon_server_finish(struct fbwl_server *server);
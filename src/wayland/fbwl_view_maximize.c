@@ -147,3 +147,71 @@ void fbwl_view_set_maximized_axes(struct fbwl_view *view, bool maximized_h, bool
         server_toolbar_ui_rebuild(server);
     }
 }
+
+void fbwl_view_refit_maximized(struct fbwl_view *view, struct wlr_output_layout *output_layout,
+        struct wl_list *outputs) {
+    if (view == NULL || output_layout == NULL || view->fullscreen || (!view->maximized_h && !view->maximized_v)) {
+        return;
+    }
+    struct fbwl_server *server = view->server;
+    const struct fbwl_screen_config *cfg = server != NULL ? fbwl_server_screen_config_for_view(server, view) : NULL;
+    const bool full_max = cfg != NULL ? cfg->full_maximization : (server != NULL && server->full_maximization);
+    if (full_max) {
+        return;
+    }
+
+    struct wlr_box box;
+    fbwl_view_get_output_usable_box(view, output_layout, outputs, NULL, &box);
+    fbwl_view_apply_tabs_maxover_box(view, &box);
+    if (box.width < 1 || box.height < 1) {
+        return;
+    }
+
+    int frame_left = 0;
+    int frame_top = 0;
+    int frame_right = 0;
+    int frame_bottom = 0;
+    if (server != NULL) {
+        fbwl_view_decor_frame_extents(view, &server->decor_theme, &frame_left, &frame_top, &frame_right, &frame_bottom);
+    }
+    const int cur_w = fbwl_view_current_width(view);
+    const int cur_h = fbwl_view_current_height(view);
+    int x = view->x;
+    int y = view->y;
+    int w = cur_w;
+    int h = cur_h;
+    if (view->maximized_h) {
+        x = box.x + frame_left;
+        w = box.width - frame_left - frame_right;
+    }
+    if (view->maximized_v) {
+        y = box.y + frame_top;
+        h = box.height - frame_top - frame_bottom;
+    }
+    if (w < 1 || h < 1) {
+        return;
+    }
+    const bool ignore_inc = view->ignore_size_hints_override_set ? view->ignore_size_hints_override :
+        (cfg != NULL ? cfg->max_ignore_increment : (server == NULL || server->max_ignore_increment));
+    if (view->maximized && view->type == FBWL_VIEW_XWAYLAND && view->xwayland_surface != NULL && !ignore_inc) {
+        fbwl_xwayland_apply_size_hints(view->xwayland_surface, &w, &h, true);
+    }
+    if (x == view->x && y == view->y && w == cur_w && h == cur_h) {
+        return;
+    }
+
+    view->x = x;
+    view->y = y;
+    if (view->scene_tree != NULL) {
+        wlr_scene_node_set_position(&view->scene_tree->node, view->x, view->y);
+    }
+    fbwl_view_pseudo_bg_update(view, "maximize-refit");
+    if (view->type == FBWL_VIEW_XDG) {
+        wlr_xdg_toplevel_set_size(view->xdg_toplevel, w, h);
+    } else if (view->type == FBWL_VIEW_XWAYLAND) {
+        wlr_xwayland_surface_configure(view->xwayland_surface, view->x, view->y, (uint16_t)w, (uint16_t)h);
+    }
+    fbwl_tabs_sync_geometry_from_view(view, true, w, h, "maximize-refit");
+    fbwl_view_foreign_update_output_from_position(view, output_layout);
+    wlr_log(WLR_INFO, "Maximize: refit %s w=%d h=%d", fbwl_view_display_title(view), w, h);
+}
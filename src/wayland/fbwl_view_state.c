@@ -66,6 +66,8 @@ void fbwl_view_cleanup(struct fbwl_view *view) {
     free(view->title_override);
     view->title_override = NULL;
 
+    fbwl_view_icon_cache_finish(view);
+
     free(view->xwayland_role_cache);
     view->xwayland_role_cache = NULL;
 
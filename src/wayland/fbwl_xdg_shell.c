@@ -12,6 +12,7 @@
 #include "wayland/fbwl_apps_rules.h"
 #include "wayland/fbwl_server_internal.h"
 #include "wayland/fbwl_tabs.h"
+#include "wayland/fbwl_trace.h"
 #include "wayland/fbwl_util.h"
 #include "wayland/fbwl_view.h"
 #include "wayland/fbwl_view_attention.h"
@@ -141,6 +142,7 @@ void fbwl_xdg_shell_handle_new_toplevel(struct fbwl_server *server, struct wlr_x
     fbwl_view_decor_create(view, decor_theme);
 
     fbwm_view_init(&view->wm_view, wm_view_ops, view);
+    view->wm_view.create_seq = view->create_seq;
 
     view->map.notify = map_fn;
     wl_signal_add(&xdg_toplevel->base->surface->events.map, &view->map);
@@ -215,11 +217,11 @@ void fbwl_xdg_shell_handle_toplevel_map(struct fbwl_view *view,
     }
 
     if (autotab_anchor != NULL) {
-        view->wm_view.workspace = autotab_anchor->wm_view.workspace;
-        view->wm_view.sticky = autotab_anchor->wm_view.sticky;
-    } else {
+        fbwm_core_view_set_workspace(wm, &view->wm_view, autotab_anchor->wm_view.workspace);
+        fbwm_core_view_set_sticky(wm, &view->wm_view, autotab_anchor->wm_view.sticky);
+    } else if (!view->session_restore_pending) {
         const size_t head = view->server != NULL ? fbwl_server_screen_index_at(view->server, cursor_x, cursor_y) : 0;
-        view->wm_view.workspace = fbwm_core_workspace_current_for_head(wm, head);
+        fbwm_core_view_set_workspace(wm, &view->wm_view, fbwm_core_workspace_current_for_head(wm, head));
     }
 
     if (!view->apps_rules_applied && apps_rule != NULL) {
@@ -268,12 +270,12 @@ void fbwl_xdg_shell_handle_toplevel_map(struct fbwl_view *view,
 
     if (autotab_anchor == NULL && apps_rule != NULL && apps_rule->set_head && !apps_rule->set_workspace) {
         const size_t head = apps_rule->head >= 0 ? (size_t)apps_rule->head : 0;
-        view->wm_view.workspace = fbwm_core_workspace_current_for_head(wm, head);
+        fbwm_core_view_set_workspace(wm, &view->wm_view, fbwm_core_workspace_current_for_head(wm, head));
     }
 
     if (autotab_anchor != NULL) {
-        view->wm_view.workspace = autotab_anchor->wm_view.workspace;
-        view->wm_view.sticky = autotab_anchor->wm_view.sticky;
+        fbwm_core_view_set_workspace(wm, &view->wm_view, autotab_anchor->wm_view.workspace);
+        fbwm_core_view_set_sticky(wm, &view->wm_view, autotab_anchor->wm_view.sticky);
     }
 
     if (!view->decor_forced) {
@@ -349,7 +351,7 @@ void fbwl_xdg_shell_handle_toplevel_commit(struct fbwl_view *view,
         view->committed_height = h;
         view->width = w;
         view->height = h;
-        wlr_log(WLR_INFO, "Surface size: %s %dx%d",
+        fbwl_trace(FBWL_TRACE_SURFACE, "Surface size: %s %dx%d",
             fbwl_view_display_title(view),
             w, h);
     }
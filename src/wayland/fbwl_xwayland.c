@@ -289,6 +289,7 @@ void fbwl_xwayland_handle_new_surface(struct fbwl_server *server, struct wlr_xwa
     xsurface->data = view;
 
     fbwm_view_init(&view->wm_view, wm_view_ops, view);
+    view->wm_view.create_seq = view->create_seq;
 
     view->destroy.notify = destroy_fn;
     wl_signal_add(&xsurface->events.destroy, &view->destroy);
@@ -365,11 +366,11 @@ void fbwl_xwayland_handle_surface_map(struct fbwl_view *view,
     }
 
     if (autotab_anchor != NULL) {
-        view->wm_view.workspace = autotab_anchor->wm_view.workspace;
-        view->wm_view.sticky = autotab_anchor->wm_view.sticky;
-    } else {
+        fbwm_core_view_set_workspace(wm, &view->wm_view, autotab_anchor->wm_view.workspace);
+        fbwm_core_view_set_sticky(wm, &view->wm_view, autotab_anchor->wm_view.sticky);
+    } else if (!view->session_restore_pending) {
         const size_t head = view->server != NULL ? fbwl_server_screen_index_at(view->server, cursor_x, cursor_y) : 0;
-        view->wm_view.workspace = fbwm_core_workspace_current_for_head(wm, head);
+        fbwm_core_view_set_workspace(wm, &view->wm_view, fbwm_core_workspace_current_for_head(wm, head));
     }
 
     if (!view->apps_rules_applied && apps_rule != NULL) {
@@ -418,12 +419,12 @@ void fbwl_xwayland_handle_surface_map(struct fbwl_view *view,
 
     if (autotab_anchor == NULL && apps_rule != NULL && apps_rule->set_head && !apps_rule->set_workspace) {
         const size_t head = apps_rule->head >= 0 ? (size_t)apps_rule->head : 0;
-        view->wm_view.workspace = fbwm_core_workspace_current_for_head(wm, head);
+        fbwm_core_view_set_workspace(wm, &view->wm_view, fbwm_core_workspace_current_for_head(wm, head));
     }
 
     if (autotab_anchor != NULL) {
-        view->wm_view.workspace = autotab_anchor->wm_view.workspace;
-        view->wm_view.sticky = autotab_anchor->wm_view.sticky;
+        fbwm_core_view_set_workspace(wm, &view->wm_view, autotab_anchor->wm_view.workspace);
+        fbwm_core_view_set_sticky(wm, &view->wm_view, autotab_anchor->wm_view.sticky);
     }
 
     if (view->server != NULL &&
@@ -586,6 +587,7 @@ void fbwl_xwayland_handle_surface_dissociate(struct fbwl_view *view,
         view->decor_tree = NULL;
         view->decor_titlebar_pseudo_bg = (struct fbwl_pseudo_bg){0};
         view->decor_titlebar_tex = NULL;
+        view->decor_titlebar_masked_key.valid = false;
         view->decor_titlebar = NULL;
         view->decor_title_text = NULL;
         view->decor_border_top = NULL;
@@ -740,6 +742,7 @@ void fbwl_xwayland_handle_surface_destroy(struct fbwl_view *view,
     fbwl_cleanup_listener(&view->xwayland_set_class);
     fbwl_cleanup_listener(&view->xwayland_set_role);
     fbwl_cleanup_listener(&view->xwayland_set_hints);
+    fbwl_cleanup_listener(&view->xwayland_set_icon);
 
     fbwl_cleanup_listener(&view->foreign_request_maximize);
     fbwl_cleanup_listener(&view->foreign_request_minimize);
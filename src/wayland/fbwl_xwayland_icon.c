@@ -7,69 +7,139 @@
 #include <string.h>
 
 #include <xcb/xcb.h>
+#include <xcb/xcbext.h>
 
-#include <wlr/interfaces/wlr_buffer.h>
 #include <wlr/util/log.h>
-#include <wlr/xwayland.h>
 
 #include "wayland/fbwl_ui_menu_icon.h"
 
-static xcb_atom_t intern_atom(xcb_connection_t *conn, const char *name) {
-    if (conn == NULL || name == NULL) {
-        return XCB_ATOM_NONE;
+// Our own client connection to the XWayland display: icon replies are read
+// from its socket without touching the XWM connection wlroots owns, and the
+// interned atom lives and dies with it.
+struct fbwl_xwayland_icon_conn {
+    xcb_connection_t *conn;
+    xcb_atom_t net_wm_icon;
+};
+
+struct fbwl_xwayland_icon_conn *fbwl_xwayland_icon_connect(const char *display_name) {
+    if (display_name == NULL || *display_name == '\0') {
+        return NULL;
+    }
+    xcb_connection_t *conn = xcb_connect(display_name, NULL);
+    if (conn == NULL || xcb_connection_has_error(conn)) {
+        wlr_log(WLR_ERROR, "Icon: failed to connect to XWayland display %s", display_name);
+        if (conn != NULL) {
+            xcb_disconnect(conn);
+        }
+        return NULL;
     }
-    xcb_intern_atom_cookie_t cookie =
-        xcb_intern_atom(conn, 0, (uint16_t)strlen(name), name);
+
+    // One round trip per connection, paid while XWayland comes up rather
+    // than on the first map.
+    static const char name[] = "_NET_WM_ICON";
+    xcb_intern_atom_cookie_t cookie = xcb_intern_atom(conn, 0, (uint16_t)(sizeof(name) - 1), name);
     xcb_intern_atom_reply_t *reply = xcb_intern_atom_reply(conn, cookie, NULL);
-    if (reply == NULL) {
-        return XCB_ATOM_NONE;
+    if (reply == NULL || reply->atom == XCB_ATOM_NONE) {
+        free(reply);
+        xcb_disconnect(conn);
+        return NULL;
+    }
+
+    struct fbwl_xwayland_icon_conn *ic = calloc(1, sizeof(*ic));
+    if (ic == NULL) {
+        free(reply);
+        xcb_disconnect(conn);
+        return NULL;
     }
-    xcb_atom_t atom = reply->atom;
+    ic->conn = conn;
+    ic->net_wm_icon = reply->atom;
     free(reply);
-    return atom;
+    return ic;
 }
 
-struct wlr_buffer *fbwl_xwayland_icon_buffer_create(struct wlr_xwayland *xwayland,
-        const struct wlr_xwayland_surface *xsurface, int icon_px) {
-    if (xwayland == NULL || xsurface == NULL || icon_px < 1) {
-        return NULL;
+void fbwl_xwayland_icon_disconnect(struct fbwl_xwayland_icon_conn *ic) {
+    if (ic == NULL) {
+        return;
     }
+    xcb_disconnect(ic->conn);
+    free(ic);
+}
 
-    xcb_connection_t *conn = wlr_xwayland_get_xwm_connection(xwayland);
-    if (conn == NULL) {
-        return NULL;
+int fbwl_xwayland_icon_fd(const struct fbwl_xwayland_icon_conn *ic) {
+    return ic != NULL ? xcb_get_file_descriptor(ic->conn) : -1;
+}
+
+bool fbwl_xwayland_icon_drain(struct fbwl_xwayland_icon_conn *ic) {
+    if (ic == NULL) {
+        return false;
     }
+    // Nothing is selected on our windows, but errors to unchecked requests
+    // still arrive as events; don't let them queue up.
+    xcb_generic_event_t *ev = NULL;
+    while ((ev = xcb_poll_for_event(ic->conn)) != NULL) {
+        free(ev);
+    }
+    return xcb_connection_has_error(ic->conn) == 0;
+}
 
-    xcb_atom_t atom_net_wm_icon = intern_atom(conn, "_NET_WM_ICON");
-    if (atom_net_wm_icon == XCB_ATOM_NONE) {
-        return NULL;
+bool fbwl_xwayland_icon_request(struct fbwl_xwayland_icon_conn *ic, uint32_t window_id, unsigned int *out_seq) {
+    if (ic == NULL || window_id == XCB_WINDOW_NONE || out_seq == NULL) {
+        return false;
     }
 
     // Cap property payload to 4 MiB to avoid pathological allocations.
     // xcb_get_property's long_length is in 32-bit units.
     const uint32_t max_u32 = 1024u * 1024u;
 
-    xcb_get_property_cookie_t cookie = xcb_get_property(conn, 0, xsurface->window_id,
-        atom_net_wm_icon, XCB_ATOM_CARDINAL, 0, max_u32);
-    xcb_get_property_reply_t *reply = xcb_get_property_reply(conn, cookie, NULL);
-    if (reply == NULL) {
-        return NULL;
+    xcb_get_property_cookie_t cookie = xcb_get_property(ic->conn, 0, window_id,
+        ic->net_wm_icon, XCB_ATOM_CARDINAL, 0, max_u32);
+    xcb_flush(ic->conn);
+    *out_seq = cookie.sequence;
+    return true;
+}
+
+int fbwl_xwayland_icon_poll(struct fbwl_xwayland_icon_conn *ic, unsigned int seq, uint32_t **out_data, size_t *out_len) {
+    if (out_data == NULL || out_len == NULL) {
+        return -1;
+    }
+    *out_data = NULL;
+    *out_len = 0;
+    if (ic == NULL) {
+        return -1;
     }
 
-    struct wlr_buffer *buf = NULL;
+    void *raw = NULL;
+    xcb_generic_error_t *err = NULL;
+    if (xcb_poll_for_reply(ic->conn, seq, &raw, &err) == 0) {
+        return 0;
+    }
+    free(err);
+    xcb_get_property_reply_t *reply = raw;
+    if (reply == NULL) {
+        return -1;
+    }
 
-    if (reply->format != 32) {
-        goto out;
+    const size_t n_u32 = reply->format == 32 ? (size_t)(xcb_get_property_value_length(reply) / 4) : 0;
+    if (n_u32 >= 2) {
+        *out_data = malloc(n_u32 * sizeof(uint32_t));
+        if (*out_data != NULL) {
+            memcpy(*out_data, xcb_get_property_value(reply), n_u32 * sizeof(uint32_t));
+            *out_len = n_u32;
+        }
     }
+    free(reply);
+    return 1;
+}
 
-    const size_t n_u32 = (size_t)(xcb_get_property_value_length(reply) / 4);
-    if (n_u32 < 2) {
-        goto out;
+void fbwl_xwayland_icon_discard(struct fbwl_xwayland_icon_conn *ic, unsigned int seq) {
+    if (ic != NULL) {
+        xcb_discard_reply(ic->conn, seq);
     }
+}
 
-    const uint32_t *vals = (const uint32_t *)xcb_get_property_value(reply);
-    if (vals == NULL) {
-        goto out;
+cairo_surface_t *fbwl_xwayland_icon_surface_from_data(const uint32_t *vals, size_t n_u32, int icon_px) {
+    if (vals == NULL || n_u32 < 2 || icon_px < 1) {
+        return NULL;
     }
 
     int best_w = 0;
@@ -126,16 +196,12 @@ struct wlr_buffer *fbwl_xwayland_icon_buffer_create(struct wlr_xwayland *xwaylan
     }
 
     if (best_pixels == NULL) {
-        goto out;
+        return NULL;
     }
 
-    buf = fbwl_ui_menu_icon_buffer_create_argb32(best_pixels, best_w, best_h, icon_px);
-    if (buf == NULL) {
-        wlr_log(WLR_DEBUG, "XWayland: failed to build _NET_WM_ICON buffer (win=0x%x)", (unsigned)xsurface->window_id);
-        goto out;
+    cairo_surface_t *surface = fbwl_ui_menu_icon_surface_create_argb32(best_pixels, best_w, best_h, icon_px);
+    if (surface == NULL) {
+        wlr_log(WLR_DEBUG, "XWayland: failed to build _NET_WM_ICON surface (%dx%d)", best_w, best_h);
     }
-
-out:
-    free(reply);
-    return buf;
+    return surface;
 }
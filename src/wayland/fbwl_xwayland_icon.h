@@ -1,9 +1,26 @@
 #pragma once
 
-struct wlr_buffer;
-struct wlr_xwayland;
-struct wlr_xwayland_surface;
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
 
-struct wlr_buffer *fbwl_xwayland_icon_buffer_create(struct wlr_xwayland *xwayland,
-    const struct wlr_xwayland_surface *xsurface, int icon_px);
+#include <cairo/cairo.h>
 
+// Private client connection to the XWayland display used for _NET_WM_ICON.
+struct fbwl_xwayland_icon_conn;
+
+struct fbwl_xwayland_icon_conn *fbwl_xwayland_icon_connect(const char *display_name);
+void fbwl_xwayland_icon_disconnect(struct fbwl_xwayland_icon_conn *ic);
+// The connection's socket, for waking up when replies arrive; -1 if none.
+int fbwl_xwayland_icon_fd(const struct fbwl_xwayland_icon_conn *ic);
+// Drops queued events; false once the connection has failed.
+bool fbwl_xwayland_icon_drain(struct fbwl_xwayland_icon_conn *ic);
+
+// Sends a non-blocking _NET_WM_ICON request; collect it with
+// fbwl_xwayland_icon_poll() (1 = done, 0 = not yet, -1 = failed).
+bool fbwl_xwayland_icon_request(struct fbwl_xwayland_icon_conn *ic, uint32_t window_id, unsigned int *out_seq);
+int fbwl_xwayland_icon_poll(struct fbwl_xwayland_icon_conn *ic, unsigned int seq, uint32_t **out_data, size_t *out_len);
+void fbwl_xwayland_icon_discard(struct fbwl_xwayland_icon_conn *ic, unsigned int seq);
+
+// Picks the best-fitting image out of a _NET_WM_ICON reply and scales it.
+cairo_surface_t *fbwl_xwayland_icon_surface_from_data(const uint32_t *vals, size_t n_u32, int icon_px);
@@ -9,11 +9,13 @@
 #include <wlr/util/log.h>
 
 #include "wayland/fbwl_server_internal.h"
+#include "wayland/fbwl_socket_handover.h"
 #include "wayland/fbwl_style_parse.h"
+#include "wayland/fbwl_trace.h"
 #include "wayland/fbwl_util.h"
 
 static void usage(const char *argv0) {
-    printf("Usage: %s [--socket NAME] [--ipc-socket PATH] [--no-xwayland] [--bg-color #RRGGBB[AA]] [-s CMD] [--terminal CMD] [--workspaces N] [--config-dir DIR] [-rc FILE] [-no-toolbar] [-no-slit] [--keys FILE] [--apps FILE] [--style FILE] [--menu FILE] [--log-level LEVEL] [--log-protocol]\n", argv0);
+    printf("Usage: %s [--socket NAME] [--ipc-socket PATH] [--no-xwayland] [--bg-color #RRGGBB[AA]] [-s CMD] [--terminal CMD] [--workspaces N] [--config-dir DIR] [-rc FILE] [-no-toolbar] [-no-slit] [--keys FILE] [--apps FILE] [--style FILE] [--menu FILE] [--log-level LEVEL] [--log-protocol] [--trace CATS] [--trace-text CATS] [--trace-text-rate N] [--restart-keep-socket]\n", argv0);
     printf("Keybindings:\n");
     printf("  Alt+Return: spawn terminal\n");
     printf("  Alt+Escape: exit\n");
@@ -70,6 +72,10 @@ int main(int argc, char **argv) {
     bool no_slit = false;
     enum wlr_log_importance log_level = WLR_INFO;
     bool log_protocol = false;
+    uint32_t trace_mask = 0;
+    uint32_t trace_text_mask = FBWL_TRACE_ALL;
+    int trace_text_rate = 0;
+    bool restart_keep_socket = false;
 
     static const struct option options[] = {
         {"socket", required_argument, NULL, 1},
@@ -88,6 +94,10 @@ int main(int argc, char **argv) {
         {"menu", required_argument, NULL, 10},
         {"log-level", required_argument, NULL, 12},
         {"log-protocol", no_argument, NULL, 13},
+        {"trace", required_argument, NULL, 17},
+        {"trace-text", required_argument, NULL, 18},
+        {"trace-text-rate", required_argument, NULL, 19},
+        {"restart-keep-socket", no_argument, NULL, 20},
         {"help", no_argument, NULL, 'h'},
         {0, 0, 0, 0},
     };
@@ -153,6 +163,23 @@ int main(int argc, char **argv) {
         case 13:
             log_protocol = true;
             break;
+        case 17:
+        case 18:
+            if (!fbwl_trace_parse_mask(optarg, c == 17 ? &trace_mask : &trace_text_mask)) {
+                fprintf(stderr, "invalid --%s (expected all|none or a list of workspace,surface,focus,stack,layers,toolbar): %s\n",
+                    c == 17 ? "trace" : "trace-text", optarg);
+                return 1;
+            }
+            break;
+        case 19:
+            trace_text_rate = atoi(optarg);
+            if (trace_text_rate < 0) {
+                trace_text_rate = 0;
+            }
+            break;
+        case 20:
+            restart_keep_socket = true;
+            break;
         case 's':
             startup_cmd = optarg;
             break;
@@ -168,10 +195,19 @@ int main(int argc, char **argv) {
     }
 
     wlr_log_init(log_level, NULL);
+    fbwl_trace_configure(trace_mask, trace_text_mask, trace_text_rate);
+
+    // A restarting parent that kept its socket passes it on regardless of flags.
+    struct fbwl_socket_handover handover;
+    fbwl_socket_handover_init(&handover);
+    if (fbwl_socket_handover_take(&handover)) {
+        restart_keep_socket = true;
+    }
 
     struct fbwl_server server = {0};
     const struct fbwl_server_bootstrap_options bootstrap = {
         .socket_name = socket_name,
+        .socket_handover = restart_keep_socket ? &handover : NULL,
         .ipc_socket_path = ipc_socket_path,
         .startup_cmd = startup_cmd,
         .terminal_cmd = terminal_cmd,
@@ -191,6 +227,7 @@ int main(int argc, char **argv) {
     };
 
     if (!fbwl_server_bootstrap(&server, &bootstrap)) {
+        fbwl_socket_handover_close(&handover);
         return 1;
     }
 
@@ -211,6 +248,9 @@ int main(int argc, char **argv) {
             perror(restart_cmd);
         }
 
+        if (restart_keep_socket && !fbwl_socket_handover_export(&handover)) {
+            fbwl_socket_handover_close(&handover);
+        }
         execvp(argv[0], argv);
         perror(argv[0]);
 
@@ -219,10 +259,12 @@ int main(int argc, char **argv) {
         execvp(base, argv);
         perror(base);
 
+        fbwl_socket_handover_close(&handover);
         free(restart_cmd);
         return 1;
     }
 
+    fbwl_socket_handover_close(&handover);
     free(restart_cmd);
     return 0;
 }
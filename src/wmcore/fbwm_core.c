@@ -87,6 +87,107 @@ static void list_remove(struct fbwm_view *view) {
     view->next = NULL;
 }
 
+static size_t view_ws_bucket(const struct fbwm_core *core, const struct fbwm_view *view) {
+    if (view->sticky) {
+        return (size_t)core->workspace_count;
+    }
+    if (view->workspace < 0) {
+        return 0;
+    }
+    if (view->workspace >= core->workspace_count) {
+        return (size_t)core->workspace_count - 1;
+    }
+    return (size_t)view->workspace;
+}
+
+static void ws_list_remove(struct fbwm_view *view) {
+    if (view->ws_prev == NULL || view->ws_next == NULL) {
+        return;
+    }
+    view->ws_prev->ws_next = view->ws_next;
+    view->ws_next->ws_prev = view->ws_prev;
+    view->ws_prev = NULL;
+    view->ws_next = NULL;
+    view->ws_bucket = -1;
+}
+
+// Keeps each list newest first; the view being focused or mapped carries the
+// newest stamp, so only re-filing after a workspace change walks the list.
+static void ws_list_insert(struct fbwm_core *core, struct fbwm_view *view) {
+    if (core->workspace_lists == NULL) {
+        return;
+    }
+    const size_t bucket = view_ws_bucket(core, view);
+    struct fbwm_view *head = &core->workspace_lists[bucket];
+    struct fbwm_view *pos = head;
+    while (pos->ws_next != head && pos->ws_next->mru_seq > view->mru_seq) {
+        pos = pos->ws_next;
+    }
+    view->ws_next = pos->ws_next;
+    view->ws_prev = pos;
+    pos->ws_next->ws_prev = view;
+    pos->ws_next = view;
+    view->ws_bucket = (int)bucket;
+}
+
+static void ws_list_refile(struct fbwm_core *core, struct fbwm_view *view) {
+    if (!view_in_list(view) || core->workspace_lists == NULL) {
+        return;
+    }
+    if (view->ws_bucket == (int)view_ws_bucket(core, view) && view->ws_next != NULL) {
+        return;
+    }
+    ws_list_remove(view);
+    ws_list_insert(core, view);
+}
+
+// (Re)allocates one sentinel per workspace plus the sticky one and files
+// every mapped view; only runs when the workspace count changes.
+static void ws_lists_rebuild(struct fbwm_core *core) {
+    const size_t len = (size_t)core->workspace_count + 1;
+    struct fbwm_view *lists = calloc(len, sizeof(*lists));
+    for (struct fbwm_view *walk = core->views.next; walk != &core->views; walk = walk->next) {
+        walk->ws_prev = NULL;
+        walk->ws_next = NULL;
+        walk->ws_bucket = -1;
+    }
+    free(core->workspace_lists);
+    core->workspace_lists = lists;
+    core->workspace_lists_len = lists != NULL ? len : 0;
+    if (lists == NULL) {
+        return;
+    }
+    for (size_t i = 0; i < len; i++) {
+        lists[i].ws_prev = &lists[i];
+        lists[i].ws_next = &lists[i];
+        lists[i].ws_bucket = (int)i;
+    }
+    for (struct fbwm_view *walk = core->views.prev; walk != &core->views; walk = walk->prev) {
+        ws_list_insert(core, walk);
+    }
+}
+
+static void created_list_insert(struct fbwm_core *core, struct fbwm_view *view) {
+    struct fbwm_view *pos = core->created.create_prev;
+    while (pos != &core->created && pos->create_seq > view->create_seq) {
+        pos = pos->create_prev;
+    }
+    view->create_prev = pos;
+    view->create_next = pos->create_next;
+    pos->create_next->create_prev = view;
+    pos->create_next = view;
+}
+
+static void created_list_remove(struct fbwm_view *view) {
+    if (view->create_prev == NULL || view->create_next == NULL) {
+        return;
+    }
+    view->create_prev->create_next = view->create_next;
+    view->create_next->create_prev = view->create_prev;
+    view->create_prev = NULL;
+    view->create_next = NULL;
+}
+
 static const char *safe_str(const char *s) {
     return s != NULL ? s : "(null)";
 }
@@ -111,6 +212,13 @@ void fbwm_view_init(struct fbwm_view *view, const struct fbwm_view_ops *ops, voi
     view->next = NULL;
     view->workspace = 0;
     view->sticky = false;
+    view->ws_prev = NULL;
+    view->ws_next = NULL;
+    view->ws_bucket = -1;
+    view->mru_seq = 0;
+    view->create_seq = 0;
+    view->create_prev = NULL;
+    view->create_next = NULL;
 }
 
 void fbwm_core_init(struct fbwm_core *core) {
@@ -134,6 +242,13 @@ void fbwm_core_init(struct fbwm_core *core) {
     core->workspace_count = 4;
     core->workspace_names = NULL;
     core->workspace_names_len = 0;
+    core->workspace_lists = NULL;
+    core->workspace_lists_len = 0;
+    core->created = (struct fbwm_view){0};
+    core->created.create_prev = &core->created;
+    core->created.create_next = &core->created;
+    core->mru_clock = 0;
+    core->visible_serial = 0;
 
     core->placement_strategy = FBWM_PLACE_ROW_SMART;
     core->placement_row_dir = FBWM_ROW_LEFT_TO_RIGHT;
@@ -154,6 +269,9 @@ void fbwm_core_finish(struct fbwm_core *core) {
     core->workspace_prev_by_head = NULL;
     core->workspace_current_by_head_len = 0;
     fbwm_core_clear_workspace_names(core);
+    free(core->workspace_lists);
+    core->workspace_lists = NULL;
+    core->workspace_lists_len = 0;
 }
 
 void fbwm_core_view_map(struct fbwm_core *core, struct fbwm_view *view) {
@@ -168,6 +286,14 @@ void fbwm_core_view_map(struct fbwm_core *core, struct fbwm_view *view) {
         view->workspace = workspace_current_for_head(core, head);
     }
     list_insert_after(&core->views, view);
+    view->mru_seq = ++core->mru_clock;
+    if (core->workspace_lists_len != (size_t)core->workspace_count + 1) {
+        ws_lists_rebuild(core);
+    } else {
+        ws_list_insert(core, view);
+    }
+    created_list_insert(core, view);
+    core->visible_serial++;
 }
 
 static struct fbwm_view *pick_refocus_candidate(struct fbwm_core *core, const struct fbwm_view *reference,
@@ -175,10 +301,9 @@ static struct fbwm_view *pick_refocus_candidate(struct fbwm_core *core, const st
     if (core == NULL) {
         return NULL;
     }
-    for (struct fbwm_view *walk = core->views.next; walk != &core->views; walk = walk->next) {
-        if (!view_is_visible(core, walk)) {
-            continue;
-        }
+    struct fbwm_visible_iter iter;
+    fbwm_core_visible_iter_init(core, &iter, false);
+    for (struct fbwm_view *walk; (walk = fbwm_core_visible_iter_next(&iter)) != NULL;) {
         if (filter_enabled && core->refocus_filter != NULL &&
                 !core->refocus_filter(core->refocus_filter_userdata, walk, reference)) {
             continue;
@@ -222,7 +347,10 @@ void fbwm_core_view_unmap(struct fbwm_core *core, struct fbwm_view *view) {
     }
 
     const bool was_focused = core->focused == view;
+    ws_list_remove(view);
+    created_list_remove(view);
     list_remove(view);
+    core->visible_serial++;
     if (was_focused) {
         refocus_if_needed(core, view);
     }
@@ -251,6 +379,11 @@ void fbwm_core_focus_view(struct fbwm_core *core, struct fbwm_view *view) {
 
     list_remove(view);
     list_insert_after(&core->views, view);
+    view->mru_seq = ++core->mru_clock;
+    if (view->ws_next != NULL) {
+        ws_list_remove(view);
+        ws_list_insert(core, view);
+    }
     core->focused = view;
 
     log_focus(view, "direct");
@@ -276,13 +409,9 @@ void fbwm_core_focus_next(struct fbwm_core *core) {
         return;
     }
 
-    struct fbwm_view *candidate = NULL;
-    for (struct fbwm_view *walk = core->views.prev; walk != &core->views; walk = walk->prev) {
-        if (view_is_visible(core, walk)) {
-            candidate = walk;
-            break;
-        }
-    }
+    struct fbwm_visible_iter iter;
+    fbwm_core_visible_iter_init(core, &iter, true);
+    struct fbwm_view *candidate = fbwm_core_visible_iter_next(&iter);
     if (candidate == NULL || candidate == core->focused) {
         return;
     }
@@ -296,12 +425,11 @@ void fbwm_core_focus_prev(struct fbwm_core *core) {
         return;
     }
 
-    struct fbwm_view *candidate = NULL;
-    for (struct fbwm_view *walk = core->views.next; walk != &core->views; walk = walk->next) {
-        if (view_is_visible(core, walk) && walk != core->focused) {
-            candidate = walk;
-            break;
-        }
+    struct fbwm_visible_iter iter;
+    fbwm_core_visible_iter_init(core, &iter, false);
+    struct fbwm_view *candidate = fbwm_core_visible_iter_next(&iter);
+    if (candidate != NULL && candidate == core->focused) {
+        candidate = fbwm_core_visible_iter_next(&iter);
     }
     if (candidate == NULL) {
         return;
@@ -350,6 +478,10 @@ void fbwm_core_set_workspace_count(struct fbwm_core *core, int count) {
             core->workspace_prev = core->workspace_prev_by_head[0];
         }
     }
+    if (core->workspace_lists_len != (size_t)core->workspace_count + 1) {
+        ws_lists_rebuild(core);
+    }
+    core->visible_serial++;
     refocus_if_needed(core, NULL);
 }
 
@@ -403,6 +535,7 @@ void fbwm_core_set_head_count(struct fbwm_core *core, size_t head_count) {
     core->workspace_current_by_head_len = head_count;
     core->workspace_current = next_cur[0];
     core->workspace_prev = next_prev[0];
+    core->visible_serial++;
 }
 
 size_t fbwm_core_head_count(const struct fbwm_core *core) {
@@ -543,6 +676,138 @@ bool fbwm_core_view_is_visible(const struct fbwm_core *core, const struct fbwm_v
     return view_is_visible(core, view);
 }
 
+void fbwm_core_view_set_workspace(struct fbwm_core *core, struct fbwm_view *view, int workspace) {
+    if (view == NULL) {
+        return;
+    }
+    view->workspace = workspace;
+    if (core != NULL) {
+        ws_list_refile(core, view);
+        core->visible_serial++;
+    }
+}
+
+void fbwm_core_view_set_sticky(struct fbwm_core *core, struct fbwm_view *view, bool sticky) {
+    if (view == NULL) {
+        return;
+    }
+    view->sticky = sticky;
+    if (core != NULL) {
+        ws_list_refile(core, view);
+        core->visible_serial++;
+    }
+}
+
+size_t fbwm_core_workspace_reindex(struct fbwm_core *core) {
+    if (core == NULL) {
+        return 0;
+    }
+    if (core->workspace_lists_len != (size_t)core->workspace_count + 1) {
+        ws_lists_rebuild(core);
+        return 0;
+    }
+    size_t moved = 0;
+    for (struct fbwm_view *walk = core->views.next; walk != &core->views; walk = walk->next) {
+        if (walk->ws_bucket != (int)view_ws_bucket(core, walk) || walk->ws_next == NULL) {
+            ws_list_refile(core, walk);
+            moved++;
+        }
+    }
+    if (moved > 0) {
+        core->visible_serial++;
+    }
+    return moved;
+}
+
+const struct fbwm_view *fbwm_core_workspace_list(const struct fbwm_core *core, int workspace) {
+    if (core == NULL || core->workspace_lists == NULL || workspace < 0 ||
+            (size_t)workspace + 1 >= core->workspace_lists_len) {
+        return NULL;
+    }
+    return &core->workspace_lists[workspace];
+}
+
+const struct fbwm_view *fbwm_core_creation_list(const struct fbwm_core *core) {
+    return core != NULL ? &core->created : NULL;
+}
+
+uint64_t fbwm_core_visible_serial(const struct fbwm_core *core) {
+    return core != NULL ? core->visible_serial : 0;
+}
+
+static void visible_iter_add(struct fbwm_visible_iter *iter, const struct fbwm_view *list) {
+    for (size_t i = 0; i < iter->len; i++) {
+        if (iter->end[i] == list) {
+            return;
+        }
+    }
+    iter->end[iter->len] = list;
+    iter->pos[iter->len] = iter->oldest_first ? list->ws_prev : list->ws_next;
+    iter->len++;
+}
+
+void fbwm_core_visible_iter_init(const struct fbwm_core *core, struct fbwm_visible_iter *iter, bool oldest_first) {
+    if (iter == NULL) {
+        return;
+    }
+    *iter = (struct fbwm_visible_iter){ .core = core, .oldest_first = oldest_first };
+    if (core == NULL) {
+        return;
+    }
+    const size_t heads = fbwm_core_head_count(core);
+    if (core->workspace_lists == NULL || core->workspace_lists_len != (size_t)core->workspace_count + 1 ||
+            heads >= FBWM_VISIBLE_ITER_LISTS) {
+        iter->walk = oldest_first ? core->views.prev : core->views.next;
+        return;
+    }
+    for (size_t head = 0; head < heads; head++) {
+        const struct fbwm_view probe = {
+            .workspace = workspace_current_for_head(core, head),
+        };
+        visible_iter_add(iter, &core->workspace_lists[view_ws_bucket(core, &probe)]);
+    }
+    visible_iter_add(iter, &core->workspace_lists[core->workspace_lists_len - 1]);
+}
+
+struct fbwm_view *fbwm_core_visible_iter_next(struct fbwm_visible_iter *iter) {
+    if (iter == NULL || iter->core == NULL) {
+        return NULL;
+    }
+    const struct fbwm_core *core = iter->core;
+    if (iter->len == 0) {
+        while (iter->walk != NULL && iter->walk != &core->views) {
+            struct fbwm_view *view = iter->walk;
+            iter->walk = iter->oldest_first ? view->prev : view->next;
+            if (view_is_visible(core, view)) {
+                return view;
+            }
+        }
+        return NULL;
+    }
+    for (;;) {
+        size_t best = iter->len;
+        for (size_t i = 0; i < iter->len; i++) {
+            if (iter->pos[i] == iter->end[i]) {
+                continue;
+            }
+            if (best == iter->len ||
+                    (iter->oldest_first ? iter->pos[i]->mru_seq < iter->pos[best]->mru_seq :
+                        iter->pos[i]->mru_seq > iter->pos[best]->mru_seq)) {
+                best = i;
+            }
+        }
+        if (best == iter->len) {
+            return NULL;
+        }
+        struct fbwm_view *view = iter->pos[best];
+        iter->pos[best] = iter->oldest_first ? view->ws_prev : view->ws_next;
+        // A head showing another workspace hides this bucket's views there.
+        if (view_is_visible(core, view)) {
+            return view;
+        }
+    }
+}
+
 void fbwm_core_workspace_switch(struct fbwm_core *core, int workspace) {
     fbwm_core_workspace_switch_on_head(core, 0, workspace);
 }
@@ -582,6 +847,7 @@ void fbwm_core_workspace_switch_on_head(struct fbwm_core *core, size_t head, int
         fprintf(stderr, "Policy: workspace switch to %d\n", workspace + 1);
     }
 
+    core->visible_serial++;
     refocus_if_needed(core, NULL);
 }
 
@@ -597,7 +863,7 @@ void fbwm_core_move_focused_to_workspace(struct fbwm_core *core, int workspace)
     }
 
     struct fbwm_view *view = core->focused;
-    view->workspace = workspace;
+    fbwm_core_view_set_workspace(core, view, workspace);
     const char *title = view->ops && view->ops->title ? view->ops->title(view) : NULL;
     const char *app_id = view->ops && view->ops->app_id ? view->ops->app_id(view) : NULL;
     fprintf(stderr, "Policy: move focused to workspace %d title=%s app_id=%s\n",
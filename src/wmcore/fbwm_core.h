@@ -2,6 +2,7 @@
 
 #include <stdbool.h>
 #include <stddef.h>
+#include <stdint.h>
 
 struct fbwm_box;
 struct fbwm_view;
@@ -25,6 +26,21 @@ struct fbwm_view {
 
     int workspace;
     bool sticky;
+
+    // Per-workspace membership (see fbwm_core_workspace_list); prefer
+    // fbwm_core_view_set_workspace/_sticky over writing the fields above.
+    struct fbwm_view *ws_prev;
+    struct fbwm_view *ws_next;
+    int ws_bucket;
+
+    // Focus recency stamp; each per-workspace list is kept newest first.
+    uint64_t mru_seq;
+
+    // Creation-order membership (see fbwm_core_creation_list). create_seq is
+    // owned by the caller; views with equal values keep their map order.
+    uint64_t create_seq;
+    struct fbwm_view *create_prev;
+    struct fbwm_view *create_next;
 };
 
 typedef bool (*fbwm_core_refocus_filter_fn)(void *userdata, const struct fbwm_view *candidate,
@@ -50,6 +66,23 @@ enum fbwm_col_placement_direction {
     FBWM_COL_BOTTOM_TO_TOP,
 };
 
+enum {
+    FBWM_VISIBLE_ITER_LISTS = 8,
+};
+
+// Merges the per-workspace lists shown on any head with the sticky list,
+// yielding visible views in focus order without touching the others. Focus
+// and workspace changes invalidate an iterator in progress.
+struct fbwm_visible_iter {
+    const struct fbwm_core *core;
+    bool oldest_first;
+    size_t len;
+    struct fbwm_view *pos[FBWM_VISIBLE_ITER_LISTS];
+    const struct fbwm_view *end[FBWM_VISIBLE_ITER_LISTS];
+    // Fallback walk of the main list when the index is unavailable.
+    struct fbwm_view *walk;
+};
+
 struct fbwm_core {
     struct fbwm_view views;
     struct fbwm_view *focused;
@@ -66,6 +99,17 @@ struct fbwm_core {
     char **workspace_names;
     size_t workspace_names_len;
 
+    // Sentinels of the per-workspace view lists. The extra last one parks
+    // sticky views, which no switch ever needs to walk.
+    struct fbwm_view *workspace_lists;
+    size_t workspace_lists_len;
+
+    // Mapped views ordered by create_seq.
+    struct fbwm_view created;
+    uint64_t mru_clock;
+    // Bumped whenever the set of visible views may have changed.
+    uint64_t visible_serial;
+
     enum fbwm_window_placement_strategy placement_strategy;
     enum fbwm_row_placement_direction placement_row_dir;
     enum fbwm_col_placement_direction placement_col_dir;
@@ -111,6 +155,19 @@ enum fbwm_col_placement_direction fbwm_core_col_placement_direction(const struct
 void fbwm_core_set_col_placement_direction(struct fbwm_core *core, enum fbwm_col_placement_direction dir);
 
 bool fbwm_core_view_is_visible(const struct fbwm_core *core, const struct fbwm_view *view);
+void fbwm_core_view_set_workspace(struct fbwm_core *core, struct fbwm_view *view, int workspace);
+void fbwm_core_view_set_sticky(struct fbwm_core *core, struct fbwm_view *view, bool sticky);
+// Re-files views whose workspace/sticky fields were written directly;
+// returns how many moved.
+size_t fbwm_core_workspace_reindex(struct fbwm_core *core);
+// Sentinel of the mapped, non-sticky views on `workspace` (walk ws_next back
+// to it), or NULL when the index is unavailable.
+const struct fbwm_view *fbwm_core_workspace_list(const struct fbwm_core *core, int workspace);
+// Sentinel of the mapped views in creation order (walk create_next).
+const struct fbwm_view *fbwm_core_creation_list(const struct fbwm_core *core);
+uint64_t fbwm_core_visible_serial(const struct fbwm_core *core);
+void fbwm_core_visible_iter_init(const struct fbwm_core *core, struct fbwm_visible_iter *iter, bool oldest_first);
+struct fbwm_view *fbwm_core_visible_iter_next(struct fbwm_visible_iter *iter);
 void fbwm_core_workspace_switch(struct fbwm_core *core, int workspace);
 void fbwm_core_workspace_switch_on_head(struct fbwm_core *core, size_t head, int workspace);
 void fbwm_core_move_focused_to_workspace(struct fbwm_core *core, int workspace);
@@ -224,36 +224,54 @@ int main(int argc, char **argv) {
         return 1;
     }
 
-    char resp[1024];
+    // The compositor writes one reply (possibly several lines) and closes
+    // the connection, so read to EOF.
+    char *resp = NULL;
     size_t len = 0;
-    bool saw_newline = false;
-    resp[0] = '\0';
+    size_t cap = 0;
 
     struct pollfd pfd = {.fd = fd, .events = POLLIN};
-    while (!saw_newline && len + 1 < sizeof(resp)) {
+    for (;;) {
+        if (cap - len < 1024) {
+            size_t new_cap = cap > 0 ? cap * 2 : 4096;
+            char *tmp = realloc(resp, new_cap);
+            if (tmp == NULL) {
+                fprintf(stderr, "fbwl-remote: out of memory\n");
+                free(resp);
+                close(fd);
+                free(path);
+                return 1;
+            }
+            resp = tmp;
+            cap = new_cap;
+        }
+
         int prc = poll(&pfd, 1, timeout_ms);
         if (prc < 0) {
             if (errno == EINTR) {
                 continue;
             }
             fprintf(stderr, "fbwl-remote: poll() failed: %s\n", strerror(errno));
+            free(resp);
             close(fd);
             free(path);
             return 1;
         }
         if (prc == 0) {
             fprintf(stderr, "fbwl-remote: timed out waiting for response (%d ms)\n", timeout_ms);
+            free(resp);
             close(fd);
             free(path);
             return 1;
         }
 
-        ssize_t n = read(fd, resp + len, sizeof(resp) - 1 - len);
+        ssize_t n = read(fd, resp + len, cap - 1 - len);
         if (n < 0) {
             if (errno == EINTR) {
                 continue;
             }
             fprintf(stderr, "fbwl-remote: read() failed: %s\n", strerror(errno));
+            free(resp);
             close(fd);
             free(path);
             return 1;
@@ -261,32 +279,25 @@ int main(int argc, char **argv) {
         if (n == 0) {
             break;
         }
-
         len += (size_t)n;
-        resp[len] = '\0';
-
-        if (strchr(resp, '\n') != NULL) {
-            saw_newline = true;
-        }
     }
+    resp[len] = '\0';
 
     close(fd);
     free(path);
 
-    char *nl = strchr(resp, '\n');
-    if (nl != NULL) {
-        *nl = '\0';
-    }
-
-    if (len == 0 || resp[0] == '\0') {
+    if (len == 0 || resp[0] == '\0' || resp[0] == '\n') {
         fprintf(stderr, "fbwl-remote: empty response\n");
+        free(resp);
         return 1;
     }
 
-    printf("%s\n", resp);
-
-    if (strncmp(resp, "ok", 2) == 0) {
-        return 0;
+    fputs(resp, stdout);
+    if (resp[len - 1] != '\n') {
+        fputc('\n', stdout);
     }
-    return 1;
+
+    const bool resp_ok = strncmp(resp, "ok", 2) == 0;
+    free(resp);
+    return resp_ok ? 0 : 1;
 }
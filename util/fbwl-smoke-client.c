@@ -245,7 +245,7 @@ static const struct xdg_toplevel_listener xdg_toplevel_listener = {
 
 static void usage(const char *argv0) {
     fprintf(stderr,
-        "Usage: %s [--socket NAME] [--timeout-ms MS] [--title TITLE] [--app-id APPID] [--stay-ms MS] [--width PX] [--height PX] [--xdg-decoration] [--ignore-close]\n",
+        "Usage: %s [--socket NAME] [--timeout-ms MS] [--title TITLE] [--app-id APPID] [--stay-ms MS] [--width PX] [--height PX] [--xdg-decoration] [--ignore-close] [--title-storm N]\n",
         argv0);
 }
 
@@ -295,6 +295,7 @@ int main(int argc, char **argv) {
     int init_height = 32;
     bool want_xdg_decoration = false;
     bool ignore_close = false;
+    int title_storm = 0;
 
     static const struct option options[] = {
         {"socket", required_argument, NULL, 1},
@@ -306,6 +307,7 @@ int main(int argc, char **argv) {
         {"width", required_argument, NULL, 7},
         {"height", required_argument, NULL, 8},
         {"ignore-close", no_argument, NULL, 9},
+        {"title-storm", required_argument, NULL, 10},
         {"help", no_argument, NULL, 'h'},
         {0, 0, 0, 0},
     };
@@ -340,6 +342,9 @@ int main(int argc, char **argv) {
         case 9:
             ignore_close = true;
             break;
+        case 10:
+            title_storm = atoi(optarg);
+            break;
         case 'h':
         default:
             usage(argv[0]);
@@ -471,6 +476,24 @@ int main(int argc, char **argv) {
         return 1;
     }
 
+    if (title_storm > 0) {
+        /* Retitle as fast as the socket allows; each roundtrip keeps the
+         * client from outrunning the compositor's buffer. */
+        char storm_title[256];
+        for (int i = 1; i <= title_storm; i++) {
+            snprintf(storm_title, sizeof(storm_title), "%s-%d", title != NULL ? title : "storm", i);
+            xdg_toplevel_set_title(app.xdg_toplevel, storm_title);
+            if ((i % 64) == 0 || i == title_storm) {
+                if (wl_display_roundtrip(app.display) < 0) {
+                    fprintf(stderr, "fbwl-smoke-client: title storm roundtrip failed: %s\n",
+                        strerror(errno));
+                    cleanup(&app);
+                    return 1;
+                }
+            }
+        }
+    }
+
     if (stay_ms != 0) {
         const int64_t stay_deadline = now_ms() + stay_ms;
         while (!app.closed && now_ms() < stay_deadline) {
@@ -1,4 +1,6 @@
+#include <errno.h>
 #include <getopt.h>
+#include <signal.h>
 #include <stdbool.h>
 #include <stdint.h>
 #include <stdio.h>
@@ -22,6 +24,7 @@ static void usage(const char *argv0) {
     printf("          [--attention-icon-rgba #RRGGBB[AA]] [--attention-icon-size N] [--attention-icon-name NAME]\n");
     printf("          [--overlay-icon-rgba #RRGGBB[AA]] [--overlay-icon-size N] [--overlay-icon-name NAME]\n");
     printf("          [--update-icon-rgba #RRGGBB[AA]] [--update-icon-on-activate]\n");
+    printf("          [--burst-on-usr1 N]\n");
     printf("\n");
     printf("Defaults:\n");
     printf("  --watcher   org.kde.StatusNotifierWatcher\n");
@@ -58,8 +61,16 @@ struct item_service {
     uint8_t update_g;
     uint8_t update_b;
     uint8_t update_a;
+    int burst_count;
 };
 
+static volatile sig_atomic_t burst_requested;
+
+static void handle_usr1(int sig) {
+    (void)sig;
+    burst_requested = 1;
+}
+
 static uint64_t now_usec(void) {
     struct timespec ts = {0};
     if (clock_gettime(CLOCK_MONOTONIC, &ts) != 0) {
@@ -334,6 +345,107 @@ static int item_prop_id(sd_bus *bus, const char *path, const char *interface, co
     return sd_bus_message_append(reply, "s", svc != NULL && svc->id != NULL ? svc->id : "");
 }
 
+static int append_icon_pixmap(sd_bus_message *m, const struct item_service *svc) {
+    int r = sd_bus_message_open_container(m, 'a', "(iiay)");
+    if (r < 0) {
+        return r;
+    }
+    if (svc->icon_argb != NULL && svc->icon_w > 0 && svc->icon_h > 0 && svc->icon_len > 0) {
+        r = sd_bus_message_open_container(m, 'r', "iiay");
+        if (r < 0) {
+            return r;
+        }
+        r = sd_bus_message_append(m, "ii", svc->icon_w, svc->icon_h);
+        if (r < 0) {
+            return r;
+        }
+        r = sd_bus_message_append_array(m, 'y', svc->icon_argb, svc->icon_len);
+        if (r < 0) {
+            return r;
+        }
+        r = sd_bus_message_close_container(m);
+        if (r < 0) {
+            return r;
+        }
+    }
+    return sd_bus_message_close_container(m);
+}
+
+static int emit_status_icon_changed(sd_bus *bus, const struct item_service *svc, const char *status) {
+    sd_bus_message *m = NULL;
+    int r = sd_bus_message_new_signal(bus, &m, svc->item_path, "org.freedesktop.DBus.Properties",
+        "PropertiesChanged");
+    if (r < 0) {
+        return r;
+    }
+
+    r = sd_bus_message_append(m, "s", "org.kde.StatusNotifierItem");
+    if (r >= 0) {
+        r = sd_bus_message_open_container(m, 'a', "{sv}");
+    }
+    if (r >= 0) {
+        r = sd_bus_message_append(m, "{sv}", "Status", "s", status);
+    }
+    if (r >= 0) {
+        r = sd_bus_message_open_container(m, 'e', "sv");
+    }
+    if (r >= 0) {
+        r = sd_bus_message_append(m, "s", "IconPixmap");
+    }
+    if (r >= 0) {
+        r = sd_bus_message_open_container(m, 'v', "a(iiay)");
+    }
+    if (r >= 0) {
+        r = append_icon_pixmap(m, svc);
+    }
+    if (r >= 0) {
+        r = sd_bus_message_close_container(m);
+    }
+    if (r >= 0) {
+        r = sd_bus_message_close_container(m);
+    }
+    if (r >= 0) {
+        r = sd_bus_message_close_container(m);
+    }
+    if (r >= 0) {
+        r = sd_bus_message_append(m, "as", 0);
+    }
+    if (r >= 0) {
+        r = sd_bus_send(bus, m, NULL);
+    }
+    sd_bus_message_unref(m);
+    return r;
+}
+
+// Sends `burst_count` rounds of PropertiesChanged (Status + IconPixmap values)
+// and NewStatus back to back, as a blinking tray app would. Status alternates
+// and ends on NeedsAttention; the icon is switched to the update colour first.
+static void emit_burst(sd_bus *bus, struct item_service *svc) {
+    if (svc->update_has_color && svc->icon_argb != NULL) {
+        for (size_t i = 0; i + 3 < svc->icon_len; i += 4) {
+            svc->icon_argb[i + 0] = svc->update_a;
+            svc->icon_argb[i + 1] = svc->update_r;
+            svc->icon_argb[i + 2] = svc->update_g;
+            svc->icon_argb[i + 3] = svc->update_b;
+        }
+    }
+
+    for (int i = 0; i < svc->burst_count; i++) {
+        const char *status = (svc->burst_count - 1 - i) % 2 == 0 ? "NeedsAttention" : "Active";
+        int r = emit_status_icon_changed(bus, svc, status);
+        if (r >= 0) {
+            r = sd_bus_emit_signal(bus, svc->item_path, "org.kde.StatusNotifierItem", "NewStatus", "s", status);
+        }
+        if (r < 0) {
+            fprintf(stderr, "fbwl-sni-item-client: burst signal failed: %s\n", strerror(-r));
+            return;
+        }
+    }
+    (void)sd_bus_flush(bus);
+    printf("ok sni burst signals=%d\n", svc->burst_count * 2);
+    fflush(stdout);
+}
+
 static const sd_bus_vtable item_vtable[] = {
     SD_BUS_VTABLE_START(0),
     SD_BUS_METHOD("Activate", "ii", "", item_method_activate, SD_BUS_VTABLE_UNPRIVILEGED),
@@ -472,6 +584,7 @@ int main(int argc, char **argv) {
     const char *overlay_icon_name = NULL;
     const char *update_icon_rgba = NULL;
     bool update_icon_on_activate = false;
+    int burst_count = 0;
 
     static const struct option options[] = {
         {"watcher", required_argument, NULL, 1},
@@ -494,6 +607,7 @@ int main(int argc, char **argv) {
         {"overlay-icon-size", required_argument, NULL, 18},
         {"overlay-icon-name", required_argument, NULL, 19},
         {"id", required_argument, NULL, 20},
+        {"burst-on-usr1", required_argument, NULL, 21},
         {"help", no_argument, NULL, 'h'},
         {0, 0, 0, 0},
     };
@@ -582,6 +696,12 @@ int main(int argc, char **argv) {
         case 20:
             item_id = optarg;
             break;
+        case 21:
+            burst_count = atoi(optarg);
+            if (burst_count < 0) {
+                burst_count = 0;
+            }
+            break;
         case 'h':
         default:
             usage(argv[0]);
@@ -672,6 +792,10 @@ int main(int argc, char **argv) {
         svc.update_a = a;
     }
     svc.update_on_activate = update_icon_on_activate;
+    svc.burst_count = burst_count;
+    if (burst_count > 0) {
+        signal(SIGUSR1, handle_usr1);
+    }
 
     sd_bus *bus = NULL;
     sd_bus_error error = SD_BUS_ERROR_NULL;
@@ -783,6 +907,11 @@ int main(int argc, char **argv) {
                 }
             }
 
+            if (burst_requested) {
+                burst_requested = 0;
+                emit_burst(bus, &svc);
+            }
+
             uint64_t now = now_usec();
             if (deadline == 0 || now >= deadline) {
                 break;
@@ -790,6 +919,9 @@ int main(int argc, char **argv) {
 
             uint64_t remaining = deadline - now;
             r = sd_bus_wait(bus, remaining);
+            if (r == -EINTR) {
+                continue;
+            }
             if (r < 0) {
                 fprintf(stderr, "fbwl-sni-item-client: sd_bus_wait failed: %s\n", strerror(-r));
                 break;